@@ -2,11 +2,72 @@
 #define LAYER_H_INCLUDED
 
 #include <cstddef>
+#include <cstring>
 #include <string>
 
+#include "memory_arena.h"
+
 namespace RTNEURAL_NAMESPACE
 {
 
+template <typename T>
+struct PlanOp;
+
+#ifndef DOXYGEN
+/**
+ * Helpers for copying layer state to and from a flat array of values.
+ * The state members may be stored as plain values, SIMD batches, arrays,
+ * or fixed-size Eigen vectors, so they are copied as raw memory.
+ */
+namespace state_detail
+{
+    /** Returns the number of values of type T taken up by `count` elements of type U. */
+    template <typename T, typename U>
+    constexpr size_t getNumValues(size_t count) noexcept
+    {
+        static_assert(sizeof(U) % sizeof(T) == 0, "State elements must be made up of whole values!");
+        return count * (sizeof(U) / sizeof(T));
+    }
+
+    /** Copies `count` elements into `state`, and returns the position after them. */
+    template <typename T, typename U>
+    T* saveValues(const U* elements, size_t count, T* state) noexcept
+    {
+        std::memcpy(state, elements, count * sizeof(U));
+        return state + getNumValues<T, U>(count);
+    }
+
+    /** Copies `count` elements from `state`, and returns the position after them. */
+    template <typename T, typename U>
+    const T* loadValues(U* elements, size_t count, const T* state) noexcept
+    {
+        std::memcpy(elements, state, count * sizeof(U));
+        return state + getNumValues<T, U>(count);
+    }
+
+    /** Returns the number of values of type T taken up by a contiguous buffer (e.g. a delay line). */
+    template <typename T, typename Container>
+    size_t getBufferSize(const Container& buffer) noexcept
+    {
+        return getNumValues<T, typename Container::value_type>(buffer.size());
+    }
+
+    /** Copies a contiguous buffer into `state`, and returns the position after it. */
+    template <typename T, typename Container>
+    T* saveBuffer(const Container& buffer, T* state) noexcept
+    {
+        return saveValues(buffer.data(), buffer.size(), state);
+    }
+
+    /** Copies a contiguous buffer from `state`, and returns the position after it. */
+    template <typename T, typename Container>
+    const T* loadBuffer(Container& buffer, const T* state) noexcept
+    {
+        return loadValues(buffer.data(), buffer.size(), state);
+    }
+} // namespace state_detail
+#endif
+
 /** Virtual base class for a generic neural network layer. */
 template <typename T>
 class Layer
@@ -27,9 +88,65 @@ public:
     /** Resets the state of this layer. */
     virtual void reset() { }
 
+    /**
+     * Returns the number of values needed to store the internal state of
+     * this layer (e.g. recurrent state or convolution history), or zero
+     * if the layer is stateless.
+     */
+    virtual size_t getStateSize() const noexcept { return 0; }
+
+    /** Copies the internal state of this layer into `state`, which must hold `getStateSize()` values. */
+    virtual void saveState(T* /*state*/) const noexcept { }
+
+    /** Restores the internal state of this layer from values written by `saveState()`. */
+    virtual void loadState(const T* /*state*/) noexcept { }
+
     /** Implements the forward propagation step for this layer. */
     virtual void forward(const T* input, T* out) noexcept = 0;
 
+    /**
+     * Implements the forward propagation step for a block of frames.
+     *
+     * The frames are stored contiguously, so frame `n` of the input starts
+     * at `input + n * in_size`, and frame `n` of the output starts at
+     * `out + n * out_size`. The default implementation calls `forward()`
+     * for each frame, but layers may override this method to process the
+     * whole block at once.
+     */
+    virtual void forwardBlock(const T* input, T* out, int numSamples) noexcept
+    {
+        for(int n = 0; n < numSamples; ++n)
+            forward(input + n * in_size, out + n * out_size);
+    }
+
+    /**
+     * Returns an estimate of the number of multiply-adds done by `forward()`,
+     * which is used to balance work between threads. The default is one
+     * operation per output, as for an element-wise activation.
+     */
+    virtual size_t getNumMACs() const noexcept { return (size_t)out_size; }
+
+    /**
+     * Returns the number of bytes needed to store the weights and state
+     * of this layer in a MemoryArena, or zero if the layer always manages
+     * its own memory.
+     */
+    virtual size_t getArenaBytes() const noexcept { return 0; }
+
+    /**
+     * Moves the weights and state of this layer into memory taken from
+     * the arena, which must have at least `getArenaBytes()` bytes free.
+     */
+    virtual void moveToArena(MemoryArena&) { }
+
+    /**
+     * Used by `Model::compile()` for layer types that the execution plan
+     * doesn't know about. Layers may fill in `op` to be called directly
+     * and return true, or return false to be called through the virtual
+     * methods.
+     */
+    virtual bool resolvePlanOp(PlanOp<T>&) { return false; }
+
     const int in_size;
     const int out_size;
 };
@@ -1,15 +1,19 @@
 #ifndef MODEL_H_INCLUDED
 #define MODEL_H_INCLUDED
 
+#include <algorithm>
 #include <vector>
 
 #include "Layer.h"
 #include "activation/activation.h"
+#include "activation/gated_activation.h"
+#include "activation/lut_activation.h"
 #include "batchnorm/batchnorm.h"
 #include "batchnorm/batchnorm.tpp"
 #include "batchnorm/batchnorm2d.h"
 #include "batchnorm/batchnorm2d.tpp"
 #include "config.h"
+#include "memory_arena.h"
 #include "conv1d/conv1d.h"
 #include "conv1d/conv1d.tpp"
 #include "conv2d/conv2d.h"
@@ -19,6 +23,7 @@
 #include "gru/gru.tpp"
 #include "lstm/lstm.h"
 #include "lstm/lstm.tpp"
+#include "model_plan.h"
 
 namespace RTNEURAL_NAMESPACE
 {
@@ -45,8 +50,6 @@ public:
         for(auto l : layers)
             delete l;
         layers.clear();
-
-        outs.clear();
     }
 
     /** Returns the model's input size */
@@ -68,9 +71,47 @@ public:
     void addLayer(Layer<T>* layer)
     {
         layers.push_back(layer);
-        outs.push_back(vec_type(layer->out_size, (T)0));
+        allocateBuffers();
+    }
+
+    /**
+     * Prepares the model to process blocks of up to `newMaxBlockSize` frames.
+     * Larger blocks can still be passed to the block `forward()` method, but
+     * they will be processed in chunks of `newMaxBlockSize` frames.
+     *
+     * This method allocates memory, so it should not be called from the
+     * real-time thread.
+     */
+    void prepare(int newMaxBlockSize)
+    {
+        maxBlockSize = std::max(newMaxBlockSize, 1);
+        allocateBuffers();
     }
 
+    /** Returns the maximum number of frames processed in a single chunk. */
+    int getMaxBlockSize() const noexcept { return maxBlockSize; }
+
+    /**
+     * Enables or disables intermediate buffer reuse.
+     *
+     * By default, each layer writes its output to its own buffer. When
+     * buffer reuse is enabled, the layer outputs alternate between two
+     * buffers (sized for the largest layer), and activation layers run in
+     * place, since each buffer is only needed until the next layer has
+     * read it. This keeps the working set of deep models small.
+     *
+     * This method allocates memory, so it should not be called from the
+     * real-time thread.
+     */
+    void setBufferReuse(bool shouldReuseBuffers)
+    {
+        reuseBuffers = shouldReuseBuffers;
+        allocateBuffers();
+    }
+
+    /** Returns true if intermediate buffer reuse is enabled. */
+    bool getBufferReuse() const noexcept { return reuseBuffers; }
+
     /** Resets the state of the network layers. */
     RTNEURAL_REALTIME void reset()
     {
@@ -78,39 +119,352 @@ public:
             l->reset();
     }
 
+    /** Returns the number of values needed to store the state of the network layers. */
+    size_t getStateSize() const noexcept
+    {
+        size_t stateSize = 0;
+        for(const auto* l : layers)
+            stateSize += l->getStateSize();
+        return stateSize;
+    }
+
+    /**
+     * Copies the state of the network layers into `state`, which must hold
+     * `getStateSize()` values. The state can be restored with `loadState()`,
+     * e.g. to start a voice from a pre-warmed state without running warm-up
+     * samples.
+     */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept
+    {
+        for(const auto* l : layers)
+        {
+            l->saveState(state);
+            state += l->getStateSize();
+        }
+    }
+
+    /**
+     * Restores the state of the network layers from values written by
+     * `saveState()`, on a model with the same layers (and the same sample
+     * rate correction delays).
+     */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept
+    {
+        for(auto* l : layers)
+        {
+            l->loadState(state);
+            state += l->getStateSize();
+        }
+    }
+
     /** Performs forward propagation for this model. */
     RTNEURAL_REALTIME inline T forward(const T* input)
     {
-        layers[0]->forward(input, outs[0].data());
+        if(!plan.empty())
+        {
+            const auto* ops = plan.data();
+            ops[0].forward(ops[0].layer, input, ops[0].out);
+            for(size_t i = 1; i < plan.size(); ++i)
+                ops[i].forward(ops[i].layer, ops[i].in, ops[i].out);
+
+            return outs.back()[0];
+        }
+
+        layers[0]->forward(input, outs[0]);
 
         for(int i = 1; i < (int)layers.size(); ++i)
         {
-            layers[i]->forward(outs[i - 1].data(), outs[i].data());
+            layers[i]->forward(outs[i - 1], outs[i]);
         }
 
         return outs.back()[0];
     }
 
+    /**
+     * Performs forward propagation for a block of frames.
+     *
+     * The input frames are stored contiguously (frame `n` starts at
+     * `input + n * getInSize()`), and the output frames are written
+     * contiguously to `output` (frame `n` starts at `output + n * getOutSize()`).
+     * Each layer is called once per block (or once per chunk of
+     * `getMaxBlockSize()` frames), rather than once per frame.
+     */
+    RTNEURAL_REALTIME inline void forward(const T* input, T* output, int numSamples)
+    {
+        const auto numLayers = (int)layers.size();
+        const auto inSize = layers.front()->in_size;
+        const auto outSize = layers.back()->out_size;
+
+        for(int offset = 0; offset < numSamples; offset += maxBlockSize)
+        {
+            const auto chunkSize = std::min(maxBlockSize, numSamples - offset);
+            const auto* chunkIn = input + (size_t)offset * (size_t)inSize;
+            auto* chunkOut = output + (size_t)offset * (size_t)outSize;
+
+            if(!plan.empty())
+            {
+                forwardPlanBlock(chunkIn, chunkOut, chunkSize);
+                continue;
+            }
+
+            if(numLayers == 1)
+            {
+                layers[0]->forwardBlock(chunkIn, chunkOut, chunkSize);
+                continue;
+            }
+
+            layers[0]->forwardBlock(chunkIn, blockOuts[0], chunkSize);
+            for(int i = 1; i < numLayers - 1; ++i)
+                layers[i]->forwardBlock(blockOuts[i - 1], blockOuts[i], chunkSize);
+            layers[numLayers - 1]->forwardBlock(blockOuts[numLayers - 2], chunkOut, chunkSize);
+        }
+
+        // keep getOutputs() consistent with the single-frame API
+        if(numSamples > 0)
+            std::copy(output + (size_t)(numSamples - 1) * (size_t)outSize,
+                output + (size_t)numSamples * (size_t)outSize,
+                outs.back());
+    }
+
     /** Returns a pointer to the output of the final layer in the network. */
     RTNEURAL_REALTIME inline const T* getOutputs() const noexcept
     {
-        return outs.back().data();
+        return outs.back();
+    }
+
+    /**
+     * Returns the number of bytes needed by `allocateArena()` to hold the
+     * weights, state, and intermediate buffers of the model.
+     */
+    size_t getArenaBytes() const noexcept
+    {
+        auto numBytes = getBufferBytes();
+        for(auto* l : layers)
+            numBytes += l->getArenaBytes();
+        return numBytes;
     }
 
+    /**
+     * Moves the weights, state, and intermediate buffers of the model
+     * into a single aligned block of memory, laid out in the order that
+     * the layers are processed. Layers which don't support being placed
+     * in an arena keep their own memory: the xsimd dense, Conv1D, GRU, and
+     * LSTM layers, and the PReLU, BatchNorm, Conv2D, and stateless Conv1D
+     * layers on every backend.
+     *
+     * This should be called after all the layers have been added and
+     * loaded, and after `prepare()`. The weights and state are preserved.
+     * This method allocates memory, so it should not be called from the
+     * real-time thread.
+     */
+    void allocateArena()
+    {
+        MemoryArena newArena(getArenaBytes());
+        moveToArena(newArena);
+    }
+
+    /**
+     * Same as `allocateArena()`, but uses caller-provided memory
+     * (e.g. pre-faulted or huge-page memory), which must be aligned to
+     * `MemoryArena::alignment`, and must outlive the model.
+     *
+     * Returns false (and leaves the model unchanged) if the memory is
+     * smaller than `getArenaBytes()`, or is not aligned.
+     */
+    bool allocateArena(void* memory, size_t numBytes)
+    {
+        if(numBytes < getArenaBytes() || !MemoryArena::isAligned(memory))
+            return false;
+
+        MemoryArena newArena(memory, numBytes);
+        moveToArena(newArena);
+        return true;
+    }
+
+    /**
+     * Compiles the layers into a flat execution plan, which is used
+     * by the `forward()` methods from now on. The plan calls each layer's
+     * implementation through a direct function pointer, with the buffer
+     * pointers resolved ahead of time, so running the model does not
+     * need any virtual calls.
+     *
+     * The plan is kept up to date if layers are added, or if the model's
+     * buffers are re-allocated (e.g. by `prepare()` or `allocateArena()`).
+     * This method allocates memory, so it should not be called from the
+     * real-time thread.
+     */
+    void compile()
+    {
+        plan.resize(layers.size());
+        for(size_t i = 0; i < layers.size(); ++i)
+        {
+            auto& op = plan[i];
+            op.layer = layers[i];
+            resolvePlanOp(op);
+
+            op.in = i == 0 ? nullptr : outs[i - 1];
+            op.out = outs[i];
+            op.blockIn = i == 0 ? nullptr : blockOuts[i - 1];
+            op.blockOut = blockOuts[i];
+        }
+    }
+
+    /** Returns true if the model has been compiled into an execution plan. */
+    bool isCompiled() const noexcept { return !plan.empty(); }
+
     /** A vector storing the network layers in sequential order. */
     std::vector<Layer<T>*> layers;
 
 private:
-#if RTNEURAL_USE_XSIMD
-    using vec_type = std::vector<T, xsimd::aligned_allocator<T>>;
-#elif RTNEURAL_USE_EIGEN
-    using vec_type = std::vector<T, Eigen::aligned_allocator<T>>;
-#else
-    using vec_type = std::vector<T>;
-#endif
+    /** Returns the size of the single-frame and block buffers for an output of the given size. */
+    size_t getBufferBytes(int size) const noexcept
+    {
+        return MemoryArena::getBytes<T>((size_t)size)
+            + MemoryArena::getBytes<T>((size_t)size * (size_t)maxBlockSize);
+    }
+
+    /** Returns the total size of the intermediate buffers. */
+    size_t getBufferBytes() const noexcept
+    {
+        if(reuseBuffers)
+            return (size_t)getNumSharedBuffers() * getBufferBytes(getMaxOutSize());
+
+        size_t numBytes = 0;
+        for(auto* l : layers)
+            numBytes += getBufferBytes(l->out_size);
+        return numBytes;
+    }
+
+    int getMaxOutSize() const noexcept
+    {
+        int maxOutSize = 0;
+        for(auto* l : layers)
+            maxOutSize = std::max(maxOutSize, l->out_size);
+        return maxOutSize;
+    }
+
+    /**
+     * Returns the shared buffer used for the output of layer `layerIdx`,
+     * given the shared buffer used for its input (or -1 for the model input).
+     * Activation layers work element-wise, so they can run in place.
+     */
+    int getSharedBufferIndex(size_t layerIdx, int inputBufferIdx) const noexcept
+    {
+        if(inputBufferIdx >= 0 && dynamic_cast<const Activation<T>*>(layers[layerIdx]) != nullptr)
+            return inputBufferIdx;
+
+        return inputBufferIdx == 0 ? 1 : 0;
+    }
+
+    int getNumSharedBuffers() const noexcept
+    {
+        int numBuffers = 0;
+        int bufferIdx = -1;
+        for(size_t i = 0; i < layers.size(); ++i)
+        {
+            bufferIdx = getSharedBufferIndex(i, bufferIdx);
+            numBuffers = std::max(numBuffers, bufferIdx + 1);
+        }
+        return numBuffers;
+    }
+
+    /**
+     * Takes the intermediate buffers (and optionally the layer weights and state)
+     * from the arena, in the order that the layers are processed.
+     */
+    void bindBuffers(MemoryArena& memory, bool moveLayers)
+    {
+        const auto maxOutSize = (size_t)getMaxOutSize();
+        T* sharedOuts[2] {};
+        T* sharedBlockOuts[2] {};
+        if(reuseBuffers)
+        {
+            for(int b = 0; b < getNumSharedBuffers(); ++b)
+            {
+                sharedOuts[b] = memory.allocate<T>(maxOutSize);
+                sharedBlockOuts[b] = memory.allocate<T>(maxOutSize * (size_t)maxBlockSize);
+            }
+        }
+
+        outs.resize(layers.size());
+        blockOuts.resize(layers.size());
+        int bufferIdx = -1;
+        for(size_t i = 0; i < layers.size(); ++i)
+        {
+            if(moveLayers)
+                layers[i]->moveToArena(memory);
+
+            const auto out_size = (size_t)layers[i]->out_size;
+            if(reuseBuffers)
+            {
+                bufferIdx = getSharedBufferIndex(i, bufferIdx);
+                outs[i] = sharedOuts[bufferIdx];
+                blockOuts[i] = sharedBlockOuts[bufferIdx];
+            }
+            else
+            {
+                outs[i] = memory.allocate<T>(out_size);
+                blockOuts[i] = memory.allocate<T>(out_size * (size_t)maxBlockSize);
+            }
+
+            std::fill(outs[i], outs[i] + out_size, (T)0);
+            std::fill(blockOuts[i], blockOuts[i] + out_size * (size_t)maxBlockSize, (T)0);
+        }
+
+        if(isCompiled())
+            compile();
+    }
+
+    /** Allocates the intermediate buffers for each layer, in a single block of memory. */
+    void allocateBuffers()
+    {
+        bufferMemory = MemoryArena(getBufferBytes());
+        bindBuffers(bufferMemory, false);
+    }
+
+    void moveToArena(MemoryArena& newArena)
+    {
+        // keep getOutputs() consistent
+        std::vector<T> lastOuts;
+        if(!outs.empty())
+            lastOuts.assign(outs.back(), outs.back() + layers.back()->out_size);
+
+        bindBuffers(newArena, true);
+        if(!lastOuts.empty())
+            std::copy(lastOuts.begin(), lastOuts.end(), outs.back());
+
+        bufferMemory = MemoryArena {};
+        arena = std::move(newArena);
+    }
+
+    /** Runs the execution plan for a chunk of up to `maxBlockSize` frames. */
+    RTNEURAL_REALTIME inline void forwardPlanBlock(const T* chunkIn, T* chunkOut, int chunkSize) noexcept
+    {
+        const auto* ops = plan.data();
+        const auto lastOp = plan.size() - 1;
+        if(lastOp == 0)
+        {
+            ops[0].forwardBlock(ops[0].layer, chunkIn, chunkOut, chunkSize);
+            return;
+        }
+
+        ops[0].forwardBlock(ops[0].layer, chunkIn, ops[0].blockOut, chunkSize);
+        for(size_t i = 1; i < lastOp; ++i)
+            ops[i].forwardBlock(ops[i].layer, ops[i].blockIn, ops[i].blockOut, chunkSize);
+        ops[lastOp].forwardBlock(ops[lastOp].layer, ops[lastOp].blockIn, chunkOut, chunkSize);
+    }
 
     const int in_size;
-    std::vector<vec_type> outs;
+    std::vector<T*> outs;
+
+    int maxBlockSize = 64;
+    std::vector<T*> blockOuts;
+
+    bool reuseBuffers = false;
+    MemoryArena bufferMemory;
+    MemoryArena arena;
+
+    std::vector<PlanOp<T>> plan;
 };
 
 } // namespace RTNEURAL_NAMESPACE
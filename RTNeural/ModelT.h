@@ -1,6 +1,13 @@
 #pragma once
 
 #include "model_loader.h"
+#include "multi_instance/activation_multi.h"
+#include "multi_instance/conv1d_multi.h"
+#include "multi_instance/dense_multi.h"
+#include "multi_instance/gru_multi.h"
+#include "multi_instance/lstm_multi.h"
+#include "quantized/gru_fixed.h"
+#include "quantized/lstm_fixed.h"
 
 namespace RTNEURAL_NAMESPACE
 {
@@ -71,14 +78,340 @@ namespace modelt_detail
         static void call(T&) { }
     };
 
+    template <typename...>
+    struct make_void
+    {
+        using type = void;
+    };
+
+    template <typename... Ts>
+    using void_t = typename make_void<Ts...>::type;
+
+    constexpr int max_value(int a) { return a; }
+
+    template <typename... Ints>
+    constexpr int max_value(int a, int b, Ints... rest)
+    {
+        return max_value(a > b ? a : b, rest...);
+    }
+
+    constexpr bool all_true() { return true; }
+
+    template <typename... Bools>
+    constexpr bool all_true(bool a, Bools... rest)
+    {
+        return a && all_true(rest...);
+    }
+
+    /**
+     * Data type and frame stride used for the intermediate buffers of block
+     * processing. Each frame is stored in the same layout that the layers
+     * use for their `outs` member.
+     */
+#if RTNEURAL_USE_XSIMD
+    template <typename T>
+    using block_frame_type = xsimd::simd_type<T>;
+
+    template <typename T>
+    constexpr int block_frame_stride(int size)
+    {
+        return ceil_div(size, (int)xsimd::simd_type<T>::size);
+    }
+#else
+    template <typename T>
+    using block_frame_type = T;
+
+    template <typename T>
+    constexpr int block_frame_stride(int size)
+    {
+        return size;
+    }
+#endif
+
+    /** Checks whether a layer can process a whole block of frames at once. */
+    template <typename LayerType, typename FrameType, typename = void>
+    struct has_forward_block : std::false_type
+    {
+    };
+
+    template <typename LayerType, typename FrameType>
+    struct has_forward_block<LayerType, FrameType,
+        void_t<decltype(std::declval<LayerType&>().forwardBlock(std::declval<const FrameType*>(), std::declval<FrameType*>(), 0))>>
+        : std::true_type
+    {
+    };
+
+    /** Checks whether a layer has internal state which can be saved and restored. */
+    template <typename T, typename LayerType, typename = void>
+    struct has_state : std::false_type
+    {
+    };
+
+    template <typename T, typename LayerType>
+    struct has_state<T, LayerType,
+        void_t<decltype(std::declval<const LayerType&>().saveState(std::declval<T*>()))>>
+        : std::true_type
+    {
+    };
+
+    /** The scalar type stored in a layer's `outs` member. */
+#if RTNEURAL_USE_EIGEN
+    template <typename LayerType>
+    using layer_outs_scalar_t = typename std::remove_reference_t<decltype(std::declval<LayerType&>().outs)>::Scalar;
+#elif RTNEURAL_USE_XSIMD
+    template <typename LayerType>
+    using layer_outs_scalar_t = typename std::remove_extent_t<decltype(LayerType::outs)>::value_type;
+#else
+    template <typename LayerType>
+    using layer_outs_scalar_t = std::enable_if_t<std::is_arithmetic<std::remove_extent_t<decltype(LayerType::outs)>>::value,
+        std::remove_extent_t<decltype(LayerType::outs)>>;
+#endif
+
+    /**
+     * The scalar type that a layer computes with. This is deduced from the
+     * layer's `outs` member, and falls back to `T` for layers where it can't
+     * be deduced (e.g. the multi-instance layers).
+     */
+    template <typename T, typename LayerType, typename = void>
+    struct layer_scalar
+    {
+        using type = T;
+    };
+
+    template <typename T, typename LayerType>
+    struct layer_scalar<T, LayerType, void_t<layer_outs_scalar_t<LayerType>>>
+    {
+        using type = layer_outs_scalar_t<LayerType>;
+    };
+
+    template <typename T, typename LayerType>
+    using layer_scalar_t = typename layer_scalar<T, LayerType>::type;
+
+    /** Checks whether any of the layers computes with a scalar type other than `T`. */
+    template <typename T, typename... Layers>
+    struct is_mixed_precision : std::integral_constant<bool, !all_true(std::is_same<layer_scalar_t<T, Layers>, T>::value...)>
+    {
+    };
+
     template <typename T, typename LayerType>
-    void loadLayer(LayerType&, int&, const nlohmann::json&, const std::string&, int, bool debug)
+    size_t get_state_size(const LayerType& layer, std::true_type) noexcept { return layer.getStateSize(); }
+
+    template <typename T, typename LayerType>
+    size_t get_state_size(const LayerType&, std::false_type) noexcept { return 0; }
+
+    template <typename T, typename LayerType>
+    void save_state(const LayerType& layer, T* state, std::true_type) noexcept { layer.saveState(state); }
+
+    template <typename T, typename LayerType>
+    void save_state(const LayerType&, T*, std::false_type) noexcept { }
+
+    template <typename T, typename LayerType>
+    void load_state(LayerType& layer, const T* state, std::true_type) noexcept { layer.loadState(state); }
+
+    template <typename T, typename LayerType>
+    void load_state(LayerType&, const T*, std::false_type) noexcept { }
+
+    /** Returns the state size of a layer, which may use a different scalar type to `T`. */
+    template <typename T, typename LayerType>
+    size_t get_layer_state_size(const LayerType& layer) noexcept
+    {
+        using S = layer_scalar_t<T, LayerType>;
+        return get_state_size<S>(layer, has_state<S, LayerType> {});
+    }
+
+    /** Returns the number of bytes needed to convert the state of a layer to the scalar type `T`. */
+    template <typename T, typename LayerType>
+    size_t get_state_conversion_bytes(const LayerType& layer) noexcept
+    {
+        using S = layer_scalar_t<T, LayerType>;
+        return std::is_same<S, T>::value ? 0 : get_layer_state_size<T>(layer) * sizeof(S);
+    }
+
+    /** Saves the state of a layer that uses the scalar type `T`. */
+    template <typename T, typename LayerType>
+    void save_layer_state(const LayerType& layer, T* state, unsigned char*, std::true_type) noexcept
+    {
+        save_state<T>(layer, state, has_state<T, LayerType> {});
+    }
+
+    /**
+     * Saves the state of a layer that uses a different scalar type, converting it through
+     * `scratch`, which must hold at least `get_state_conversion_bytes<T>(layer)` bytes.
+     */
+    template <typename T, typename LayerType>
+    void save_layer_state(const LayerType& layer, T* state, unsigned char* scratch, std::false_type) noexcept
+    {
+        using S = layer_scalar_t<T, LayerType>;
+        auto* layer_state = reinterpret_cast<S*>(scratch);
+        save_state<S>(layer, layer_state, has_state<S, LayerType> {});
+        std::copy(layer_state, layer_state + get_layer_state_size<T>(layer), state);
+    }
+
+    /** Restores the state of a layer that uses the scalar type `T`. */
+    template <typename T, typename LayerType>
+    void load_layer_state(LayerType& layer, const T* state, unsigned char*, std::true_type) noexcept
+    {
+        load_state<T>(layer, state, has_state<T, LayerType> {});
+    }
+
+    /**
+     * Restores the state of a layer that uses a different scalar type, converting it through
+     * `scratch`, which must hold at least `get_state_conversion_bytes<T>(layer)` bytes.
+     */
+    template <typename T, typename LayerType>
+    void load_layer_state(LayerType& layer, const T* state, unsigned char* scratch, std::false_type) noexcept
+    {
+        using S = layer_scalar_t<T, LayerType>;
+        auto* layer_state = reinterpret_cast<S*>(scratch);
+        std::copy(state, state + get_layer_state_size<T>(layer), layer_state);
+        load_state<S>(layer, layer_state, has_state<S, LayerType> {});
+    }
+
+    /** Passes the output of one layer to the next layer, when both layers use the same scalar type. */
+    template <typename T, typename PrevLayer, typename NextLayer>
+    void forward_layer(const PrevLayer& prev, NextLayer& next, std::true_type)
+    {
+        next.forward(prev.outs);
+    }
+
+    /**
+     * Passes the output of one layer to the next layer, converting it to
+     * the scalar type of the next layer.
+     */
+    template <typename T, typename PrevLayer, typename NextLayer>
+    void forward_layer(const PrevLayer& prev, NextLayer& next, std::false_type)
+    {
+        using NextT = layer_scalar_t<T, NextLayer>;
+
+#if RTNEURAL_USE_EIGEN
+        constexpr auto size = (int)std::remove_reference_t<decltype(prev.outs)>::RowsAtCompileTime;
+        const Eigen::Matrix<NextT, size, 1> ins = prev.outs.template cast<NextT>();
+        next.forward(ins);
+#elif RTNEURAL_USE_XSIMD
+        using PrevT = layer_scalar_t<T, PrevLayer>;
+        using next_v_type = xsimd::simd_type<NextT>;
+        constexpr auto size = PrevLayer::out_size;
+        constexpr auto prev_v_size = (int)xsimd::simd_type<PrevT>::size;
+        constexpr auto next_v_size = (int)next_v_type::size;
+        constexpr auto prev_v_count = ceil_div(size, prev_v_size);
+        constexpr auto next_v_count = ceil_div(size, next_v_size);
+
+        PrevT prev_arr alignas(RTNEURAL_DEFAULT_ALIGNMENT)[prev_v_count * prev_v_size];
+        NextT next_arr alignas(RTNEURAL_DEFAULT_ALIGNMENT)[next_v_count * next_v_size] {};
+        for(int i = 0; i < prev_v_count; ++i)
+            xsimd::store_aligned(prev_arr + i * prev_v_size, prev.outs[i]);
+        std::copy(prev_arr, prev_arr + size, next_arr);
+
+        // single values are broadcast, the same way as the model input
+        next_v_type ins[next_v_count];
+        for(int i = 0; i < next_v_count; ++i)
+            ins[i] = size == 1 ? next_v_type(next_arr[0]) : xsimd::load_aligned(next_arr + i * next_v_size);
+        next.forward(ins);
+#else
+        constexpr auto size = (int)std::extent<decltype(PrevLayer::outs)>::value;
+        NextT ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
+        std::copy(std::begin(prev.outs), std::end(prev.outs), ins);
+        next.forward(ins);
+#endif
+    }
+
+    // unrolled loop for forward inferencing, with conversions between layers of different scalar types
+    template <size_t idx, size_t Niter>
+    struct forward_convert_unroll
+    {
+        template <typename T, typename LayersTuple>
+        static void call(LayersTuple& t)
+        {
+            using PrevLayer = std::remove_reference_t<decltype(std::get<idx - 1>(t))>;
+            using NextLayer = std::remove_reference_t<decltype(std::get<idx>(t))>;
+            forward_layer<T>(std::get<idx - 1>(t), std::get<idx>(t),
+                std::is_same<layer_scalar_t<T, PrevLayer>, layer_scalar_t<T, NextLayer>> {});
+            forward_convert_unroll<idx + 1, Niter - 1>::template call<T>(t);
+        }
+    };
+
+    template <size_t idx>
+    struct forward_convert_unroll<idx, 0>
+    {
+        template <typename T, typename LayersTuple>
+        static void call(LayersTuple&) { }
+    };
+
+    /** Processes a block of frames with a layer that supports block processing. */
+    template <typename T, int in_stride, typename LayerType>
+    void forward_layer_block(LayerType& layer, const block_frame_type<T>* ins, block_frame_type<T>* outs, int numFrames, std::true_type)
+    {
+        layer.forwardBlock(ins, outs, numFrames);
+    }
+
+    /**
+     * The number of block frame elements needed to store a layer's output.
+     * This is deduced from the layer's `outs` member, so that custom layers
+     * don't need to provide an `out_size`.
+     */
+#if RTNEURAL_USE_EIGEN
+    template <typename LayerType>
+    struct layer_out_stride
+        : std::integral_constant<int, (int)std::remove_reference_t<decltype(std::declval<LayerType&>().outs)>::RowsAtCompileTime>
+    {
+    };
+#else
+    template <typename LayerType>
+    struct layer_out_stride
+        : std::integral_constant<int, (int)std::extent<decltype(LayerType::outs)>::value>
+    {
+    };
+#endif
+
+    /** Processes a block of frames by stepping the layer one frame at a time. */
+    template <typename T, int in_stride, typename LayerType>
+    void forward_layer_block(LayerType& layer, const block_frame_type<T>* ins, block_frame_type<T>* outs, int numFrames, std::false_type)
+    {
+        constexpr auto out_stride = layer_out_stride<LayerType>::value;
+
+        for(int n = 0; n < numFrames; ++n)
+        {
+#if RTNEURAL_USE_EIGEN
+            layer.forward(Eigen::Map<const Eigen::Matrix<T, in_stride, 1>>(ins + n * in_stride));
+            Eigen::Map<Eigen::Matrix<T, out_stride, 1>>(outs + n * out_stride) = layer.outs;
+#else
+            using in_frame_type = block_frame_type<T>[in_stride];
+            layer.forward(reinterpret_cast<const in_frame_type&>(ins[n * in_stride]));
+            std::copy(std::begin(layer.outs), std::begin(layer.outs) + out_stride, outs + n * out_stride);
+#endif
+        }
+    }
+
+    // unrolled loop for layer-major block processing
+    template <size_t idx, size_t Niter>
+    struct forward_block_unroll
+    {
+        template <typename T, int in_stride, typename LayersTuple>
+        static void call(LayersTuple& layers, const block_frame_type<T>* ins, block_frame_type<T>* outs, block_frame_type<T>* scratch, int numFrames)
+        {
+            using LayerType = std::remove_reference_t<decltype(std::get<idx>(layers))>;
+            forward_layer_block<T, in_stride>(std::get<idx>(layers), ins, outs, numFrames, has_forward_block<LayerType, block_frame_type<T>> {});
+            forward_block_unroll<idx + 1, Niter - 1>::template call<T, layer_out_stride<LayerType>::value>(layers, outs, scratch, outs, numFrames);
+        }
+    };
+
+    template <size_t idx>
+    struct forward_block_unroll<idx, 0>
+    {
+        template <typename T, int in_stride, typename LayersTuple>
+        static void call(LayersTuple&, const block_frame_type<T>*, block_frame_type<T>*, block_frame_type<T>*, int) { }
+    };
+
+    template <typename T, typename LayerType>
+    bool loadLayer(LayerType&, int&, const nlohmann::json&, const std::string&, int, bool debug)
     {
         json_parser::debug_print("Loading a no-op layer!", debug);
+        return true;
     }
 
-    template <typename T, int in_size, int out_size>
-    void loadLayer(DenseT<T, in_size, out_size>& dense, int& json_stream_idx, const nlohmann::json& l,
+    /** Loads a DenseT (or DenseInt8T, DenseHalfT, DenseSparseT, DenseMultiT) layer. */
+    template <typename T, typename DenseType>
+    bool loadDenseLayer(DenseType& dense, int& json_stream_idx, const nlohmann::json& l,
         const std::string& type, int layerDims, bool debug)
     {
         using namespace json_parser;
@@ -87,7 +420,8 @@ namespace modelt_detail
         debug_print("  Dims: " + std::to_string(layerDims), debug);
         const auto& weights = l["weights"];
 
-        if(checkDense<T>(dense, type, layerDims, debug))
+        const auto matched = checkDense<T>(dense, type, layerDims, debug);
+        if(matched)
             loadDense<T>(dense, weights);
 
         if(!l.contains("activation"))
@@ -100,10 +434,62 @@ namespace modelt_detail
             if(activationType.empty())
                 json_stream_idx++;
         }
+
+        return matched;
     }
 
-    template <typename T, int in_size, int out_size, int kernel_size, int dilation_rate, int groups, bool dynamic_state>
-    void loadLayer(Conv1DT<T, in_size, out_size, kernel_size, dilation_rate, groups, dynamic_state>& conv, int& json_stream_idx, const nlohmann::json& l,
+    template <typename T, int in_size, int out_size>
+    bool loadLayer(DenseT<T, in_size, out_size>& dense, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadDenseLayer<T>(dense, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size>
+    bool loadLayer(DenseInt8T<T, in_size, out_size>& dense, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        json_parser::loadInputRange<T>(dense, l);
+        return loadDenseLayer<T>(dense, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size, typename WeightType>
+    bool loadLayer(DenseHalfT<T, in_size, out_size, WeightType>& dense, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadDenseLayer<T>(dense, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size>
+    bool loadLayer(DenseSparseT<T, in_size, out_size>& dense, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadDenseLayer<T>(dense, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size, int max_rank>
+    bool loadLayer(DenseLowRankT<T, in_size, out_size, max_rank>& dense, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+
+        dense.setTolerance(l.value("low_rank_tolerance", dense.getTolerance()));
+        const auto matched = checkDense<T>(dense, type, layerDims, debug);
+        if(matched)
+            loadDenseLowRank<T>(dense, l["weights"]);
+
+        if(!l.contains("activation") || l["activation"].get<std::string>().empty())
+            json_stream_idx++;
+
+        return matched;
+    }
+
+    /** Loads a Conv1DT (or Conv1DInt8T, Conv1DHalfT, Conv1DMultiT) layer. */
+    template <typename T, typename Conv1DType>
+    bool loadConv1DLayer(Conv1DType& conv, int& json_stream_idx, const nlohmann::json& l,
         const std::string& type, int layerDims, bool debug)
     {
         using namespace json_parser;
@@ -111,11 +497,15 @@ namespace modelt_detail
         debug_print("Layer: " + type, debug);
         debug_print("  Dims: " + std::to_string(layerDims), debug);
         const auto& l_weights = l["weights"];
-        const auto l_kernel = l["kernel_size"].back().get<int>();
-        const auto l_dilation = l["dilation"].back().get<int>();
+
+        // other layer types don't have these fields, and will fail the check below
+        const auto isConv1D = type == "conv1d";
+        const auto l_kernel = isConv1D ? l["kernel_size"].back().get<int>() : 0;
+        const auto l_dilation = isConv1D ? l["dilation"].back().get<int>() : 0;
         const auto l_groups = l.value("groups", 1);
 
-        if(checkConv1D<T>(conv, type, layerDims, l_kernel, l_dilation, l_groups, debug))
+        const auto matched = checkConv1D<T>(conv, type, layerDims, l_kernel, l_dilation, l_groups, debug);
+        if(matched)
             loadConv1D<T>(conv, l_kernel, l_dilation, l_weights);
 
         if(!l.contains("activation"))
@@ -128,10 +518,35 @@ namespace modelt_detail
             if(activationType.empty())
                 json_stream_idx++;
         }
+
+        return matched;
     }
+
+    template <typename T, int in_size, int out_size, int kernel_size, int dilation_rate, int groups, bool dynamic_state>
+    bool loadLayer(Conv1DT<T, in_size, out_size, kernel_size, dilation_rate, groups, dynamic_state>& conv, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadConv1DLayer<T>(conv, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size, int kernel_size, int dilation_rate, int groups>
+    bool loadLayer(Conv1DInt8T<T, in_size, out_size, kernel_size, dilation_rate, groups>& conv, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        json_parser::loadInputRange<T>(conv, l);
+        return loadConv1DLayer<T>(conv, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size, int kernel_size, int dilation_rate, int groups, typename WeightType>
+    bool loadLayer(Conv1DHalfT<T, in_size, out_size, kernel_size, dilation_rate, groups, WeightType>& conv, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadConv1DLayer<T>(conv, json_stream_idx, l, type, layerDims, debug);
+    }
+
     template <typename T, int num_filters_in_t, int num_filters_out_t, int num_features_in_t, int kernel_size_time_t,
         int kernel_size_feature_t, int dilation_rate_t, int stride_t, bool valid_pad_t>
-    void loadLayer(Conv2DT<T, num_filters_in_t, num_filters_out_t, num_features_in_t, kernel_size_time_t,
+    bool loadLayer(Conv2DT<T, num_filters_in_t, num_filters_out_t, num_features_in_t, kernel_size_time_t,
                        kernel_size_feature_t, dilation_rate_t, stride_t, valid_pad_t>& conv,
         int& json_stream_idx, const nlohmann::json& l,
         const std::string& type, int layerDims, bool debug)
@@ -141,14 +556,18 @@ namespace modelt_detail
         debug_print("Layer: " + type, debug);
         debug_print("  Dims: " + std::to_string(layerDims), debug);
         const auto& weights = l["weights"];
-        const auto kernel_time = l["kernel_size_time"].back().get<int>();
-        const auto kernel_feature = l["kernel_size_feature"].back().get<int>();
 
-        const auto dilation = l["dilation"].back().get<int>();
-        const auto strides = l["strides"].back().get<int>();
-        const bool valid_pad = l["padding"].get<std::string>() == "valid";
+        // other layer types don't have these fields, and will fail the check below
+        const auto isConv2D = type == "conv2d";
+        const auto kernel_time = isConv2D ? l["kernel_size_time"].back().get<int>() : 0;
+        const auto kernel_feature = isConv2D ? l["kernel_size_feature"].back().get<int>() : 0;
 
-        if(checkConv2D<T>(conv, type, layerDims, kernel_time, kernel_feature, dilation, strides, valid_pad, debug))
+        const auto dilation = isConv2D ? l["dilation"].back().get<int>() : 0;
+        const auto strides = isConv2D ? l["strides"].back().get<int>() : 0;
+        const bool valid_pad = isConv2D && l["padding"].get<std::string>() == "valid";
+
+        const auto matched = checkConv2D<T>(conv, type, layerDims, kernel_time, kernel_feature, dilation, strides, valid_pad, debug);
+        if(matched)
             loadConv2D<T>(conv, weights);
 
         if(!l.contains("activation"))
@@ -161,10 +580,13 @@ namespace modelt_detail
             if(activationType.empty())
                 json_stream_idx++;
         }
+
+        return matched;
     }
 
-    template <typename T, int in_size, int out_size, SampleRateCorrectionMode mode>
-    void loadLayer(GRULayerT<T, in_size, out_size, mode>& gru, int& json_stream_idx, const nlohmann::json& l,
+    /** Loads a GRULayerT (or GRULayerFixedT, GRULayerHalfT, GRULayerSparseT, GRULayerMultiT) layer. */
+    template <typename T, typename GRUType>
+    bool loadGRULayer(GRUType& gru, int& json_stream_idx, const nlohmann::json& l,
         const std::string& type, int layerDims, bool debug)
     {
         using namespace json_parser;
@@ -173,14 +595,46 @@ namespace modelt_detail
         debug_print("  Dims: " + std::to_string(layerDims), debug);
         const auto& weights = l["weights"];
 
-        if(checkGRU<T>(gru, type, layerDims, debug))
+        const auto matched = checkGRU<T>(gru, type, layerDims, debug);
+        if(matched)
             loadGRU<T>(gru, weights);
 
         json_stream_idx++;
+
+        return matched;
     }
 
-    template <typename T, int in_size, int out_size, SampleRateCorrectionMode mode>
-    void loadLayer(LSTMLayerT<T, in_size, out_size, mode>& lstm, int& json_stream_idx, const nlohmann::json& l,
+    template <typename T, int in_size, int out_size, SampleRateCorrectionMode mode, typename MathsProvider>
+    bool loadLayer(GRULayerT<T, in_size, out_size, mode, MathsProvider>& gru, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadGRULayer<T>(gru, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size, typename FixedPoint>
+    bool loadLayer(GRULayerFixedT<T, in_size, out_size, FixedPoint>& gru, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadGRULayer<T>(gru, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size, typename WeightType, typename MathsProvider>
+    bool loadLayer(GRULayerHalfT<T, in_size, out_size, WeightType, MathsProvider>& gru, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadGRULayer<T>(gru, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size, typename MathsProvider>
+    bool loadLayer(GRULayerSparseT<T, in_size, out_size, MathsProvider>& gru, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadGRULayer<T>(gru, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    /** Loads a LSTMLayerT (or LSTMLayerFixedT, LSTMLayerHalfT, LSTMLayerSparseT, LSTMLayerMultiT) layer. */
+    template <typename T, typename LSTMType>
+    bool loadLSTMLayer(LSTMType& lstm, int& json_stream_idx, const nlohmann::json& l,
         const std::string& type, int layerDims, bool debug)
     {
         using namespace json_parser;
@@ -189,14 +643,106 @@ namespace modelt_detail
         debug_print("  Dims: " + std::to_string(layerDims), debug);
         const auto& weights = l["weights"];
 
-        if(checkLSTM<T>(lstm, type, layerDims, debug))
+        const auto matched = checkLSTM<T>(lstm, type, layerDims, debug);
+        if(matched)
             loadLSTM<T>(lstm, weights);
 
         json_stream_idx++;
+
+        return matched;
+    }
+
+    template <typename T, int in_size, int out_size, SampleRateCorrectionMode mode, typename MathsProvider>
+    bool loadLayer(LSTMLayerT<T, in_size, out_size, mode, MathsProvider>& lstm, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadLSTMLayer<T>(lstm, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size, typename FixedPoint>
+    bool loadLayer(LSTMLayerFixedT<T, in_size, out_size, FixedPoint>& lstm, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadLSTMLayer<T>(lstm, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size, typename WeightType, typename MathsProvider>
+    bool loadLayer(LSTMLayerHalfT<T, in_size, out_size, WeightType, MathsProvider>& lstm, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadLSTMLayer<T>(lstm, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size, typename MathsProvider>
+    bool loadLayer(LSTMLayerSparseT<T, in_size, out_size, MathsProvider>& lstm, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadLSTMLayer<T>(lstm, json_stream_idx, l, type, layerDims, debug);
     }
 
     template <typename T, int size>
-    void loadLayer(PReLUActivationT<T, size>& prelu, int& json_stream_idx, const nlohmann::json& l,
+    bool loadLayer(PReLUActivationT<T, size>& prelu, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto& weights = l["weights"];
+
+        const auto matched = checkPReLU<T>(prelu, type, layerDims, debug);
+        if(matched)
+            loadPReLU<T>(prelu, weights);
+
+        json_stream_idx++;
+
+        return matched;
+    }
+
+    template <typename T, int in_size, typename MathsProvider>
+    bool loadLayer(GatedActivationT<T, in_size, MathsProvider>& gated, int& json_stream_idx, const nlohmann::json&,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+
+        json_stream_idx++;
+
+        return checkGatedActivation(gated, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size, int num_instances>
+    bool loadLayer(DenseMultiT<T, in_size, out_size, num_instances>& dense, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadDenseLayer<T>(dense, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size, int kernel_size, int dilation_rate, int num_instances, int groups>
+    bool loadLayer(Conv1DMultiT<T, in_size, out_size, kernel_size, dilation_rate, num_instances, groups>& conv, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadConv1DLayer<T>(conv, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size, int num_instances, typename MathsProvider>
+    bool loadLayer(GRULayerMultiT<T, in_size, out_size, num_instances, MathsProvider>& gru, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadGRULayer<T>(gru, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int in_size, int out_size, int num_instances, typename MathsProvider>
+    bool loadLayer(LSTMLayerMultiT<T, in_size, out_size, num_instances, MathsProvider>& lstm, int& json_stream_idx, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        return loadLSTMLayer<T>(lstm, json_stream_idx, l, type, layerDims, debug);
+    }
+
+    template <typename T, int size, int num_instances>
+    bool loadLayer(PReLUActivationMultiT<T, size, num_instances>& prelu, int& json_stream_idx, const nlohmann::json& l,
         const std::string& type, int layerDims, bool debug)
     {
         using namespace json_parser;
@@ -205,14 +751,17 @@ namespace modelt_detail
         debug_print("  Dims: " + std::to_string(layerDims), debug);
         const auto& weights = l["weights"];
 
-        if(checkPReLU<T>(prelu, type, layerDims, debug))
+        const auto matched = checkPReLU<T>(prelu, type, layerDims, debug);
+        if(matched)
             loadPReLU<T>(prelu, weights);
 
         json_stream_idx++;
+
+        return matched;
     }
 
     template <typename T, int size, bool affine>
-    void loadLayer(BatchNorm1DT<T, size, affine>& batch_norm, int& json_stream_idx, const nlohmann::json& l,
+    bool loadLayer(BatchNorm1DT<T, size, affine>& batch_norm, int& json_stream_idx, const nlohmann::json& l,
         const std::string& type, int layerDims, bool debug)
     {
         using namespace json_parser;
@@ -221,17 +770,20 @@ namespace modelt_detail
         debug_print("  Dims: " + std::to_string(layerDims), debug);
         const auto& weights = l["weights"];
 
-        if(checkBatchNorm<T>(batch_norm, type, layerDims, weights, debug))
+        const auto matched = checkBatchNorm<T>(batch_norm, type, layerDims, weights, debug);
+        if(matched)
         {
             loadBatchNorm<T>(batch_norm, weights);
             batch_norm.setEpsilon(l["epsilon"].get<float>());
         }
 
         json_stream_idx++;
+
+        return matched;
     }
 
     template <typename T, int num_filters, int num_features, bool affine>
-    void loadLayer(BatchNorm2DT<T, num_filters, num_features, affine>& batch_norm, int& json_stream_idx, const nlohmann::json& l,
+    bool loadLayer(BatchNorm2DT<T, num_filters, num_features, affine>& batch_norm, int& json_stream_idx, const nlohmann::json& l,
         const std::string& type, int layerDims, bool debug)
     {
         using namespace json_parser;
@@ -240,17 +792,28 @@ namespace modelt_detail
         debug_print("  Dims: " + std::to_string(layerDims), debug);
         const auto& weights = l["weights"];
 
-        if(checkBatchNorm2D<T>(batch_norm, type, layerDims, weights, debug))
+        const auto matched = checkBatchNorm2D<T>(batch_norm, type, layerDims, weights, debug);
+        if(matched)
         {
             loadBatchNorm<T>(batch_norm, weights);
             batch_norm.setEpsilon(l["epsilon"].get<float>());
         }
 
         json_stream_idx++;
+
+        return matched;
     }
 
+    /**
+     * Loads the layer weights from a json model, and returns true if
+     * the json layers exactly match the given layers.
+     *
+     * Loading stops at the first layer that doesn't match (either its
+     * input or output size, or its type), so that weights of the wrong
+     * size are never loaded into the following layers.
+     */
     template <typename T, int in_size, typename... Layers>
-    void parseJson(const nlohmann::json& parent, std::tuple<Layers...>& layers, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
+    bool parseJson(const nlohmann::json& parent, std::tuple<Layers...>& layers, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
     {
         using namespace json_parser;
 
@@ -258,7 +821,7 @@ namespace modelt_detail
         auto json_layers = parent["layers"];
 
         if(!shape.is_array() || !json_layers.is_array())
-            return;
+            return false;
 
         // If 4D: nDims is num_features * num_channels
         const int nDims = shape.size() == 4 ? shape[2].get<int>() * shape[3].get<int>() : shape.back().get<int>();
@@ -268,15 +831,21 @@ namespace modelt_detail
         if(nDims != in_size)
         {
             debug_print("Incorrect input size!", debug);
-            return;
+            return false;
         }
 
+        bool matched = true;
         int json_stream_idx = 0;
+        int prevDims = nDims;
         modelt_detail::forEachInTuple([&](auto& layer, size_t)
             {
+                if(!matched)
+                    return;
+
                 if(json_stream_idx >= (int)json_layers.size())
                 {
                     debug_print("Too many layers!", debug);
+                    matched = false;
                     return;
                 }
 
@@ -287,11 +856,23 @@ namespace modelt_detail
                 // If 4D: layerDims is num_features * num_channels
                 const int layerDims = layerShape.size() == 4 ? layerShape[2].get<int>() * layerShape[3].get<int>() : layerShape.back().get<int>();
 
+                // the input of each layer is the output of the json layer before it
+                using LayerType = std::decay_t<decltype(layer)>;
+                const int inDims = prevDims;
+                prevDims = layerDims;
+                if(LayerType::in_size != inDims)
+                {
+                    debug_print("Wrong layer input size! Expected: " + std::to_string(LayerType::in_size), debug);
+                    matched = false;
+                    return;
+                }
+
                 if(layer.isActivation()) // activation layers don't need initialisation
                 {
                     if(!l.contains("activation"))
                     {
                         debug_print("No activation layer expected!", debug);
+                        matched = false;
                         return;
                     }
 
@@ -299,7 +880,11 @@ namespace modelt_detail
                     if(!activationType.empty())
                     {
                         debug_print("  activation: " + activationType, debug);
-                        checkActivation(layer, activationType, layerDims, debug);
+                        matched &= checkActivation(layer, activationType, layerDims, debug);
+                    }
+                    else
+                    {
+                        matched = false;
                     }
 
                     json_stream_idx++;
@@ -313,8 +898,17 @@ namespace modelt_detail
                     return;
                 }
 
-                modelt_detail::loadLayer<T>(layer, json_stream_idx, l, type, layerDims, debug); },
+                // each layer loads its weights in its own scalar type
+                matched &= modelt_detail::loadLayer<modelt_detail::layer_scalar_t<T, LayerType>>(layer, json_stream_idx, l, type, layerDims, debug); },
             layers);
+
+        if(matched && json_stream_idx != (int)json_layers.size())
+        {
+            debug_print("Too few layers for the json model!", debug);
+            matched = false;
+        }
+
+        return matched;
     }
 } // namespace modelt_detail
 #endif // DOXYGEN
@@ -330,6 +924,19 @@ namespace modelt_detail
  *      DenseT<double, 8, 1>
  *  > model;
  *  ```
+ *
+ *  Each layer may use its own scalar type, e.g. to run the recurrent
+ *  layers in double precision, and the rest of the model in float:
+ *  ```
+ *  ModelT<float, 1, 1,
+ *      DenseT<float, 1, 8>,
+ *      LSTMLayerT<double, 8, 8>,
+ *      DenseT<float, 8, 1>
+ *  > model;
+ *  ```
+ *  The values are converted wherever the scalar type changes from one
+ *  layer to the next, and the model's input, output, and state use `T`.
+ *  Models with mixed scalar types process blocks one frame at a time.
  */
 template <typename T, int in_size, int out_size, typename... Layers>
 class ModelT
@@ -342,11 +949,12 @@ public:
     {
 #if RTNEURAL_USE_XSIMD
         for(int i = 0; i < v_in_size; ++i)
-            v_ins[i] = v_type((T)0);
+            v_ins[i] = v_type((in_scalar)0);
 #elif RTNEURAL_USE_EIGEN
-        auto& layer_outs = get<n_layers - 1>().outs;
-        new(&layer_outs) Eigen::Map<Eigen::Matrix<T, out_size, 1>, RTNeuralEigenAlignment>(outs);
+        bindOutputs(std::is_same<out_scalar, T> {});
 #endif
+
+        prepareStateConversion();
     }
 
     /** Get a reference to the layer at index `Index`. */
@@ -371,30 +979,102 @@ public:
             layers);
     }
 
+    /** Returns the number of values needed to store the state of the network layers. */
+    size_t getStateSize() const noexcept
+    {
+        size_t stateSize = 0;
+        modelt_detail::forEachInTuple([&](const auto& layer, size_t)
+            { stateSize += modelt_detail::get_layer_state_size<T>(layer); },
+            layers);
+
+        return stateSize;
+    }
+
+    /**
+     * Allocates the memory used to convert the state of layers with a
+     * different scalar type to the model's type. This is called by the
+     * constructor, and should be called again (not from the audio thread)
+     * if the state size of such a layer grows, e.g. with a longer sample
+     * rate correction delay. Until then, `saveState()` and `loadState()`
+     * return false.
+     */
+    void prepareStateConversion()
+    {
+        const auto scratchBytes = getStateConversionBytes();
+        if(state_scratch.size() < scratchBytes)
+            state_scratch.resize(scratchBytes);
+    }
+
+    /**
+     * Copies the state of the network layers into `state`, which must hold
+     * `getStateSize()` values. The state can be restored with `loadState()`,
+     * e.g. to start a voice from a pre-warmed state without running warm-up
+     * samples.
+     */
+    template <bool mixed = modelt_detail::is_mixed_precision<T, Layers...>::value>
+    RTNEURAL_REALTIME std::enable_if_t<!mixed, bool> saveState(T* state) const noexcept
+    {
+        saveLayerStates(state, nullptr);
+        return true;
+    }
+
+    /**
+     * Copies the state of the network layers into `state`, converting it
+     * to the model's type. Returns false, without writing any values, if
+     * the state of a layer has outgrown the memory allocated by
+     * `prepareStateConversion()`.
+     *
+     * The state is converted through memory owned by the model, so this
+     * is not const for models with mixed scalar types.
+     */
+    template <bool mixed = modelt_detail::is_mixed_precision<T, Layers...>::value>
+    RTNEURAL_REALTIME std::enable_if_t<mixed, bool> saveState(T* state) noexcept
+    {
+        if(getStateConversionBytes() > state_scratch.size())
+            return false;
+
+        saveLayerStates(state, state_scratch.data());
+        return true;
+    }
+
+    /**
+     * Restores the state of the network layers from values written by
+     * `saveState()`, on a model of the same type (with the same sample
+     * rate correction delays). For models with mixed scalar types, this
+     * returns false, without changing any layers, if the state of a layer
+     * has outgrown the memory allocated by `prepareStateConversion()`.
+     */
+    RTNEURAL_REALTIME bool loadState(const T* state) noexcept
+    {
+        if(getStateConversionBytes() > state_scratch.size())
+            return false;
+
+        modelt_detail::forEachInTuple([&](auto& layer, size_t)
+            {
+                using LayerType = std::decay_t<decltype(layer)>;
+                modelt_detail::load_layer_state<T>(layer, state, state_scratch.data(), std::is_same<modelt_detail::layer_scalar_t<T, LayerType>, T> {});
+                state += modelt_detail::get_layer_state_size<T>(layer);
+            },
+            layers);
+        return true;
+    }
+
     /** Performs forward propagation for this model. */
     template <int N = in_size>
     RTNEURAL_REALTIME inline typename std::enable_if<(N > 1), T>::type
     forward(const T* input)
     {
 #if RTNEURAL_USE_XSIMD
-        for(int i = 0; i < v_in_size; ++i)
-            v_ins[i] = xsimd::load_aligned(input + i * v_size);
+        loadInputs(input, std::is_same<in_scalar, T> {});
 #elif RTNEURAL_USE_EIGEN
-        auto v_ins = Eigen::Map<const vec_type, RTNeuralEigenAlignment>(input);
+        auto v_ins = Eigen::Map<const Eigen::Matrix<T, in_size, 1>, RTNeuralEigenAlignment>(input).template cast<in_scalar>();
 #else // RTNEURAL_USE_STL
         std::copy(input, input + in_size, v_ins);
 #endif
         std::get<0>(layers).forward(v_ins);
-        modelt_detail::forward_unroll<1, n_layers - 1>::call(layers);
+        modelt_detail::forward_convert_unroll<1, n_layers - 1>::template call<T>(layers);
 
-#if RTNEURAL_USE_XSIMD
-        for(int i = 0; i < v_out_size; ++i)
-            xsimd::store_aligned(outs + i * v_size, get<n_layers - 1>().outs[i]);
-#elif RTNEURAL_USE_EIGEN
-#else // RTNEURAL_USE_STL
-        auto& layer_outs = get<n_layers - 1>().outs;
-        std::copy(layer_outs, layer_outs + out_size, outs);
-#endif
+        storeOutputs(std::is_same<out_scalar, T> {});
         return outs[0];
     }
 
@@ -404,41 +1084,60 @@ public:
     forward(const T* input)
     {
 #if RTNEURAL_USE_XSIMD
-        v_ins[0] = (v_type)input[0];
+        v_ins[0] = (v_type)(in_scalar)input[0];
 #elif RTNEURAL_USE_EIGEN
-        const auto v_ins = vec_type::Constant(input[0]);
+        const auto v_ins = vec_type::Constant((in_scalar)input[0]);
 #else // RTNEURAL_USE_STL
-        v_ins[0] = input[0];
+        v_ins[0] = (in_scalar)input[0];
 #endif
 
         std::get<0>(layers).forward(v_ins);
-        modelt_detail::forward_unroll<1, n_layers - 1>::call(layers);
+        modelt_detail::forward_convert_unroll<1, n_layers - 1>::template call<T>(layers);
 
-#if RTNEURAL_USE_XSIMD
-        for(int i = 0; i < v_out_size; ++i)
-            xsimd::store_aligned(outs + i * v_size, get<n_layers - 1>().outs[i]);
-#elif RTNEURAL_USE_EIGEN
-#else // RTNEURAL_USE_STL
-        auto& layer_outs = get<n_layers - 1>().outs;
-        std::copy(layer_outs, layer_outs + out_size, outs);
-#endif
+        storeOutputs(std::is_same<out_scalar, T> {});
         return outs[0];
     }
 
+    /**
+     * Performs forward propagation for a block of frames.
+     *
+     * The frames are stored contiguously, so frame `n` of the input starts
+     * at `input + n * in_size`, and frame `n` of the output starts at
+     * `output + n * out_size`.
+     *
+     * The block is processed one layer at a time. Layers that provide a
+     * `forwardBlock()` method (dense layers, most activations, batch-norm)
+     * process all of the frames at once, which turns the matrix-vector
+     * products of the dense layers into matrix-matrix products. Other layers
+     * are stepped one frame at a time. Blocks longer than
+     * `RTNEURAL_MODELT_BLOCK_SIZE` are processed in chunks. Models with
+     * mixed scalar types are processed one frame at a time.
+     */
+    RTNEURAL_REALTIME inline void processBlock(const T* input, T* output, int numFrames)
+    {
+        processBlock(input, output, numFrames, std::integral_constant<bool, is_mixed> {});
+    }
+
     /** Returns a pointer to the output of the final layer in the network. */
     RTNEURAL_REALTIME inline const T* getOutputs() const noexcept
     {
         return outs;
     }
 
-    /** Loads neural network model weights from a json stream. */
-    void parseJson(const nlohmann::json& parent, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
+    /**
+     * Loads neural network model weights from a json stream.
+     * Returns true if the json layers exactly match the model's layers.
+     */
+    bool parseJson(const nlohmann::json& parent, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
     {
-        modelt_detail::parseJson<T, in_size>(parent, layers, debug, custom_layers);
+        return modelt_detail::parseJson<T, in_size>(parent, layers, debug, custom_layers);
     }
 
-    /** Loads neural network model weights from a json stream. */
-    void parseJson(std::ifstream& jsonStream, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
+    /**
+     * Loads neural network model weights from a json stream.
+     * Returns true if the json layers exactly match the model's layers.
+     */
+    bool parseJson(std::ifstream& jsonStream, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
     {
         nlohmann::json parent;
         jsonStream >> parent;
@@ -446,26 +1145,196 @@ public:
     }
 
 private:
+    /** Processes a block of frames in chunks, one layer at a time. */
+    RTNEURAL_REALTIME inline void processBlock(const T* input, T* output, int numFrames, std::false_type)
+    {
+        for(int offset = 0; offset < numFrames; offset += block_size)
+        {
+            const auto chunkSize = std::min((int)block_size, numFrames - offset);
+            processChunk(input + offset * in_size, output + offset * out_size, chunkSize);
+        }
+
+        // keep getOutputs() consistent with the single-frame API
+        if(numFrames > 0)
+            std::copy(output + (numFrames - 1) * out_size, output + numFrames * out_size, outs);
+    }
+
+    /** Processes a block of frames one frame at a time, for models with mixed scalar types. */
+    RTNEURAL_REALTIME inline void processBlock(const T* input, T* output, int numFrames, std::true_type)
+    {
+        for(int n = 0; n < numFrames; ++n)
+        {
+            forward(input + n * in_size);
+            std::copy(outs, outs + out_size, output + n * out_size);
+        }
+    }
+
 #if RTNEURAL_USE_XSIMD
-    using v_type = xsimd::simd_type<T>;
+    /** Loads the model input into the input registers of the first layer. */
+    RTNEURAL_REALTIME inline void loadInputs(const T* input, std::true_type) noexcept
+    {
+        for(int i = 0; i < v_in_size; ++i)
+            v_ins[i] = xsimd::load_aligned(input + i * v_size);
+    }
+
+    /** Loads the model input into the input registers of the first layer, converting it to the layer's scalar type. */
+    RTNEURAL_REALTIME inline void loadInputs(const T* input, std::false_type) noexcept
+    {
+        in_scalar load_arr alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_in_size * v_size] {};
+        std::copy(input, input + in_size, load_arr);
+        for(int i = 0; i < v_in_size; ++i)
+            v_ins[i] = xsimd::load_aligned(load_arr + i * v_size);
+    }
+#elif RTNEURAL_USE_EIGEN
+    /** Points the outputs of the final layer at the model outputs. */
+    void bindOutputs(std::true_type) noexcept
+    {
+        auto& layer_outs = get<n_layers - 1>().outs;
+        new(&layer_outs) Eigen::Map<Eigen::Matrix<T, out_size, 1>, RTNeuralEigenAlignment>(outs);
+    }
+
+    /** The final layer uses a different scalar type, so it keeps its own outputs. */
+    void bindOutputs(std::false_type) noexcept { }
+#endif
+
+    /** Copies the outputs of the final layer into the model outputs. */
+    RTNEURAL_REALTIME inline void storeOutputs(std::true_type) noexcept
+    {
+#if RTNEURAL_USE_XSIMD
+        constexpr auto out_v_size = (int)xsimd::simd_type<T>::size;
+        for(int i = 0; i < v_out_size; ++i)
+            xsimd::store_aligned(outs + i * out_v_size, get<n_layers - 1>().outs[i]);
+#elif RTNEURAL_USE_EIGEN
+        // the final layer writes directly into the model outputs
+#else // RTNEURAL_USE_STL
+        auto& layer_outs = get<n_layers - 1>().outs;
+        std::copy(layer_outs, layer_outs + out_size, outs);
+#endif
+    }
+
+    /** Copies the outputs of the final layer into the model outputs, converting them to `T`. */
+    RTNEURAL_REALTIME inline void storeOutputs(std::false_type) noexcept
+    {
+#if RTNEURAL_USE_XSIMD
+        using layer_v_type = xsimd::simd_type<out_scalar>;
+        constexpr auto layer_v_size = (int)layer_v_type::size;
+        constexpr auto layer_v_out_size = ceil_div(out_size, layer_v_size);
+
+        out_scalar store_arr alignas(RTNEURAL_DEFAULT_ALIGNMENT)[layer_v_out_size * layer_v_size];
+        for(int i = 0; i < layer_v_out_size; ++i)
+            xsimd::store_aligned(store_arr + i * layer_v_size, get<n_layers - 1>().outs[i]);
+        std::copy(store_arr, store_arr + out_size, outs);
+#elif RTNEURAL_USE_EIGEN
+        auto model_outs = Eigen::Map<Eigen::Matrix<T, out_size, 1>, RTNeuralEigenAlignment>(outs);
+        model_outs = get<n_layers - 1>().outs.template cast<T>();
+#else // RTNEURAL_USE_STL
+        auto& layer_outs = get<n_layers - 1>().outs;
+        std::copy(layer_outs, layer_outs + out_size, outs);
+#endif
+    }
+
+    /** Processes a block of at most `block_size` frames. */
+    RTNEURAL_REALTIME inline void processChunk(const T* input, T* output, int numFrames)
+    {
+        auto* block_outs = block_buffers[(n_layers - 1) % 2];
+
+#if RTNEURAL_USE_XSIMD
+        // pack the input frames into SIMD registers, the same way as forward()
+        auto* block_ins = block_buffers[1];
+        T load_arr alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_in_size * v_size] {};
+        for(int n = 0; n < numFrames; ++n)
+        {
+            if(in_size == 1)
+            {
+                block_ins[n] = (v_type)input[n];
+                continue;
+            }
+
+            std::copy(input + n * in_size, input + (n + 1) * in_size, load_arr);
+            for(int i = 0; i < v_in_size; ++i)
+                block_ins[n * v_in_size + i] = xsimd::load_aligned(load_arr + i * v_size);
+        }
+
+        modelt_detail::forward_block_unroll<0, n_layers>::template call<T, v_in_size>(layers, block_ins, block_buffers[0], block_buffers[1], numFrames);
+
+        for(int n = 0; n < numFrames; ++n)
+        {
+            for(int i = 0; i < v_out_size; ++i)
+                xsimd::store_aligned(outs + i * v_size, block_outs[n * v_out_size + i]);
+            std::copy(outs, outs + out_size, output + n * out_size);
+        }
+#else
+        modelt_detail::forward_block_unroll<0, n_layers>::template call<T, in_size>(layers, input, block_buffers[0], block_buffers[1], numFrames);
+        std::copy(block_outs, block_outs + numFrames * out_size, output);
+#endif
+    }
+
+    std::tuple<Layers...> layers;
+    static constexpr size_t n_layers = sizeof...(Layers);
+
+    /** The scalar types used by the first and last layers. */
+    using in_scalar = modelt_detail::layer_scalar_t<T, std::tuple_element_t<0, std::tuple<Layers...>>>;
+    using out_scalar = modelt_detail::layer_scalar_t<T, std::tuple_element_t<n_layers - 1, std::tuple<Layers...>>>;
+    static constexpr bool is_mixed = modelt_detail::is_mixed_precision<T, Layers...>::value;
+
+#if RTNEURAL_USE_XSIMD
+    using v_type = xsimd::simd_type<in_scalar>;
     static constexpr auto v_size = (int)v_type::size;
     static constexpr auto v_in_size = ceil_div(in_size, v_size);
-    static constexpr auto v_out_size = ceil_div(out_size, v_size);
+    static constexpr auto v_out_size = ceil_div(out_size, (int)xsimd::simd_type<T>::size);
     v_type v_ins[v_in_size];
 #elif RTNEURAL_USE_EIGEN
-    using vec_type = Eigen::Matrix<T, in_size, 1>;
+    using vec_type = Eigen::Matrix<in_scalar, in_size, 1>;
 #else // RTNEURAL_USE_STL
-    T v_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+    in_scalar v_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
 #endif
 
 #if RTNEURAL_USE_XSIMD
-    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_out_size * v_size];
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_out_size * (int)xsimd::simd_type<T>::size];
 #else
     T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
 #endif
 
-    std::tuple<Layers...> layers;
-    static constexpr size_t n_layers = sizeof...(Layers);
+    static constexpr int block_size = RTNEURAL_MODELT_BLOCK_SIZE;
+    static constexpr int block_stride = modelt_detail::max_value(modelt_detail::block_frame_stride<T>(in_size),
+        modelt_detail::layer_out_stride<Layers>::value...);
+
+
+    /**
+     * The intermediate buffers for block processing, sized from the widest layer
+     * so that constructing the model doesn't allocate. Mixed-precision models
+     * process blocks one frame at a time, so they don't need these.
+     */
+    static constexpr int block_buffer_size = is_mixed ? 1 : block_size * block_stride;
+#if RTNEURAL_USE_XSIMD
+    v_type block_buffers[2][block_buffer_size];
+#else
+    T block_buffers alignas(RTNEURAL_DEFAULT_ALIGNMENT)[2][block_buffer_size];
+#endif
+
+    /** Returns the number of bytes needed to convert the state of the largest layer with a different scalar type. */
+    size_t getStateConversionBytes() const noexcept
+    {
+        size_t scratchBytes = 0;
+        modelt_detail::forEachInTuple([&](const auto& layer, size_t)
+            { scratchBytes = std::max(scratchBytes, modelt_detail::get_state_conversion_bytes<T>(layer)); },
+            layers);
+        return scratchBytes;
+    }
+
+    void saveLayerStates(T* state, unsigned char* scratch) const noexcept
+    {
+        modelt_detail::forEachInTuple([&](const auto& layer, size_t)
+            {
+                using LayerType = std::decay_t<decltype(layer)>;
+                modelt_detail::save_layer_state<T>(layer, state, scratch, std::is_same<modelt_detail::layer_scalar_t<T, LayerType>, T> {});
+                state += modelt_detail::get_layer_state_size<T>(layer);
+            },
+            layers);
+    }
+
+    /** Memory for converting the state of layers with a different scalar type (only used by non-const methods). */
+    std::vector<unsigned char> state_scratch;
 };
 
 #if RTNEURAL_USE_EIGEN || !RTNEURAL_USE_XSIMD
@@ -523,6 +1392,52 @@ public:
             layers);
     }
 
+    /** Returns the number of values needed to store the state of the network layers. */
+    size_t getStateSize() const noexcept
+    {
+        size_t stateSize = 0;
+        modelt_detail::forEachInTuple([&](const auto& layer, size_t)
+            {
+                using LayerType = std::decay_t<decltype(layer)>;
+                stateSize += modelt_detail::get_state_size<T>(layer, modelt_detail::has_state<T, LayerType> {});
+            },
+            layers);
+        return stateSize;
+    }
+
+    /**
+     * Copies the state of the network layers into `state`, which must hold
+     * `getStateSize()` values. The state can be restored with `loadState()`,
+     * e.g. to start a voice from a pre-warmed state without running warm-up
+     * samples.
+     */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept
+    {
+        modelt_detail::forEachInTuple([&](const auto& layer, size_t)
+            {
+                using LayerType = std::decay_t<decltype(layer)>;
+                modelt_detail::save_state<T>(layer, state, modelt_detail::has_state<T, LayerType> {});
+                state += modelt_detail::get_state_size<T>(layer, modelt_detail::has_state<T, LayerType> {});
+            },
+            layers);
+    }
+
+    /**
+     * Restores the state of the network layers from values written by
+     * `saveState()`, on a model of the same type (with the same sample
+     * rate correction delays).
+     */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept
+    {
+        modelt_detail::forEachInTuple([&](auto& layer, size_t)
+            {
+                using LayerType = std::decay_t<decltype(layer)>;
+                modelt_detail::load_state<T>(layer, state, modelt_detail::has_state<T, LayerType> {});
+                state += modelt_detail::get_state_size<T>(layer, modelt_detail::has_state<T, LayerType> {});
+            },
+            layers);
+    }
+
     /** Performs forward propagation for this model. */
     inline T forward(const T* input)
     {
@@ -553,14 +1468,20 @@ public:
         return outs;
     }
 
-    /** Loads neural network model weights from a json stream. */
-    void parseJson(const nlohmann::json& parent, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
+    /**
+     * Loads neural network model weights from a json stream.
+     * Returns true if the json layers exactly match the model's layers.
+     */
+    bool parseJson(const nlohmann::json& parent, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
     {
-        modelt_detail::parseJson<T, input_size>(parent, layers, debug, custom_layers);
+        return modelt_detail::parseJson<T, input_size>(parent, layers, debug, custom_layers);
     }
 
-    /** Loads neural network model weights from a json stream. */
-    void parseJson(std::ifstream& jsonStream, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
+    /**
+     * Loads neural network model weights from a json stream.
+     * Returns true if the json layers exactly match the model's layers.
+     */
+    bool parseJson(std::ifstream& jsonStream, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
     {
         nlohmann::json parent;
         jsonStream >> parent;
@@ -0,0 +1,234 @@
+#pragma once
+
+#include "ModelT.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+#ifndef DOXYGEN
+namespace multi_instance_detail
+{
+    /**
+     * Maps a static layer type to the equivalent multi-instance layer type.
+     *
+     * Layers without a multi-instance implementation are left undefined,
+     * so that using them in a MultiInstanceModelT fails at compile-time.
+     */
+    template <typename LayerType, int num_instances>
+    struct multi_instance_layer;
+
+    template <typename T, int in_size, int out_size, int num_instances>
+    struct multi_instance_layer<DenseT<T, in_size, out_size>, num_instances>
+    {
+        using type = DenseMultiT<T, in_size, out_size, num_instances>;
+    };
+
+    template <typename T, int in_size, int out_size, int kernel_size, int dilation_rate, int groups, bool dynamic_state, int num_instances>
+    struct multi_instance_layer<Conv1DT<T, in_size, out_size, kernel_size, dilation_rate, groups, dynamic_state>, num_instances>
+    {
+        using type = Conv1DMultiT<T, in_size, out_size, kernel_size, dilation_rate, num_instances, groups>;
+    };
+
+    template <typename T, int in_size, int out_size, SampleRateCorrectionMode mode, typename MathsProvider, int num_instances>
+    struct multi_instance_layer<GRULayerT<T, in_size, out_size, mode, MathsProvider>, num_instances>
+    {
+        static_assert(mode == SampleRateCorrectionMode::None, "Multi-instance GRU layers do not support sample rate correction!");
+        using type = GRULayerMultiT<T, in_size, out_size, num_instances, MathsProvider>;
+    };
+
+    template <typename T, int in_size, int out_size, SampleRateCorrectionMode mode, typename MathsProvider, int num_instances>
+    struct multi_instance_layer<LSTMLayerT<T, in_size, out_size, mode, MathsProvider>, num_instances>
+    {
+        static_assert(mode == SampleRateCorrectionMode::None, "Multi-instance LSTM layers do not support sample rate correction!");
+        using type = LSTMLayerMultiT<T, in_size, out_size, num_instances, MathsProvider>;
+    };
+
+    template <typename T, int size, typename MathsProvider, int num_instances>
+    struct multi_instance_layer<TanhActivationT<T, size, MathsProvider>, num_instances>
+    {
+        using type = TanhActivationMultiT<T, size, num_instances, MathsProvider>;
+    };
+
+    template <typename T, int size, int num_instances>
+    struct multi_instance_layer<ReLuActivationT<T, size>, num_instances>
+    {
+        using type = ReLuActivationMultiT<T, size, num_instances>;
+    };
+
+    template <typename T, int size, typename MathsProvider, int num_instances>
+    struct multi_instance_layer<SigmoidActivationT<T, size, MathsProvider>, num_instances>
+    {
+        using type = SigmoidActivationMultiT<T, size, num_instances, MathsProvider>;
+    };
+
+    template <typename T, int size, typename MathsProvider, int num_instances>
+    struct multi_instance_layer<SoftmaxActivationT<T, size, MathsProvider>, num_instances>
+    {
+        using type = SoftmaxActivationMultiT<T, size, num_instances, MathsProvider>;
+    };
+
+    template <typename T, int size, int AlphaNumerator, int AlphaDenominator, typename MathsProvider, int num_instances>
+    struct multi_instance_layer<ELuActivationT<T, size, AlphaNumerator, AlphaDenominator, MathsProvider>, num_instances>
+    {
+        using type = ELuActivationMultiT<T, size, num_instances, AlphaNumerator, AlphaDenominator, MathsProvider>;
+    };
+
+    template <typename T, int size, int num_instances>
+    struct multi_instance_layer<PReLUActivationT<T, size>, num_instances>
+    {
+        using type = PReLUActivationMultiT<T, size, num_instances>;
+    };
+} // namespace multi_instance_detail
+#endif // DOXYGEN
+
+/**
+ *  A static sequential neural network model, which runs `num_instances`
+ *  independent instances of the same network (e.g. one per synth voice).
+ *
+ *  The layers are defined in the same way as for ModelT:
+ *  ```
+ *  MultiInstanceModelT<float, 8, 1, 1,
+ *      DenseT<float, 1, 8>,
+ *      TanhActivationT<float, 8>,
+ *      DenseT<float, 8, 1>
+ *  > model;
+ *  ```
+ *
+ *  All of the instances share one copy of the weights, while the layer
+ *  states are stored in structure-of-arrays form, with one instance per
+ *  SIMD lane when using the XSIMD backend. A single call to `forward()`
+ *  steps every instance by one frame. Any MathsProvider given to the
+ *  layers is used for every instance.
+ *
+ *  Supported layers are DenseT, Conv1DT, GRULayerT, LSTMLayerT (without
+ *  sample rate correction), and the tanh, ReLU, sigmoid, softmax, ELU, and
+ *  PReLU activations. Other layers fail to compile.
+ */
+template <typename T, int num_instances, int in_size, int out_size, typename... Layers>
+class MultiInstanceModelT
+{
+    using v_type = multi_instance_detail::lane_type<T>;
+    static constexpr auto v_size = multi_instance_detail::lane_width<T>();
+    static constexpr auto num_groups = multi_instance_detail::num_lane_groups<T>(num_instances);
+
+public:
+    static constexpr auto instances = num_instances;
+    static constexpr auto input_size = in_size;
+    static constexpr auto output_size = out_size;
+
+    MultiInstanceModelT()
+    {
+        for(int k = 0; k < in_size; ++k)
+            for(int g = 0; g < num_groups; ++g)
+                v_ins[k][g] = (v_type)(T)0;
+
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+    }
+
+    /** Get a reference to the layer at index `Index`. */
+    template <int Index>
+    RTNEURAL_REALTIME auto& get() noexcept
+    {
+        return std::get<Index>(layers);
+    }
+
+    /** Get a reference to the layer at index `Index`. */
+    template <int Index>
+    RTNEURAL_REALTIME const auto& get() const noexcept
+    {
+        return std::get<Index>(layers);
+    }
+
+    /** Resets the state of the network layers, for all of the instances. */
+    RTNEURAL_REALTIME void reset()
+    {
+        modelt_detail::forEachInTuple([&](auto& layer, size_t)
+            { layer.reset(); },
+            layers);
+    }
+
+    /**
+     * Performs forward propagation for all of the instances.
+     *
+     * The input for instance `i` starts at `input + i * in_size`.
+     */
+    RTNEURAL_REALTIME inline void forward(const T* input) noexcept
+    {
+#if RTNEURAL_USE_XSIMD
+        T lanes alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_size];
+        for(int k = 0; k < in_size; ++k)
+        {
+            for(int g = 0; g < num_groups; ++g)
+            {
+                for(int l = 0; l < v_size; ++l)
+                {
+                    const auto instance = g * v_size + l;
+                    lanes[l] = instance < num_instances ? input[instance * in_size + k] : (T)0;
+                }
+                v_ins[k][g] = xsimd::load_unaligned(lanes);
+            }
+        }
+#else
+        for(int k = 0; k < in_size; ++k)
+            for(int g = 0; g < num_groups; ++g)
+                v_ins[k][g] = input[g * in_size + k];
+#endif
+
+        std::get<0>(layers).forward(v_ins);
+        modelt_detail::forward_unroll<1, n_layers - 1>::call(layers);
+
+        const auto& layer_outs = get<n_layers - 1>().outs;
+#if RTNEURAL_USE_XSIMD
+        for(int i = 0; i < out_size; ++i)
+        {
+            for(int g = 0; g < num_groups; ++g)
+            {
+                xsimd::store_unaligned(lanes, layer_outs[i][g]);
+                for(int l = 0; l < v_size && g * v_size + l < num_instances; ++l)
+                    outs[(g * v_size + l) * out_size + i] = lanes[l];
+            }
+        }
+#else
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                outs[g * out_size + i] = layer_outs[i][g];
+#endif
+    }
+
+    /**
+     * Returns a pointer to the outputs of the final layer in the network.
+     *
+     * The output for instance `i` starts at `getOutputs() + i * out_size`.
+     */
+    RTNEURAL_REALTIME inline const T* getOutputs() const noexcept
+    {
+        return outs;
+    }
+
+    /**
+     * Loads neural network model weights from a json stream.
+     * Returns true if the json layers exactly match the model's layers.
+     */
+    bool parseJson(const nlohmann::json& parent, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
+    {
+        return modelt_detail::parseJson<T, in_size>(parent, layers, debug, custom_layers);
+    }
+
+    /**
+     * Loads neural network model weights from a json stream.
+     * Returns true if the json layers exactly match the model's layers.
+     */
+    bool parseJson(std::ifstream& jsonStream, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
+    {
+        nlohmann::json parent;
+        jsonStream >> parent;
+        return parseJson(parent, debug, custom_layers);
+    }
+
+private:
+    v_type v_ins[in_size][num_groups];
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[num_instances * out_size];
+
+    std::tuple<typename multi_instance_detail::multi_instance_layer<Layers, num_instances>::type...> layers;
+    static constexpr size_t n_layers = sizeof...(Layers);
+};
+} // namespace RTNEURAL_NAMESPACE
@@ -8,6 +8,8 @@
 // RTNeural includes:
 #include "Model.h"
 #include "ModelT.h"
+#include "MultiInstanceModelT.h"
 #include "config.h"
 #include "model_loader.h"
+#include "model_registry.h"
 #include "torch_helpers.h"
@@ -4,6 +4,7 @@
 #include "../Layer.h"
 #include "../config.h"
 #include <functional>
+#include <vector>
 
 namespace RTNEURAL_NAMESPACE
 {
@@ -77,6 +78,13 @@ public:
         for(int i = 0; i < Layer<T>::out_size; ++i)
             out[i] = MathsProvider::tanh(input[i]);
     }
+
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        for(int i = 0; i < Layer<T>::out_size * numSamples; ++i)
+            out[i] = MathsProvider::tanh(input[i]);
+    }
 };
 
 /** Static implementation of a tanh activation layer. */
@@ -104,6 +112,13 @@ public:
             outs[i] = MathsProvider::tanh(ins[i]);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        for(int i = 0; i < size * numFrames; ++i)
+            out[i] = MathsProvider::tanh(ins[i]);
+    }
+
     T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
 };
 
@@ -125,6 +140,13 @@ public:
         : ReLuActivation(*sizes.begin())
     {
     }
+
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        for(int i = 0; i < Layer<T>::out_size * numSamples; ++i)
+            out[i] = std::max((T)0, input[i]);
+    }
 };
 
 /** Static implementation of a ReLU activation layer. */
@@ -152,6 +174,13 @@ public:
             outs[i] = std::max((T)0, ins[i]);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        for(int i = 0; i < size * numFrames; ++i)
+            out[i] = std::max((T)0, ins[i]);
+    }
+
     T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
 };
 
@@ -173,6 +202,13 @@ public:
         : SigmoidActivation(*sizes.begin())
     {
     }
+
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        for(int i = 0; i < Layer<T>::out_size * numSamples; ++i)
+            out[i] = MathsProvider::sigmoid(input[i]);
+    }
 };
 
 /** Static implementation of a sigmoid activation layer. */
@@ -200,6 +236,13 @@ public:
             outs[i] = MathsProvider::sigmoid(ins[i]);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        for(int i = 0; i < size * numFrames; ++i)
+            out[i] = MathsProvider::sigmoid(ins[i]);
+    }
+
     T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
 };
 
@@ -297,6 +340,13 @@ public:
     {
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        for(int i = 0; i < Layer<T>::out_size * numSamples; ++i)
+            out[i] = input[i] > (T)0 ? input[i] : (alpha * (MathsProvider::exp(input[i]) - (T)1));
+    }
+
     /** Sets a custom value for the layer's "alpha" parameter. */
     RTNEURAL_REALTIME void set_alpha(T newAlpha) { alpha = newAlpha; }
 
@@ -341,6 +391,14 @@ public:
             outs[i] = ins[i] > (T)0 ? ins[i] : (alpha * (MathsProvider::exp(ins[i]) - (T)1));
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        static constexpr T alpha = (T)AlphaNumerator / (T)AlphaDenominator;
+        for(int i = 0; i < size * numFrames; ++i)
+            out[i] = ins[i] > (T)0 ? ins[i] : (alpha * (MathsProvider::exp(ins[i]) - (T)1));
+    }
+
     T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
 };
 
@@ -362,6 +420,18 @@ public:
             out[i] = input[i] >= (T)0 ? input[i] : (input[i] * alpha[i]);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        for(int n = 0; n < numSamples; ++n)
+        {
+            const auto* frameIn = input + n * Layer<T>::in_size;
+            auto* frameOut = out + n * Layer<T>::out_size;
+            for(auto i = 0; i < Layer<T>::in_size; ++i)
+                frameOut[i] = frameIn[i] >= (T)0 ? frameIn[i] : (frameIn[i] * alpha[i]);
+        }
+    }
+
     RTNEURAL_REALTIME void setAlphaVals(const std::vector<T>& alphaVals)
     {
         if(alphaVals.size() == 1)
@@ -409,6 +479,18 @@ public:
             outs[i] = ins[i] >= (T)0 ? ins[i] : (ins[i] * alpha[i]);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        for(int n = 0; n < numFrames; ++n)
+        {
+            const auto* frameIn = ins + n * size;
+            auto* frameOut = out + n * size;
+            for(auto i = 0; i < size; ++i)
+                frameOut[i] = frameIn[i] >= (T)0 ? frameIn[i] : (frameIn[i] * alpha[i]);
+        }
+    }
+
     RTNEURAL_REALTIME void setAlphaVals(const std::vector<T>& alphaVals)
     {
         if(alphaVals.size() == 1)
@@ -36,6 +36,16 @@ public:
         std::copy(outVec.data(), outVec.data() + Layer<T>::in_size, out);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        const auto inBlock = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(
+            input, Layer<T>::in_size * numSamples);
+        auto outBlock = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>>(
+            out, Layer<T>::in_size * numSamples);
+        outBlock = MathsProvider::tanh(inBlock);
+    }
+
     Eigen::Matrix<T, Eigen::Dynamic, 1> inVec;
     Eigen::Matrix<T, Eigen::Dynamic, 1> outVec;
 };
@@ -70,6 +80,14 @@ public:
         outs = MathsProvider::tanh(ins);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        const auto inBlock = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(ins, size * numFrames);
+        auto outBlock = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>>(out, size * numFrames);
+        outBlock = MathsProvider::tanh(inBlock);
+    }
+
     Eigen::Map<v_type, RTNeuralEigenAlignment> outs;
 
 private:
@@ -104,6 +122,16 @@ public:
         std::copy(outVec.data(), outVec.data() + Layer<T>::in_size, out);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        const auto inBlock = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(
+            input, Layer<T>::in_size * numSamples);
+        auto outBlock = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>>(
+            out, Layer<T>::in_size * numSamples);
+        outBlock = inBlock.array().max((T)0);
+    }
+
     Eigen::Matrix<T, Eigen::Dynamic, 1> inVec;
     Eigen::Matrix<T, Eigen::Dynamic, 1> outVec;
 };
@@ -138,6 +166,14 @@ public:
         outs = ins.array().max((T)0);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        const auto inBlock = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(ins, size * numFrames);
+        auto outBlock = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>>(out, size * numFrames);
+        outBlock = inBlock.array().max((T)0);
+    }
+
     Eigen::Map<v_type, RTNeuralEigenAlignment> outs;
 
 private:
@@ -173,6 +209,16 @@ public:
         std::copy(outVec.data(), outVec.data() + Layer<T>::in_size, out);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        const auto inBlock = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(
+            input, Layer<T>::in_size * numSamples);
+        auto outBlock = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>>(
+            out, Layer<T>::in_size * numSamples);
+        outBlock = MathsProvider::sigmoid(inBlock);
+    }
+
     Eigen::Matrix<T, Eigen::Dynamic, 1> inVec;
     Eigen::Matrix<T, Eigen::Dynamic, 1> outVec;
 };
@@ -207,6 +253,14 @@ public:
         outs = MathsProvider::sigmoid(ins);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        const auto inBlock = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(ins, size * numFrames);
+        auto outBlock = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>>(out, size * numFrames);
+        outBlock = MathsProvider::sigmoid(inBlock);
+    }
+
     Eigen::Map<v_type, RTNeuralEigenAlignment> outs;
 
 private:
@@ -242,6 +296,18 @@ public:
         std::copy(outVec.data(), outVec.data() + Layer<T>::in_size, out);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        const auto inBlock = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(
+            input, Layer<T>::in_size, numSamples);
+        auto outBlock = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(
+            out, Layer<T>::in_size, numSamples);
+        outBlock = MathsProvider::exp(inBlock);
+        for(int n = 0; n < numSamples; ++n)
+            outBlock.col(n) /= outBlock.col(n).sum();
+    }
+
     Eigen::Matrix<T, Eigen::Dynamic, 1> inVec;
     Eigen::Matrix<T, Eigen::Dynamic, 1> outVec;
 };
@@ -312,6 +378,16 @@ public:
         std::copy(outVec.data(), outVec.data() + Layer<T>::in_size, out);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        const auto inBlock = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(
+            input, Layer<T>::in_size * numSamples);
+        auto outBlock = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>>(
+            out, Layer<T>::in_size * numSamples);
+        outBlock = (inBlock.array() > (T)0).select(inBlock.array(), alpha * (MathsProvider::exp(inBlock) - (T)1));
+    }
+
     Eigen::Matrix<T, Eigen::Dynamic, 1> inVec;
     Eigen::Matrix<T, Eigen::Dynamic, 1> outVec;
 
@@ -364,6 +440,15 @@ public:
         outs = (ins.array() > (T)0).select(ins, alpha * (MathsProvider::exp(ins) - ones.array()));
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        const auto inBlock = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(ins, size * numFrames);
+        auto outBlock = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>>(out, size * numFrames);
+        static constexpr T alpha = (T)AlphaNumerator / (T)AlphaDenominator;
+        outBlock = (inBlock.array() > (T)0).select(inBlock.array(), alpha * (MathsProvider::exp(inBlock) - (T)1));
+    }
+
     Eigen::Map<v_type, RTNeuralEigenAlignment> outs;
 
 private:
@@ -394,6 +479,16 @@ public:
         std::copy(outVec.data(), outVec.data() + Layer<T>::in_size, out);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        const auto inBlock = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(
+            input, Layer<T>::in_size, numSamples);
+        auto outBlock = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(
+            out, Layer<T>::in_size, numSamples);
+        outBlock = (inBlock.array() >= (T)0).select(inBlock.array(), inBlock.array().colwise() * alpha.array());
+    }
+
     RTNEURAL_REALTIME void setAlphaVals(const std::vector<T>& alphaVals)
     {
         if(alphaVals.size() == 1)
@@ -444,6 +539,14 @@ public:
         outs = (ins.array() >= (T)0).select(ins, alpha.cwiseProduct(ins));
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        const auto inBlock = Eigen::Map<const Eigen::Matrix<T, size, Eigen::Dynamic>>(ins, size, numFrames);
+        auto outBlock = Eigen::Map<Eigen::Matrix<T, size, Eigen::Dynamic>>(out, size, numFrames);
+        outBlock = (inBlock.array() >= (T)0).select(inBlock.array(), inBlock.array().colwise() * alpha.array());
+    }
+
     RTNEURAL_REALTIME void setAlphaVals(const std::vector<T>& alphaVals)
     {
         if(alphaVals.size() == 1)
@@ -29,6 +29,14 @@ public:
     {
         tanh<T, MathsProvider>(input, out, Layer<T>::in_size);
     }
+
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        xsimd::transform(input, input + Layer<T>::in_size * numSamples, out,
+            [](auto const& x)
+            { return MathsProvider::tanh(x); });
+    }
 };
 
 /** Static implementation of a tanh activation layer. */
@@ -64,6 +72,13 @@ public:
             outs[i] = MathsProvider::tanh(ins[i]);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const v_type* ins, v_type* out, int numFrames) noexcept
+    {
+        for(int i = 0; i < v_io_size * numFrames; ++i)
+            out[i] = MathsProvider::tanh(ins[i]);
+    }
+
     v_type outs[v_io_size];
 };
 
@@ -93,6 +108,17 @@ public:
             { return xsimd::max(a, b); });
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        xsimd::transform(input, input + Layer<T>::in_size * numSamples, out,
+            [](auto const& x)
+            {
+                using x_type = typename std::decay<decltype(x)>::type;
+                return xsimd::max(x, x_type((T)0));
+            });
+    }
+
     std::vector<T, xsimd::aligned_allocator<T>> zeros;
 };
 
@@ -129,6 +155,13 @@ public:
             outs[i] = xsimd::max(ins[i], v_type((T)0));
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const v_type* ins, v_type* out, int numFrames) noexcept
+    {
+        for(int i = 0; i < v_io_size * numFrames; ++i)
+            out[i] = xsimd::max(ins[i], v_type((T)0));
+    }
+
     v_type outs[v_io_size];
 };
 
@@ -153,6 +186,14 @@ public:
     {
         sigmoid<T, MathsProvider>(input, out, Layer<T>::in_size);
     }
+
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        xsimd::transform(input, input + Layer<T>::in_size * numSamples, out,
+            [](auto const& x)
+            { return MathsProvider::sigmoid(x); });
+    }
 };
 
 /** Static implementation of a sigmoid activation layer. */
@@ -188,6 +229,13 @@ public:
             outs[i] = MathsProvider::sigmoid(ins[i]);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const v_type* ins, v_type* out, int numFrames) noexcept
+    {
+        for(int i = 0; i < v_io_size * numFrames; ++i)
+            out[i] = MathsProvider::sigmoid(ins[i]);
+    }
+
     v_type outs[v_io_size];
 };
 
@@ -212,6 +260,24 @@ public:
     {
         softmax<T, MathsProvider>(input, out, Layer<T>::in_size);
     }
+
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        for(int n = 0; n < numSamples; ++n)
+        {
+            const auto* frameIn = input + n * Layer<T>::in_size;
+            auto* frameOut = out + n * Layer<T>::out_size;
+            xsimd::transform(frameIn, frameIn + Layer<T>::in_size, frameOut,
+                [](auto const& x)
+                { return MathsProvider::exp(x); });
+
+            const auto exp_sum_recip = (T)1 / xsimd::reduce(frameOut, frameOut + Layer<T>::out_size, (T)0);
+            xsimd::transform(frameOut, frameOut + Layer<T>::out_size, frameOut,
+                [exp_sum_recip](auto const& x)
+                { return x * exp_sum_recip; });
+        }
+    }
 };
 
 /** Static implementation of a softmax activation layer. */
@@ -280,6 +346,14 @@ public:
         elu<T, MathsProvider>(input, out, Layer<T>::in_size, alpha);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        xsimd::transform(input, input + Layer<T>::in_size * numSamples, out,
+            [a = alpha](auto const& x)
+            { return xsimd::select(x > (T)0, x, a * (MathsProvider::exp(x) - (T)1)); });
+    }
+
     /** Sets a custom value for the layer's "alpha" parameter. */
     RTNEURAL_REALTIME void set_alpha(T newAlpha) { alpha = newAlpha; }
 
@@ -328,6 +402,14 @@ public:
             outs[i] = xsimd::select(ins[i] > (T)0, ins[i], alpha * (MathsProvider::exp(ins[i]) - (T)1));
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const v_type* ins, v_type* out, int numFrames) noexcept
+    {
+        static constexpr T alpha = (T)AlphaNumerator / (T)AlphaDenominator;
+        for(int i = 0; i < v_io_size * numFrames; ++i)
+            out[i] = xsimd::select(ins[i] > (T)0, ins[i], alpha * (MathsProvider::exp(ins[i]) - (T)1));
+    }
+
     v_type outs[v_io_size];
 };
 
@@ -363,6 +445,18 @@ public:
             out[i] = input[i] >= (T)0 ? input[i] : (input[i] * alpha[i]);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        for(int n = 0; n < numSamples; ++n)
+        {
+            const auto* frameIn = input + n * Layer<T>::in_size;
+            xsimd::transform(frameIn, frameIn + Layer<T>::in_size, alpha.data(), out + n * Layer<T>::out_size,
+                [](auto const& x, auto const& a)
+                { return xsimd::select(x >= (T)0, x, x * a); });
+        }
+    }
+
     RTNEURAL_REALTIME void setAlphaVals(const std::vector<T>& alphaVals)
     {
         if(alphaVals.size() == 1)
@@ -414,6 +508,18 @@ public:
             outs[i] = xsimd::select(ins[i] >= (T)0, ins[i], ins[i] * alpha[i]);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const v_type* ins, v_type* out, int numFrames) noexcept
+    {
+        for(int n = 0; n < numFrames; ++n)
+        {
+            const auto* frameIn = ins + n * v_io_size;
+            auto* frameOut = out + n * v_io_size;
+            for(int i = 0; i < v_io_size; ++i)
+                frameOut[i] = xsimd::select(frameIn[i] >= (T)0, frameIn[i], frameIn[i] * alpha[i]);
+        }
+    }
+
     RTNEURAL_REALTIME void setAlphaVals(const std::vector<T>& alphaVals)
     {
         if(alphaVals.size() == 1)
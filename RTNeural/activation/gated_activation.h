@@ -0,0 +1,211 @@
+#ifndef GATED_ACTIVATION_H_INCLUDED
+#define GATED_ACTIVATION_H_INCLUDED
+
+#include <algorithm>
+
+#include "../common.h"
+#include "../config.h"
+#include "activation.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * Dynamic implementation of a gated activation layer, as used in
+ * WaveNet-style models. The input is split into two halves, and the
+ * output is tanh(first half) * sigmoid(second half), so the output
+ * size is half of the input size. Both halves are computed in the
+ * same pass over the outputs.
+ */
+template <typename T, typename MathsProvider = DefaultMathsProvider>
+class GatedActivation final : public Layer<T>
+{
+public:
+    /** Constructs a gated activation layer for a given input size. */
+    explicit GatedActivation(int in_size)
+        : Layer<T>(in_size, in_size / 2)
+    {
+    }
+
+    GatedActivation(std::initializer_list<int> sizes)
+        : GatedActivation(*sizes.begin())
+    {
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "gated_activation"; }
+
+    /** Performs forward propagation for this layer. */
+    RTNEURAL_REALTIME inline void forward(const T* input, T* out) noexcept override
+    {
+        const auto size = Layer<T>::out_size;
+#if RTNEURAL_USE_EIGEN
+        const auto inVec = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(input, Layer<T>::in_size);
+        auto outVec = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>>(out, size);
+        outVec = MathsProvider::tanh(inVec.head(size)) * MathsProvider::sigmoid(inVec.segment(size, size));
+#elif RTNEURAL_USE_XSIMD
+        gated_activation<T, MathsProvider>(input, out, size);
+#else
+        for(int i = 0; i < size; ++i)
+            out[i] = MathsProvider::tanh(input[i]) * MathsProvider::sigmoid(input[i + size]);
+#endif
+    }
+
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+#if RTNEURAL_USE_EIGEN
+        const auto size = Layer<T>::out_size;
+        const auto inBlock = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(input, Layer<T>::in_size, numSamples);
+        auto outBlock = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(out, size, numSamples);
+        outBlock = MathsProvider::tanh(inBlock.topRows(size)) * MathsProvider::sigmoid(inBlock.middleRows(size, size));
+#else
+        for(int n = 0; n < numSamples; ++n)
+            forward(input + n * Layer<T>::in_size, out + n * Layer<T>::out_size);
+#endif
+    }
+};
+
+//====================================================
+/**
+ * Static implementation of a gated activation layer, which computes
+ * tanh(first half) * sigmoid(second half) of its input. See
+ * `GatedActivation` for details.
+ */
+template <typename T, int in_sizet, typename MathsProvider = DefaultMathsProvider>
+class GatedActivationT
+{
+    static_assert(in_sizet % 2 == 0, "The gated activation input size must be even!");
+
+#if RTNEURAL_USE_EIGEN
+    using v_in_type = Eigen::Matrix<T, in_sizet, 1>;
+    using v_out_type = Eigen::Matrix<T, in_sizet / 2, 1>;
+#elif RTNEURAL_USE_XSIMD
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_in_size = ceil_div(in_sizet, v_size);
+    static constexpr auto v_out_size = ceil_div(in_sizet / 2, v_size);
+#endif
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = in_sizet / 2;
+
+    GatedActivationT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+#if RTNEURAL_USE_EIGEN
+        outs = v_out_type::Zero();
+#elif RTNEURAL_USE_XSIMD
+        std::fill(std::begin(outs), std::end(outs), v_type((T)0));
+#else
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+#endif
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "gated_activation"; }
+
+    /** Returns false, since the output size of this layer is different to the input size. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    RTNEURAL_REALTIME void reset() { }
+
+    /** Performs forward propagation for this layer. */
+#if RTNEURAL_USE_EIGEN
+    RTNEURAL_REALTIME inline void forward(const v_in_type& ins) noexcept
+    {
+        outs = MathsProvider::tanh(ins.template head<out_size>()) * MathsProvider::sigmoid(ins.template tail<out_size>());
+    }
+
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        const auto inBlock = Eigen::Map<const Eigen::Matrix<T, in_size, Eigen::Dynamic>>(ins, in_size, numFrames);
+        auto outBlock = Eigen::Map<Eigen::Matrix<T, out_size, Eigen::Dynamic>>(out, out_size, numFrames);
+        outBlock = MathsProvider::tanh(inBlock.template topRows<out_size>()) * MathsProvider::sigmoid(inBlock.template bottomRows<out_size>());
+    }
+#elif RTNEURAL_USE_XSIMD
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        forwardFrame(ins, outs);
+    }
+
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const v_type* ins, v_type* out, int numFrames) noexcept
+    {
+        for(int n = 0; n < numFrames; ++n)
+            forwardFrame(ins + n * v_in_size, out + n * v_out_size);
+    }
+#else
+    RTNEURAL_REALTIME inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = MathsProvider::tanh(ins[i]) * MathsProvider::sigmoid(ins[i + out_size]);
+    }
+
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        for(int n = 0; n < numFrames; ++n)
+        {
+            const auto* frameIn = ins + n * in_size;
+            auto* frameOut = out + n * out_size;
+            for(int i = 0; i < out_size; ++i)
+                frameOut[i] = MathsProvider::tanh(frameIn[i]) * MathsProvider::sigmoid(frameIn[i + out_size]);
+        }
+    }
+#endif
+
+private:
+#if RTNEURAL_USE_XSIMD
+    /** When the halves line up with the SIMD batches, both halves are read straight from the input batches. */
+    template <int N = out_size>
+    RTNEURAL_REALTIME inline typename std::enable_if<N % v_size == 0, void>::type
+    forwardFrame(const v_type* ins, v_type* out) noexcept
+    {
+        for(int i = 0; i < v_out_size; ++i)
+            out[i] = MathsProvider::tanh(ins[i]) * MathsProvider::sigmoid(ins[i + v_out_size]);
+    }
+
+    /** Otherwise the second half is re-loaded from an unaligned offset. */
+    template <int N = out_size>
+    RTNEURAL_REALTIME inline typename std::enable_if<N % v_size != 0, void>::type
+    forwardFrame(const v_type* ins, v_type* out) noexcept
+    {
+        T scalar_in alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size + v_out_size * v_size] {};
+        for(int i = 0; i < v_in_size - 1; ++i)
+            ins[i].store_aligned(scalar_in + i * v_size);
+
+        // the last input batch may be padded past the end of the scratch array
+        T last_in alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_size];
+        ins[v_in_size - 1].store_aligned(last_in);
+        std::copy(last_in, last_in + in_size - (v_in_size - 1) * v_size, scalar_in + (v_in_size - 1) * v_size);
+
+        for(int i = 0; i < v_out_size; ++i)
+        {
+            const auto x = xsimd::load_aligned(scalar_in + i * v_size);
+            const auto g = xsimd::load_unaligned(scalar_in + out_size + i * v_size);
+            out[i] = MathsProvider::tanh(x) * MathsProvider::sigmoid(g);
+        }
+    }
+#endif
+
+public:
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<v_out_type, RTNeuralEigenAlignment> outs;
+
+private:
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#elif RTNEURAL_USE_XSIMD
+    v_type outs[v_out_size];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // GATED_ACTIVATION_H_INCLUDED
@@ -0,0 +1,394 @@
+#ifndef LUT_ACTIVATION_H_INCLUDED
+#define LUT_ACTIVATION_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../common.h"
+#include "../config.h"
+#include "../memory_arena.h"
+#include "activation.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/** Activation functions which can be computed from a lookup table. */
+enum class LUTFunction
+{
+    Tanh,
+    Sigmoid,
+    ELu,
+};
+
+#ifndef DOXYGEN
+namespace lut_detail
+{
+    /** The default number of table entries. */
+    constexpr int defaultTableSize = 2048;
+
+    /**
+     * The input range covered by the table for a function, along with the
+     * largest first and second derivatives in that range (which bound the
+     * rounding and interpolation errors), and the largest error from
+     * clamping the input to the range. The ELU table only covers negative
+     * inputs.
+     */
+    struct Range
+    {
+        double min;
+        double max;
+        double maxSlope;
+        double maxCurvature;
+        double clampError;
+    };
+
+    constexpr Range getRange(LUTFunction func)
+    {
+        return func == LUTFunction::Tanh      ? Range { -8.0, 8.0, 1.0, 0.769800358919501, 2.250703e-7 }
+            : func == LUTFunction::Sigmoid ? Range { -16.0, 16.0, 0.25, 0.0962250448649376, 1.125352e-7 }
+                                           : Range { -16.0, 0.0, 1.0, 1.0, 1.125352e-7 };
+    }
+
+    /** Returns the name of a function (as used by the other activation layers). */
+    inline std::string getName(LUTFunction func)
+    {
+        return func == LUTFunction::Tanh ? "tanh" : (func == LUTFunction::Sigmoid ? "sigmoid" : "elu");
+    }
+
+    /** Evaluates the function stored in the table (exp(x) - 1 for ELU). */
+    inline double evaluate(LUTFunction func, double x)
+    {
+        if(func == LUTFunction::Tanh)
+            return std::tanh(x);
+        if(func == LUTFunction::Sigmoid)
+            return 1.0 / (1.0 + std::exp(-x));
+        return std::expm1(x);
+    }
+
+    /**
+     * Returns the largest absolute error of the interpolated table for a
+     * given function and table size (for ELU, with alpha = 1). This is the
+     * sum of the interpolation error, the clamping error, and the rounding
+     * errors of the table index and the table values.
+     */
+    template <typename T>
+    double getMaxError(LUTFunction func, int tableSize)
+    {
+        constexpr auto eps = (double)std::numeric_limits<T>::epsilon();
+        const auto range = getRange(func);
+        const auto step = (range.max - range.min) / (double)(tableSize - 1);
+        return step * step * range.maxCurvature / 8.0 + range.clampError
+            + eps * (range.max - range.min) * range.maxSlope + eps;
+    }
+
+    /**
+     * Fills a table with `tableSize + 1` entries. The last entry repeats
+     * the previous one, so that inputs at the top of the range can be
+     * interpolated without a bounds check.
+     */
+    template <typename T>
+    void fillTable(T* table, LUTFunction func, int tableSize)
+    {
+        const auto range = getRange(func);
+        const auto step = (range.max - range.min) / (double)(tableSize - 1);
+        for(int i = 0; i < tableSize; ++i)
+            table[i] = (T)evaluate(func, range.min + step * (double)i);
+        table[tableSize] = table[tableSize - 1];
+    }
+
+    /** The scalar values needed to index a table. */
+    template <typename T>
+    struct TableInfo
+    {
+        TableInfo(LUTFunction func, int tableSize)
+            : min((T)getRange(func).min)
+            , max((T)getRange(func).max)
+            , scale((T)((double)(tableSize - 1) / (getRange(func).max - getRange(func).min)))
+        {
+        }
+
+        T min;
+        T max;
+        T scale;
+    };
+
+    /** Returns the linearly interpolated table value for x. */
+    template <typename T>
+    RTNEURAL_REALTIME inline T lookup(const T* table, const TableInfo<T>& info, T x) noexcept
+    {
+        // written so that NaN inputs are clamped to the bottom of the table
+        const auto u = (std::min(x > info.min ? x : info.min, info.max) - info.min) * info.scale;
+        const auto i = (int)u;
+        const auto t = u - (T)i;
+        return table[i] + t * (table[i + 1] - table[i]);
+    }
+
+#if RTNEURAL_USE_XSIMD
+    /** Returns the linearly interpolated table values for x, using gathers. */
+    template <typename T>
+    RTNEURAL_REALTIME inline xsimd::simd_type<T> lookup(const T* table, const TableInfo<T>& info, const xsimd::simd_type<T>& x) noexcept
+    {
+        using b_type = xsimd::simd_type<T>;
+        const b_type min(info.min);
+
+        const auto u = (xsimd::min(xsimd::select(x > min, x, min), b_type(info.max)) - min) * b_type(info.scale);
+        const auto index = xsimd::batch_cast<xsimd::as_integer_t<T>>(u);
+        const auto t = u - xsimd::batch_cast<T>(index);
+        const auto y0 = b_type::gather(table, index);
+        const auto y1 = b_type::gather(table + 1, index);
+        return xsimd::fma(t, y1 - y0, y0);
+    }
+#endif
+
+    /** Computes the activation function for `size` values. */
+    template <LUTFunction func, typename T>
+    RTNEURAL_REALTIME inline void forward(const T* table, const TableInfo<T>& info, T alpha, const T* input, T* out, int size) noexcept
+    {
+        int i = 0;
+#if RTNEURAL_USE_XSIMD
+        using b_type = xsimd::simd_type<T>;
+        constexpr auto inc = (int)b_type::size;
+        for(; i + inc <= size; i += inc)
+        {
+            const auto x = xsimd::load_unaligned(input + i);
+            if(func == LUTFunction::ELu)
+                xsimd::store_unaligned(out + i, xsimd::select(x > b_type((T)0), x, b_type(alpha) * lookup(table, info, x)));
+            else
+                xsimd::store_unaligned(out + i, lookup(table, info, x));
+        }
+#endif
+
+        for(; i < size; ++i)
+        {
+            if(func == LUTFunction::ELu)
+                out[i] = input[i] > (T)0 ? input[i] : alpha * lookup(table, info, input[i]);
+            else
+                out[i] = lookup(table, info, input[i]);
+        }
+    }
+
+    /** A table shared by all the static layers with the same function and table size. */
+    template <typename T, LUTFunction func, int tableSize>
+    struct SharedTable
+    {
+        SharedTable() { fillTable(values, func, tableSize); }
+
+        static const T* get()
+        {
+            static const SharedTable table;
+            return table.values;
+        }
+
+        T values[tableSize + 1];
+    };
+} // namespace lut_detail
+#endif // DOXYGEN
+
+/**
+ * Dynamic implementation of a tanh, sigmoid, or ELU activation layer,
+ * which reads the function from a precomputed table, with linear
+ * interpolation. Inputs outside of the table range are clamped (tanh and
+ * sigmoid saturate, and ELU uses the table for negative inputs only).
+ *
+ * The largest error of the table (see `getMaxError()`) is below
+ * 1e-5 with the default table size of 2048 entries.
+ */
+template <typename T>
+class LUTActivation final : public Activation<T>
+{
+public:
+    /** Constructs a table activation layer for a given size, function, and table size. */
+    LUTActivation(int size, LUTFunction func, int tableSize = lut_detail::defaultTableSize)
+        : Activation<T>(size, {}, lut_detail::getName(func))
+        , func(func)
+        , tableSize(tableSize)
+        , info(func, tableSize)
+        , memory(MemoryArena::getBytes<T>((size_t)(tableSize + 1)))
+    {
+        bindMemory();
+        lut_detail::fillTable(table, func, tableSize);
+    }
+
+    LUTActivation(const LUTActivation& other)
+        : LUTActivation(other.in_size, other.func, other.tableSize)
+    {
+        alpha = other.alpha;
+    }
+
+    LUTActivation& operator=(const LUTActivation& other) = delete;
+
+    /** Performs forward propagation for this layer. */
+    RTNEURAL_REALTIME inline void forward(const T* input, T* out) noexcept override
+    {
+        forwardBlock(input, out, 1);
+    }
+
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        const auto size = Layer<T>::out_size * numSamples;
+        if(func == LUTFunction::Tanh)
+            lut_detail::forward<LUTFunction::Tanh>(table, info, alpha, input, out, size);
+        else if(func == LUTFunction::Sigmoid)
+            lut_detail::forward<LUTFunction::Sigmoid>(table, info, alpha, input, out, size);
+        else
+            lut_detail::forward<LUTFunction::ELu>(table, info, alpha, input, out, size);
+    }
+
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+    }
+
+    /** Returns the function computed by this layer. */
+    LUTFunction getFunction() const noexcept { return func; }
+
+    /** Returns the number of table entries. */
+    int getTableSize() const noexcept { return tableSize; }
+
+    /** Returns the largest absolute error of the table (for ELU, multiplied by alpha). */
+    double getMaxError() const noexcept { return lut_detail::getMaxError<T>(func, tableSize) * std::max((double)std::abs(alpha), 1.0); }
+
+    /** Sets a custom value for the "alpha" parameter of an ELU layer. */
+    RTNEURAL_REALTIME void set_alpha(T newAlpha) { alpha = newAlpha; }
+
+private:
+    /** Points the table at the layer memory. */
+    void bindMemory() noexcept
+    {
+        memory.rewind();
+        table = memory.allocate<T>((size_t)(tableSize + 1));
+    }
+
+    const LUTFunction func;
+    const int tableSize;
+    const lut_detail::TableInfo<T> info;
+    T alpha = (T)1;
+
+    MemoryArena memory;
+    T* table = nullptr;
+};
+
+//====================================================
+/**
+ * Static implementation of a tanh, sigmoid, or ELU activation layer,
+ * which reads the function from a precomputed table, with linear
+ * interpolation. See `LUTActivation` for details.
+ *
+ * The table is shared by all layers with the same function and table size.
+ */
+template <typename T, int size, LUTFunction func, int tableSize = lut_detail::defaultTableSize>
+class LUTActivationT
+{
+    static_assert(tableSize >= 2, "The table must have at least 2 entries!");
+
+#if RTNEURAL_USE_EIGEN
+    using v_type = Eigen::Matrix<T, size, 1>;
+#elif RTNEURAL_USE_XSIMD
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_io_size = ceil_div(size, v_size);
+#endif
+
+public:
+    static constexpr auto in_size = size;
+    static constexpr auto out_size = size;
+
+    LUTActivationT()
+        : info(func, tableSize)
+        , table(lut_detail::SharedTable<T, func, tableSize>::get())
+#if RTNEURAL_USE_EIGEN
+        , outs(outs_internal)
+#endif
+    {
+#if RTNEURAL_USE_EIGEN
+        outs = v_type::Zero();
+#elif RTNEURAL_USE_XSIMD
+        std::fill(std::begin(outs), std::end(outs), v_type((T)0));
+#else
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+#endif
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return lut_detail::getName(func); }
+
+    /** Returns true since this layer is an activation layer. */
+    constexpr bool isActivation() const noexcept { return true; }
+
+    RTNEURAL_REALTIME void reset() { }
+
+    /** Performs forward propagation for this layer. */
+#if RTNEURAL_USE_EIGEN
+    RTNEURAL_REALTIME inline void forward(const v_type& ins) noexcept
+    {
+        lut_detail::forward<func>(table, info, (T)1, ins.data(), outs.data(), size);
+    }
+
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        lut_detail::forward<func>(table, info, (T)1, ins, out, size * numFrames);
+    }
+#elif RTNEURAL_USE_XSIMD
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[v_io_size]) noexcept
+    {
+        for(int i = 0; i < v_io_size; ++i)
+            outs[i] = forwardBatch(ins[i]);
+    }
+
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const v_type* ins, v_type* out, int numFrames) noexcept
+    {
+        for(int i = 0; i < v_io_size * numFrames; ++i)
+            out[i] = forwardBatch(ins[i]);
+    }
+#else
+    RTNEURAL_REALTIME inline void forward(const T (&ins)[size]) noexcept
+    {
+        lut_detail::forward<func>(table, info, (T)1, ins, outs, size);
+    }
+
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        lut_detail::forward<func>(table, info, (T)1, ins, out, size * numFrames);
+    }
+#endif
+
+    /** Returns the largest absolute error of the table. */
+    static double getMaxError() noexcept { return lut_detail::getMaxError<T>(func, tableSize); }
+
+private:
+#if RTNEURAL_USE_XSIMD
+    RTNEURAL_REALTIME inline v_type forwardBatch(const v_type& x) const noexcept
+    {
+        if(func == LUTFunction::ELu)
+            return xsimd::select(x > v_type((T)0), x, lut_detail::lookup(table, info, x));
+        return lut_detail::lookup(table, info, x);
+    }
+#endif
+
+    const lut_detail::TableInfo<T> info;
+    const T* table;
+
+public:
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<v_type, RTNeuralEigenAlignment> outs;
+
+private:
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#elif RTNEURAL_USE_XSIMD
+    v_type outs[v_io_size];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // LUT_ACTIVATION_H_INCLUDED
@@ -99,6 +99,24 @@ public:
             outs[i] = multiplier[i] * (ins[i] - running_mean[i]);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        for(int n = 0; n < numFrames; ++n)
+        {
+            const auto* frameIn = ins + n * size;
+            auto* frameOut = out + n * size;
+            for(int i = 0; i < size; ++i)
+                frameOut[i] = multiplier[i] * (frameIn[i] - running_mean[i]);
+
+            if(affine)
+            {
+                for(int i = 0; i < size; ++i)
+                    frameOut[i] += beta[i];
+            }
+        }
+    }
+
     /** Sets the layer "gamma" values. */
     template <bool isAffine = affine>
     RTNEURAL_REALTIME typename std::enable_if<isAffine, void>::type setGamma(const std::vector<T>& gammaVals);
@@ -33,6 +33,21 @@ public:
         }
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        // each frame is a (num_filters x num_features) matrix, so the whole block
+        // can be treated as a single (num_filters x num_features * numSamples) matrix.
+        auto inMat = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(
+            input, num_filters, num_features * numSamples);
+
+        auto outMat = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(
+            out, num_filters, num_features * numSamples);
+
+        outMat.array() = (inMat.array().colwise() - running_mean.array()).colwise() * multiplier.array();
+        outMat.colwise() += beta;
+    }
+
     /** Sets the layer "gamma" values. */
     RTNEURAL_REALTIME void setGamma(const std::vector<T>& gammaVals);
 
@@ -29,6 +29,19 @@ public:
         outVec = multiplier.cwiseProduct(inVec - running_mean) + beta;
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        auto inMat = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(
+            input, Layer<T>::in_size, numSamples);
+
+        auto outMat = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(
+            out, Layer<T>::in_size, numSamples);
+
+        outMat.array() = (inMat.array().colwise() - running_mean.array()).colwise() * multiplier.array();
+        outMat.colwise() += beta;
+    }
+
     /** Sets the layer "gamma" values. */
     RTNEURAL_REALTIME void setGamma(const std::vector<T>& gammaVals);
 
@@ -94,6 +107,17 @@ public:
         outs = multiplier.cwiseProduct(ins - running_mean);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        const auto inBlock = Eigen::Map<const Eigen::Matrix<T, size, Eigen::Dynamic>>(ins, size, numFrames);
+        auto outBlock = Eigen::Map<Eigen::Matrix<T, size, Eigen::Dynamic>>(out, size, numFrames);
+
+        outBlock.array() = (inBlock.array().colwise() - running_mean.array()).colwise() * multiplier.array();
+        if(affine)
+            outBlock.colwise() += beta;
+    }
+
     /** Sets the layer "gamma" values. */
     template <bool isAffine = affine>
     RTNEURAL_REALTIME typename std::enable_if<isAffine, void>::type setGamma(const std::vector<T>& gammaVals);
@@ -104,6 +104,24 @@ public:
             outs[k] = multiplier[k] * (ins[k] - running_mean[k]);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const v_type* ins, v_type* out, int numFrames) noexcept
+    {
+        for(int n = 0; n < numFrames; ++n)
+        {
+            const auto* frameIn = ins + n * v_out_size;
+            auto* frameOut = out + n * v_out_size;
+            for(int k = 0; k < v_out_size; ++k)
+                frameOut[k] = multiplier[k] * (frameIn[k] - running_mean[k]);
+
+            if(affine)
+            {
+                for(int k = 0; k < v_out_size; ++k)
+                    frameOut[k] += beta[k];
+            }
+        }
+    }
+
     /** Sets the layer "gamma" values. */
     template <bool isAffine = affine>
     RTNEURAL_REALTIME typename std::enable_if<isAffine, void>::type setGamma(const std::vector<T>& gammaVals);
@@ -236,6 +236,28 @@ static inline void elu(const T* in, T* out, int dim, T alpha) noexcept
     for(auto i = vec_size; i < dim; ++i)
         out[i] = in[i] > (T)0 ? in[i] : (alpha * (MathsProvider::exp(in[i]) - (T)1));
 }
+
+/** Computes the gated activation tanh(in[i]) * sigmoid(in[i + dim]), for i < dim. */
+template <typename T, typename MathsProvider>
+static inline void gated_activation(const T* in, T* out, int dim) noexcept
+{
+    using b_type = xsimd::simd_type<T>;
+    constexpr auto inc = (int)b_type::size;
+
+    // size for which the vectorization is possible
+    auto vec_size = dim - dim % inc;
+    for(int i = 0; i < vec_size; i += inc)
+    {
+        // the second half is only aligned when dim is a multiple of the batch size
+        b_type x_vec = xsimd::load_unaligned(&in[i]);
+        b_type g_vec = xsimd::load_unaligned(&in[i + dim]);
+        xsimd::store_unaligned(&out[i], MathsProvider::tanh(x_vec) * MathsProvider::sigmoid(g_vec));
+    }
+
+    // Remaining part that cannot be vectorized
+    for(auto i = vec_size; i < dim; ++i)
+        out[i] = MathsProvider::tanh(in[i]) * MathsProvider::sigmoid(in[i + dim]);
+}
 } // namespace RTNEURAL_NAMESPACE
 
 #else // STL backend
@@ -253,3 +275,49 @@ static inline T vMult(const T* arg1, const T* arg2, int dim) noexcept
 } // namespace RTNEURAL_NAMESPACE
 
 #endif
+
+namespace RTNEURAL_NAMESPACE
+{
+/**
+ * Applies `MathsProvider::sigmoid()` to `dim` values in place. This lets
+ * layers which compute their gates on raw arrays use the same maths
+ * providers as the other layers, on every backend.
+ */
+template <typename MathsProvider, typename T>
+static inline void applySigmoid(T* x, int dim) noexcept
+{
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>> xVec(x, dim);
+    xVec = MathsProvider::sigmoid(xVec);
+#else
+    for(int i = 0; i < dim; ++i)
+        x[i] = MathsProvider::sigmoid(x[i]);
+#endif
+}
+
+/** Applies `MathsProvider::tanh()` to `dim` values in place. */
+template <typename MathsProvider, typename T>
+static inline void applyTanh(T* x, int dim) noexcept
+{
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>> xVec(x, dim);
+    xVec = MathsProvider::tanh(xVec);
+#else
+    for(int i = 0; i < dim; ++i)
+        x[i] = MathsProvider::tanh(x[i]);
+#endif
+}
+
+/** Applies `MathsProvider::exp()` to `dim` values in place. */
+template <typename MathsProvider, typename T>
+static inline void applyExp(T* x, int dim) noexcept
+{
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>> xVec(x, dim);
+    xVec = MathsProvider::exp(xVec);
+#else
+    for(int i = 0; i < dim; ++i)
+        x[i] = MathsProvider::exp(x[i]);
+#endif
+}
+} // namespace RTNEURAL_NAMESPACE
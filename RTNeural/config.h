@@ -35,3 +35,15 @@
 #else
 #define RTNEURAL_REALTIME
 #endif
+
+/**
+    The number of frames that `ModelT::processBlock()` processes at once.
+    Longer blocks are processed in chunks of this size. Each ModelT holds
+    two intermediate buffers of this many frames, so larger values trade
+    memory for better throughput on dense-heavy models. The templated
+    recurrent layers also pre-compute their input projections for chunks
+    of this many frames.
+*/
+#ifndef RTNEURAL_MODELT_BLOCK_SIZE
+#define RTNEURAL_MODELT_BLOCK_SIZE 32
+#endif
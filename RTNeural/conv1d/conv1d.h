@@ -42,14 +42,25 @@ public:
     Conv1D(std::initializer_list<int> sizes);
     Conv1D(const Conv1D& other);
     Conv1D& operator=(const Conv1D& other);
-    virtual ~Conv1D();
+    virtual ~Conv1D() = default;
 
     /** Resets the layer state. */
     RTNEURAL_REALTIME void reset() override;
 
+    /** Returns the number of values in the layer state. */
+    size_t getStateSize() const noexcept override { return (size_t)(state_size * Layer<T>::in_size); }
+
+    /** Copies the past inputs into `state`, from oldest to newest. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept override;
+
+    /** Restores the past inputs from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept override;
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "conv1d"; }
 
+    size_t getNumMACs() const noexcept override { return (size_t)(Layer<T>::out_size * filters_per_group * kernel_size); }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const T* input, T* h) noexcept override
     {
@@ -108,6 +119,13 @@ public:
         state_ptr = (state_ptr == state_size - 1 ? 0 : state_ptr + 1); // iterate state pointer forwards
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* h, int numSamples) noexcept override
+    {
+        for(int n = 0; n < numSamples; ++n)
+            Conv1D::forward(input + n * Layer<T>::in_size, h + n * Layer<T>::out_size);
+    }
+
     /**
      * Sets the layer weights.
      *
@@ -131,6 +149,14 @@ public:
     /** Returns the number of "groups" in the convolution. */
     int getGroups() const noexcept { return groups; }
 
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+    }
+
 private:
     const int dilation_rate;
     const int kernel_size;
@@ -139,13 +165,20 @@ private:
     const int filters_per_group;
     const int channels_per_group;
 
-    T*** weights;
-    T* bias;
+    size_t getMemoryBytes() const noexcept;
+
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept;
+
+    MemoryArena memory;
 
-    T** state;
-    T** state_cols;
+    T*** weights = nullptr;
+    T* bias = nullptr;
 
-    int* state_ptrs;
+    T** state = nullptr;
+    T** state_cols = nullptr;
+
+    int* state_ptrs = nullptr;
     int state_ptr = 0;
 
     /** Sets pointers to state array columns. */
@@ -198,6 +231,15 @@ public:
     /** Resets the layer state. */
     RTNEURAL_REALTIME void reset();
 
+    /** Returns the number of values in the layer state. */
+    static constexpr size_t getStateSize() noexcept { return (size_t)(state_size * in_size); }
+
+    /** Copies the past inputs into `state`, from oldest to newest. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept;
+
+    /** Restores the past inputs from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept;
+
     template <int _groups = groups, std::enable_if_t<_groups == 1, bool> = true>
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const T (&ins)[in_size]) noexcept
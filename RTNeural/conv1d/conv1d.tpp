@@ -15,28 +15,8 @@ Conv1D<T>::Conv1D(int in_size, int out_size, int kernel_size, int dilation, int
     , filters_per_group(in_size / groups)
     , channels_per_group(out_size / groups)
 {
-    weights = new T**[out_size];
-    for(int i = 0; i < out_size; ++i)
-    {
-        weights[i] = new T*[kernel_size];
-        for(int k = 0; k < kernel_size; ++k)
-        {
-            weights[i][k] = new T[filters_per_group];
-            std::fill(weights[i][k], weights[i][k] + filters_per_group, (T)0);
-        }
-    }
-
-    bias = new T[out_size];
-
-    state = new T*[state_size];
-    for(int k = 0; k < state_size; ++k)
-        state[k] = new T[in_size];
-
-    state_cols = new T*[kernel_size];
-    for(int k = 0; k < kernel_size; ++k)
-        state_cols[k] = new T[filters_per_group];
-
-    state_ptrs = new int[kernel_size];
+    memory = MemoryArena(getMemoryBytes());
+    bindMemory();
 }
 
 template <typename T>
@@ -61,28 +41,43 @@ Conv1D<T>& Conv1D<T>::operator=(const Conv1D<T>& other)
 }
 
 template <typename T>
-Conv1D<T>::~Conv1D()
+size_t Conv1D<T>::getMemoryBytes() const noexcept
 {
+    return MemoryArena::getBytes<T**>((size_t)Layer<T>::out_size)
+        + (size_t)Layer<T>::out_size * MemoryArena::getBytes<T*>((size_t)kernel_size)
+        + (size_t)(Layer<T>::out_size * kernel_size) * MemoryArena::getBytes<T>((size_t)filters_per_group)
+        + MemoryArena::getBytes<T>((size_t)Layer<T>::out_size)
+        + MemoryArena::getBytes<T*>((size_t)state_size)
+        + (size_t)state_size * MemoryArena::getBytes<T>((size_t)Layer<T>::in_size)
+        + MemoryArena::getBytes<T*>((size_t)kernel_size)
+        + (size_t)kernel_size * MemoryArena::getBytes<T>((size_t)filters_per_group)
+        + MemoryArena::getBytes<int>((size_t)kernel_size);
+}
+
+template <typename T>
+void Conv1D<T>::bindMemory() noexcept
+{
+    memory.rewind();
+
+    weights = memory.allocate<T**>((size_t)Layer<T>::out_size);
     for(int i = 0; i < Layer<T>::out_size; ++i)
     {
+        weights[i] = memory.allocate<T*>((size_t)kernel_size);
         for(int k = 0; k < kernel_size; ++k)
-            delete[] weights[i][k];
-
-        delete[] weights[i];
+            weights[i][k] = memory.allocate<T>((size_t)filters_per_group);
     }
 
-    delete[] weights;
-    delete[] bias;
+    bias = memory.allocate<T>((size_t)Layer<T>::out_size);
 
+    state = memory.allocate<T*>((size_t)state_size);
     for(int k = 0; k < state_size; ++k)
-        delete[] state[k];
-    delete[] state;
+        state[k] = memory.allocate<T>((size_t)Layer<T>::in_size);
 
+    state_cols = memory.allocate<T*>((size_t)kernel_size);
     for(int k = 0; k < kernel_size; ++k)
-        delete[] state_cols[k];
-    delete[] state_cols;
+        state_cols[k] = memory.allocate<T>((size_t)filters_per_group);
 
-    delete[] state_ptrs;
+    state_ptrs = memory.allocate<int>((size_t)kernel_size);
 }
 
 template <typename T>
@@ -100,6 +95,25 @@ void Conv1D<T>::reset()
     state_ptr = 0;
 }
 
+template <typename T>
+void Conv1D<T>::saveState(T* stateOut) const noexcept
+{
+    for(int k = 0; k < state_size; ++k)
+    {
+        const auto* col = state[(state_ptr + k) % state_size];
+        stateOut = std::copy(col, col + Layer<T>::in_size, stateOut);
+    }
+}
+
+template <typename T>
+void Conv1D<T>::loadState(const T* stateIn) noexcept
+{
+    for(int k = 0; k < state_size; ++k, stateIn += Layer<T>::in_size)
+        std::copy(stateIn, stateIn + Layer<T>::in_size, state[k]);
+
+    state_ptr = 0;
+}
+
 template <typename T>
 void Conv1D<T>::setWeights(const std::vector<std::vector<std::vector<T>>>& ws)
 {
@@ -151,6 +165,25 @@ void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, groups, dynamic
         state_ptrs[i] = 0;
 }
 
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, int groups, bool dynamic_state>
+void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, groups, dynamic_state>::saveState(T* stateOut) const noexcept
+{
+    for(int k = 0; k < state_size; ++k)
+    {
+        const auto& col = state[(state_ptr + k) % state_size];
+        stateOut = std::copy(col.begin(), col.end(), stateOut);
+    }
+}
+
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, int groups, bool dynamic_state>
+void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, groups, dynamic_state>::loadState(const T* stateIn) noexcept
+{
+    for(int k = 0; k < state_size; ++k, stateIn += in_size)
+        std::copy(stateIn, stateIn + in_size, state[k].begin());
+
+    state_ptr = 0;
+}
+
 template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, int groups, bool dynamic_state>
 void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, groups, dynamic_state>::setWeights(const std::vector<std::vector<std::vector<T>>>& ws)
 {
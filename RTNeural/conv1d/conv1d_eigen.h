@@ -39,9 +39,20 @@ public:
     /** Resets the layer state. */
     RTNEURAL_REALTIME void reset() override;
 
+    /** Returns the number of values in the layer state. */
+    size_t getStateSize() const noexcept override { return (size_t)(state_size * Layer<T>::in_size); }
+
+    /** Copies the past inputs into `state`, from oldest to newest. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept override;
+
+    /** Restores the past inputs from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept override;
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "conv1d"; }
 
+    size_t getNumMACs() const noexcept override { return (size_t)(Layer<T>::out_size * filters_per_group * kernel_size); }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const T* input, T* h) noexcept override
     {
@@ -60,7 +71,7 @@ public:
 
             // perform a multichannel convolution
             for(int i = 0; i < Layer<T>::out_size; ++i)
-                h[i] = state_cols.cwiseProduct(kernelWeights[i]).sum() + bias(i);
+                h[i] = state_cols.cwiseProduct(kernelWeights.middleCols(i * kernel_size, kernel_size)).sum() + bias(i);
         }
         else
         {
@@ -72,13 +83,50 @@ public:
                 for(int k = 0; k < kernel_size; ++k)
                     state_cols.col(k) = state.col(state_ptrs(k))(Eigen::seqN(ii, filters_per_group));
 
-                h[i] = state_cols.cwiseProduct(kernelWeights[i]).sum() + bias(i);
+                h[i] = state_cols.cwiseProduct(kernelWeights.middleCols(i * kernel_size, kernel_size)).sum() + bias(i);
             }
         }
 
         state_ptr = (state_ptr == state_size - 1 ? 0 : state_ptr + 1); // iterate state pointer forwards
     }
 
+    /**
+     * Performs forward propagation for a block of frames.
+     *
+     * For non-grouped convolutions, the dilated input history for each
+     * chunk of frames is unrolled into an "im2col" matrix, so that the
+     * whole chunk is computed with a single matrix-matrix product.
+     * Grouped convolutions are processed frame-by-frame.
+     */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* h, int numSamples) noexcept override
+    {
+        if(groups != 1)
+        {
+            // the frames in the block are not guaranteed to be aligned,
+            // so the inputs are copied through an aligned scratch buffer.
+            for(int n = 0; n < numSamples; ++n)
+            {
+                const auto* frameIn = input + n * Layer<T>::in_size;
+                std::copy(frameIn, frameIn + Layer<T>::in_size, inFrame.data());
+                Conv1D::forward(inFrame.data(), h + n * Layer<T>::out_size);
+            }
+            return;
+        }
+
+        for(int offset = 0; offset < numSamples; offset += im2col_block_size)
+        {
+            const auto blockSize = std::min((int)im2col_block_size, numSamples - offset);
+            const auto inBlock = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(input + offset * Layer<T>::in_size, Layer<T>::in_size, blockSize);
+            auto outBlock = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(h + offset * Layer<T>::out_size, Layer<T>::out_size, blockSize);
+
+            fillIm2Col(inBlock, blockSize);
+            outBlock.noalias() = packedWeights * im2col.leftCols(blockSize);
+            outBlock.colwise() += bias;
+
+            pushToState(inBlock, blockSize);
+        }
+    }
+
     /**
      * Sets the layer weights.
      *
@@ -102,7 +150,18 @@ public:
     /** Returns the number of "groups" in the convolution. */
     int getGroups() const noexcept { return groups; }
 
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+    }
+
 private:
+    using mat_type = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>, RTNeuralEigenAlignment>;
+    using vec_type = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>, RTNeuralEigenAlignment>;
+
     const int dilation_rate;
     const int kernel_size;
     const int state_size;
@@ -110,20 +169,67 @@ private:
     const int filters_per_group;
     const int channels_per_group;
 
-    std::vector<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>> kernelWeights;
-    Eigen::Vector<T, Eigen::Dynamic> bias;
+    // im2col matrix width used for block processing
+    static constexpr int im2col_block_size = RTNEURAL_MODELT_BLOCK_SIZE;
+
+    size_t getMemoryBytes() const noexcept;
+
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept;
+
+    MemoryArena memory;
 
-    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> state;
-    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> state_cols;
-    Eigen::VectorXi state_ptrs;
+    // kernel weights stored as [filters_per_group][out_size * kernel_size],
+    // so that the kernel for output i starts at column i * kernel_size
+    mat_type kernelWeights { nullptr, 0, 0 };
+    vec_type bias { nullptr, 0 };
+
+    mat_type state { nullptr, 0, 0 };
+    mat_type state_cols { nullptr, 0, 0 };
+    Eigen::Map<Eigen::VectorXi, RTNeuralEigenAlignment> state_ptrs { nullptr, 0 };
     int state_ptr = 0;
 
+    vec_type inFrame { nullptr, 0 };
+
+    // kernel weights packed as [out_size][kernel_size * in_size], and the
+    // matching "im2col" matrix used for block processing
+    mat_type packedWeights { nullptr, 0, 0 };
+    mat_type im2col { nullptr, 0, 0 };
+
     /** Sets pointers to state array columns. */
     inline void setStatePointers()
     {
         for(int k = 0; k < kernel_size; ++k)
             state_ptrs[k] = (state_ptr + state_size - k * dilation_rate) % state_size;
     }
+
+    /** Unrolls the dilated input history for a block of frames into the im2col matrix. */
+    template <typename BlockType>
+    inline void fillIm2Col(const BlockType& inBlock, int numFrames) noexcept
+    {
+        const auto in_size = Layer<T>::in_size;
+        for(int n = 0; n < numFrames; ++n)
+        {
+            for(int k = 0; k < kernel_size; ++k)
+            {
+                const auto delay = k * dilation_rate;
+                if(delay <= n)
+                    im2col.block(k * in_size, n, in_size, 1) = inBlock.col(n - delay);
+                else // this sample was received before the block, so it lives in the state buffer
+                    im2col.block(k * in_size, n, in_size, 1) = state.col((state_ptr + state_size - (delay - n)) % state_size);
+            }
+        }
+    }
+
+    /** Writes a block of frames into the state buffer, as if they had been processed one at a time. */
+    template <typename BlockType>
+    inline void pushToState(const BlockType& inBlock, int numFrames) noexcept
+    {
+        for(int n = std::max(numFrames - state_size, 0); n < numFrames; ++n)
+            state.col((state_ptr + n) % state_size) = inBlock.col(n);
+
+        state_ptr = (state_ptr + numFrames) % state_size;
+    }
 };
 
 //====================================================
@@ -174,6 +280,15 @@ public:
     /** Resets the layer state. */
     RTNEURAL_REALTIME void reset();
 
+    /** Returns the number of values in the layer state. */
+    static constexpr size_t getStateSize() noexcept { return (size_t)(state_size * in_size); }
+
+    /** Copies the past inputs into `state`, from oldest to newest. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept;
+
+    /** Restores the past inputs from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept;
+
     /** Performs forward propagation for this layer. */
     template <int _groups = groups, std::enable_if_t<_groups == 1, bool> = true>
     RTNEURAL_REALTIME inline void forward(const Eigen::Matrix<T, in_size, 1>& ins) noexcept
@@ -219,6 +334,45 @@ public:
         state_ptr = (state_ptr == state_size - 1 ? 0 : state_ptr + 1); // iterate state pointer forwards
     }
 
+    /**
+     * Performs forward propagation for a block of frames.
+     *
+     * The dilated input history for each chunk of frames is unrolled into
+     * an "im2col" matrix, so that the whole chunk is computed with a single
+     * matrix-matrix product.
+     */
+    template <int _groups = groups, std::enable_if_t<_groups == 1, bool> = true>
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        for(int offset = 0; offset < numFrames; offset += im2col_block_size)
+        {
+            const auto blockSize = std::min((int)im2col_block_size, numFrames - offset);
+            const auto inBlock = Eigen::Map<const Eigen::Matrix<T, in_size, Eigen::Dynamic>>(ins + offset * in_size, in_size, blockSize);
+            auto outBlock = Eigen::Map<Eigen::Matrix<T, out_size, Eigen::Dynamic>>(out + offset * out_size, out_size, blockSize);
+
+            // unroll the dilated input history into the im2col matrix
+            for(int n = 0; n < blockSize; ++n)
+            {
+                for(int k = 0; k < kernel_length; ++k)
+                {
+                    const auto delay = k * dilation_rate;
+                    if(delay <= n)
+                        im2col.template block<in_size, 1>(k * in_size, n) = inBlock.col(n - delay);
+                    else // this sample was received before the block, so it lives in the state buffer
+                        im2col.template block<in_size, 1>(k * in_size, n) = state.col((state_ptr + state_size - (delay - n)) % state_size);
+                }
+            }
+
+            outBlock.noalias() = packedWeights * im2col.leftCols(blockSize);
+            outBlock.colwise() += bias;
+
+            // write the inputs into the state buffer, as if they had been processed one at a time
+            for(int n = std::max(blockSize - state_size, 0); n < blockSize; ++n)
+                state.col((state_ptr + n) % state_size) = inBlock.col(n);
+            state_ptr = (state_ptr + blockSize) % state_size;
+        }
+    }
+
     /**
      * Sets the layer weights.
      *
@@ -261,6 +415,12 @@ private:
     weights_type weights[out_size];
     vec_type bias;
 
+    // kernel weights packed as [out_size][kernel_size * in_size], and the
+    // matching "im2col" matrix used for block processing
+    static constexpr int im2col_block_size = RTNEURAL_MODELT_BLOCK_SIZE;
+    Eigen::Matrix<T, out_size, Eigen::Dynamic> packedWeights;
+    Eigen::Matrix<T, filters_per_group * kernel_size, Eigen::Dynamic> im2col;
+
     /** Sets pointers to state array columns. */
     inline void setStatePointers()
     {
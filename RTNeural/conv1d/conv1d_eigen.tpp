@@ -13,14 +13,9 @@ Conv1D<T>::Conv1D(int in_size, int out_size, int kernel_size, int dilation, int
     , filters_per_group(in_size / groups)
     , channels_per_group(out_size / groups)
 {
-    kernelWeights.resize(out_size);
-    for(int i = 0; i < out_size; ++i)
-        kernelWeights[i] = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(filters_per_group, kernel_size);
-
-    bias = Eigen::Vector<T, Eigen::Dynamic>::Zero(out_size);
-    state = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(in_size, state_size);
-    state_cols = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(filters_per_group, kernel_size);
-    state_ptrs = Eigen::Vector<int, Eigen::Dynamic>::Zero(kernel_size);
+    // the arena memory starts zeroed
+    memory = MemoryArena(getMemoryBytes());
+    bindMemory();
 }
 
 template <typename T>
@@ -44,6 +39,38 @@ Conv1D<T>& Conv1D<T>::operator=(const Conv1D<T>& other)
 template <typename T>
 Conv1D<T>::~Conv1D() = default;
 
+template <typename T>
+size_t Conv1D<T>::getMemoryBytes() const noexcept
+{
+    const auto in_size = Layer<T>::in_size;
+    const auto out_size = Layer<T>::out_size;
+    return MemoryArena::getBytes<T>((size_t)(filters_per_group * out_size * kernel_size))
+        + MemoryArena::getBytes<T>((size_t)out_size)
+        + MemoryArena::getBytes<T>((size_t)(in_size * state_size))
+        + MemoryArena::getBytes<T>((size_t)(filters_per_group * kernel_size))
+        + MemoryArena::getBytes<int>((size_t)kernel_size)
+        + MemoryArena::getBytes<T>((size_t)in_size)
+        + MemoryArena::getBytes<T>((size_t)(out_size * filters_per_group * kernel_size))
+        + MemoryArena::getBytes<T>((size_t)(filters_per_group * kernel_size * im2col_block_size));
+}
+
+template <typename T>
+void Conv1D<T>::bindMemory() noexcept
+{
+    const auto in_size = Layer<T>::in_size;
+    const auto out_size = Layer<T>::out_size;
+
+    memory.rewind();
+    memory.allocateMap(kernelWeights, filters_per_group, out_size * kernel_size);
+    memory.allocateMap(bias, out_size, 1);
+    memory.allocateMap(state, in_size, state_size);
+    memory.allocateMap(state_cols, filters_per_group, kernel_size);
+    memory.allocateMap(state_ptrs, kernel_size, 1);
+    memory.allocateMap(inFrame, in_size, 1);
+    memory.allocateMap(packedWeights, out_size, filters_per_group * kernel_size);
+    memory.allocateMap(im2col, filters_per_group * kernel_size, im2col_block_size);
+}
+
 template <typename T>
 void Conv1D<T>::reset()
 {
@@ -53,13 +80,36 @@ void Conv1D<T>::reset()
     state.setZero();
 }
 
+template <typename T>
+void Conv1D<T>::saveState(T* stateOut) const noexcept
+{
+    for(int k = 0; k < state_size; ++k)
+    {
+        const auto* col = state.col((state_ptr + k) % state_size).data();
+        stateOut = std::copy(col, col + Layer<T>::in_size, stateOut);
+    }
+}
+
+template <typename T>
+void Conv1D<T>::loadState(const T* stateIn) noexcept
+{
+    for(int k = 0; k < state_size; ++k, stateIn += Layer<T>::in_size)
+        std::copy(stateIn, stateIn + Layer<T>::in_size, state.col(k).data());
+
+    state_ptr = 0;
+}
+
 template <typename T>
 void Conv1D<T>::setWeights(const std::vector<std::vector<std::vector<T>>>& weights)
 {
     for(int i = 0; i < Layer<T>::out_size; ++i)
         for(int k = 0; k < filters_per_group; ++k)
             for(int j = 0; j < kernel_size; ++j)
-                kernelWeights[i](k, j) = weights[i][k][j];
+                kernelWeights(k, i * kernel_size + j) = weights[i][k][j];
+
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+        for(int j = 0; j < kernel_size; ++j)
+            packedWeights.block(i, j * filters_per_group, 1, filters_per_group) = kernelWeights.col(i * kernel_size + j).transpose();
 }
 
 template <typename T>
@@ -79,6 +129,9 @@ Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, groups, dynamic_stat
 
     bias = vec_type::Zero();
 
+    packedWeights = Eigen::Matrix<T, out_size, Eigen::Dynamic>::Zero(out_size, filters_per_group * kernel_size);
+    im2col = Eigen::Matrix<T, filters_per_group * kernel_size, Eigen::Dynamic>::Zero(filters_per_group * kernel_size, im2col_block_size);
+
     resize_state();
     reset();
 }
@@ -92,6 +145,25 @@ void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, groups, dynamic
     state_ptr = 0;
 }
 
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, int groups, bool dynamic_state>
+void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, groups, dynamic_state>::saveState(T* stateOut) const noexcept
+{
+    for(int k = 0; k < state_size; ++k)
+    {
+        const auto* col = state.col((state_ptr + k) % state_size).data();
+        stateOut = std::copy(col, col + in_size, stateOut);
+    }
+}
+
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, int groups, bool dynamic_state>
+void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, groups, dynamic_state>::loadState(const T* stateIn) noexcept
+{
+    for(int k = 0; k < state_size; ++k, stateIn += in_size)
+        std::copy(stateIn, stateIn + in_size, state.col(k).data());
+
+    state_ptr = 0;
+}
+
 template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, int groups, bool dynamic_state>
 void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, groups, dynamic_state>::setWeights(const std::vector<std::vector<std::vector<T>>>& ws)
 {
@@ -99,6 +171,10 @@ void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, groups, dynamic
         for(int k = 0; k < filters_per_group; ++k)
             for(int j = 0; j < kernel_size; ++j)
                 weights[i](k, j) = ws[i][k][j];
+
+    for(int i = 0; i < out_size; ++i)
+        for(int j = 0; j < kernel_size; ++j)
+            packedWeights.template block<1, filters_per_group>(i, j * filters_per_group) = weights[i].col(j).transpose();
 }
 
 template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, int groups, bool dynamic_state>
@@ -42,9 +42,20 @@ public:
     /** Resets the layer state. */
     RTNEURAL_REALTIME void reset() override;
 
+    /** Returns the number of values in the layer state. */
+    size_t getStateSize() const noexcept override { return (size_t)(state_size * Layer<T>::in_size); }
+
+    /** Copies the past inputs into `state`, from oldest to newest. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept override;
+
+    /** Restores the past inputs from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept override;
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "conv1d"; }
 
+    size_t getNumMACs() const noexcept override { return (size_t)(Layer<T>::out_size * filters_per_group * kernel_size); }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const T* input, T* h) noexcept override
     {
@@ -94,6 +105,23 @@ public:
         state_ptr = (state_ptr == state_size - 1 ? 0 : state_ptr + 1); // iterate state pointer forwards
     }
 
+    /**
+     * Performs forward propagation for a block of frames.
+     *
+     * The frames in the block are not guaranteed to be aligned, so they are
+     * copied through aligned scratch buffers.
+     */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* h, int numSamples) noexcept override
+    {
+        for(int n = 0; n < numSamples; ++n)
+        {
+            const auto* frameIn = input + n * Layer<T>::in_size;
+            std::copy(frameIn, frameIn + Layer<T>::in_size, inFrame.begin());
+            Conv1D::forward(inFrame.data(), outFrame.data());
+            std::copy(outFrame.begin(), outFrame.end(), h + n * Layer<T>::out_size);
+        }
+    }
+
     /**
      * Sets the layer weights.
      *
@@ -140,6 +168,9 @@ private:
 
     vec_type prod_state;
 
+    vec_type inFrame;
+    vec_type outFrame;
+
     /** Sets pointers to state array columns. */
     inline void setStatePointers()
     {
@@ -194,6 +225,15 @@ public:
     /** Resets the layer state. */
     RTNEURAL_REALTIME void reset();
 
+    /** Returns the number of values in the layer state. */
+    static constexpr size_t getStateSize() noexcept { return state_detail::getNumValues<T, state_col_type>(state_size); }
+
+    /** Copies the past inputs into `state`, from oldest to newest. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept;
+
+    /** Restores the past inputs from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept;
+
     /** Performs forward propagation for this layer. */
     template <int G = groups>
     RTNEURAL_REALTIME inline typename std::enable_if<(G > 1), void>::type
@@ -19,6 +19,9 @@ Conv1D<T>::Conv1D(int in_size, int out_size, int kernel_size, int dilation, int
     state_cols = vec2_type(kernel_size, vec_type(filters_per_group, (T)0));
     state_ptrs.resize(kernel_size);
     prod_state.resize(filters_per_group);
+
+    inFrame.resize(in_size, (T)0);
+    outFrame.resize(out_size, (T)0);
 }
 
 template <typename T>
@@ -55,6 +58,25 @@ void Conv1D<T>::reset()
     state_ptr = 0;
 }
 
+template <typename T>
+void Conv1D<T>::saveState(T* stateOut) const noexcept
+{
+    for(int k = 0; k < state_size; ++k)
+    {
+        const auto& col = state[(state_ptr + k) % state_size];
+        stateOut = std::copy(col.begin(), col.begin() + Layer<T>::in_size, stateOut);
+    }
+}
+
+template <typename T>
+void Conv1D<T>::loadState(const T* stateIn) noexcept
+{
+    for(int k = 0; k < state_size; ++k, stateIn += Layer<T>::in_size)
+        std::copy(stateIn, stateIn + Layer<T>::in_size, state[k].begin());
+
+    state_ptr = 0;
+}
+
 template <typename T>
 void Conv1D<T>::setWeights(const std::vector<std::vector<std::vector<T>>>& ws)
 {
@@ -106,6 +128,22 @@ void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, groups, dynamic
         state_ptrs[i] = 0;
 }
 
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, int groups, bool dynamic_state>
+void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, groups, dynamic_state>::saveState(T* stateOut) const noexcept
+{
+    for(int k = 0; k < state_size; ++k)
+        stateOut = state_detail::saveValues(&state[(state_ptr + k) % state_size], 1, stateOut);
+}
+
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, int groups, bool dynamic_state>
+void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, groups, dynamic_state>::loadState(const T* stateIn) noexcept
+{
+    for(int k = 0; k < state_size; ++k)
+        stateIn = state_detail::loadValues(&state[k], 1, stateIn);
+
+    state_ptr = 0;
+}
+
 template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, int groups, bool dynamic_state>
 void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, groups, dynamic_state>::setWeights(const std::vector<std::vector<std::vector<T>>>& ws)
 {
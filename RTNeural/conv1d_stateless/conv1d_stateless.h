@@ -71,6 +71,8 @@ public:
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "conv1d_stateless"; }
 
+    size_t getNumMACs() const noexcept override { return (size_t)(num_filters_out * num_features_out * num_filters_in * kernel_size); }
+
     /** Returns false since convolution is not an activation layer. */
     constexpr bool isActivation() const noexcept { return false; }
 
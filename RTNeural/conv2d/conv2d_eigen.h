@@ -45,9 +45,30 @@ public:
         }
     };
 
+    /** Returns the number of values in the layer state. */
+    size_t getStateSize() const noexcept override { return (size_t)receptive_field * state_detail::getBufferSize<T>(state[0]); }
+
+    /** Copies the partially accumulated outputs into `state`, starting with the next output. */
+    RTNEURAL_REALTIME void saveState(T* stateOut) const noexcept override
+    {
+        for(int i = 0; i < receptive_field; ++i)
+            stateOut = state_detail::saveBuffer(state[(state_index + i) % receptive_field], stateOut);
+    }
+
+    /** Restores the partially accumulated outputs from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* stateIn) noexcept override
+    {
+        for(int i = 0; i < receptive_field; ++i)
+            stateIn = state_detail::loadBuffer(state[i], stateIn);
+
+        state_index = 0;
+    }
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "conv2d"; }
 
+    size_t getNumMACs() const noexcept override { return (size_t)(num_filters_out * num_features_out * num_filters_in * kernel_size_time * kernel_size_feature); }
+
     /** Returns false since convolution is not an activation layer. */
     constexpr bool isActivation() const noexcept { return false; }
 
@@ -73,6 +94,23 @@ public:
         state_index = state_index == receptive_field - 1 ? 0 : state_index + 1;
     }
 
+    /**
+     * Performs forward propagation for a block of frames.
+     *
+     * The frames in the block are not guaranteed to be aligned, so they are
+     * copied through aligned scratch buffers.
+     */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* output, int numSamples) noexcept override
+    {
+        for(int n = 0; n < numSamples; ++n)
+        {
+            const auto* frameIn = input + n * Layer<T>::in_size;
+            std::copy(frameIn, frameIn + Layer<T>::in_size, inFrame.data());
+            Conv2D<T>::forward(inFrame.data(), outFrame.data());
+            std::copy(outFrame.data(), outFrame.data() + Layer<T>::out_size, output + n * Layer<T>::out_size);
+        }
+    }
+
     /**
      * Sets the layer weights.
      *
@@ -118,6 +156,9 @@ private:
     int state_index = 0;
 
     Eigen::Vector<T, Eigen::Dynamic> bias;
+
+    Eigen::Vector<T, Eigen::Dynamic> inFrame;
+    Eigen::Vector<T, Eigen::Dynamic> outFrame;
 };
 
 //====================================================
@@ -179,6 +220,25 @@ public:
         }
     };
 
+    /** Returns the number of values in the layer state. */
+    size_t getStateSize() const noexcept { return (size_t)receptive_field * state_detail::getBufferSize<T>(state[0]); }
+
+    /** Copies the partially accumulated outputs into `state`, starting with the next output. */
+    RTNEURAL_REALTIME void saveState(T* stateOut) const noexcept
+    {
+        for(int i = 0; i < receptive_field; ++i)
+            stateOut = state_detail::saveBuffer(state[(state_index + i) % receptive_field], stateOut);
+    }
+
+    /** Restores the partially accumulated outputs from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* stateIn) noexcept
+    {
+        for(int i = 0; i < receptive_field; ++i)
+            stateIn = state_detail::loadBuffer(state[i], stateIn);
+
+        state_index = 0;
+    }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const input_type_flat& inMatrix) noexcept
     {
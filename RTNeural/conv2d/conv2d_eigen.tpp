@@ -21,6 +21,9 @@ Conv2D<T>::Conv2D(int in_num_filters_in, int in_num_filters_out, int in_num_feat
     bias = Eigen::Vector<T, Eigen::Dynamic>::Zero(num_filters_out);
 
     state.resize(receptive_field, Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(num_filters_out, num_features_out));
+
+    inFrame = Eigen::Vector<T, Eigen::Dynamic>::Zero(Layer<T>::in_size);
+    outFrame = Eigen::Vector<T, Eigen::Dynamic>::Zero(Layer<T>::out_size);
 }
 
 template <typename T>
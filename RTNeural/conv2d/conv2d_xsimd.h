@@ -44,9 +44,30 @@ public:
         }
     }
 
+    /** Returns the number of values in the layer state. */
+    size_t getStateSize() const noexcept override { return (size_t)receptive_field * state_detail::getBufferSize<T>(state[0]); }
+
+    /** Copies the partially accumulated outputs into `state`, starting with the next output. */
+    RTNEURAL_REALTIME void saveState(T* stateOut) const noexcept override
+    {
+        for(int i = 0; i < receptive_field; ++i)
+            stateOut = state_detail::saveBuffer(state[(state_index + i) % receptive_field], stateOut);
+    }
+
+    /** Restores the partially accumulated outputs from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* stateIn) noexcept override
+    {
+        for(int i = 0; i < receptive_field; ++i)
+            stateIn = state_detail::loadBuffer(state[i], stateIn);
+
+        state_index = 0;
+    }
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "conv2d"; }
 
+    size_t getNumMACs() const noexcept override { return (size_t)(num_filters_out * num_features_out * num_filters_in * kernel_size_time * kernel_size_feature); }
+
     /** Returns false since convolution is not an activation layer. */
     constexpr bool isActivation() const noexcept { return false; }
 
@@ -181,6 +202,25 @@ public:
         }
     }
 
+    /** Returns the number of values in the layer state. */
+    size_t getStateSize() const noexcept { return (size_t)receptive_field * state_detail::getBufferSize<T>(state[0]); }
+
+    /** Copies the partially accumulated outputs into `state`, starting with the next output. */
+    RTNEURAL_REALTIME void saveState(T* stateOut) const noexcept
+    {
+        for(int i = 0; i < receptive_field; ++i)
+            stateOut = state_detail::saveBuffer(state[(state_index + i) % receptive_field], stateOut);
+    }
+
+    /** Restores the partially accumulated outputs from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* stateIn) noexcept
+    {
+        for(int i = 0; i < receptive_field; ++i)
+            stateIn = state_detail::loadBuffer(state[i], stateIn);
+
+        state_index = 0;
+    }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const v_type (&ins)[v_in_size]) noexcept
     {
@@ -16,45 +16,6 @@
 namespace RTNEURAL_NAMESPACE
 {
 
-#ifndef DOXYGEN
-/** Single-output dense layer used internally */
-template <typename T>
-class Dense1
-{
-public:
-    explicit Dense1(int in_size)
-        : in_size(in_size)
-    {
-        weights = new T[in_size];
-    }
-
-    ~Dense1() { delete[] weights; }
-
-    RTNEURAL_REALTIME inline T forward(const T* input) noexcept
-    {
-        return std::inner_product(weights, weights + in_size, input, (T)0) + bias;
-    }
-
-    RTNEURAL_REALTIME void setWeights(const T* newWeights)
-    {
-        for(int i = 0; i < in_size; ++i)
-            weights[i] = newWeights[i];
-    }
-
-    RTNEURAL_REALTIME void setBias(T b) { bias = b; }
-
-    RTNEURAL_REALTIME T getWeight(int i) const noexcept { return weights[i]; }
-
-    RTNEURAL_REALTIME T getBias() const noexcept { return bias; }
-
-private:
-    const int in_size;
-    T bias;
-
-    T* weights;
-};
-#endif // DOXYGEN
-
 /**
  * Dynamic implementation of a fully-connected (dense) layer,
  * with no activation.
@@ -66,10 +27,11 @@ public:
     /** Constructs a dense layer for a given input and output size. */
     Dense(int in_size, int out_size)
         : Layer<T>(in_size, out_size)
+        , memory(getMemoryBytes(in_size, out_size))
     {
-        subLayers = new Dense1<T>*[out_size];
-        for(int i = 0; i < out_size; ++i)
-            subLayers[i] = new Dense1<T>(in_size);
+        bindMemory();
+        std::fill(weights, weights + in_size * out_size, (T)0);
+        std::fill(bias, bias + out_size, (T)0);
     }
 
     Dense(std::initializer_list<int> sizes)
@@ -87,22 +49,32 @@ public:
         return *this = Dense(other);
     }
 
-    virtual ~Dense()
-    {
-        for(int i = 0; i < Layer<T>::out_size; ++i)
-            delete subLayers[i];
-
-        delete[] subLayers;
-    }
+    virtual ~Dense() = default;
 
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "dense"; }
 
+    size_t getNumMACs() const noexcept override { return (size_t)(Layer<T>::in_size * Layer<T>::out_size); }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const T* input, T* out) noexcept override
     {
         for(int i = 0; i < Layer<T>::out_size; ++i)
-            out[i] = subLayers[i]->forward(input);
+            out[i] = std::inner_product(input, input + Layer<T>::in_size, weights + i * Layer<T>::in_size, (T)0) + bias[i];
+    }
+
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+        {
+            const auto* row = weights + i * Layer<T>::in_size;
+            for(int n = 0; n < numSamples; ++n)
+            {
+                const auto* frameIn = input + n * Layer<T>::in_size;
+                out[n * Layer<T>::out_size + i] = std::inner_product(frameIn, frameIn + Layer<T>::in_size, row, (T)0) + bias[i];
+            }
+        }
     }
 
     /**
@@ -114,7 +86,7 @@ public:
     RTNEURAL_REALTIME void setWeights(const std::vector<std::vector<T>>& newWeights)
     {
         for(int i = 0; i < Layer<T>::out_size; ++i)
-            subLayers[i]->setWeights(newWeights[i].data());
+            std::copy(newWeights[i].begin(), newWeights[i].begin() + Layer<T>::in_size, weights + i * Layer<T>::in_size);
     }
 
     /**
@@ -126,7 +98,7 @@ public:
     RTNEURAL_REALTIME void setWeights(T** newWeights)
     {
         for(int i = 0; i < Layer<T>::out_size; ++i)
-            subLayers[i]->setWeights(newWeights[i]);
+            std::copy(newWeights[i], newWeights[i] + Layer<T>::in_size, weights + i * Layer<T>::in_size);
     }
 
     /**
@@ -135,21 +107,43 @@ public:
      */
     RTNEURAL_REALTIME void setBias(const T* b)
     {
-        for(int i = 0; i < Layer<T>::out_size; ++i)
-            subLayers[i]->setBias(b[i]);
+        std::copy(b, b + Layer<T>::out_size, bias);
     }
 
     /** Returns the weights value at the given indices. */
     RTNEURAL_REALTIME T getWeight(int i, int k) const noexcept
     {
-        return subLayers[i]->getWeight(k);
+        return weights[i * Layer<T>::in_size + k];
     }
 
     /** Returns the bias value at the given index. */
-    RTNEURAL_REALTIME T getBias(int i) const noexcept { return subLayers[i]->getBias(); }
+    RTNEURAL_REALTIME T getBias(int i) const noexcept { return bias[i]; }
+
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+    }
 
 private:
-    Dense1<T>** subLayers;
+    static size_t getMemoryBytes(int in_size, int out_size) noexcept
+    {
+        return MemoryArena::getBytes<T>((size_t)(in_size * out_size)) + MemoryArena::getBytes<T>((size_t)out_size);
+    }
+
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept
+    {
+        memory.rewind();
+        weights = memory.allocate<T>((size_t)(Layer<T>::in_size * Layer<T>::out_size));
+        bias = memory.allocate<T>((size_t)Layer<T>::out_size);
+    }
+
+    MemoryArena memory;
+    T* weights = nullptr;
+    T* bias = nullptr;
 };
 
 //====================================================
@@ -194,6 +188,15 @@ public:
             outs[i] = std::inner_product(ins, ins + in_size, &weights[i * in_size], (T)0) + bias[i];
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        // loop over the frames in the inner loop, so that each row of weights is re-used across the block
+        for(int i = 0; i < out_size; ++i)
+            for(int n = 0; n < numFrames; ++n)
+                out[n * out_size + i] = std::inner_product(ins + n * in_size, ins + (n + 1) * in_size, &weights[i * in_size], (T)0) + bias[i];
+    }
+
     /**
      * Sets the layer weights from a given vector.
      *
@@ -2,6 +2,7 @@
 #define DENSEEIGEN_H_INCLUDED
 
 #include "../Layer.h"
+#include "../common.h"
 #include "../config.h"
 #include <Eigen/Dense>
 
@@ -19,12 +20,9 @@ public:
     /** Constructs a dense layer for a given input and output size. */
     Dense(int in_size, int out_size)
         : Layer<T>(in_size, out_size)
+        , memory(getMemoryBytes(in_size, out_size))
     {
-        weights = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(out_size, in_size + 1);
-
-        inVec = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(in_size + 1);
-        outVec = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(out_size);
-
+        bindMemory();
         inVec(in_size, 0) = (T)1;
     }
 
@@ -48,6 +46,8 @@ public:
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "dense"; }
 
+    size_t getNumMACs() const noexcept override { return (size_t)(Layer<T>::in_size * Layer<T>::out_size); }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const T* input, T* out) noexcept override
     {
@@ -64,6 +64,18 @@ public:
             out[i] = outVec(i, 0);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        auto inMat = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(
+            input, Layer<T>::in_size, numSamples);
+        auto outMat = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(
+            out, Layer<T>::out_size, numSamples);
+
+        outMat.noalias() = weights.leftCols(Layer<T>::in_size) * inMat;
+        outMat.colwise() += weights.col(Layer<T>::in_size);
+    }
+
     /**
      * Sets the layer weights from a given vector.
      *
@@ -106,11 +118,40 @@ public:
     /** Returns the bias value at the given index. */
     RTNEURAL_REALTIME T getBias(int i) const noexcept { return weights(i, Layer<T>::in_size); }
 
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+    }
+
 private:
-    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> weights;
+    using mat_type = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>, RTNeuralEigenAlignment>;
+    using vec_type = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>, RTNeuralEigenAlignment>;
 
-    Eigen::Matrix<T, Eigen::Dynamic, 1> inVec;
-    Eigen::Matrix<T, Eigen::Dynamic, 1> outVec;
+    static size_t getMemoryBytes(int in_size, int out_size) noexcept
+    {
+        return MemoryArena::getBytes<T>((size_t)(out_size * (in_size + 1)))
+            + MemoryArena::getBytes<T>((size_t)(in_size + 1))
+            + MemoryArena::getBytes<T>((size_t)out_size);
+    }
+
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept
+    {
+        memory.rewind();
+        memory.allocateMap(weights, Layer<T>::out_size, Layer<T>::in_size + 1);
+        memory.allocateMap(inVec, Layer<T>::in_size + 1, 1);
+        memory.allocateMap(outVec, Layer<T>::out_size, 1);
+    }
+
+    MemoryArena memory;
+
+    mat_type weights { nullptr, 0, 0 };
+
+    vec_type inVec { nullptr, 0 };
+    vec_type outVec { nullptr, 0 };
 };
 
 //====================================================
@@ -160,6 +201,19 @@ public:
         outs.noalias() = weights * ins_internal;
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        const auto inBlock = Eigen::Map<const Eigen::Matrix<T, in_size, Eigen::Dynamic>>(ins, in_size, numFrames);
+        auto outBlock = Eigen::Map<Eigen::Matrix<T, out_size, Eigen::Dynamic>>(out, out_size, numFrames);
+
+        /**
+         * | out_0 ... out_N | = w * | input_0 ... input_N | + b
+         */
+        outBlock.noalias() = weights.template leftCols<in_size>() * inBlock;
+        outBlock.colwise() += weights.col(in_size);
+    }
+
     /**
      * Sets the layer weights from a given vector.
      *
@@ -47,6 +47,8 @@ public:
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "dense"; }
 
+    size_t getNumMACs() const noexcept override { return (size_t)(Layer<T>::in_size * Layer<T>::out_size); }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const T* input, T* out) noexcept override
     {
@@ -61,6 +63,58 @@ public:
         }
     }
 
+    /**
+     * Performs forward propagation for a block of frames, as one
+     * matrix-matrix product. Four frames are computed at a time, so that
+     * each batch of weights is loaded once for all four frames.
+     */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* out, int numSamples) noexcept override
+    {
+        using b_type = xsimd::simd_type<T>;
+        constexpr auto inc = (int)b_type::size;
+        constexpr int numFrames = 4;
+
+        const auto inSize = Layer<T>::in_size;
+        const auto outSize = Layer<T>::out_size;
+        const auto vec_size = inSize - inSize % inc;
+
+        int n = 0;
+        for(; n + numFrames <= numSamples; n += numFrames)
+        {
+            const T* frameIn[numFrames];
+            for(int j = 0; j < numFrames; ++j)
+                frameIn[j] = input + (n + j) * inSize;
+
+            for(int l = 0; l < outSize; ++l)
+            {
+                const auto* w = weights[l].data();
+
+                b_type acc[numFrames];
+                for(int j = 0; j < numFrames; ++j)
+                    acc[j] = b_type((T)0);
+
+                for(int k = 0; k < vec_size; k += inc)
+                {
+                    const auto wVec = xsimd::load_aligned(w + k);
+                    for(int j = 0; j < numFrames; ++j)
+                        acc[j] = xsimd::fma(xsimd::load_unaligned(frameIn[j] + k), wVec, acc[j]);
+                }
+
+                for(int j = 0; j < numFrames; ++j)
+                {
+                    auto sum = xsimd::reduce_add(acc[j]);
+                    for(int k = vec_size; k < inSize; ++k)
+                        sum += frameIn[j][k] * w[k];
+                    out[(n + j) * outSize + l] = sum + bias[l];
+                }
+            }
+        }
+
+        // remaining frames
+        for(; n < numSamples; ++n)
+            forward(input + n * inSize, out + n * outSize);
+    }
+
     /**
      * Sets the layer weights from a given vector.
      *
@@ -172,6 +226,25 @@ public:
         }
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const v_type* ins, v_type* out, int numFrames) noexcept
+    {
+        for(int n = 0; n < numFrames; ++n)
+            for(int i = 0; i < v_out_size; ++i)
+                out[n * v_out_size + i] = bias[i];
+
+        // accumulate one input element at a time, so that each row of weights is re-used across the block
+        for(int k = 0; k < in_size; ++k)
+        {
+            for(int n = 0; n < numFrames; ++n)
+            {
+                const auto in = v_type(reinterpret_cast<const T*>(ins + n * v_in_size)[k]);
+                for(int i = 0; i < v_out_size; ++i)
+                    out[n * v_out_size + i] += in * weights[k][i];
+            }
+        }
+    }
+
     /**
      * Sets the layer weights from a given vector.
      *
@@ -260,6 +333,20 @@ public:
         outs[0] = v_type(xsimd::reduce_add(y) + bias);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const v_type* ins, v_type* out, int numFrames) noexcept
+    {
+        for(int n = 0; n < numFrames; ++n)
+        {
+            const auto* frameIn = ins + n * v_in_size;
+            v_type y {};
+            for(int k = 0; k < v_in_size; ++k)
+                y += frameIn[k] * weights[k];
+
+            out[n] = v_type(xsimd::reduce_add(y) + bias);
+        }
+    }
+
     RTNEURAL_REALTIME void setWeights(const std::vector<std::vector<T>>& newWeights)
     {
         for(int i = 0; i < out_size; ++i)
@@ -343,6 +430,17 @@ public:
             outs[i] += in * weights[i];
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const v_type* ins, v_type* out, int numFrames) noexcept
+    {
+        for(int n = 0; n < numFrames; ++n)
+        {
+            const auto in = ins[n].get(0);
+            for(int i = 0; i < v_out_size; ++i)
+                out[n * v_out_size + i] = bias[i] + in * weights[i];
+        }
+    }
+
     /**
      * Sets the layer weights from a given vector.
      *
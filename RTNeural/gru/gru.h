@@ -36,14 +36,25 @@ public:
     GRULayer(std::initializer_list<int> sizes);
     GRULayer(const GRULayer& other);
     GRULayer& operator=(const GRULayer& other);
-    virtual ~GRULayer();
+    virtual ~GRULayer() = default;
 
     /** Resets the state of the GRU. */
     RTNEURAL_REALTIME void reset() override { std::fill(ht1, ht1 + Layer<T>::out_size, (T)0); }
 
+    /** Returns the number of values in the GRU state. */
+    size_t getStateSize() const noexcept override { return (size_t)Layer<T>::out_size; }
+
+    /** Copies the GRU state into `state`. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept override { std::copy(ht1, ht1 + Layer<T>::out_size, state); }
+
+    /** Restores the GRU state from `state`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept override { std::copy(state, state + Layer<T>::out_size, ht1); }
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "gru"; }
 
+    size_t getNumMACs() const noexcept override { return (size_t)(3 * Layer<T>::out_size * (Layer<T>::in_size + Layer<T>::out_size)); }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const T* input, T* h) noexcept override
     {
@@ -58,6 +69,13 @@ public:
         std::copy(h, h + Layer<T>::out_size, ht1);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* h, int numSamples) noexcept override
+    {
+        for(int n = 0; n < numSamples; ++n)
+            GRULayer::forward(input + n * Layer<T>::in_size, h + n * Layer<T>::out_size);
+    }
+
     /**
      * Sets the layer kernel weights.
      *
@@ -109,28 +127,48 @@ public:
     /** Returns the bias value for the given indices. */
     RTNEURAL_REALTIME T getBVal(int i, int k) const noexcept;
 
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+    }
+
 protected:
-    T* ht1;
+    T* ht1 = nullptr;
 
     /** Struct to hold layer weights (used internally) */
     struct WeightSet
     {
-        WeightSet(int in_size, int out_size);
-        ~WeightSet();
+        explicit WeightSet(int out_size)
+            : out_size(out_size)
+        {
+        }
+
+        static size_t getMemoryBytes(int in_size, int out_size) noexcept;
+        void bindMemory(MemoryArena& memory, int in_size) noexcept;
 
-        T** W; // kernel weights
-        T** U; // recurrent weights
-        T** b; // bias
+        T** W = nullptr; // kernel weights
+        T** U = nullptr; // recurrent weights
+        T** b = nullptr; // bias
         const int out_size;
     };
 
+    static size_t getMemoryBytes(int in_size, int out_size) noexcept;
+
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept;
+
+    MemoryArena memory;
+
     WeightSet zWeights;
     WeightSet rWeights;
     WeightSet cWeights;
 
-    T* zVec;
-    T* rVec;
-    T* cVec;
+    T* zVec = nullptr;
+    T* rVec = nullptr;
+    T* cVec = nullptr;
 
     static constexpr int kNumBiasLayers { 2 };
 };
@@ -174,6 +212,23 @@ public:
     /** Resets the state of the GRU. */
     RTNEURAL_REALTIME void reset();
 
+    /** Returns the number of values in the GRU state, including the sample rate correction delay line. */
+    size_t getStateSize() const noexcept { return (size_t)out_size + state_detail::getBufferSize<T>(outs_delayed); }
+
+    /** Copies the GRU state into `state`, which must hold `getStateSize()` values. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept
+    {
+        state = state_detail::saveValues(outs, out_size, state);
+        state_detail::saveBuffer(outs_delayed, state);
+    }
+
+    /** Restores the GRU state from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept
+    {
+        state = state_detail::loadValues(outs, out_size, state);
+        state_detail::loadBuffer(outs_delayed, state);
+    }
+
     /** Performs forward propagation for this layer. */
     template <int N = in_size>
     RTNEURAL_REALTIME inline typename std::enable_if<(N > 1), void>::type
@@ -223,6 +278,63 @@ public:
         computeOutput();
     }
 
+    /**
+     * Performs forward propagation for a block of frames.
+     *
+     * The kernel products (W * x) don't depend on the recurrent state,
+     * so they are computed for a whole chunk of frames up front, and
+     * only the recurrent products are computed frame-by-frame.
+     */
+    template <int N = in_size>
+    RTNEURAL_REALTIME inline typename std::enable_if<(N > 1), void>::type
+    forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        for(int offset = 0; offset < numFrames; offset += kernel_block_size)
+        {
+            const auto blockSize = std::min((int)kernel_block_size, numFrames - offset);
+            kernel_block_mat_mul(ins + offset * in_size, Wz, kernel_block.data(), blockSize);
+            kernel_block_mat_mul(ins + offset * in_size, Wr, kernel_block.data() + out_size, blockSize);
+            kernel_block_mat_mul(ins + offset * in_size, Wh, kernel_block.data() + 2 * out_size, blockSize);
+
+            for(int n = 0; n < blockSize; ++n)
+            {
+                const auto* kernel_z = kernel_block.data() + n * 3 * out_size;
+                const auto* kernel_r = kernel_z + out_size;
+                const auto* kernel_h = kernel_z + 2 * out_size;
+
+                // compute zt
+                recurrent_mat_mul(outs, Uz, zt);
+                for(int i = 0; i < out_size; ++i)
+                    zt[i] = MathsProvider::sigmoid(zt[i] + bz[i] + kernel_z[i]);
+
+                // compute rt
+                recurrent_mat_mul(outs, Ur, rt);
+                for(int i = 0; i < out_size; ++i)
+                    rt[i] = MathsProvider::sigmoid(rt[i] + br[i] + kernel_r[i]);
+
+                // compute h_hat
+                recurrent_mat_mul(outs, Uh, ct);
+                for(int i = 0; i < out_size; ++i)
+                    ht[i] = MathsProvider::tanh(rt[i] * (ct[i] + bh1[i]) + bh0[i] + kernel_h[i]);
+
+                computeOutput();
+                std::copy(outs, outs + out_size, out + (offset + n) * out_size);
+            }
+        }
+    }
+
+    /** Performs forward propagation for a block of frames. */
+    template <int N = in_size>
+    RTNEURAL_REALTIME inline typename std::enable_if<N == 1, void>::type
+    forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        for(int n = 0; n < numFrames; ++n)
+        {
+            forward(reinterpret_cast<const T(&)[in_size]>(ins[n]));
+            std::copy(outs, outs + out_size, out + n * out_size);
+        }
+    }
+
     /**
      * Sets the layer kernel weights.
      *
@@ -305,6 +417,14 @@ private:
             out[j] = std::inner_product(mat[j], mat[j] + in_size, vec, (T)0);
     }
 
+    /** Computes the kernel products for a block of frames, with a stride of 3 * out_size between frames. */
+    static inline void kernel_block_mat_mul(const T* ins, const T (&mat)[out_size][in_size], T* out, int numFrames) noexcept
+    {
+        for(int j = 0; j < out_size; ++j)
+            for(int n = 0; n < numFrames; ++n)
+                out[n * 3 * out_size + j] = std::inner_product(mat[j], mat[j] + in_size, ins + n * in_size, (T)0);
+    }
+
     // kernel weights
     T Wr alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size][in_size];
     T Wz alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size][in_size];
@@ -333,6 +453,10 @@ private:
     T ct alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
     T ht alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
 
+    // kernel products for block processing
+    static constexpr int kernel_block_size = RTNEURAL_MODELT_BLOCK_SIZE;
+    std::vector<T> kernel_block;
+
     // needed for delays when doing sample rate correction
     std::vector<std::array<T, out_size>> outs_delayed;
     int delayWriteIdx = 0;
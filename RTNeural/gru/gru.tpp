@@ -7,14 +7,12 @@ namespace RTNEURAL_NAMESPACE
 template <typename T, typename MathsProvider>
 GRULayer<T, MathsProvider>::GRULayer(int in_size, int out_size)
     : Layer<T>(in_size, out_size)
-    , zWeights(in_size, out_size)
-    , rWeights(in_size, out_size)
-    , cWeights(in_size, out_size)
+    , memory(getMemoryBytes(in_size, out_size))
+    , zWeights(out_size)
+    , rWeights(out_size)
+    , cWeights(out_size)
 {
-    ht1 = new T[out_size];
-    zVec = new T[out_size];
-    rVec = new T[out_size];
-    cVec = new T[out_size];
+    bindMemory();
 }
 
 template <typename T, typename MathsProvider>
@@ -38,51 +36,51 @@ GRULayer<T, MathsProvider>& GRULayer<T, MathsProvider>::operator=(const GRULayer
 }
 
 template <typename T, typename MathsProvider>
-GRULayer<T, MathsProvider>::~GRULayer()
+size_t GRULayer<T, MathsProvider>::getMemoryBytes(int in_size, int out_size) noexcept
 {
-    delete[] ht1;
-    delete[] zVec;
-    delete[] rVec;
-    delete[] cVec;
+    return 3 * WeightSet::getMemoryBytes(in_size, out_size) + 4 * MemoryArena::getBytes<T>((size_t)out_size);
 }
 
 template <typename T, typename MathsProvider>
-GRULayer<T, MathsProvider>::WeightSet::WeightSet(int in_size, int out_size)
-    : out_size(out_size)
+void GRULayer<T, MathsProvider>::bindMemory() noexcept
 {
-    W = new T*[out_size];
-    U = new T*[out_size];
-    b = new T*[kNumBiasLayers];
-
-    for(int i = 0; i < kNumBiasLayers; ++i)
-    {
-        b[i] = new T[out_size];
-    }
+    memory.rewind();
+    zWeights.bindMemory(memory, Layer<T>::in_size);
+    rWeights.bindMemory(memory, Layer<T>::in_size);
+    cWeights.bindMemory(memory, Layer<T>::in_size);
+
+    ht1 = memory.allocate<T>((size_t)Layer<T>::out_size);
+    zVec = memory.allocate<T>((size_t)Layer<T>::out_size);
+    rVec = memory.allocate<T>((size_t)Layer<T>::out_size);
+    cVec = memory.allocate<T>((size_t)Layer<T>::out_size);
+}
 
-    for(int i = 0; i < out_size; ++i)
-    {
-        W[i] = new T[in_size];
-        U[i] = new T[out_size];
-    }
+template <typename T, typename MathsProvider>
+size_t GRULayer<T, MathsProvider>::WeightSet::getMemoryBytes(int in_size, int out_size) noexcept
+{
+    return 2 * MemoryArena::getBytes<T*>((size_t)out_size)
+        + MemoryArena::getBytes<T*>((size_t)kNumBiasLayers)
+        + (size_t)kNumBiasLayers * MemoryArena::getBytes<T>((size_t)out_size)
+        + (size_t)out_size * (MemoryArena::getBytes<T>((size_t)in_size) + MemoryArena::getBytes<T>((size_t)out_size));
 }
 
 template <typename T, typename MathsProvider>
-GRULayer<T, MathsProvider>::WeightSet::~WeightSet()
+void GRULayer<T, MathsProvider>::WeightSet::bindMemory(MemoryArena& memory, int in_size) noexcept
 {
+    W = memory.allocate<T*>((size_t)out_size);
+    U = memory.allocate<T*>((size_t)out_size);
+    b = memory.allocate<T*>((size_t)kNumBiasLayers);
+
     for(int i = 0; i < kNumBiasLayers; ++i)
     {
-        delete[] b[i];
+        b[i] = memory.allocate<T>((size_t)out_size);
     }
 
     for(int i = 0; i < out_size; ++i)
     {
-        delete[] W[i];
-        delete[] U[i];
+        W[i] = memory.allocate<T>((size_t)in_size);
+        U[i] = memory.allocate<T>((size_t)out_size);
     }
-
-    delete[] b;
-    delete[] W;
-    delete[] U;
 }
 
 template <typename T, typename MathsProvider>
@@ -266,6 +264,9 @@ GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider>::GRULayerT()
         }
     }
 
+    if(in_size > 1)
+        kernel_block.resize((size_t)(kernel_block_size * 3 * out_size), (T)0);
+
     reset();
 }
 
@@ -35,9 +35,20 @@ public:
         extendedHt1(Layer<T>::out_size) = (T)1;
     }
 
+    /** Returns the number of values in the GRU state. */
+    size_t getStateSize() const noexcept override { return (size_t)Layer<T>::out_size; }
+
+    /** Copies the GRU state into `state`. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept override { std::copy(extendedHt1.data(), extendedHt1.data() + Layer<T>::out_size, state); }
+
+    /** Restores the GRU state from `state`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept override { std::copy(state, state + Layer<T>::out_size, extendedHt1.data()); }
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "gru"; }
 
+    size_t getNumMACs() const noexcept override { return (size_t)(3 * Layer<T>::out_size * (Layer<T>::in_size + Layer<T>::out_size)); }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const T* input, T* h) noexcept override
     {
@@ -85,6 +96,13 @@ public:
         }
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* h, int numSamples) noexcept override
+    {
+        for(int n = 0; n < numSamples; ++n)
+            GRULayer::forward(input + n * Layer<T>::in_size, h + n * Layer<T>::out_size);
+    }
+
     /**
      * Sets the layer kernel weights.
      *
@@ -119,29 +137,47 @@ public:
     RTNEURAL_REALTIME T getUVal(int i, int k) const noexcept;
     RTNEURAL_REALTIME T getBVal(int i, int k) const noexcept;
 
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+    }
+
 private:
+    using mat_type = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>, RTNeuralEigenAlignment>;
+    using vec_type = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>, RTNeuralEigenAlignment>;
+
+    static size_t getMemoryBytes(int in_size, int out_size) noexcept;
+
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept;
+
+    MemoryArena memory;
+
     // Kernels
     // | Wz bz0 |
     // | Wr br0 |
     // | Wc bc0 |
-    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> wCombinedWeights;
+    mat_type wCombinedWeights { nullptr, 0, 0 };
 
     // | Uz bz1 |
     // | Ur br1 |
     // | Uc bc1 |
-    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> uCombinedWeights;
+    mat_type uCombinedWeights { nullptr, 0, 0 };
 
     // Input vec
-    Eigen::Matrix<T, Eigen::Dynamic, 1> extendedInVec;
+    vec_type extendedInVec { nullptr, 0 };
 
     // h(t-1) vec
-    Eigen::Matrix<T, Eigen::Dynamic, 1> extendedHt1;
+    vec_type extendedHt1 { nullptr, 0 };
 
     // Scratch memory
-    Eigen::Matrix<T, Eigen::Dynamic, 1> alphaVec;
-    Eigen::Matrix<T, Eigen::Dynamic, 1> betaVec;
-    Eigen::Matrix<T, Eigen::Dynamic, 1> gammaVec;
-    Eigen::Matrix<T, Eigen::Dynamic, 1> cVec;
+    vec_type alphaVec { nullptr, 0 };
+    vec_type betaVec { nullptr, 0 };
+    vec_type gammaVec { nullptr, 0 };
+    vec_type cVec { nullptr, 0 };
 };
 
 //====================================================
@@ -194,6 +230,25 @@ public:
     /** Resets the state of the GRU. */
     RTNEURAL_REALTIME void reset();
 
+    /** Returns the number of values in the GRU state, including the sample rate correction delay line. */
+    size_t getStateSize() const noexcept { return (size_t)(2 * out_sizet) + state_detail::getBufferSize<T>(outs_delayed); }
+
+    /** Copies the GRU state into `state`, which must hold `getStateSize()` values. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept
+    {
+        state = state_detail::saveValues(extendedHt1.data(), out_sizet, state);
+        state = state_detail::saveValues(outs.data(), out_sizet, state);
+        state_detail::saveBuffer(outs_delayed, state);
+    }
+
+    /** Restores the GRU state from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept
+    {
+        state = state_detail::loadValues(extendedHt1.data(), out_sizet, state);
+        state = state_detail::loadValues(outs.data(), out_sizet, state);
+        state_detail::loadBuffer(outs_delayed, state);
+    }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const in_type& ins) noexcept
     {
@@ -212,29 +267,35 @@ public:
          *        | Uc bc[1] |                | Uc * h(t-1) + bc[1] |
          */
         alphaVec.noalias() = wCombinedWeights * extendedInVec;
-        betaVec.noalias() = uCombinedWeights * extendedHt1;
-
-        /**
-         * gamma = sigmoid( | z |   = sigmoid(alpha[0 : 2*out_sizet] + beta[0 : 2*out_sizet])
-         *                  | r | )
-         */
-        gammaVec = MathsProvider::sigmoid(alphaVec.segment(0, 2 * out_sizet) + betaVec.segment(0, 2 * out_sizet));
-
-        /**
-         * c = tanh( alpha[2*out_sizet : 3*out_sizet] + r.cwiseProduct(beta[2*out_sizet : 3*out_sizet] )
-         * i.e. c = tanh( Wc * input + bc[0] + r.cwiseProduct(Uc * h(t-1) + bc[1]) )
-         */
-        cVec.noalias() = alphaVec.segment(2 * out_sizet, out_sizet) + gammaVec.segment(out_sizet, out_sizet).cwiseProduct(betaVec.segment(2 * out_sizet, out_sizet));
-        cVec = MathsProvider::tanh(cVec);
-
-        /**
-         * h(t-1) = (1 - z).cwiseProduct(c) + z.cwiseProduct(h(t-1))
-         *        = c - z.cwiseProduct(c) + z.cwiseProduct(ht(t-1))
-         *        = c + z.cwiseProduct(h(t-1) - c)
-         */
-        extendedHt1.segment(0, out_sizet) = cVec + gammaVec.segment(0, out_sizet).cwiseProduct(extendedHt1.segment(0, out_sizet) - cVec);
+        forwardRecurrent();
+    }
 
-        computeOutput();
+    /**
+     * Performs forward propagation for a block of frames.
+     *
+     * The kernel products (alpha) don't depend on the recurrent state,
+     * so they are computed for a whole chunk of frames with a single
+     * matrix-matrix product, and only the recurrent products (beta) are
+     * computed frame-by-frame.
+     */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        for(int offset = 0; offset < numFrames; offset += kernel_block_size)
+        {
+            const auto blockSize = std::min((int)kernel_block_size, numFrames - offset);
+            const auto inBlock = Eigen::Map<const Eigen::Matrix<T, in_sizet, Eigen::Dynamic>>(ins + offset * in_sizet, in_sizet, blockSize);
+
+            auto alphaBlock = kernelBlock.leftCols(blockSize);
+            alphaBlock.noalias() = wCombinedWeights.template leftCols<in_sizet>() * inBlock;
+            alphaBlock.colwise() += wCombinedWeights.col(in_sizet);
+
+            for(int n = 0; n < blockSize; ++n)
+            {
+                alphaVec = alphaBlock.col(n);
+                forwardRecurrent();
+                Eigen::Map<out_type>(out + (offset + n) * out_sizet) = outs;
+            }
+        }
     }
 
     /**
@@ -263,6 +324,34 @@ public:
 private:
     T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
 
+    /** Computes the recurrent part of the GRU, given the kernel products in alphaVec. */
+    inline void forwardRecurrent() noexcept
+    {
+        betaVec.noalias() = uCombinedWeights * extendedHt1;
+
+        /**
+         * gamma = sigmoid( | z |   = sigmoid(alpha[0 : 2*out_sizet] + beta[0 : 2*out_sizet])
+         *                  | r | )
+         */
+        gammaVec = MathsProvider::sigmoid(alphaVec.segment(0, 2 * out_sizet) + betaVec.segment(0, 2 * out_sizet));
+
+        /**
+         * c = tanh( alpha[2*out_sizet : 3*out_sizet] + r.cwiseProduct(beta[2*out_sizet : 3*out_sizet] )
+         * i.e. c = tanh( Wc * input + bc[0] + r.cwiseProduct(Uc * h(t-1) + bc[1]) )
+         */
+        cVec.noalias() = alphaVec.segment(2 * out_sizet, out_sizet) + gammaVec.segment(out_sizet, out_sizet).cwiseProduct(betaVec.segment(2 * out_sizet, out_sizet));
+        cVec = MathsProvider::tanh(cVec);
+
+        /**
+         * h(t-1) = (1 - z).cwiseProduct(c) + z.cwiseProduct(h(t-1))
+         *        = c - z.cwiseProduct(c) + z.cwiseProduct(ht(t-1))
+         *        = c + z.cwiseProduct(h(t-1) - c)
+         */
+        extendedHt1.segment(0, out_sizet) = cVec + gammaVec.segment(0, out_sizet).cwiseProduct(extendedHt1.segment(0, out_sizet) - cVec);
+
+        computeOutput();
+    }
+
     template <SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::None, void>
     computeOutput() noexcept
@@ -324,6 +413,10 @@ private:
     extended_in_type extendedInVec;
     extended_out_type extendedHt1;
 
+    // kernel products for block processing
+    static constexpr int kernel_block_size = RTNEURAL_MODELT_BLOCK_SIZE;
+    Eigen::Matrix<T, out_sizet * 3, Eigen::Dynamic> kernelBlock;
+
     // needed for delays when doing sample rate correction
     std::vector<out_type> outs_delayed;
     int delayWriteIdx = 0;
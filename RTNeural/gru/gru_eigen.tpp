@@ -8,18 +8,11 @@ namespace RTNEURAL_NAMESPACE
 template <typename T, typename MathsProvider>
 GRULayer<T, MathsProvider>::GRULayer(int in_size, int out_size)
     : Layer<T>(in_size, out_size)
+    , memory(getMemoryBytes(in_size, out_size))
 {
-    wCombinedWeights = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(3 * out_size, in_size + 1);
-    uCombinedWeights = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(3 * out_size, out_size + 1);
-    extendedInVec = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(in_size + 1);
-    extendedHt1 = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(out_size + 1);
+    bindMemory();
     extendedInVec(Layer<T>::in_size) = (T)1;
     extendedHt1(Layer<T>::out_size) = (T)1;
-
-    alphaVec = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(3 * out_size);
-    betaVec = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(3 * out_size);
-    gammaVec = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(2 * out_size);
-    cVec = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(out_size);
 }
 
 template <typename T, typename MathsProvider>
@@ -40,6 +33,36 @@ GRULayer<T, MathsProvider>& GRULayer<T, MathsProvider>::operator=(const GRULayer
     return *this = GRULayer<T, MathsProvider>(other);
 }
 
+template <typename T, typename MathsProvider>
+size_t GRULayer<T, MathsProvider>::getMemoryBytes(int in_size, int out_size) noexcept
+{
+    return MemoryArena::getBytes<T>((size_t)(3 * out_size * (in_size + 1)))
+        + MemoryArena::getBytes<T>((size_t)(3 * out_size * (out_size + 1)))
+        + MemoryArena::getBytes<T>((size_t)(in_size + 1))
+        + MemoryArena::getBytes<T>((size_t)(out_size + 1))
+        + 2 * MemoryArena::getBytes<T>((size_t)(3 * out_size))
+        + MemoryArena::getBytes<T>((size_t)(2 * out_size))
+        + MemoryArena::getBytes<T>((size_t)out_size);
+}
+
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::bindMemory() noexcept
+{
+    const auto in_size = Layer<T>::in_size;
+    const auto out_size = Layer<T>::out_size;
+
+    memory.rewind();
+    memory.allocateMap(wCombinedWeights, 3 * out_size, in_size + 1);
+    memory.allocateMap(uCombinedWeights, 3 * out_size, out_size + 1);
+    memory.allocateMap(extendedInVec, in_size + 1, 1);
+    memory.allocateMap(extendedHt1, out_size + 1, 1);
+
+    memory.allocateMap(alphaVec, 3 * out_size, 1);
+    memory.allocateMap(betaVec, 3 * out_size, 1);
+    memory.allocateMap(gammaVec, 2 * out_size, 1);
+    memory.allocateMap(cVec, out_size, 1);
+}
+
 template <typename T, typename MathsProvider>
 void GRULayer<T, MathsProvider>::setWVals(const std::vector<std::vector<T>>& wVals)
 {
@@ -152,6 +175,8 @@ GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider>::GRULayerT()
     extendedInVec(in_sizet) = (T)1;
     extendedHt1(out_sizet) = (T)1;
 
+    kernelBlock = Eigen::Matrix<T, out_sizet * 3, Eigen::Dynamic>::Zero(out_sizet * 3, kernel_block_size);
+
     reset();
 }
 
@@ -31,9 +31,20 @@ public:
     /** Resets the state of the GRU. */
     RTNEURAL_REALTIME void reset() override { std::fill(ht1.begin(), ht1.end(), (T)0); }
 
+    /** Returns the number of values in the GRU state. */
+    size_t getStateSize() const noexcept override { return (size_t)Layer<T>::out_size; }
+
+    /** Copies the GRU state into `state`. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept override { std::copy(ht1.begin(), ht1.begin() + Layer<T>::out_size, state); }
+
+    /** Restores the GRU state from `state`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept override { std::copy(state, state + Layer<T>::out_size, ht1.begin()); }
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "gru"; }
 
+    size_t getNumMACs() const noexcept override { return (size_t)(3 * Layer<T>::out_size * (Layer<T>::in_size + Layer<T>::out_size)); }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const T* input, T* h) noexcept override
     {
@@ -67,6 +78,21 @@ public:
         vCopy(h, ht1.data(), Layer<T>::out_size);
     }
 
+    /**
+     * Performs forward propagation for a block of frames.
+     *
+     * The frames in the block are not guaranteed to be aligned, so the
+     * outputs are computed in an aligned scratch buffer.
+     */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* h, int numSamples) noexcept override
+    {
+        for(int n = 0; n < numSamples; ++n)
+        {
+            GRULayer::forward(input + n * Layer<T>::in_size, outFrame.data());
+            std::copy(outFrame.begin(), outFrame.end(), h + n * Layer<T>::out_size);
+        }
+    }
+
     /**
      * Sets the layer kernel weights.
      *
@@ -147,6 +173,8 @@ protected:
     vec_type prod_in;
     vec_type prod_out;
     vec_type ones;
+
+    vec_type outFrame;
 };
 
 //====================================================
@@ -193,6 +221,23 @@ public:
     /** Resets the state of the GRU. */
     RTNEURAL_REALTIME void reset();
 
+    /** Returns the number of values in the GRU state, including the sample rate correction delay line. */
+    size_t getStateSize() const noexcept { return state_detail::getNumValues<T, v_type>(v_out_size) + state_detail::getBufferSize<T>(outs_delayed); }
+
+    /** Copies the GRU state into `state`, which must hold `getStateSize()` values. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept
+    {
+        state = state_detail::saveValues(outs, v_out_size, state);
+        state_detail::saveBuffer(outs_delayed, state);
+    }
+
+    /** Restores the GRU state from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept
+    {
+        state = state_detail::loadValues(outs, v_out_size, state);
+        state_detail::loadBuffer(outs_delayed, state);
+    }
+
     /** Performs forward propagation for this layer. */
     template <int N = in_size>
     RTNEURAL_REALTIME inline typename std::enable_if<(N > 1), void>::type
@@ -242,6 +287,63 @@ public:
         computeOutput();
     }
 
+    /**
+     * Performs forward propagation for a block of frames.
+     *
+     * The kernel products (W * x) don't depend on the recurrent state,
+     * so they are computed for a whole chunk of frames up front, and
+     * only the recurrent products are computed frame-by-frame.
+     */
+    template <int N = in_size>
+    RTNEURAL_REALTIME inline typename std::enable_if<(N > 1), void>::type
+    forwardBlock(const v_type* ins, v_type* out, int numFrames) noexcept
+    {
+        for(int offset = 0; offset < numFrames; offset += kernel_block_size)
+        {
+            const auto blockSize = std::min((int)kernel_block_size, numFrames - offset);
+            kernel_block_mat_mul(ins + offset * v_in_size, Wz, kernel_block.data(), blockSize);
+            kernel_block_mat_mul(ins + offset * v_in_size, Wr, kernel_block.data() + v_out_size, blockSize);
+            kernel_block_mat_mul(ins + offset * v_in_size, Wh, kernel_block.data() + 2 * v_out_size, blockSize);
+
+            for(int n = 0; n < blockSize; ++n)
+            {
+                const auto* kernel_z = kernel_block.data() + n * 3 * v_out_size;
+                const auto* kernel_r = kernel_z + v_out_size;
+                const auto* kernel_h = kernel_z + 2 * v_out_size;
+
+                // compute zt
+                recurrent_mat_mul(outs, Uz, zt);
+                for(int i = 0; i < v_out_size; ++i)
+                    zt[i] = MathsProvider::sigmoid(zt[i] + bz[i] + kernel_z[i]);
+
+                // compute rt
+                recurrent_mat_mul(outs, Ur, rt);
+                for(int i = 0; i < v_out_size; ++i)
+                    rt[i] = MathsProvider::sigmoid(rt[i] + br[i] + kernel_r[i]);
+
+                // compute h_hat
+                recurrent_mat_mul(outs, Uh, ct);
+                for(int i = 0; i < v_out_size; ++i)
+                    ht[i] = MathsProvider::tanh(xsimd::fma(rt[i], ct[i] + bh1[i], bh0[i] + kernel_h[i]));
+
+                computeOutput();
+                std::copy(std::begin(outs), std::end(outs), out + (offset + n) * v_out_size);
+            }
+        }
+    }
+
+    /** Performs forward propagation for a block of frames. */
+    template <int N = in_size>
+    RTNEURAL_REALTIME inline typename std::enable_if<N == 1, void>::type
+    forwardBlock(const v_type* ins, v_type* out, int numFrames) noexcept
+    {
+        for(int n = 0; n < numFrames; ++n)
+        {
+            forward(reinterpret_cast<const v_type(&)[v_in_size]>(ins[n * v_in_size]));
+            std::copy(std::begin(outs), std::end(outs), out + n * v_out_size);
+        }
+    }
+
     /**
      * Sets the layer kernel weights.
      *
@@ -346,6 +448,27 @@ private:
         }
     }
 
+    /** Computes the kernel products for a block of frames, with a stride of 3 * v_out_size between frames. */
+    static inline void kernel_block_mat_mul(const v_type* ins, const v_type (&mat)[in_size][v_out_size], v_type* out, int numFrames) noexcept
+    {
+        for(int n = 0; n < numFrames; ++n)
+        {
+            for(int i = 0; i < v_out_size; ++i)
+                out[n * 3 * v_out_size + i] = v_type((T)0);
+        }
+
+        // each row of the weights is re-used for every frame in the block
+        for(int k = 0; k < in_size; ++k)
+        {
+            for(int n = 0; n < numFrames; ++n)
+            {
+                const auto x = reinterpret_cast<const T*>(ins + n * v_in_size)[k];
+                for(int i = 0; i < v_out_size; ++i)
+                    out[n * 3 * v_out_size + i] += x * mat[k][i];
+            }
+        }
+    }
+
     // kernel weights
     v_type Wz[in_size][v_out_size];
     v_type Wr[in_size][v_out_size];
@@ -374,6 +497,10 @@ private:
     v_type ct[v_out_size];
     v_type ht[v_out_size];
 
+    // kernel products for block processing
+    static constexpr int kernel_block_size = RTNEURAL_MODELT_BLOCK_SIZE;
+    std::vector<v_type, xsimd::aligned_allocator<v_type>> kernel_block;
+
     // needed for delays when doing sample rate correction
     std::vector<std::array<v_type, v_out_size>> outs_delayed;
     int delayWriteIdx = 0;
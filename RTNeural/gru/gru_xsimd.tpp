@@ -20,6 +20,8 @@ GRULayer<T, MathsProvider>::GRULayer(int in_size, int out_size)
     prod_out.resize(out_size, (T)0);
 
     ones.resize(out_size, (T)1);
+
+    outFrame.resize(out_size, (T)0);
 }
 
 template <typename T, typename MathsProvider>
@@ -241,6 +243,9 @@ GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider>::GRULayerT()
         }
     }
 
+    if(in_size > 1)
+        kernel_block.resize((size_t)(kernel_block_size * 3 * v_out_size), v_type((T)0));
+
     reset();
 }
 
@@ -0,0 +1,442 @@
+#ifndef DENSE_LOW_RANK_H_INCLUDED
+#define DENSE_LOW_RANK_H_INCLUDED
+
+#include <algorithm>
+#include <vector>
+
+#include "../Layer.h"
+#include "../common.h"
+#include "../config.h"
+#include "../memory_arena.h"
+#include "../model_plan.h"
+#include "svd.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+#ifndef DOXYGEN
+namespace low_rank_detail
+{
+    /** The default relative (Frobenius norm) error of the factorized weights. */
+    constexpr float defaultTolerance = 1.0e-2f;
+
+    /** Returns the largest rank for which a factorized out_size x in_size matrix takes fewer multiply-adds. */
+    constexpr int getBreakEvenRank(int in_size, int out_size)
+    {
+        return (in_size * out_size - 1) / (in_size + out_size) > 0 ? (in_size * out_size - 1) / (in_size + out_size) : 1;
+    }
+
+#if RTNEURAL_USE_XSIMD
+    /** Computes y += a * x. */
+    template <typename T>
+    RTNEURAL_REALTIME inline void axpy(const T* a, T x, T* y, int dim) noexcept
+    {
+        using b_type = xsimd::simd_type<T>;
+        constexpr auto inc = (int)b_type::size;
+
+        const b_type x_vec(x);
+        auto vec_size = dim - dim % inc;
+        for(int i = 0; i < vec_size; i += inc)
+        {
+            b_type y_vec = xsimd::load_unaligned(&y[i]);
+            b_type a_vec = xsimd::load_unaligned(&a[i]);
+            xsimd::store_unaligned(&y[i], xsimd::fma(a_vec, x_vec, y_vec));
+        }
+
+        for(auto i = vec_size; i < dim; ++i)
+            y[i] += a[i] * x;
+    }
+#else
+    /** Computes y += a * x. */
+    template <typename T>
+    RTNEURAL_REALTIME inline void axpy(const T* a, T x, T* y, int dim) noexcept
+    {
+        for(int i = 0; i < dim; ++i)
+            y[i] += a[i] * x;
+    }
+#endif
+
+    /**
+     * Computes out = left * (right * x) + bias, with the factors stored as
+     * described in `Factors`. `tmp` must have room for `rank` values.
+     */
+    template <typename T>
+    RTNEURAL_REALTIME inline void forward(const T* left, const T* right, const T* bias, const T* x, T* tmp, T* out,
+        int in_size, int out_size, int rank) noexcept
+    {
+#if RTNEURAL_USE_EIGEN
+        using Matrix = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+        using Vector = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+        Eigen::Map<Vector> tmpVec(tmp, rank);
+        tmpVec.noalias() = Eigen::Map<const Matrix>(right, rank, in_size) * Eigen::Map<const Vector>(x, in_size);
+        Eigen::Map<Vector>(out, out_size).noalias() = Eigen::Map<const Matrix>(left, out_size, rank) * tmpVec
+            + Eigen::Map<const Vector>(bias, out_size);
+#else
+        std::fill(tmp, tmp + rank, (T)0);
+        for(int k = 0; k < in_size; ++k)
+            axpy(right + k * rank, x[k], tmp, rank);
+
+        std::copy(bias, bias + out_size, out);
+        for(int r = 0; r < rank; ++r)
+            axpy(left + r * out_size, tmp[r], out, out_size);
+#endif
+    }
+
+    /**
+     * Converts factors with size left[out_size][rank] and right[rank][in_size]
+     * to the `Factors` layout.
+     */
+    template <typename T>
+    Factors getFactors(const std::vector<std::vector<T>>& left, const std::vector<std::vector<T>>& right)
+    {
+        Factors factors;
+        factors.rank = (int)right.size();
+        const auto rows = (int)left.size();
+        const auto cols = right.empty() ? 0 : (int)right[0].size();
+
+        factors.left.resize((size_t)(factors.rank * rows));
+        factors.right.resize((size_t)(factors.rank * cols));
+        for(int r = 0; r < factors.rank; ++r)
+        {
+            for(int i = 0; i < rows; ++i)
+                factors.left[(size_t)(r * rows + i)] = (double)left[(size_t)i][(size_t)r];
+            for(int k = 0; k < cols; ++k)
+                factors.right[(size_t)(k * factors.rank + r)] = (double)right[(size_t)r][(size_t)k];
+        }
+
+        return factors;
+    }
+} // namespace low_rank_detail
+#endif
+
+/**
+ * Dynamic implementation of a fully-connected (dense) layer, with
+ * low-rank weights, and no activation.
+ *
+ * The weights are stored as the product of an out_size x rank matrix
+ * and a rank x in_size matrix, which takes rank * (in_size + out_size)
+ * multiply-adds instead of in_size * out_size. When the layer weights
+ * are set, they are factorized with a truncated SVD, using the smallest
+ * rank for which the (Frobenius norm) error of the weights is at most
+ * `getTolerance()` times the norm of the weights. `json_parser::parseJson()`
+ * uses this layer for dense layers when it is given a low-rank tolerance,
+ * and the rank needed is small enough to save some work.
+ */
+template <typename T>
+class DenseLowRank final : public Layer<T>
+{
+public:
+    /** Constructs a dense layer for a given input and output size. */
+    DenseLowRank(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , memory(MemoryArena::getBytes<T>((size_t)out_size))
+    {
+        bindMemory();
+        std::fill(bias, bias + out_size, (T)0);
+        allocateFactors(1);
+    }
+
+    DenseLowRank(std::initializer_list<int> sizes)
+        : DenseLowRank(*sizes.begin(), *(sizes.begin() + 1))
+    {
+    }
+
+    DenseLowRank(const DenseLowRank& other)
+        : DenseLowRank(other.in_size, other.out_size)
+    {
+        tolerance = other.tolerance;
+    }
+
+    DenseLowRank& operator=(const DenseLowRank& other)
+    {
+        return *this = DenseLowRank(other);
+    }
+
+    virtual ~DenseLowRank() = default;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "dense"; }
+
+    size_t getNumMACs() const noexcept override { return (size_t)(rank * (Layer<T>::in_size + Layer<T>::out_size)); }
+
+    /** Lets `Model::compile()` call this layer directly. */
+    bool resolvePlanOp(PlanOp<T>& op) override { return plan_detail::resolve<T, DenseLowRank<T>>(op); }
+
+    /** Performs forward propagation for this layer. */
+    RTNEURAL_REALTIME inline void forward(const T* input, T* out) noexcept override
+    {
+        low_rank_detail::forward(left, right, bias, input, tmp, out, Layer<T>::in_size, Layer<T>::out_size, rank);
+    }
+
+    /** Sets the relative error allowed when the weights are factorized by `setWeights()`. */
+    void setTolerance(float newTolerance) noexcept { tolerance = newTolerance; }
+
+    /** Returns the relative error allowed when the weights are factorized by `setWeights()`. */
+    float getTolerance() const noexcept { return tolerance; }
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        setFactors(low_rank_detail::factorize([&newWeights](int i, int k)
+                                                  { return newWeights[(size_t)i][(size_t)k]; },
+            Layer<T>::out_size, Layer<T>::in_size, (double)tolerance, std::min(Layer<T>::in_size, Layer<T>::out_size)));
+    }
+
+    /**
+     * Sets the layer weights from factors which have already been computed.
+     *
+     * The dimension of the factors must be left[out_size][rank]
+     * and right[rank][in_size]
+     */
+    void setFactors(const std::vector<std::vector<T>>& newLeft, const std::vector<std::vector<T>>& newRight)
+    {
+        setFactors(low_rank_detail::getFactors(newLeft, newRight));
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + Layer<T>::out_size, bias);
+    }
+
+    /** Returns the (factorized) weights value at the given indices. */
+    T getWeight(int i, int k) const noexcept
+    {
+        T w = (T)0;
+        for(int r = 0; r < rank; ++r)
+            w += left[r * Layer<T>::out_size + i] * right[k * rank + r];
+        return w;
+    }
+
+    /** Returns the bias value at the given index. */
+    RTNEURAL_REALTIME T getBias(int i) const noexcept { return bias[i]; }
+
+    /** Returns the rank of the factorized weights. */
+    int getRank() const noexcept { return rank; }
+
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity() + factorMemory.getCapacity(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        factorMemory.moveInto(arena);
+        bindMemory();
+        bindFactorMemory();
+    }
+
+private:
+    void setFactors(const low_rank_detail::Factors& factors)
+    {
+        allocateFactors(factors.rank);
+        std::transform(factors.left.begin(), factors.left.end(), left, [](double x)
+            { return (T)x; });
+        std::transform(factors.right.begin(), factors.right.end(), right, [](double x)
+            { return (T)x; });
+    }
+
+    void allocateFactors(int newRank)
+    {
+        rank = newRank;
+        factorMemory = MemoryArena(MemoryArena::getBytes<T>((size_t)(rank * Layer<T>::out_size))
+            + MemoryArena::getBytes<T>((size_t)(rank * Layer<T>::in_size))
+            + MemoryArena::getBytes<T>((size_t)rank));
+        bindFactorMemory();
+    }
+
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept
+    {
+        memory.rewind();
+        bias = memory.allocate<T>((size_t)Layer<T>::out_size);
+    }
+
+    /** Points the factor buffers at the factor memory. */
+    void bindFactorMemory() noexcept
+    {
+        factorMemory.rewind();
+        left = factorMemory.allocate<T>((size_t)(rank * Layer<T>::out_size));
+        right = factorMemory.allocate<T>((size_t)(rank * Layer<T>::in_size));
+        tmp = factorMemory.allocate<T>((size_t)rank);
+    }
+
+    float tolerance = low_rank_detail::defaultTolerance;
+    int rank = 0;
+
+    MemoryArena memory;
+    MemoryArena factorMemory;
+    T* bias = nullptr;
+    T* left = nullptr;
+    T* right = nullptr;
+    T* tmp = nullptr;
+};
+
+//====================================================
+/**
+ * Static implementation of a fully-connected (dense) layer, with
+ * low-rank weights, and no activation. See `DenseLowRank` for details.
+ *
+ * The layer has room for factors with rank up to `max_rank` (by default,
+ * the largest rank which takes fewer multiply-adds than `DenseT`). If the
+ * weights need a larger rank to meet the tolerance, they are truncated to
+ * `max_rank`.
+ */
+template <typename T, int in_sizet, int out_sizet, int max_rank = low_rank_detail::getBreakEvenRank(in_sizet, out_sizet)>
+class DenseLowRankT
+{
+#if RTNEURAL_USE_EIGEN
+    using in_type = Eigen::Matrix<T, in_sizet, 1>;
+    using out_type = Eigen::Matrix<T, out_sizet, 1>;
+#elif RTNEURAL_USE_XSIMD
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_in_size = ceil_div(in_sizet, v_size);
+    static constexpr auto v_out_size = ceil_div(out_sizet, v_size);
+#endif
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    DenseLowRankT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        std::fill(std::begin(left), std::end(left), (T)0);
+        std::fill(std::begin(right), std::end(right), (T)0);
+#if RTNEURAL_USE_EIGEN
+        outs = out_type::Zero();
+#elif RTNEURAL_USE_XSIMD
+        std::fill(std::begin(outs), std::end(outs), v_type((T)0));
+#else
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+#endif
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "dense"; }
+
+    /** Returns false since dense is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Reset is a no-op, since Dense does not have state. */
+    RTNEURAL_REALTIME void reset() { }
+
+    /** Performs forward propagation for this layer. */
+#if RTNEURAL_USE_EIGEN
+    RTNEURAL_REALTIME inline void forward(const in_type& ins) noexcept
+    {
+        low_rank_detail::forward(left, right, bias, ins.data(), tmp, outs.data(), in_size, out_size, rank);
+    }
+#elif RTNEURAL_USE_XSIMD
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        low_rank_detail::forward(left, right, bias, reinterpret_cast<const T*>(ins), tmp, reinterpret_cast<T*>(outs), in_size, out_size, rank);
+    }
+#else
+    RTNEURAL_REALTIME inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        low_rank_detail::forward(left, right, bias, ins, tmp, outs, in_size, out_size, rank);
+    }
+#endif
+
+    /** Sets the relative error allowed when the weights are factorized by `setWeights()`. */
+    void setTolerance(float newTolerance) noexcept { tolerance = newTolerance; }
+
+    /** Returns the relative error allowed when the weights are factorized by `setWeights()`. */
+    float getTolerance() const noexcept { return tolerance; }
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        setFactors(low_rank_detail::factorize([&newWeights](int i, int k)
+                                                  { return newWeights[(size_t)i][(size_t)k]; },
+            out_size, in_size, (double)tolerance, max_rank));
+    }
+
+    /**
+     * Sets the layer weights from factors which have already been computed.
+     *
+     * The dimension of the factors must be left[out_size][rank]
+     * and right[rank][in_size], with rank <= max_rank.
+     */
+    void setFactors(const std::vector<std::vector<T>>& newLeft, const std::vector<std::vector<T>>& newRight)
+    {
+        setFactors(low_rank_detail::getFactors(newLeft, newRight));
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + out_size, std::begin(bias));
+    }
+
+    /** Returns the (factorized) weights value at the given indices. */
+    T getWeight(int i, int k) const noexcept
+    {
+        T w = (T)0;
+        for(int r = 0; r < rank; ++r)
+            w += left[r * out_size + i] * right[k * rank + r];
+        return w;
+    }
+
+    /** Returns the bias value at the given index. */
+    RTNEURAL_REALTIME T getBias(int i) const noexcept { return bias[i]; }
+
+    /** Returns the rank of the factorized weights. */
+    int getRank() const noexcept { return rank; }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<out_type, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD
+    v_type outs[v_out_size];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    void setFactors(const low_rank_detail::Factors& factors)
+    {
+        rank = std::min(factors.rank, max_rank);
+        for(int r = 0; r < rank; ++r)
+        {
+            for(int i = 0; i < out_size; ++i)
+                left[r * out_size + i] = (T)factors.left[(size_t)(r * out_size + i)];
+            for(int k = 0; k < in_size; ++k)
+                right[k * rank + r] = (T)factors.right[(size_t)(k * factors.rank + r)];
+        }
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    float tolerance = low_rank_detail::defaultTolerance;
+    int rank = 1;
+
+    T left alignas(RTNEURAL_DEFAULT_ALIGNMENT)[max_rank * out_size];
+    T right alignas(RTNEURAL_DEFAULT_ALIGNMENT)[max_rank * in_size];
+    T tmp alignas(RTNEURAL_DEFAULT_ALIGNMENT)[max_rank];
+    T bias[out_size];
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // DENSE_LOW_RANK_H_INCLUDED
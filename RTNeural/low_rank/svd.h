@@ -0,0 +1,151 @@
+#ifndef LOW_RANK_SVD_H_INCLUDED
+#define LOW_RANK_SVD_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "../config.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+#ifndef DOXYGEN
+namespace low_rank_detail
+{
+    /**
+     * A rank-`rank` factorization of a rows x cols matrix, W = left * right.
+     *
+     * `left` is stored column-major (left[r * rows + i]), and `right` is
+     * stored with the `rank` values for each column of W next to each other
+     * (right[k * rank + r]), so that both matrix-vector products can be
+     * computed as a series of multiply-adds over contiguous memory.
+     */
+    struct Factors
+    {
+        int rank = 0;
+        std::vector<double> left;
+        std::vector<double> right;
+    };
+
+    /**
+     * Computes the singular value decomposition A = U * diag(s) * V^T
+     * of a tall (rows >= cols) column-major matrix with one-sided Jacobi
+     * rotations. On return, each column of `a` holds s_j * u_j, and each
+     * column of `v` (cols x cols, column-major) holds v_j.
+     */
+    inline void jacobiSVD(std::vector<double>& a, std::vector<double>& v, int rows, int cols)
+    {
+        v.assign((size_t)(cols * cols), 0.0);
+        for(int j = 0; j < cols; ++j)
+            v[(size_t)(j * cols + j)] = 1.0;
+
+        auto rotate = [](double* x, double* y, int n, double c, double s)
+        {
+            for(int i = 0; i < n; ++i)
+            {
+                const auto xi = x[i];
+                x[i] = c * xi - s * y[i];
+                y[i] = s * xi + c * y[i];
+            }
+        };
+
+        constexpr int maxSweeps = 60;
+        constexpr double eps = 1.0e-15;
+        for(int sweep = 0; sweep < maxSweeps; ++sweep)
+        {
+            bool rotated = false;
+            for(int p = 0; p < cols - 1; ++p)
+            {
+                for(int q = p + 1; q < cols; ++q)
+                {
+                    auto* ap = a.data() + p * rows;
+                    auto* aq = a.data() + q * rows;
+                    const auto alpha = std::inner_product(ap, ap + rows, ap, 0.0);
+                    const auto beta = std::inner_product(aq, aq + rows, aq, 0.0);
+                    const auto gamma = std::inner_product(ap, ap + rows, aq, 0.0);
+                    if(std::abs(gamma) <= eps * std::sqrt(alpha * beta))
+                        continue;
+
+                    rotated = true;
+                    const auto zeta = (beta - alpha) / (2.0 * gamma);
+                    const auto t = (zeta >= 0.0 ? 1.0 : -1.0) / (std::abs(zeta) + std::sqrt(1.0 + zeta * zeta));
+                    const auto c = 1.0 / std::sqrt(1.0 + t * t);
+                    const auto s = c * t;
+                    rotate(ap, aq, rows, c, s);
+                    rotate(v.data() + p * cols, v.data() + q * cols, cols, c, s);
+                }
+            }
+
+            if(!rotated)
+                break;
+        }
+    }
+
+    /**
+     * Returns the truncated SVD of a matrix with `getWeight(row, col)`, with
+     * the smallest rank (up to `maxRank`) for which the Frobenius norm of the
+     * error is at most `tolerance` times the Frobenius norm of the matrix.
+     * The singular values are folded into the left factor.
+     */
+    template <typename GetWeight>
+    Factors factorize(GetWeight&& getWeight, int rows, int cols, double tolerance, int maxRank)
+    {
+        // work on the transpose of wide matrices, so that the rotations act on the shorter dimension
+        const auto transpose = rows < cols;
+        const auto m = transpose ? cols : rows;
+        const auto n = transpose ? rows : cols;
+
+        std::vector<double> a((size_t)(m * n));
+        for(int j = 0; j < n; ++j)
+            for(int i = 0; i < m; ++i)
+                a[(size_t)(j * m + i)] = transpose ? (double)getWeight(j, i) : (double)getWeight(i, j);
+
+        std::vector<double> v;
+        jacobiSVD(a, v, m, n);
+
+        std::vector<double> sigmaSquared((size_t)n);
+        for(int j = 0; j < n; ++j)
+            sigmaSquared[(size_t)j] = std::inner_product(a.begin() + j * m, a.begin() + (j + 1) * m, a.begin() + j * m, 0.0);
+
+        std::vector<int> order((size_t)n);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&sigmaSquared](int x, int y)
+            { return sigmaSquared[(size_t)x] > sigmaSquared[(size_t)y]; });
+
+        // choose the rank from the energy in the discarded singular values
+        const auto totalEnergy = std::accumulate(sigmaSquared.begin(), sigmaSquared.end(), 0.0);
+        const auto maxError = tolerance * tolerance * totalEnergy;
+        auto discardedEnergy = totalEnergy;
+        int rank = 0;
+        while(rank < std::min(n, maxRank) && discardedEnergy > maxError)
+            discardedEnergy -= sigmaSquared[(size_t)order[(size_t)rank++]];
+        rank = std::max(rank, 1);
+
+        Factors factors;
+        factors.rank = rank;
+        factors.left.resize((size_t)(rank * rows));
+        factors.right.resize((size_t)(rank * cols));
+        for(int r = 0; r < rank; ++r)
+        {
+            const auto j = order[(size_t)r];
+            const auto* scaledU = a.data() + j * m; // s_j * u_j
+            const auto* vj = v.data() + j * n;
+
+            // W = (s * U) * V^T, or for the transpose, W = V * (s * U)^T
+            const auto* leftCol = transpose ? vj : scaledU;
+            const auto* rightRow = transpose ? scaledU : vj;
+            std::copy(leftCol, leftCol + rows, factors.left.begin() + r * rows);
+            for(int k = 0; k < cols; ++k)
+                factors.right[(size_t)(k * rank + r)] = rightRow[k];
+        }
+
+        return factors;
+    }
+} // namespace low_rank_detail
+#endif
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // LOW_RANK_SVD_H_INCLUDED
@@ -34,14 +34,33 @@ public:
     LSTMLayer(std::initializer_list<int> sizes);
     LSTMLayer(const LSTMLayer& other);
     LSTMLayer& operator=(const LSTMLayer& other);
-    virtual ~LSTMLayer();
+    virtual ~LSTMLayer() = default;
 
     /** Resets the state of the LSTM. */
     RTNEURAL_REALTIME void reset() override;
 
+    /** Returns the number of values in the LSTM state. */
+    size_t getStateSize() const noexcept override { return (size_t)(2 * Layer<T>::out_size); }
+
+    /** Copies the LSTM state into `state`. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept override
+    {
+        state = std::copy(ht1, ht1 + Layer<T>::out_size, state);
+        std::copy(ct1, ct1 + Layer<T>::out_size, state);
+    }
+
+    /** Restores the LSTM state from `state`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept override
+    {
+        std::copy(state, state + Layer<T>::out_size, ht1);
+        std::copy(state + Layer<T>::out_size, state + 2 * Layer<T>::out_size, ct1);
+    }
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "lstm"; }
 
+    size_t getNumMACs() const noexcept override { return (size_t)(4 * Layer<T>::out_size * (Layer<T>::in_size + Layer<T>::out_size)); }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const T* input, T* h) noexcept override
     {
@@ -59,6 +78,13 @@ public:
         std::copy(h, h + Layer<T>::out_size, ht1);
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* h, int numSamples) noexcept override
+    {
+        for(int n = 0; n < numSamples; ++n)
+            LSTMLayer::forward(input + n * Layer<T>::in_size, h + n * Layer<T>::out_size);
+    }
+
     /**
      * Sets the layer kernel weights.
      *
@@ -80,32 +106,52 @@ public:
      */
     RTNEURAL_REALTIME void setBVals(const std::vector<T>& bVals);
 
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+    }
+
 protected:
-    T* ht1;
-    T* ct1;
+    T* ht1 = nullptr;
+    T* ct1 = nullptr;
 
     /** Struct to hold layer weights (used internally) */
     struct WeightSet
     {
-        WeightSet(int in_size, int out_size);
-        ~WeightSet();
+        explicit WeightSet(int out_size)
+            : out_size(out_size)
+        {
+        }
 
-        T** W; // kernel weights
-        T** U; // recurrent weights
-        T* b; // bias
+        static size_t getMemoryBytes(int in_size, int out_size) noexcept;
+        void bindMemory(MemoryArena& memory, int in_size) noexcept;
+
+        T** W = nullptr; // kernel weights
+        T** U = nullptr; // recurrent weights
+        T* b = nullptr; // bias
         const int out_size;
     };
 
+    static size_t getMemoryBytes(int in_size, int out_size) noexcept;
+
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept;
+
+    MemoryArena memory;
+
     WeightSet fWeights;
     WeightSet iWeights;
     WeightSet oWeights;
     WeightSet cWeights;
 
-    T* fVec;
-    T* iVec;
-    T* oVec;
-    T* ctVec;
-    T* cVec;
+    T* fVec = nullptr;
+    T* iVec = nullptr;
+    T* oVec = nullptr;
+    T* ctVec = nullptr;
+    T* cVec = nullptr;
 };
 
 //====================================================
@@ -147,6 +193,32 @@ public:
     /** Resets the state of the LSTM. */
     RTNEURAL_REALTIME void reset();
 
+    /** Returns the number of values in the LSTM state, including the sample rate correction delay lines. */
+    size_t getStateSize() const noexcept
+    {
+        return (size_t)(2 * out_size)
+            + state_detail::getBufferSize<T>(ct_delayed)
+            + state_detail::getBufferSize<T>(outs_delayed);
+    }
+
+    /** Copies the LSTM state into `state`, which must hold `getStateSize()` values. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept
+    {
+        state = state_detail::saveValues(outs, out_size, state);
+        state = state_detail::saveValues(ct, out_size, state);
+        state = state_detail::saveBuffer(ct_delayed, state);
+        state_detail::saveBuffer(outs_delayed, state);
+    }
+
+    /** Restores the LSTM state from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept
+    {
+        state = state_detail::loadValues(outs, out_size, state);
+        state = state_detail::loadValues(ct, out_size, state);
+        state = state_detail::loadBuffer(ct_delayed, state);
+        state_detail::loadBuffer(outs_delayed, state);
+    }
+
     /** Performs forward propagation for this layer. */
     template <int N = in_size>
     RTNEURAL_REALTIME inline typename std::enable_if<(N > 1), void>::type
@@ -170,7 +242,9 @@ public:
         for(int i = 0; i < out_size; ++i)
             ot[i] = MathsProvider::sigmoid(ot[i] + bo[i] + kernel_outs[i]);
 
-        computeOutputs(ins);
+        // compute ct
+        kernel_mat_mul(ins, Wc, kernel_outs);
+        computeOutputs(kernel_outs);
     }
 
     /** Performs forward propagation for this layer. */
@@ -193,7 +267,69 @@ public:
         for(int i = 0; i < out_size; ++i)
             ot[i] = MathsProvider::sigmoid(ot[i] + bo[i] + (Wo_1[i] * ins[0]));
 
-        computeOutputs(ins);
+        // compute ct
+        for(int i = 0; i < out_size; ++i)
+            kernel_outs[i] = Wc_1[i] * ins[0];
+        computeOutputs(kernel_outs);
+    }
+
+    /**
+     * Performs forward propagation for a block of frames.
+     *
+     * The kernel products (W * x) don't depend on the recurrent state,
+     * so they are computed for a whole chunk of frames up front, and
+     * only the recurrent products are computed frame-by-frame.
+     */
+    template <int N = in_size>
+    RTNEURAL_REALTIME inline typename std::enable_if<(N > 1), void>::type
+    forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        for(int offset = 0; offset < numFrames; offset += kernel_block_size)
+        {
+            const auto blockSize = std::min((int)kernel_block_size, numFrames - offset);
+            kernel_block_mat_mul(ins + offset * in_size, Wf, kernel_block.data(), blockSize);
+            kernel_block_mat_mul(ins + offset * in_size, Wi, kernel_block.data() + out_size, blockSize);
+            kernel_block_mat_mul(ins + offset * in_size, Wo, kernel_block.data() + 2 * out_size, blockSize);
+            kernel_block_mat_mul(ins + offset * in_size, Wc, kernel_block.data() + 3 * out_size, blockSize);
+
+            for(int n = 0; n < blockSize; ++n)
+            {
+                const auto* kernel_f = kernel_block.data() + n * 4 * out_size;
+                const auto* kernel_i = kernel_f + out_size;
+                const auto* kernel_o = kernel_f + 2 * out_size;
+                const auto* kernel_c = kernel_f + 3 * out_size;
+
+                // compute ft
+                recurrent_mat_mul(outs, Uf, ft);
+                for(int i = 0; i < out_size; ++i)
+                    ft[i] = MathsProvider::sigmoid(ft[i] + bf[i] + kernel_f[i]);
+
+                // compute it
+                recurrent_mat_mul(outs, Ui, it);
+                for(int i = 0; i < out_size; ++i)
+                    it[i] = MathsProvider::sigmoid(it[i] + bi[i] + kernel_i[i]);
+
+                // compute ot
+                recurrent_mat_mul(outs, Uo, ot);
+                for(int i = 0; i < out_size; ++i)
+                    ot[i] = MathsProvider::sigmoid(ot[i] + bo[i] + kernel_o[i]);
+
+                computeOutputs(kernel_c);
+                std::copy(outs, outs + out_size, out + (offset + n) * out_size);
+            }
+        }
+    }
+
+    /** Performs forward propagation for a block of frames. */
+    template <int N = in_size>
+    RTNEURAL_REALTIME inline typename std::enable_if<N == 1, void>::type
+    forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        for(int n = 0; n < numFrames; ++n)
+        {
+            forward(reinterpret_cast<const T(&)[in_size]>(ins[n]));
+            std::copy(outs, outs + out_size, out + n * out_size);
+        }
     }
 
     /**
@@ -222,44 +358,28 @@ public:
 private:
     template <SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::None, void>
-    computeOutputs(const T (&ins)[in_size]) noexcept
+    computeOutputs(const T* kernel_c) noexcept
     {
-        computeOutputsInternal(ins, ct, outs);
+        computeOutputsInternal(kernel_c, ct, outs);
     }
 
     template <SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr != SampleRateCorrectionMode::None, void>
-    computeOutputs(const T (&ins)[in_size]) noexcept
+    computeOutputs(const T* kernel_c) noexcept
     {
-        computeOutputsInternal(ins, ct_delayed[delayWriteIdx], outs_delayed[delayWriteIdx]);
+        computeOutputsInternal(kernel_c, ct_delayed[delayWriteIdx], outs_delayed[delayWriteIdx]);
 
         processDelay(ct_delayed, ct, delayWriteIdx);
         processDelay(outs_delayed, outs, delayWriteIdx);
     }
 
-    template <typename VecType, int N = in_size>
-    inline std::enable_if_t<(N > 1), void>
-    computeOutputsInternal(const T (&ins)[in_size], VecType& ctVec, VecType& outsVec) noexcept
-    {
-        // compute ct
-        recurrent_mat_mul(outs, Uc, ht);
-        kernel_mat_mul(ins, Wc, kernel_outs);
-        for(int i = 0; i < out_size; ++i)
-            ctVec[i] = it[i] * MathsProvider::tanh(ht[i] + bc[i] + kernel_outs[i]) + ft[i] * ct[i];
-
-        // compute output
-        for(int i = 0; i < out_size; ++i)
-            outsVec[i] = ot[i] * MathsProvider::tanh(ctVec[i]);
-    }
-
-    template <typename VecType, int N = in_size>
-    inline std::enable_if_t<N == 1, void>
-    computeOutputsInternal(const T (&ins)[in_size], VecType& ctVec, VecType& outsVec) noexcept
+    template <typename VecType>
+    inline void computeOutputsInternal(const T* kernel_c, VecType& ctVec, VecType& outsVec) noexcept
     {
         // compute ct
         recurrent_mat_mul(outs, Uc, ht);
         for(int i = 0; i < out_size; ++i)
-            ctVec[i] = it[i] * MathsProvider::tanh(ht[i] + bc[i] + (Wc_1[i] * ins[0])) + ft[i] * ct[i];
+            ctVec[i] = it[i] * MathsProvider::tanh(ht[i] + bc[i] + kernel_c[i]) + ft[i] * ct[i];
 
         // compute output
         for(int i = 0; i < out_size; ++i)
@@ -306,6 +426,14 @@ private:
             out[j] = std::inner_product(mat[j], mat[j] + in_size, vec, (T)0);
     }
 
+    /** Computes the kernel products for a block of frames, with a stride of 4 * out_size between frames. */
+    static inline void kernel_block_mat_mul(const T* ins, const T (&mat)[out_size][in_size], T* out, int numFrames) noexcept
+    {
+        for(int j = 0; j < out_size; ++j)
+            for(int n = 0; n < numFrames; ++n)
+                out[n * 4 * out_size + j] = std::inner_product(mat[j], mat[j] + in_size, ins + n * in_size, (T)0);
+    }
+
     // kernel weights
     T Wf alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size][in_size];
     T Wi alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size][in_size];
@@ -338,6 +466,10 @@ private:
     T ht alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
     T ct alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
 
+    // kernel products for block processing
+    static constexpr int kernel_block_size = RTNEURAL_MODELT_BLOCK_SIZE;
+    std::vector<T> kernel_block;
+
     // needed for delays when doing sample rate correction
     std::vector<std::array<T, out_size>> ct_delayed;
     std::vector<std::array<T, out_size>> outs_delayed;
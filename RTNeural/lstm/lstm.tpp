@@ -8,19 +8,13 @@ namespace RTNEURAL_NAMESPACE
 template <typename T, typename MathsProvider>
 LSTMLayer<T, MathsProvider>::LSTMLayer(int in_size, int out_size)
     : Layer<T>(in_size, out_size)
-    , fWeights(in_size, out_size)
-    , iWeights(in_size, out_size)
-    , oWeights(in_size, out_size)
-    , cWeights(in_size, out_size)
+    , memory(getMemoryBytes(in_size, out_size))
+    , fWeights(out_size)
+    , iWeights(out_size)
+    , oWeights(out_size)
+    , cWeights(out_size)
 {
-    ht1 = new T[out_size];
-    ct1 = new T[out_size];
-
-    fVec = new T[out_size];
-    iVec = new T[out_size];
-    oVec = new T[out_size];
-    ctVec = new T[out_size];
-    cVec = new T[out_size];
+    bindMemory();
 }
 
 template <typename T, typename MathsProvider>
@@ -44,53 +38,57 @@ LSTMLayer<T, MathsProvider>& LSTMLayer<T, MathsProvider>::operator=(const LSTMLa
 }
 
 template <typename T, typename MathsProvider>
-LSTMLayer<T, MathsProvider>::~LSTMLayer()
+void LSTMLayer<T, MathsProvider>::reset()
 {
-    delete[] ht1;
-    delete[] ct1;
-
-    delete[] fVec;
-    delete[] iVec;
-    delete[] oVec;
-    delete[] ctVec;
-    delete[] cVec;
+    std::fill(ht1, ht1 + Layer<T>::out_size, (T)0);
+    std::fill(ct1, ct1 + Layer<T>::out_size, (T)0);
 }
 
 template <typename T, typename MathsProvider>
-void LSTMLayer<T, MathsProvider>::reset()
+size_t LSTMLayer<T, MathsProvider>::getMemoryBytes(int in_size, int out_size) noexcept
 {
-    std::fill(ht1, ht1 + Layer<T>::out_size, (T)0);
-    std::fill(ct1, ct1 + Layer<T>::out_size, (T)0);
+    return 4 * WeightSet::getMemoryBytes(in_size, out_size) + 7 * MemoryArena::getBytes<T>((size_t)out_size);
 }
 
 template <typename T, typename MathsProvider>
-LSTMLayer<T, MathsProvider>::WeightSet::WeightSet(int in_size, int out_size)
-    : out_size(out_size)
+void LSTMLayer<T, MathsProvider>::bindMemory() noexcept
 {
-    W = new T*[out_size];
-    U = new T*[out_size];
-    b = new T[out_size];
+    memory.rewind();
+    fWeights.bindMemory(memory, Layer<T>::in_size);
+    iWeights.bindMemory(memory, Layer<T>::in_size);
+    oWeights.bindMemory(memory, Layer<T>::in_size);
+    cWeights.bindMemory(memory, Layer<T>::in_size);
+
+    ht1 = memory.allocate<T>((size_t)Layer<T>::out_size);
+    ct1 = memory.allocate<T>((size_t)Layer<T>::out_size);
+
+    fVec = memory.allocate<T>((size_t)Layer<T>::out_size);
+    iVec = memory.allocate<T>((size_t)Layer<T>::out_size);
+    oVec = memory.allocate<T>((size_t)Layer<T>::out_size);
+    ctVec = memory.allocate<T>((size_t)Layer<T>::out_size);
+    cVec = memory.allocate<T>((size_t)Layer<T>::out_size);
+}
 
-    for(int i = 0; i < out_size; ++i)
-    {
-        W[i] = new T[in_size];
-        U[i] = new T[out_size];
-    }
+template <typename T, typename MathsProvider>
+size_t LSTMLayer<T, MathsProvider>::WeightSet::getMemoryBytes(int in_size, int out_size) noexcept
+{
+    return 2 * MemoryArena::getBytes<T*>((size_t)out_size)
+        + MemoryArena::getBytes<T>((size_t)out_size)
+        + (size_t)out_size * (MemoryArena::getBytes<T>((size_t)in_size) + MemoryArena::getBytes<T>((size_t)out_size));
 }
 
 template <typename T, typename MathsProvider>
-LSTMLayer<T, MathsProvider>::WeightSet::~WeightSet()
+void LSTMLayer<T, MathsProvider>::WeightSet::bindMemory(MemoryArena& memory, int in_size) noexcept
 {
-    delete[] b;
+    W = memory.allocate<T*>((size_t)out_size);
+    U = memory.allocate<T*>((size_t)out_size);
+    b = memory.allocate<T>((size_t)out_size);
 
     for(int i = 0; i < out_size; ++i)
     {
-        delete[] W[i];
-        delete[] U[i];
+        W[i] = memory.allocate<T>((size_t)in_size);
+        U[i] = memory.allocate<T>((size_t)out_size);
     }
-
-    delete[] W;
-    delete[] U;
 }
 
 template <typename T, typename MathsProvider>
@@ -181,6 +179,9 @@ LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider>::LSTMLayerT()
         }
     }
 
+    if(in_size > 1)
+        kernel_block.resize((size_t)(kernel_block_size * 4 * out_size), (T)0);
+
     reset();
 }
 
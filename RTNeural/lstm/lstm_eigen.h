@@ -31,9 +31,32 @@ public:
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "lstm"; }
 
+    size_t getNumMACs() const noexcept override { return (size_t)(4 * Layer<T>::out_size * (Layer<T>::in_size + Layer<T>::out_size)); }
+
     /** Resets the state of the LSTM. */
     RTNEURAL_REALTIME void reset() override;
 
+    /** Returns the number of values in the LSTM state. */
+    size_t getStateSize() const noexcept override { return (size_t)(2 * Layer<T>::out_size); }
+
+    /** Copies the LSTM state into `state`. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept override
+    {
+        state = std::copy(ht1.data(), ht1.data() + Layer<T>::out_size, state);
+        std::copy(ct1.data(), ct1.data() + Layer<T>::out_size, state);
+    }
+
+    /** Restores the LSTM state from `state`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept override
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+        {
+            ht1(i) = state[i];
+            ct1(i) = state[Layer<T>::out_size + i];
+            extendedInVecHt1(Layer<T>::in_size + i) = ht1(i);
+        }
+    }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const T* input, T* h) noexcept override
     {
@@ -66,6 +89,13 @@ public:
         }
     }
 
+    /** Performs forward propagation for a block of frames. */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* h, int numSamples) noexcept override
+    {
+        for(int n = 0; n < numSamples; ++n)
+            LSTMLayer::forward(input + n * Layer<T>::in_size, h + n * Layer<T>::out_size);
+    }
+
     /**
      * Sets the layer kernel weights.
      *
@@ -87,19 +117,37 @@ public:
      */
     RTNEURAL_REALTIME void setBVals(const std::vector<T>& bVals);
 
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+    }
+
 private:
-    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> combinedWeights;
+    using mat_type = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>, RTNeuralEigenAlignment>;
+    using vec_type = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>, RTNeuralEigenAlignment>;
 
-    Eigen::Matrix<T, Eigen::Dynamic, 1> extendedInVecHt1;
+    static size_t getMemoryBytes(int in_size, int out_size) noexcept;
 
-    Eigen::Matrix<T, Eigen::Dynamic, 1> fioctVecs;
-    Eigen::Matrix<T, Eigen::Dynamic, 1> fioVecs;
-    Eigen::Matrix<T, Eigen::Dynamic, 1> ctVec;
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept;
 
-    Eigen::Matrix<T, Eigen::Dynamic, 1> cTanhVec;
+    MemoryArena memory;
 
-    Eigen::Matrix<T, Eigen::Dynamic, 1> ht1;
-    Eigen::Matrix<T, Eigen::Dynamic, 1> ct1;
+    mat_type combinedWeights { nullptr, 0, 0 };
+
+    vec_type extendedInVecHt1 { nullptr, 0 };
+
+    vec_type fioctVecs { nullptr, 0 };
+    vec_type fioVecs { nullptr, 0 };
+    vec_type ctVec { nullptr, 0 };
+
+    vec_type cTanhVec { nullptr, 0 };
+
+    vec_type ht1 { nullptr, 0 };
+    vec_type ct1 { nullptr, 0 };
 };
 
 //====================================================
@@ -149,6 +197,35 @@ public:
     /** Resets the state of the LSTM. */
     RTNEURAL_REALTIME void reset();
 
+    /** Returns the number of values in the LSTM state, including the sample rate correction delay lines. */
+    size_t getStateSize() const noexcept
+    {
+        return (size_t)(2 * out_sizet)
+            + state_detail::getBufferSize<T>(ct_delayed)
+            + state_detail::getBufferSize<T>(outs_delayed);
+    }
+
+    /** Copies the LSTM state into `state`, which must hold `getStateSize()` values. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept
+    {
+        state = state_detail::saveValues(outs.data(), out_sizet, state);
+        state = state_detail::saveValues(cVec.data(), out_sizet, state);
+        state = state_detail::saveBuffer(ct_delayed, state);
+        state_detail::saveBuffer(outs_delayed, state);
+    }
+
+    /** Restores the LSTM state from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept
+    {
+        state = state_detail::loadValues(outs.data(), out_sizet, state);
+        state = state_detail::loadValues(cVec.data(), out_sizet, state);
+        state = state_detail::loadBuffer(ct_delayed, state);
+        state_detail::loadBuffer(outs_delayed, state);
+
+        for(int i = 0; i < out_sizet; ++i)
+            extendedInHt1Vec(in_sizet + i) = outs(i);
+    }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const in_type& ins) noexcept
     {
@@ -171,6 +248,36 @@ public:
         computeOutputs();
     }
 
+    /**
+     * Performs forward propagation for a block of frames.
+     *
+     * The kernel products (W * x) don't depend on the recurrent state,
+     * so they are computed for a whole chunk of frames with a single
+     * matrix-matrix product, and only the recurrent products (U * h)
+     * are computed frame-by-frame.
+     */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* ins, T* out, int numFrames) noexcept
+    {
+        for(int offset = 0; offset < numFrames; offset += kernel_block_size)
+        {
+            const auto blockSize = std::min((int)kernel_block_size, numFrames - offset);
+            const auto inBlock = Eigen::Map<const Eigen::Matrix<T, in_sizet, Eigen::Dynamic>>(ins + offset * in_sizet, in_sizet, blockSize);
+            kernelBlock.leftCols(blockSize).noalias() = combinedWeights.template leftCols<in_sizet>() * inBlock;
+
+            for(int n = 0; n < blockSize; ++n)
+            {
+                fioctsVecs.noalias() = combinedWeights.template rightCols<out_sizet + 1>() * extendedInHt1Vec.template tail<out_sizet + 1>();
+                fioctsVecs += kernelBlock.col(n);
+
+                fioVecs = MathsProvider::sigmoid(fioctsVecs.segment(0, 3 * out_sizet));
+                ctVec = MathsProvider::tanh(fioctsVecs.segment(3 * out_sizet, out_sizet));
+
+                computeOutputs();
+                Eigen::Map<out_type>(out + (offset + n) * out_sizet) = outs;
+            }
+        }
+    }
+
     /**
      * Sets the layer kernel weights.
      *
@@ -268,6 +375,10 @@ private:
     out_type ctVec;
     out_type cVec;
 
+    // kernel products for block processing
+    static constexpr int kernel_block_size = RTNEURAL_MODELT_BLOCK_SIZE;
+    Eigen::Matrix<T, 4 * out_sizet, Eigen::Dynamic> kernelBlock;
+
     // needed for delays when doing sample rate correction
     std::vector<out_type> ct_delayed;
     std::vector<out_type> outs_delayed;
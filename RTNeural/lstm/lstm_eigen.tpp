@@ -6,19 +6,10 @@ namespace RTNEURAL_NAMESPACE
 template <typename T, typename MathsProvider>
 LSTMLayer<T, MathsProvider>::LSTMLayer(int in_size, int out_size)
     : Layer<T>(in_size, out_size)
+    , memory(getMemoryBytes(in_size, out_size))
 {
-    combinedWeights = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(4 * out_size, in_size + out_size + 1);
-    extendedInVecHt1 = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(in_size + out_size + 1);
+    bindMemory();
     extendedInVecHt1(in_size + out_size) = (T)1;
-
-    fioctVecs = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(4 * out_size);
-    fioVecs = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(3 * out_size);
-    ctVec = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(out_size);
-
-    cTanhVec = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(out_size, 1);
-
-    ht1 = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(out_size);
-    ct1 = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(out_size);
 }
 
 template <typename T, typename MathsProvider>
@@ -39,6 +30,36 @@ LSTMLayer<T, MathsProvider>& LSTMLayer<T, MathsProvider>::operator=(const LSTMLa
     return *this = LSTMLayer<T, MathsProvider>(other);
 }
 
+template <typename T, typename MathsProvider>
+size_t LSTMLayer<T, MathsProvider>::getMemoryBytes(int in_size, int out_size) noexcept
+{
+    return MemoryArena::getBytes<T>((size_t)(4 * out_size * (in_size + out_size + 1)))
+        + MemoryArena::getBytes<T>((size_t)(in_size + out_size + 1))
+        + MemoryArena::getBytes<T>((size_t)(4 * out_size))
+        + MemoryArena::getBytes<T>((size_t)(3 * out_size))
+        + 4 * MemoryArena::getBytes<T>((size_t)out_size);
+}
+
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::bindMemory() noexcept
+{
+    const auto in_size = Layer<T>::in_size;
+    const auto out_size = Layer<T>::out_size;
+
+    memory.rewind();
+    memory.allocateMap(combinedWeights, 4 * out_size, in_size + out_size + 1);
+    memory.allocateMap(extendedInVecHt1, in_size + out_size + 1, 1);
+
+    memory.allocateMap(fioctVecs, 4 * out_size, 1);
+    memory.allocateMap(fioVecs, 3 * out_size, 1);
+    memory.allocateMap(ctVec, out_size, 1);
+
+    memory.allocateMap(cTanhVec, out_size, 1);
+
+    memory.allocateMap(ht1, out_size, 1);
+    memory.allocateMap(ct1, out_size, 1);
+}
+
 template <typename T, typename MathsProvider>
 void LSTMLayer<T, MathsProvider>::reset()
 {
@@ -106,6 +127,8 @@ LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider>::LSTMLayerT()
     ctVec = out_type::Zero();
     cTanhVec = out_type::Zero();
 
+    kernelBlock = Eigen::Matrix<T, 4 * out_sizet, Eigen::Dynamic>::Zero(4 * out_sizet, kernel_block_size);
+
     reset();
 }
 
@@ -32,9 +32,28 @@ public:
     /** Resets the state of the LSTM. */
     RTNEURAL_REALTIME void reset() override;
 
+    /** Returns the number of values in the LSTM state. */
+    size_t getStateSize() const noexcept override { return (size_t)(2 * Layer<T>::out_size); }
+
+    /** Copies the LSTM state into `state`. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept override
+    {
+        state = std::copy(ht1.begin(), ht1.begin() + Layer<T>::out_size, state);
+        std::copy(ct1.begin(), ct1.begin() + Layer<T>::out_size, state);
+    }
+
+    /** Restores the LSTM state from `state`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept override
+    {
+        std::copy(state, state + Layer<T>::out_size, ht1.begin());
+        std::copy(state + Layer<T>::out_size, state + 2 * Layer<T>::out_size, ct1.begin());
+    }
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "lstm"; }
 
+    size_t getNumMACs() const noexcept override { return (size_t)(4 * Layer<T>::out_size * (Layer<T>::in_size + Layer<T>::out_size)); }
+
     /** Performs forward propagation for this layer. */
     RTNEURAL_REALTIME inline void forward(const T* input, T* h) noexcept override
     {
@@ -69,6 +88,21 @@ public:
         vCopy(h, ht1.data(), Layer<T>::out_size);
     }
 
+    /**
+     * Performs forward propagation for a block of frames.
+     *
+     * The frames in the block are not guaranteed to be aligned, so the
+     * outputs are computed in an aligned scratch buffer.
+     */
+    RTNEURAL_REALTIME inline void forwardBlock(const T* input, T* h, int numSamples) noexcept override
+    {
+        for(int n = 0; n < numSamples; ++n)
+        {
+            LSTMLayer::forward(input + n * Layer<T>::in_size, outFrame.data());
+            std::copy(outFrame.begin(), outFrame.end(), h + n * Layer<T>::out_size);
+        }
+    }
+
     /**
      * Sets the layer kernel weights.
      *
@@ -121,6 +155,8 @@ protected:
 
     vec_type prod_in;
     vec_type prod_out;
+
+    vec_type outFrame;
 };
 
 //====================================================
@@ -167,6 +203,32 @@ public:
     /** Resets the state of the LSTM. */
     RTNEURAL_REALTIME void reset();
 
+    /** Returns the number of values in the LSTM state, including the sample rate correction delay lines. */
+    size_t getStateSize() const noexcept
+    {
+        return state_detail::getNumValues<T, v_type>(2 * v_out_size)
+            + state_detail::getBufferSize<T>(ct_delayed)
+            + state_detail::getBufferSize<T>(outs_delayed);
+    }
+
+    /** Copies the LSTM state into `state`, which must hold `getStateSize()` values. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept
+    {
+        state = state_detail::saveValues(outs, v_out_size, state);
+        state = state_detail::saveValues(ct, v_out_size, state);
+        state = state_detail::saveBuffer(ct_delayed, state);
+        state_detail::saveBuffer(outs_delayed, state);
+    }
+
+    /** Restores the LSTM state from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept
+    {
+        state = state_detail::loadValues(outs, v_out_size, state);
+        state = state_detail::loadValues(ct, v_out_size, state);
+        state = state_detail::loadBuffer(ct_delayed, state);
+        state_detail::loadBuffer(outs_delayed, state);
+    }
+
     /** Performs forward propagation for this layer. */
     template <int N = in_size>
     RTNEURAL_REALTIME inline typename std::enable_if<(N > 1), void>::type
@@ -190,7 +252,9 @@ public:
         for(int i = 0; i < v_out_size; ++i)
             ot[i] = MathsProvider::sigmoid(ot[i] + bo[i] + kernel_outs[i]);
 
-        computeOutputs(ins);
+        // compute ct
+        kernel_mat_mul(ins, Wc, kernel_outs);
+        computeOutputs(kernel_outs);
     }
 
     /** Performs forward propagation for this layer. */
@@ -213,7 +277,69 @@ public:
         for(int i = 0; i < v_out_size; ++i)
             ot[i] = MathsProvider::sigmoid(xsimd::fma(Wo_1[i], ins[0], ot[i] + bo[i]));
 
-        computeOutputs(ins);
+        // compute ct
+        for(int i = 0; i < v_out_size; ++i)
+            kernel_outs[i] = Wc_1[i] * ins[0];
+        computeOutputs(kernel_outs);
+    }
+
+    /**
+     * Performs forward propagation for a block of frames.
+     *
+     * The kernel products (W * x) don't depend on the recurrent state,
+     * so they are computed for a whole chunk of frames up front, and
+     * only the recurrent products are computed frame-by-frame.
+     */
+    template <int N = in_size>
+    RTNEURAL_REALTIME inline typename std::enable_if<(N > 1), void>::type
+    forwardBlock(const v_type* ins, v_type* out, int numFrames) noexcept
+    {
+        for(int offset = 0; offset < numFrames; offset += kernel_block_size)
+        {
+            const auto blockSize = std::min((int)kernel_block_size, numFrames - offset);
+            kernel_block_mat_mul(ins + offset * v_in_size, Wf, kernel_block.data(), blockSize);
+            kernel_block_mat_mul(ins + offset * v_in_size, Wi, kernel_block.data() + v_out_size, blockSize);
+            kernel_block_mat_mul(ins + offset * v_in_size, Wo, kernel_block.data() + 2 * v_out_size, blockSize);
+            kernel_block_mat_mul(ins + offset * v_in_size, Wc, kernel_block.data() + 3 * v_out_size, blockSize);
+
+            for(int n = 0; n < blockSize; ++n)
+            {
+                const auto* kernel_f = kernel_block.data() + n * 4 * v_out_size;
+                const auto* kernel_i = kernel_f + v_out_size;
+                const auto* kernel_o = kernel_f + 2 * v_out_size;
+                const auto* kernel_c = kernel_f + 3 * v_out_size;
+
+                // compute ft
+                recurrent_mat_mul(outs, Uf, ft);
+                for(int i = 0; i < v_out_size; ++i)
+                    ft[i] = MathsProvider::sigmoid(ft[i] + bf[i] + kernel_f[i]);
+
+                // compute it
+                recurrent_mat_mul(outs, Ui, it);
+                for(int i = 0; i < v_out_size; ++i)
+                    it[i] = MathsProvider::sigmoid(it[i] + bi[i] + kernel_i[i]);
+
+                // compute ot
+                recurrent_mat_mul(outs, Uo, ot);
+                for(int i = 0; i < v_out_size; ++i)
+                    ot[i] = MathsProvider::sigmoid(ot[i] + bo[i] + kernel_o[i]);
+
+                computeOutputs(kernel_c);
+                std::copy(std::begin(outs), std::end(outs), out + (offset + n) * v_out_size);
+            }
+        }
+    }
+
+    /** Performs forward propagation for a block of frames. */
+    template <int N = in_size>
+    RTNEURAL_REALTIME inline typename std::enable_if<N == 1, void>::type
+    forwardBlock(const v_type* ins, v_type* out, int numFrames) noexcept
+    {
+        for(int n = 0; n < numFrames; ++n)
+        {
+            forward(reinterpret_cast<const v_type(&)[v_in_size]>(ins[n * v_in_size]));
+            std::copy(std::begin(outs), std::end(outs), out + n * v_out_size);
+        }
     }
 
     /**
@@ -242,44 +368,28 @@ public:
 private:
     template <SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::None, void>
-    computeOutputs(const v_type (&ins)[v_in_size]) noexcept
+    computeOutputs(const v_type* kernel_c) noexcept
     {
-        computeOutputsInternal(ins, ct, outs);
+        computeOutputsInternal(kernel_c, ct, outs);
     }
 
     template <SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr != SampleRateCorrectionMode::None, void>
-    computeOutputs(const v_type (&ins)[v_in_size]) noexcept
+    computeOutputs(const v_type* kernel_c) noexcept
     {
-        computeOutputsInternal(ins, ct_delayed[delayWriteIdx], outs_delayed[delayWriteIdx]);
+        computeOutputsInternal(kernel_c, ct_delayed[delayWriteIdx], outs_delayed[delayWriteIdx]);
 
         processDelay(ct_delayed, ct, delayWriteIdx);
         processDelay(outs_delayed, outs, delayWriteIdx);
     }
 
-    template <typename VecType, int N = in_size>
-    inline std::enable_if_t<(N > 1), void>
-    computeOutputsInternal(const v_type (&ins)[v_in_size], VecType& ctVec, VecType& outsVec) noexcept
-    {
-        // compute ct
-        recurrent_mat_mul(outs, Uc, ht);
-        kernel_mat_mul(ins, Wc, kernel_outs);
-        for(int i = 0; i < v_out_size; ++i)
-            ctVec[i] = xsimd::fma(it[i], MathsProvider::tanh(ht[i] + bc[i] + kernel_outs[i]), ft[i] * ct[i]);
-
-        // compute output
-        for(int i = 0; i < v_out_size; ++i)
-            outsVec[i] = ot[i] * MathsProvider::tanh(ctVec[i]);
-    }
-
-    template <typename VecType, int N = in_size>
-    inline std::enable_if_t<N == 1, void>
-    computeOutputsInternal(const v_type (&ins)[v_in_size], VecType& ctVec, VecType& outsVec) noexcept
+    template <typename VecType>
+    inline void computeOutputsInternal(const v_type* kernel_c, VecType& ctVec, VecType& outsVec) noexcept
     {
         // compute ct
         recurrent_mat_mul(outs, Uc, ht);
         for(int i = 0; i < v_out_size; ++i)
-            ctVec[i] = xsimd::fma(it[i], MathsProvider::tanh(xsimd::fma(Wc_1[i], ins[0], ht[i] + bc[i])), ft[i] * ct[i]);
+            ctVec[i] = xsimd::fma(it[i], MathsProvider::tanh(ht[i] + bc[i] + kernel_c[i]), ft[i] * ct[i]);
 
         // compute output
         for(int i = 0; i < v_out_size; ++i)
@@ -348,6 +458,27 @@ private:
         }
     }
 
+    /** Computes the kernel products for a block of frames, with a stride of 4 * v_out_size between frames. */
+    static inline void kernel_block_mat_mul(const v_type* ins, const v_type (&mat)[in_size][v_out_size], v_type* out, int numFrames) noexcept
+    {
+        for(int n = 0; n < numFrames; ++n)
+        {
+            for(int i = 0; i < v_out_size; ++i)
+                out[n * 4 * v_out_size + i] = v_type((T)0);
+        }
+
+        // each row of the weights is re-used for every frame in the block
+        for(int k = 0; k < in_size; ++k)
+        {
+            for(int n = 0; n < numFrames; ++n)
+            {
+                const auto x = reinterpret_cast<const T*>(ins + n * v_in_size)[k];
+                for(int i = 0; i < v_out_size; ++i)
+                    out[n * 4 * v_out_size + i] += x * mat[k][i];
+            }
+        }
+    }
+
     static inline v_type sigmoid(v_type x) noexcept
     {
         return (T)1.0 / ((T)1.0 + xsimd::exp(-x));
@@ -385,6 +516,10 @@ private:
     v_type ht[v_out_size];
     v_type ct[v_out_size];
 
+    // kernel products for block processing
+    static constexpr int kernel_block_size = RTNEURAL_MODELT_BLOCK_SIZE;
+    std::vector<v_type, xsimd::aligned_allocator<v_type>> kernel_block;
+
     // needed for delays when doing sample rate correction
     std::vector<std::array<v_type, v_out_size>> ct_delayed;
     std::vector<std::array<v_type, v_out_size>> outs_delayed;
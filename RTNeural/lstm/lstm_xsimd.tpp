@@ -22,6 +22,8 @@ LSTMLayer<T, MathsProvider>::LSTMLayer(int in_size, int out_size)
 
     prod_in.resize(in_size, (T)0);
     prod_out.resize(out_size, (T)0);
+
+    outFrame.resize(out_size, (T)0);
 }
 
 template <typename T, typename MathsProvider>
@@ -155,6 +157,9 @@ LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider>::LSTMLayerT()
         }
     }
 
+    if(in_size > 1)
+        kernel_block.resize((size_t)(kernel_block_size * 4 * v_out_size), v_type((T)0));
+
     reset();
 }
 
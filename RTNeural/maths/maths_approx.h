@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace RTNEURAL_NAMESPACE
+{
+/**
+ * Coefficients and scalar implementations for the approximate maths
+ * providers (`PadeTanhMathsProvider`, `Exp2SigmoidMathsProvider`,
+ * `PolynomialEluMathsProvider`, and `FastMathsProvider`).
+ *
+ * The maximum errors given for each approximation were measured in float
+ * over [-20, 20] (in steps of 1e-5), against the standard library
+ * functions in double.
+ */
+namespace maths_approx
+{
+    /**
+     * Coefficients for the [7/6] Padé approximant of tanh,
+     * x * (n0 + n1 x^2 + n2 x^4 + x^6) / (d0 + d1 x^2 + d2 x^4 + d3 x^6),
+     * with the input clamped to +/-maxInput, where the approximant reaches 1.
+     * Maximum absolute error: 9.7e-5.
+     */
+    namespace pade_tanh
+    {
+        constexpr double n0 = 135135.0;
+        constexpr double n1 = 17325.0;
+        constexpr double n2 = 378.0;
+        constexpr double d0 = 135135.0;
+        constexpr double d1 = 62370.0;
+        constexpr double d2 = 3150.0;
+        constexpr double d3 = 28.0;
+        constexpr double maxInput = 4.97178685852754;
+    } // namespace pade_tanh
+
+    /**
+     * Coefficients for the minimax (relative error) polynomials for 2^f,
+     * on 0 <= f < 1, which are used with the exponent bits of the result
+     * to compute 2^x. The cubic has a maximum relative error of 8.6e-5,
+     * and the quintic has a maximum relative error of 8.3e-8.
+     */
+    namespace exp2_poly
+    {
+        constexpr double cubic[] = { 1.0, 0.6951155767110629, 0.22765036958592758, 0.07706210553489179 };
+        constexpr double quintic[] = { 1.0, 0.6931513071089687, 0.2401645077135218, 0.055799702453704844, 0.009017325495044436, 0.0018669905426374118 };
+    } // namespace exp2_poly
+
+    constexpr double log2e = 1.4426950408889634;
+
+    /** The bit layout of a floating-point type. */
+    template <typename T>
+    struct FloatBits;
+
+    template <>
+    struct FloatBits<float>
+    {
+        using Int = int32_t;
+        static constexpr int mantissaBits = 23;
+        static constexpr Int exponentBias = 127;
+        static constexpr float maxExponent = 126.0f;
+    };
+
+    template <>
+    struct FloatBits<double>
+    {
+        using Int = int64_t;
+        static constexpr int mantissaBits = 52;
+        static constexpr Int exponentBias = 1023;
+        static constexpr double maxExponent = 1022.0;
+    };
+
+    /** Evaluates the 2^f polynomial of the given degree (3 or 5), for 0 <= f < 1. */
+    template <int degree, typename T, typename Scalar = T>
+    inline T exp2Poly(T f) noexcept
+    {
+        static_assert(degree == 3 || degree == 5, "The 2^x approximation must be cubic or quintic!");
+        using namespace exp2_poly;
+        if(degree == 3)
+            return (T)(Scalar)cubic[0] + f * ((T)(Scalar)cubic[1] + f * ((T)(Scalar)cubic[2] + f * (T)(Scalar)cubic[3]));
+
+        return (T)(Scalar)quintic[0] + f * ((T)(Scalar)quintic[1] + f * ((T)(Scalar)quintic[2] + f * ((T)(Scalar)quintic[3] + f * ((T)(Scalar)quintic[4] + f * (T)(Scalar)quintic[5]))));
+    }
+
+    /** Evaluates the rational part of the Padé tanh approximation (without clamping). */
+    template <typename T, typename Scalar = T>
+    inline T padeTanhRational(T x) noexcept
+    {
+        using namespace pade_tanh;
+        const auto x2 = x * x;
+        const auto num = x * ((T)(Scalar)n0 + x2 * ((T)(Scalar)n1 + x2 * ((T)(Scalar)n2 + x2)));
+        const auto den = (T)(Scalar)d0 + x2 * ((T)(Scalar)d1 + x2 * ((T)(Scalar)d2 + x2 * (T)(Scalar)d3));
+        return num / den;
+    }
+
+    /** Scalar approximation of tanh(x), with a [7/6] Padé approximant. */
+    template <typename T>
+    inline T tanh(T x) noexcept
+    {
+        return padeTanhRational(std::min(std::max(x, (T)-pade_tanh::maxInput), (T)pade_tanh::maxInput));
+    }
+
+    /**
+     * Scalar approximation of 2^x, from a polynomial for the fractional part
+     * of x, and the exponent bits for the integer part. The input is clamped
+     * to the range of normal numbers.
+     */
+    template <int degree, typename T>
+    inline T exp2(T x) noexcept
+    {
+        using Bits = FloatBits<T>;
+        x = std::min(std::max(x, (T)-Bits::maxExponent), (T)Bits::maxExponent);
+        const auto n = std::floor(x);
+        const auto bits = (typename Bits::Int)((typename Bits::Int)n + Bits::exponentBias) << Bits::mantissaBits;
+
+        T scale;
+        std::memcpy(&scale, &bits, sizeof(T));
+        return exp2Poly<degree>(x - n) * scale;
+    }
+
+    /** Scalar approximation of exp(x), with a quintic polynomial. Maximum relative error: 1.1e-6. */
+    template <typename T>
+    inline T exp(T x) noexcept
+    {
+        return exp2<5>(x * (T)log2e);
+    }
+
+    /** Scalar approximation of 1 / (1 + exp(-x)), with a cubic polynomial. Maximum absolute error: 2.2e-5. */
+    template <typename T>
+    inline T sigmoid(T x) noexcept
+    {
+        return (T)1 / ((T)1 + exp2<3>(-x * (T)log2e));
+    }
+} // namespace maths_approx
+} // namespace RTNEURAL_NAMESPACE
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "maths_approx.h"
 #include <cmath>
+#include <type_traits>
 
 namespace RTNEURAL_NAMESPACE
 {
@@ -25,4 +27,282 @@ struct DefaultMathsProvider
         return x.array().exp();
     }
 };
+
+namespace maths_approx
+{
+    template <typename Packet>
+    Packet ldexp(const Packet& a, const Packet& n, std::false_type)
+    {
+        return Eigen::internal::pldexp(a, n);
+    }
+
+    template <typename Packet>
+    Packet ldexp(const Packet& a, const Packet& n, std::true_type)
+    {
+        return Eigen::internal::pldexp_fast_impl<Packet>::run(a, n);
+    }
+
+    /**
+     * Computes a * 2^n, for packets where n is an integer in the range of
+     * normal exponents. Float packets set the exponent bits directly.
+     */
+    template <typename Packet>
+    Packet ldexp(const Packet& a, const Packet& n)
+    {
+        using Scalar = typename Eigen::internal::unpacket_traits<Packet>::type;
+        return ldexp(a, n, std::integral_constant<bool, std::is_same<Scalar, float>::value && !std::is_same<Packet, float>::value> {});
+    }
+
+    /** Eigen functor for the Padé tanh approximation. */
+    template <typename T>
+    struct TanhOp
+    {
+        T operator()(const T& x) const { return maths_approx::tanh(x); }
+
+        template <typename Packet>
+        Packet packetOp(const Packet& x) const
+        {
+            using namespace Eigen::internal;
+            using namespace pade_tanh;
+            const auto xClamped = pmin(pmax(x, pset1<Packet>((T)-maxInput)), pset1<Packet>((T)maxInput));
+            const auto x2 = pmul(xClamped, xClamped);
+            const auto num = pmul(xClamped, pmadd(x2, pmadd(x2, padd(x2, pset1<Packet>((T)n2)), pset1<Packet>((T)n1)), pset1<Packet>((T)n0)));
+            const auto den = pmadd(x2, pmadd(x2, pmadd(x2, pset1<Packet>((T)d3), pset1<Packet>((T)d2)), pset1<Packet>((T)d1)), pset1<Packet>((T)d0));
+            return pdiv(num, den);
+        }
+    };
+
+    /** Eigen functor for the sigmoid function, computed from the Padé tanh approximation. */
+    template <typename T>
+    struct TanhSigmoidOp
+    {
+        T operator()(const T& x) const { return (T)0.5 + (T)0.5 * maths_approx::tanh((T)0.5 * x); }
+
+        template <typename Packet>
+        Packet packetOp(const Packet& x) const
+        {
+            using namespace Eigen::internal;
+            const auto half = pset1<Packet>((T)0.5);
+            return pmadd(half, TanhOp<T> {}.packetOp(pmul(half, x)), half);
+        }
+    };
+
+    /** Eigen functor for the 2^x approximation, with a polynomial of the given degree. */
+    template <typename T, int degree>
+    struct Exp2Op
+    {
+        T operator()(const T& x) const { return maths_approx::exp2<degree>(x); }
+
+        template <typename Packet>
+        Packet packetOp(const Packet& x) const
+        {
+            using namespace Eigen::internal;
+            const auto xClamped = pmin(pmax(x, pset1<Packet>(-FloatBits<T>::maxExponent)), pset1<Packet>((T)FloatBits<T>::maxExponent));
+            const auto n = pfloor(xClamped);
+            const auto f = psub(xClamped, n);
+
+            const auto* c = degree == 3 ? exp2_poly::cubic : exp2_poly::quintic;
+            auto p = pset1<Packet>((T)c[degree]);
+            for(int k = degree - 1; k >= 0; --k)
+                p = pmadd(p, f, pset1<Packet>((T)c[k]));
+
+            return maths_approx::ldexp(p, n);
+        }
+    };
+
+    /** Eigen functor for the exp approximation, with a quintic polynomial. */
+    template <typename T>
+    struct ExpOp
+    {
+        T operator()(const T& x) const { return maths_approx::exp(x); }
+
+        template <typename Packet>
+        Packet packetOp(const Packet& x) const
+        {
+            using namespace Eigen::internal;
+            return Exp2Op<T, 5> {}.packetOp(pmul(x, pset1<Packet>((T)log2e)));
+        }
+    };
+
+    /** Eigen functor for the sigmoid approximation, with a cubic polynomial for 2^x. */
+    template <typename T>
+    struct SigmoidOp
+    {
+        T operator()(const T& x) const { return maths_approx::sigmoid(x); }
+
+        template <typename Packet>
+        Packet packetOp(const Packet& x) const
+        {
+            using namespace Eigen::internal;
+            const auto one = pset1<Packet>((T)1);
+            const auto e = Exp2Op<T, 3> {}.packetOp(pmul(x, pset1<Packet>((T)-log2e)));
+            return pdiv(one, padd(one, e));
+        }
+    };
+} // namespace maths_approx
+
+/**
+ * Maths provider with a fast rational (Padé) approximation of tanh,
+ * which is also used for the sigmoid function, as 0.5 + 0.5 * tanh(x / 2).
+ * Maximum absolute error: 9.7e-5 (tanh), 4.9e-5 (sigmoid).
+ */
+struct PadeTanhMathsProvider
+{
+    template <typename Matrix>
+    static auto tanh(const Matrix& x)
+    {
+        return x.array().unaryExpr(maths_approx::TanhOp<typename Matrix::Scalar> {});
+    }
+
+    template <typename Matrix>
+    static auto sigmoid(const Matrix& x)
+    {
+        return x.array().unaryExpr(maths_approx::TanhSigmoidOp<typename Matrix::Scalar> {});
+    }
+
+    template <typename Matrix>
+    static auto exp(const Matrix& x)
+    {
+        return x.array().exp();
+    }
+};
+
+/**
+ * Maths provider with a fast sigmoid function, computed from a 2^x
+ * approximation which uses a cubic polynomial for the fractional part,
+ * and sets the exponent bits directly for the integer part.
+ * Maximum absolute error: 2.2e-5 (sigmoid).
+ */
+struct Exp2SigmoidMathsProvider
+{
+    template <typename Matrix>
+    static auto tanh(const Matrix& x)
+    {
+        return x.array().tanh();
+    }
+
+    template <typename Matrix>
+    static auto sigmoid(const Matrix& x)
+    {
+        return x.array().unaryExpr(maths_approx::SigmoidOp<typename Matrix::Scalar> {});
+    }
+
+    template <typename Matrix>
+    static auto exp(const Matrix& x)
+    {
+        return x.array().exp();
+    }
+};
+
+/**
+ * Maths provider with a fast exp function (used by the ELU and softmax
+ * activations), computed from a quintic polynomial for 2^x.
+ * Maximum relative error: 1.1e-6 (exp), maximum absolute error
+ * of exp(x) - 1 for x <= 0 (as used by ELU): 1.7e-7.
+ */
+struct PolynomialEluMathsProvider
+{
+    template <typename Matrix>
+    static auto tanh(const Matrix& x)
+    {
+        return x.array().tanh();
+    }
+
+    template <typename Matrix>
+    static auto sigmoid(const Matrix& x)
+    {
+        using T = typename Matrix::Scalar;
+        return (T)1 / (((T)-1 * x.array()).array().exp() + (T)1);
+    }
+
+    template <typename Matrix>
+    static auto exp(const Matrix& x)
+    {
+        return x.array().unaryExpr(maths_approx::ExpOp<typename Matrix::Scalar> {});
+    }
+};
+
+/**
+ * Maths provider which uses the fastest approximations: Padé tanh (which
+ * is also used for the sigmoid function), and polynomial exp.
+ */
+struct FastMathsProvider
+{
+    template <typename Matrix>
+    static auto tanh(const Matrix& x)
+    {
+        return x.array().unaryExpr(maths_approx::TanhOp<typename Matrix::Scalar> {});
+    }
+
+    template <typename Matrix>
+    static auto sigmoid(const Matrix& x)
+    {
+        return x.array().unaryExpr(maths_approx::TanhSigmoidOp<typename Matrix::Scalar> {});
+    }
+
+    template <typename Matrix>
+    static auto exp(const Matrix& x)
+    {
+        return x.array().unaryExpr(maths_approx::ExpOp<typename Matrix::Scalar> {});
+    }
+};
 }
+
+#ifndef DOXYGEN
+namespace Eigen
+{
+namespace internal
+{
+    template <typename T>
+    struct functor_traits<RTNEURAL_NAMESPACE::maths_approx::TanhOp<T>>
+    {
+        enum
+        {
+            Cost = 9 * NumTraits<T>::MulCost + 7 * NumTraits<T>::AddCost + scalar_div_cost<T, packet_traits<T>::HasDiv>::value,
+            PacketAccess = packet_traits<T>::HasDiv && packet_traits<T>::HasMin && packet_traits<T>::HasMax
+        };
+    };
+
+    template <typename T>
+    struct functor_traits<RTNEURAL_NAMESPACE::maths_approx::TanhSigmoidOp<T>>
+    {
+        enum
+        {
+            Cost = functor_traits<RTNEURAL_NAMESPACE::maths_approx::TanhOp<T>>::Cost + 2 * NumTraits<T>::MulCost,
+            PacketAccess = functor_traits<RTNEURAL_NAMESPACE::maths_approx::TanhOp<T>>::PacketAccess
+        };
+    };
+
+    template <typename T, int degree>
+    struct functor_traits<RTNEURAL_NAMESPACE::maths_approx::Exp2Op<T, degree>>
+    {
+        enum
+        {
+            Cost = (degree + 2) * NumTraits<T>::MulCost + (degree + 4) * NumTraits<T>::AddCost,
+            PacketAccess = packet_traits<T>::HasFloor && packet_traits<T>::HasMin && packet_traits<T>::HasMax
+        };
+    };
+
+    template <typename T>
+    struct functor_traits<RTNEURAL_NAMESPACE::maths_approx::ExpOp<T>>
+    {
+        enum
+        {
+            Cost = functor_traits<RTNEURAL_NAMESPACE::maths_approx::Exp2Op<T, 5>>::Cost + NumTraits<T>::MulCost,
+            PacketAccess = functor_traits<RTNEURAL_NAMESPACE::maths_approx::Exp2Op<T, 5>>::PacketAccess
+        };
+    };
+
+    template <typename T>
+    struct functor_traits<RTNEURAL_NAMESPACE::maths_approx::SigmoidOp<T>>
+    {
+        enum
+        {
+            Cost = functor_traits<RTNEURAL_NAMESPACE::maths_approx::Exp2Op<T, 3>>::Cost + NumTraits<T>::MulCost
+                + NumTraits<T>::AddCost + scalar_div_cost<T, packet_traits<T>::HasDiv>::value,
+            PacketAccess = functor_traits<RTNEURAL_NAMESPACE::maths_approx::Exp2Op<T, 3>>::PacketAccess && packet_traits<T>::HasDiv
+        };
+    };
+} // namespace internal
+} // namespace Eigen
+#endif
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "maths_approx.h"
 #include <cmath>
 
 namespace RTNEURAL_NAMESPACE
@@ -24,4 +25,109 @@ struct DefaultMathsProvider
         return std::exp(x);
     }
 };
+
+/**
+ * Maths provider with a fast rational (Padé) approximation of tanh,
+ * which is also used for the sigmoid function, as 0.5 + 0.5 * tanh(x / 2).
+ * Maximum absolute error: 9.7e-5 (tanh), 4.9e-5 (sigmoid).
+ */
+struct PadeTanhMathsProvider
+{
+    template <typename T>
+    static T tanh(T x)
+    {
+        return maths_approx::tanh(x);
+    }
+
+    template <typename T>
+    static T sigmoid(T x)
+    {
+        return (T)0.5 + (T)0.5 * maths_approx::tanh((T)0.5 * x);
+    }
+
+    template <typename T>
+    static T exp(T x)
+    {
+        return std::exp(x);
+    }
+};
+
+/**
+ * Maths provider with a fast sigmoid function, computed from a 2^x
+ * approximation which uses a cubic polynomial for the fractional part,
+ * and sets the exponent bits directly for the integer part.
+ * Maximum absolute error: 2.2e-5 (sigmoid).
+ */
+struct Exp2SigmoidMathsProvider
+{
+    template <typename T>
+    static T tanh(T x)
+    {
+        return std::tanh(x);
+    }
+
+    template <typename T>
+    static T sigmoid(T x)
+    {
+        return maths_approx::sigmoid(x);
+    }
+
+    template <typename T>
+    static T exp(T x)
+    {
+        return std::exp(x);
+    }
+};
+
+/**
+ * Maths provider with a fast exp function (used by the ELU and softmax
+ * activations), computed from a quintic polynomial for 2^x.
+ * Maximum relative error: 1.1e-6 (exp), maximum absolute error
+ * of exp(x) - 1 for x <= 0 (as used by ELU): 1.7e-7.
+ */
+struct PolynomialEluMathsProvider
+{
+    template <typename T>
+    static T tanh(T x)
+    {
+        return std::tanh(x);
+    }
+
+    template <typename T>
+    static T sigmoid(T x)
+    {
+        return (T)1 / ((T)1 + std::exp(-x));
+    }
+
+    template <typename T>
+    static T exp(T x)
+    {
+        return maths_approx::exp(x);
+    }
+};
+
+/**
+ * Maths provider which uses the fastest approximations: Padé tanh (which
+ * is also used for the sigmoid function), and polynomial exp.
+ */
+struct FastMathsProvider
+{
+    template <typename T>
+    static T tanh(T x)
+    {
+        return maths_approx::tanh(x);
+    }
+
+    template <typename T>
+    static T sigmoid(T x)
+    {
+        return (T)0.5 + (T)0.5 * maths_approx::tanh((T)0.5 * x);
+    }
+
+    template <typename T>
+    static T exp(T x)
+    {
+        return maths_approx::exp(x);
+    }
+};
 }
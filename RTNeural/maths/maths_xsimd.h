@@ -1,5 +1,6 @@
 #pragma once
 
+#include "maths_approx.h"
 #include <cmath>
 
 namespace RTNEURAL_NAMESPACE
@@ -30,4 +31,160 @@ struct DefaultMathsProvider
         return exp(x);
     }
 };
+
+namespace maths_approx
+{
+    /** SIMD approximation of tanh(x), with a [7/6] Padé approximant. */
+    template <typename T, typename A>
+    inline xsimd::batch<T, A> tanh(const xsimd::batch<T, A>& x) noexcept
+    {
+        using b_type = xsimd::batch<T, A>;
+        const auto maxInput = b_type((T)pade_tanh::maxInput);
+        return padeTanhRational<b_type, T>(xsimd::min(xsimd::max(x, -maxInput), maxInput));
+    }
+
+    /** SIMD approximation of 2^x (see the scalar `exp2()`). */
+    template <int degree, typename T, typename A>
+    inline xsimd::batch<T, A> exp2(const xsimd::batch<T, A>& x) noexcept
+    {
+        using b_type = xsimd::batch<T, A>;
+        using Bits = FloatBits<T>;
+        using int_type = xsimd::batch<typename Bits::Int, A>;
+
+        const auto xClamped = xsimd::min(xsimd::max(x, b_type((T)-Bits::maxExponent)), b_type((T)Bits::maxExponent));
+        const auto n = xsimd::floor(xClamped);
+        const auto bits = (xsimd::batch_cast<typename Bits::Int>(n) + int_type((typename Bits::Int)Bits::exponentBias)) << Bits::mantissaBits;
+        return exp2Poly<degree, b_type, T>(xClamped - n) * xsimd::bitwise_cast<T>(bits);
+    }
+
+    /** SIMD approximation of exp(x), with a quintic polynomial. */
+    template <typename T, typename A>
+    inline xsimd::batch<T, A> exp(const xsimd::batch<T, A>& x) noexcept
+    {
+        return exp2<5>(x * (T)log2e);
+    }
+
+    /** SIMD approximation of 1 / (1 + exp(-x)), with a cubic polynomial. */
+    template <typename T, typename A>
+    inline xsimd::batch<T, A> sigmoid(const xsimd::batch<T, A>& x) noexcept
+    {
+        using b_type = xsimd::batch<T, A>;
+        return b_type((T)1) / (b_type((T)1) + exp2<3>(x * (T)-log2e));
+    }
+} // namespace maths_approx
+
+/**
+ * Maths provider with a fast rational (Padé) approximation of tanh,
+ * which is also used for the sigmoid function, as 0.5 + 0.5 * tanh(x / 2).
+ * Maximum absolute error: 9.7e-5 (tanh), 4.9e-5 (sigmoid).
+ */
+struct PadeTanhMathsProvider
+{
+    template <typename T>
+    static T tanh(T x)
+    {
+        return maths_approx::tanh(x);
+    }
+
+    template <typename T>
+    static T sigmoid(T x)
+    {
+        return (T)0.5 + (T)0.5 * maths_approx::tanh((T)0.5 * x);
+    }
+
+    template <typename T>
+    static T exp(T x)
+    {
+        using std::exp;
+        using xsimd::exp;
+        return exp(x);
+    }
+};
+
+/**
+ * Maths provider with a fast sigmoid function, computed from a 2^x
+ * approximation which uses a cubic polynomial for the fractional part,
+ * and sets the exponent bits directly for the integer part.
+ * Maximum absolute error: 2.2e-5 (sigmoid).
+ */
+struct Exp2SigmoidMathsProvider
+{
+    template <typename T>
+    static T tanh(T x)
+    {
+        using std::tanh;
+        using xsimd::tanh;
+        return tanh(x);
+    }
+
+    template <typename T>
+    static T sigmoid(T x)
+    {
+        return maths_approx::sigmoid(x);
+    }
+
+    template <typename T>
+    static T exp(T x)
+    {
+        using std::exp;
+        using xsimd::exp;
+        return exp(x);
+    }
+};
+
+/**
+ * Maths provider with a fast exp function (used by the ELU and softmax
+ * activations), computed from a quintic polynomial for 2^x.
+ * Maximum relative error: 1.1e-6 (exp), maximum absolute error
+ * of exp(x) - 1 for x <= 0 (as used by ELU): 1.7e-7.
+ */
+struct PolynomialEluMathsProvider
+{
+    template <typename T>
+    static T tanh(T x)
+    {
+        using std::tanh;
+        using xsimd::tanh;
+        return tanh(x);
+    }
+
+    template <typename T>
+    static T sigmoid(T x)
+    {
+        using std::exp;
+        using xsimd::exp;
+        return (T)1 / ((T)1 + exp(-x));
+    }
+
+    template <typename T>
+    static T exp(T x)
+    {
+        return maths_approx::exp(x);
+    }
+};
+
+/**
+ * Maths provider which uses the fastest approximations: Padé tanh (which
+ * is also used for the sigmoid function), and polynomial exp.
+ */
+struct FastMathsProvider
+{
+    template <typename T>
+    static T tanh(T x)
+    {
+        return maths_approx::tanh(x);
+    }
+
+    template <typename T>
+    static T sigmoid(T x)
+    {
+        return (T)0.5 + (T)0.5 * maths_approx::tanh((T)0.5 * x);
+    }
+
+    template <typename T>
+    static T exp(T x)
+    {
+        return maths_approx::exp(x);
+    }
+};
 }
@@ -0,0 +1,142 @@
+#ifndef MEMORY_ARENA_H_INCLUDED
+#define MEMORY_ARENA_H_INCLUDED
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#include "config.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * A single block of aligned memory, which hands out buffers
+ * in the order that they are requested. Every buffer starts on
+ * a `RTNEURAL_DEFAULT_ALIGNMENT` boundary.
+ *
+ * The memory is either allocated by the arena, or provided by the
+ * caller (e.g. pre-faulted or huge-page memory). Caller-provided
+ * memory must outlive the arena, and anything placed in it.
+ */
+class MemoryArena
+{
+public:
+    static constexpr size_t alignment = RTNEURAL_DEFAULT_ALIGNMENT;
+
+    /** Creates an empty arena. */
+    MemoryArena() = default;
+
+    /** Creates an arena which allocates (and owns) `numBytes` bytes of zero-initialised memory. */
+    explicit MemoryArena(size_t numBytes)
+        : ownedMemory(new unsigned char[numBytes + alignment - 1]())
+        , capacity(numBytes)
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(ownedMemory.get());
+        memory = ownedMemory.get() + (alignment - address % alignment) % alignment;
+    }
+
+    /**
+     * Creates an arena which uses `numBytes` bytes of caller-provided memory.
+     * The memory must be aligned to `MemoryArena::alignment`.
+     */
+    MemoryArena(void* callerMemory, size_t numBytes)
+        : memory(static_cast<unsigned char*>(callerMemory))
+        , capacity(numBytes)
+    {
+        assert(isAligned(callerMemory));
+    }
+
+    MemoryArena(MemoryArena&&) noexcept = default;
+    MemoryArena& operator=(MemoryArena&&) noexcept = default;
+
+    /** Returns the number of bytes used by a buffer of `count` elements, including padding. */
+    template <typename U>
+    static constexpr size_t getBytes(size_t count) noexcept
+    {
+        return (count * sizeof(U) + alignment - 1) / alignment * alignment;
+    }
+
+    /** Returns true if the given pointer is suitably aligned for the start of an arena. */
+    static bool isAligned(const void* ptr) noexcept
+    {
+        return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+    }
+
+    /**
+     * Returns a buffer of `count` elements from the arena.
+     * The buffer is not initialised.
+     */
+    template <typename U>
+    U* allocate(size_t count) noexcept
+    {
+        const auto numBytes = getBytes<U>(count);
+        assert(bytesUsed + numBytes <= capacity);
+
+        auto* ptr = memory + bytesUsed;
+        bytesUsed += numBytes;
+        return reinterpret_cast<U*>(ptr);
+    }
+
+    /**
+     * Points a matrix view (e.g. an `Eigen::Map`) at a `rows x cols`
+     * buffer from the arena. The view is re-constructed in place, since
+     * assigning to a view would copy the data rather than the pointer.
+     */
+    template <typename MapType>
+    void allocateMap(MapType& map, std::ptrdiff_t rows, std::ptrdiff_t cols) noexcept
+    {
+        using Scalar = typename MapType::Scalar;
+        new(&map) MapType(allocate<Scalar>((size_t)(rows * cols)), rows, cols);
+    }
+
+    /** Returns a (non-owning) arena made from the next `numBytes` bytes of this arena. */
+    MemoryArena allocateArena(size_t numBytes) noexcept
+    {
+        return { allocate<unsigned char>(numBytes), getBytes<unsigned char>(numBytes) };
+    }
+
+    /**
+     * Copies the contents of this arena into a new region of `arena`,
+     * and makes this arena refer to that region (releasing any memory
+     * that this arena owned). Buffers taken from this arena must be
+     * re-taken (after calling `rewind()`) to point at the new region.
+     */
+    void moveInto(MemoryArena& arena) noexcept
+    {
+        auto newMemory = arena.allocateArena(capacity);
+        std::copy(memory, memory + capacity, newMemory.data());
+        *this = std::move(newMemory);
+    }
+
+    /**
+     * Moves back to the start of the arena, so that buffers are handed out again
+     * from the beginning. The contents of the memory are left unchanged.
+     */
+    void rewind() noexcept { bytesUsed = 0; }
+
+    /** Returns a pointer to the start of the arena. */
+    unsigned char* data() const noexcept { return memory; }
+
+    /** Returns the size of the arena in bytes. */
+    size_t getCapacity() const noexcept { return capacity; }
+
+    /** Returns the number of bytes that have been handed out. */
+    size_t getBytesUsed() const noexcept { return bytesUsed; }
+
+    /** Returns true if the arena allocated its own memory. */
+    bool ownsMemory() const noexcept { return ownedMemory != nullptr; }
+
+private:
+    std::unique_ptr<unsigned char[]> ownedMemory;
+    unsigned char* memory = nullptr;
+    size_t capacity = 0;
+    size_t bytesUsed = 0;
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // MEMORY_ARENA_H_INCLUDED
@@ -2,6 +2,16 @@
 
 #include "../modules/json/json.hpp"
 #include "Model.h"
+#include "low_rank/dense_low_rank.h"
+#include "quantized/conv1d_half.h"
+#include "quantized/conv1d_int8.h"
+#include "quantized/dense_half.h"
+#include "quantized/dense_int8.h"
+#include "quantized/gru_half.h"
+#include "quantized/lstm_half.h"
+#include "sparse/dense_sparse.h"
+#include "sparse/gru_sparse.h"
+#include "sparse/lstm_sparse.h"
 #include <fstream>
 #include <memory>
 #include <string>
@@ -33,6 +43,128 @@ namespace json_parser
     }
 #endif
 
+    /** The storage format for the weights of the layers created by `parseJson()`. */
+    enum class WeightFormat
+    {
+        Float, /**< Weights are stored in the model's data type. */
+        Int8, /**< Dense and convolution weights are quantized to int8 (see `DenseInt8` and `Conv1DInt8`). */
+        BFloat16, /**< Dense, convolution, and recurrent weights are stored as bfloat16 (see `DenseHalf`, `GRULayerHalf`, etc). */
+        Float16, /**< Dense, convolution, and recurrent weights are stored as IEEE half-precision floats. */
+    };
+
+    /** Returns the name used for a weight format in json model files. */
+    inline std::string getWeightFormatName(WeightFormat format)
+    {
+        switch(format)
+        {
+        case WeightFormat::Int8:
+            return "int8";
+        case WeightFormat::BFloat16:
+            return "bfloat16";
+        case WeightFormat::Float16:
+            return "float16";
+        default:
+            return "float";
+        }
+    }
+
+    /**
+     * Returns the weight format for a json layer. Layers may set their own
+     * format with a `"weight_format"` field (e.g. as written by the quantization
+     * tool), which overrides the format requested for the whole model.
+     */
+    inline WeightFormat getLayerWeightFormat(const nlohmann::json& l, WeightFormat modelFormat)
+    {
+        if(!l.contains("weight_format"))
+            return modelFormat;
+
+        const auto name = l.at("weight_format").get<std::string>();
+        for(auto format : { WeightFormat::Float, WeightFormat::Int8, WeightFormat::BFloat16, WeightFormat::Float16 })
+        {
+            if(name == getWeightFormatName(format))
+                return format;
+        }
+
+        return modelFormat;
+    }
+
+    /**
+     * The fraction of all-zero weight blocks above which `parseJson()` stores
+     * the weights of a dense layer (or the recurrent weights of a GRU or LSTM
+     * layer) in a block-sparse format (see `DenseSparse`). Below this,
+     * the sparse layers are about as fast as the dense layers.
+     */
+    constexpr float defaultSparsityThreshold = 0.7f;
+
+    /** Options for loading a model with `parseJson()`. */
+    struct LoadOptions
+    {
+        /** Prints information about each layer while loading. */
+        bool debug = false;
+
+        /**
+         * Stores the weights of some layers in a smaller format (see `WeightFormat`).
+         * Layers with a `"weight_format"` field in the json use that format instead.
+         */
+        WeightFormat weightFormat = WeightFormat::Float;
+
+        /**
+         * Dense layers (and the recurrent weights of GRU and LSTM layers) with
+         * float weights are stored in a block-sparse format when the fraction
+         * of all-zero weight blocks is at least this threshold. Use a threshold
+         * above 1 to always use the dense layers.
+         */
+        float sparsityThreshold = defaultSparsityThreshold;
+
+        /**
+         * If above zero, the weights of other float dense layers are factorized
+         * (see `DenseLowRank`), allowing a relative error of up to this tolerance,
+         * and the low-rank layer is used if it takes fewer multiply-adds. Layers
+         * may set their own tolerance with a `"low_rank_tolerance"` field. Dense
+         * layers with pre-factored weights always use the low-rank layer.
+         */
+        float lowRankTolerance = 0.0f;
+
+        /**
+         * If above zero, tanh, sigmoid, and ELU activations read from a lookup
+         * table with this many entries (see `LUTActivation`). Layers may set
+         * their own table size with an `"activation_table_size"` field.
+         */
+        int activationTableSize = 0;
+    };
+
+    /**
+     * Returns the fraction of all-zero blocks in the block-sparse format of
+     * a json weight matrix with size weights[in_size][out_size] (as used for
+     * dense kernels and recurrent weights).
+     */
+    inline float getBlockSparsity(const nlohmann::json& weights)
+    {
+        const auto in_size = (int)weights.size();
+        const auto out_size = in_size == 0 ? 0 : (int)weights.at(0).size();
+        return sparse_detail::getBlockSparsity([&weights](int i, int k)
+            { return weights[(size_t)k][(size_t)i].get<double>(); },
+            out_size, in_size);
+    }
+
+    /** Sets the calibrated input range of an int8 layer, if the json layer has an `"input_range"` field. */
+    template <typename T, typename Int8LayerType>
+    void loadInputRange(Int8LayerType& layer, const nlohmann::json& l)
+    {
+        if(l.contains("input_range"))
+            layer.setInputRange(l.at("input_range").get<T>());
+    }
+
+    /**
+     * Returns true if the json weights of a dense layer are pre-factored,
+     * i.e. the kernel is stored as two matrices with sizes [in_size][rank]
+     * and [rank][out_size], followed by the bias.
+     */
+    inline bool isFactoredDense(const nlohmann::json& weights)
+    {
+        return weights.size() == 3;
+    }
+
     /** Loads weights for a Dense (or DenseT) layer from a json representation of the layer weights. */
     template <typename T, typename DenseType>
     void loadDense(DenseType& dense, const nlohmann::json& weights)
@@ -42,18 +174,63 @@ namespace json_parser
         for(auto& w : denseWeights)
             w.resize(dense.in_size, (T)0);
 
-        auto layerWeights = weights.at(0);
-        for(size_t i = 0; i < layerWeights.size(); ++i)
+        if(isFactoredDense(weights))
         {
-            auto lw = layerWeights.at(i);
-            for(size_t j = 0; j < lw.size(); ++j)
-                denseWeights.at(j).at(i) = lw.at(j).get<T>();
+            // multiply out the pre-factored kernel
+            const auto kernelA = weights.at(0).get<std::vector<std::vector<T>>>();
+            const auto kernelB = weights.at(1).get<std::vector<std::vector<T>>>();
+            for(size_t i = 0; i < kernelA.size(); ++i)
+                for(size_t r = 0; r < kernelB.size(); ++r)
+                    for(size_t j = 0; j < kernelB[r].size(); ++j)
+                        denseWeights.at(j).at(i) += kernelA[i][r] * kernelB[r][j];
+        }
+        else
+        {
+            auto layerWeights = weights.at(0);
+            for(size_t i = 0; i < layerWeights.size(); ++i)
+            {
+                auto lw = layerWeights.at(i);
+                for(size_t j = 0; j < lw.size(); ++j)
+                    denseWeights.at(j).at(i) = lw.at(j).get<T>();
+            }
         }
 
         dense.setWeights(denseWeights);
 
         // load biases
-        std::vector<T> denseBias = weights.at(1).get<std::vector<T>>();
+        std::vector<T> denseBias = weights.back().get<std::vector<T>>();
+        dense.setBias(denseBias.data());
+    }
+
+    /**
+     * Loads weights for a DenseLowRank (or DenseLowRankT) layer from a json
+     * representation of the layer weights. Pre-factored weights are used
+     * as they are, otherwise the weights are factorized by the layer.
+     */
+    template <typename T, typename DenseType>
+    void loadDenseLowRank(DenseType& dense, const nlohmann::json& weights)
+    {
+        if(!isFactoredDense(weights))
+        {
+            loadDense<T>(dense, weights);
+            return;
+        }
+
+        // the json kernel is in_size x out_size, so the layer factors are the transposes
+        const auto kernelA = weights.at(0).get<std::vector<std::vector<T>>>();
+        const auto kernelB = weights.at(1).get<std::vector<std::vector<T>>>();
+        std::vector<std::vector<T>> left((size_t)dense.out_size, std::vector<T>(kernelB.size(), (T)0));
+        std::vector<std::vector<T>> right(kernelB.size(), std::vector<T>((size_t)dense.in_size, (T)0));
+        for(size_t r = 0; r < kernelB.size(); ++r)
+        {
+            for(size_t j = 0; j < kernelB[r].size(); ++j)
+                left.at(j).at(r) = kernelB[r][j];
+            for(size_t i = 0; i < kernelA.size(); ++i)
+                right.at(r).at(i) = kernelA[i].at(r);
+        }
+        dense.setFactors(left, right);
+
+        std::vector<T> denseBias = weights.back().get<std::vector<T>>();
         dense.setBias(denseBias.data());
     }
 
@@ -66,6 +243,43 @@ namespace json_parser
         return std::move(dense);
     }
 
+    /** Creates a DenseInt8 layer from a json representation of the layer weights. */
+    template <typename T>
+    std::unique_ptr<DenseInt8<T>> createDenseInt8(int in_size, int out_size, const nlohmann::json& weights)
+    {
+        auto dense = std::make_unique<DenseInt8<T>>(in_size, out_size);
+        loadDense<T>(*dense.get(), weights);
+        return std::move(dense);
+    }
+
+    /** Creates a DenseHalf layer from a json representation of the layer weights. */
+    template <typename T, typename WeightType>
+    std::unique_ptr<DenseHalf<T, WeightType>> createDenseHalf(int in_size, int out_size, const nlohmann::json& weights)
+    {
+        auto dense = std::make_unique<DenseHalf<T, WeightType>>(in_size, out_size);
+        loadDense<T>(*dense.get(), weights);
+        return std::move(dense);
+    }
+
+    /** Creates a DenseSparse layer from a json representation of the layer weights. */
+    template <typename T>
+    std::unique_ptr<DenseSparse<T>> createDenseSparse(int in_size, int out_size, const nlohmann::json& weights)
+    {
+        auto dense = std::make_unique<DenseSparse<T>>(in_size, out_size);
+        loadDense<T>(*dense.get(), weights);
+        return std::move(dense);
+    }
+
+    /** Creates a DenseLowRank layer from a json representation of the layer weights. */
+    template <typename T>
+    std::unique_ptr<DenseLowRank<T>> createDenseLowRank(int in_size, int out_size, const nlohmann::json& weights, float tolerance)
+    {
+        auto dense = std::make_unique<DenseLowRank<T>>(in_size, out_size);
+        dense->setTolerance(tolerance);
+        loadDenseLowRank<T>(*dense.get(), weights);
+        return std::move(dense);
+    }
+
     /** Checks that a Dense (or DenseT) layer has the given dimensions. */
     template <typename T, typename DenseType>
     bool checkDense(const DenseType& dense, const std::string& type, int layerDims, const bool debug)
@@ -176,6 +390,26 @@ namespace json_parser
         return std::move(conv);
     }
 
+    /** Creates a Conv1DInt8 layer from a json representation of the layer weights. */
+    template <typename T>
+    std::unique_ptr<Conv1DInt8<T>> createConv1DInt8(int in_size, int out_size,
+        int kernel_size, int dilation, int groups, const nlohmann::json& weights)
+    {
+        auto conv = std::make_unique<Conv1DInt8<T>>(in_size, out_size, kernel_size, dilation, groups);
+        loadConv1D<T>(*conv.get(), kernel_size, dilation, weights);
+        return std::move(conv);
+    }
+
+    /** Creates a Conv1DHalf layer from a json representation of the layer weights. */
+    template <typename T, typename WeightType>
+    std::unique_ptr<Conv1DHalf<T, WeightType>> createConv1DHalf(int in_size, int out_size,
+        int kernel_size, int dilation, int groups, const nlohmann::json& weights)
+    {
+        auto conv = std::make_unique<Conv1DHalf<T, WeightType>>(in_size, out_size, kernel_size, dilation, groups);
+        loadConv1D<T>(*conv.get(), kernel_size, dilation, weights);
+        return std::move(conv);
+    }
+
     /** Checks that a Conv1D (or Conv1DT) layer has the given dimensions. */
     template <typename T, typename Conv1DType>
     bool checkConv1D(const Conv1DType& conv, const std::string& type, int layerDims,
@@ -326,6 +560,24 @@ namespace json_parser
         return std::move(gru);
     }
 
+    /** Creates a GRULayerHalf from a json representation of the layer weights. */
+    template <typename T, typename WeightType>
+    std::unique_ptr<GRULayerHalf<T, WeightType>> createGRUHalf(int in_size, int out_size, const nlohmann::json& weights)
+    {
+        auto gru = std::make_unique<GRULayerHalf<T, WeightType>>(in_size, out_size);
+        loadGRU<T>(*gru.get(), weights);
+        return std::move(gru);
+    }
+
+    /** Creates a GRULayerSparse from a json representation of the layer weights. */
+    template <typename T>
+    std::unique_ptr<GRULayerSparse<T>> createGRUSparse(int in_size, int out_size, const nlohmann::json& weights)
+    {
+        auto gru = std::make_unique<GRULayerSparse<T>>(in_size, out_size);
+        loadGRU<T>(*gru.get(), weights);
+        return std::move(gru);
+    }
+
     /** Checks that a GRULayer (or GRULayerT) has the given dimensions. */
     template <typename T, typename GRUType>
     bool checkGRU(const GRUType& gru, const std::string& type, int layerDims, const bool debug)
@@ -393,6 +645,24 @@ namespace json_parser
         return std::move(lstm);
     }
 
+    /** Creates a LSTMLayerHalf from a json representation of the layer weights. */
+    template <typename T, typename WeightType>
+    std::unique_ptr<LSTMLayerHalf<T, WeightType>> createLSTMHalf(int in_size, int out_size, const nlohmann::json& weights)
+    {
+        auto lstm = std::make_unique<LSTMLayerHalf<T, WeightType>>(in_size, out_size);
+        loadLSTM<T>(*lstm.get(), weights);
+        return std::move(lstm);
+    }
+
+    /** Creates a LSTMLayerSparse from a json representation of the layer weights. */
+    template <typename T>
+    std::unique_ptr<LSTMLayerSparse<T>> createLSTMSparse(int in_size, int out_size, const nlohmann::json& weights)
+    {
+        auto lstm = std::make_unique<LSTMLayerSparse<T>>(in_size, out_size);
+        loadLSTM<T>(*lstm.get(), weights);
+        return std::move(lstm);
+    }
+
     /** Checks that a LSTMLayer (or LSTMLayerT) has the given dimensions. */
     template <typename T, typename LSTMType>
     bool checkLSTM(const LSTMType& lstm, const std::string& type, int layerDims, const bool debug)
@@ -448,6 +718,31 @@ namespace json_parser
         return true;
     }
 
+    /** Checks that a GatedActivation (or GatedActivationT) has the given (output) dimensions. */
+    template <typename GatedType>
+    bool checkGatedActivation(const GatedType& gated, const std::string& type, int layerDims, const bool debug)
+    {
+        if(type != "gated_activation")
+        {
+            debug_print("Wrong layer type! Expected: Gated Activation", debug);
+            return false;
+        }
+
+        if(gated.in_size % 2 != 0)
+        {
+            debug_print("Wrong layer size! Gated activation input size must be even, got: " + std::to_string(gated.in_size), debug);
+            return false;
+        }
+
+        if(layerDims != gated.out_size)
+        {
+            debug_print("Wrong layer size! Expected: " + std::to_string(gated.out_size), debug);
+            return false;
+        }
+
+        return true;
+    }
+
     /** Loads weights for a BatchNorm1DLayer (or BatchNorm1DT) or BatchNorm2DLayer (or BatchNorm2DT) from a json representation of the layer weights. */
     template <typename T, typename BatchNormType>
     void loadBatchNorm(BatchNormType& batch_norm, const nlohmann::json& weights, bool affine)
@@ -559,11 +854,27 @@ namespace json_parser
         return true;
     }
 
-    /** Creates an activation layer of a given type. */
+    /**
+     * Creates an activation layer of a given type. If `tableSize` is above
+     * zero, tanh, sigmoid, and ELU layers read from a lookup table with
+     * that many entries (see `LUTActivation`).
+     */
     template <typename T>
     std::unique_ptr<Activation<T>>
-    createActivation(const std::string& activationType, int dims)
+    createActivation(const std::string& activationType, int dims, int tableSize = 0)
     {
+        if(tableSize > 0)
+        {
+            if(activationType == "tanh")
+                return std::make_unique<LUTActivation<T>>(dims, LUTFunction::Tanh, tableSize);
+
+            if(activationType == "sigmoid")
+                return std::make_unique<LUTActivation<T>>(dims, LUTFunction::Sigmoid, tableSize);
+
+            if(activationType == "elu")
+                return std::make_unique<LUTActivation<T>>(dims, LUTFunction::ELu, tableSize);
+        }
+
         if(activationType == "tanh")
             return std::make_unique<TanhActivation<T>>(dims);
 
@@ -601,10 +912,16 @@ namespace json_parser
         return true;
     }
 
-    /** Creates a neural network model from a json stream. */
+    /** Creates a neural network model from a json stream, with the given loading options. */
     template <typename T>
-    std::unique_ptr<Model<T>> parseJson(const nlohmann::json& parent, const bool debug = false)
+    std::unique_ptr<Model<T>> parseJson(const nlohmann::json& parent, const LoadOptions& options)
     {
+        const auto debug = options.debug;
+        const auto weightFormat = options.weightFormat;
+        const auto sparsityThreshold = options.sparsityThreshold;
+        const auto lowRankTolerance = options.lowRankTolerance;
+        const auto activationTableSize = options.activationTableSize;
+
         auto shape = parent.at("in_shape");
         auto layers = parent.at("layers");
 
@@ -629,7 +946,9 @@ namespace json_parser
 
             debug_print("  Dims: " + std::to_string(layerDims), debug);
 
-            const auto weights = l.at("weights");
+            // some layers (e.g. gated activations) have no weights
+            const auto weights = l.value("weights", nlohmann::json::array());
+            const auto layerFormat = getLayerWeightFormat(l, weightFormat);
 
             auto add_activation = [=](std::unique_ptr<Model<T>>& _model, const nlohmann::json& _l)
             {
@@ -639,7 +958,7 @@ namespace json_parser
                     if(!activationType.empty())
                     {
                         debug_print("  activation: " + activationType, debug);
-                        auto activation = createActivation<T>(activationType, layerDims);
+                        auto activation = createActivation<T>(activationType, layerDims, _l.value("activation_table_size", activationTableSize));
                         _model->addLayer(activation.release());
                     }
                 }
@@ -647,8 +966,32 @@ namespace json_parser
 
             if(type == "dense" || type == "time-distributed-dense")
             {
-                auto dense = createDense<T>(model->getNextInSize(), layerDims, weights);
-                model->addLayer(dense.release());
+                if(layerFormat == WeightFormat::Int8)
+                {
+                    auto dense = createDenseInt8<T>(model->getNextInSize(), layerDims, weights);
+                    loadInputRange<T>(*dense, l);
+                    model->addLayer(dense.release());
+                }
+                else if(layerFormat == WeightFormat::BFloat16)
+                    model->addLayer(createDenseHalf<T, bfloat16>(model->getNextInSize(), layerDims, weights).release());
+                else if(layerFormat == WeightFormat::Float16)
+                    model->addLayer(createDenseHalf<T, float16>(model->getNextInSize(), layerDims, weights).release());
+                else if(isFactoredDense(weights))
+                    model->addLayer(createDenseLowRank<T>(model->getNextInSize(), layerDims, weights, 0.0f).release());
+                else if(getBlockSparsity(weights.at(0)) >= sparsityThreshold)
+                    model->addLayer(createDenseSparse<T>(model->getNextInSize(), layerDims, weights).release());
+                else if(l.value("low_rank_tolerance", lowRankTolerance) > 0.0f)
+                {
+                    const auto in_size = model->getNextInSize();
+                    auto dense = createDenseLowRank<T>(in_size, layerDims, weights, l.value("low_rank_tolerance", lowRankTolerance));
+                    debug_print("  low-rank factorization rank: " + std::to_string(dense->getRank()), debug);
+                    if(dense->getRank() * (in_size + layerDims) < in_size * layerDims)
+                        model->addLayer(dense.release());
+                    else
+                        model->addLayer(createDense<T>(in_size, layerDims, weights).release());
+                }
+                else
+                    model->addLayer(createDense<T>(model->getNextInSize(), layerDims, weights).release());
                 add_activation(model, l);
             }
             else if(type == "conv1d")
@@ -657,8 +1000,18 @@ namespace json_parser
                 const auto dilation = l.at("dilation").back().get<int>();
                 const auto groups = l.value("groups", 1);
 
-                auto conv = createConv1D<T>(model->getNextInSize(), layerDims, kernel_size, dilation, groups, weights);
-                model->addLayer(conv.release());
+                if(layerFormat == WeightFormat::Int8)
+                {
+                    auto conv = createConv1DInt8<T>(model->getNextInSize(), layerDims, kernel_size, dilation, groups, weights);
+                    loadInputRange<T>(*conv, l);
+                    model->addLayer(conv.release());
+                }
+                else if(layerFormat == WeightFormat::BFloat16)
+                    model->addLayer(createConv1DHalf<T, bfloat16>(model->getNextInSize(), layerDims, kernel_size, dilation, groups, weights).release());
+                else if(layerFormat == WeightFormat::Float16)
+                    model->addLayer(createConv1DHalf<T, float16>(model->getNextInSize(), layerDims, kernel_size, dilation, groups, weights).release());
+                else
+                    model->addLayer(createConv1D<T>(model->getNextInSize(), layerDims, kernel_size, dilation, groups, weights).release());
                 add_activation(model, l);
             }
             else if(type == "conv2d")
@@ -683,19 +1036,39 @@ namespace json_parser
             }
             else if(type == "gru")
             {
-                auto gru = createGRU<T>(model->getNextInSize(), layerDims, weights);
-                model->addLayer(gru.release());
+                if(layerFormat == WeightFormat::BFloat16)
+                    model->addLayer(createGRUHalf<T, bfloat16>(model->getNextInSize(), layerDims, weights).release());
+                else if(layerFormat == WeightFormat::Float16)
+                    model->addLayer(createGRUHalf<T, float16>(model->getNextInSize(), layerDims, weights).release());
+                else if(getBlockSparsity(weights.at(1)) >= sparsityThreshold)
+                    model->addLayer(createGRUSparse<T>(model->getNextInSize(), layerDims, weights).release());
+                else
+                    model->addLayer(createGRU<T>(model->getNextInSize(), layerDims, weights).release());
             }
             else if(type == "lstm")
             {
-                auto lstm = createLSTM<T>(model->getNextInSize(), layerDims, weights);
-                model->addLayer(lstm.release());
+                if(layerFormat == WeightFormat::BFloat16)
+                    model->addLayer(createLSTMHalf<T, bfloat16>(model->getNextInSize(), layerDims, weights).release());
+                else if(layerFormat == WeightFormat::Float16)
+                    model->addLayer(createLSTMHalf<T, float16>(model->getNextInSize(), layerDims, weights).release());
+                else if(getBlockSparsity(weights.at(1)) >= sparsityThreshold)
+                    model->addLayer(createLSTMSparse<T>(model->getNextInSize(), layerDims, weights).release());
+                else
+                    model->addLayer(createLSTM<T>(model->getNextInSize(), layerDims, weights).release());
             }
             else if(type == "prelu")
             {
                 auto prelu = createPReLU<T>(model->getNextInSize(), weights);
                 model->addLayer(prelu.release());
             }
+            else if(type == "gated_activation")
+            {
+                auto gated = std::make_unique<GatedActivation<T>>(model->getNextInSize());
+                if(!checkGatedActivation(*gated, type, layerDims, debug))
+                    return {};
+
+                model->addLayer(gated.release());
+            }
             else if(type == "batchnorm")
             {
                 auto batch_norm = createBatchNorm<T>(model->getNextInSize(), weights, l.at("epsilon").get<T>());
@@ -717,11 +1090,29 @@ namespace json_parser
 
     /** Creates a neural network model from a json stream. */
     template <typename T>
-    std::unique_ptr<Model<T>> parseJson(std::ifstream& jsonStream, const bool debug = false)
+    std::unique_ptr<Model<T>> parseJson(const nlohmann::json& parent, const bool debug = false)
+    {
+        LoadOptions options;
+        options.debug = debug;
+        return parseJson<T>(parent, options);
+    }
+
+    /** Creates a neural network model from a json stream, with the given loading options. */
+    template <typename T>
+    std::unique_ptr<Model<T>> parseJson(std::ifstream& jsonStream, const LoadOptions& options)
     {
         nlohmann::json parent;
         jsonStream >> parent;
-        return parseJson<T>(parent, debug);
+        return parseJson<T>(parent, options);
+    }
+
+    /** Creates a neural network model from a json stream. */
+    template <typename T>
+    std::unique_ptr<Model<T>> parseJson(std::ifstream& jsonStream, const bool debug = false)
+    {
+        LoadOptions options;
+        options.debug = debug;
+        return parseJson<T>(jsonStream, options);
     }
 
 } // namespace json_parser
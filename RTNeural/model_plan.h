@@ -0,0 +1,161 @@
+#ifndef MODEL_PLAN_H_INCLUDED
+#define MODEL_PLAN_H_INCLUDED
+
+#include <type_traits>
+#include <typeinfo>
+
+#include "Layer.h"
+#include "activation/activation.h"
+#include "activation/gated_activation.h"
+#include "activation/lut_activation.h"
+#include "batchnorm/batchnorm.h"
+#include "batchnorm/batchnorm2d.h"
+#include "conv1d/conv1d.h"
+#include "conv2d/conv2d.h"
+#include "dense/dense.h"
+#include "gru/gru.h"
+#include "lstm/lstm.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * A single step of a compiled model execution plan.
+ *
+ * The function pointers call the layer's concrete implementation
+ * directly, so running the plan does not need any virtual calls.
+ * The buffer pointers are resolved when the plan is compiled, except
+ * for the model's input and output buffers, which are passed in when
+ * the plan is run.
+ */
+template <typename T>
+struct PlanOp
+{
+    using ForwardFn = void (*)(Layer<T>*, const T*, T*) noexcept;
+    using ForwardBlockFn = void (*)(Layer<T>*, const T*, T*, int) noexcept;
+
+    Layer<T>* layer = nullptr;
+    ForwardFn forward = nullptr;
+    ForwardBlockFn forwardBlock = nullptr;
+
+    const T* in = nullptr;
+    T* out = nullptr;
+    const T* blockIn = nullptr;
+    T* blockOut = nullptr;
+};
+
+#ifndef DOXYGEN
+namespace plan_detail
+{
+    template <typename LayerType, typename T>
+    void forwardDirect(Layer<T>* layer, const T* input, T* out) noexcept
+    {
+        static_cast<LayerType*>(layer)->LayerType::forward(input, out);
+    }
+
+    template <typename LayerType, typename T>
+    void forwardBlockDirect(Layer<T>* layer, const T* input, T* out, int numSamples) noexcept
+    {
+        static_cast<LayerType*>(layer)->LayerType::forwardBlock(input, out, numSamples);
+    }
+
+    /** Used for layers which don't override `forwardBlock()`, to avoid a virtual call per frame. */
+    template <typename LayerType, typename T>
+    void forwardBlockPerFrame(Layer<T>* layer, const T* input, T* out, int numSamples) noexcept
+    {
+        auto* l = static_cast<LayerType*>(layer);
+        for(int n = 0; n < numSamples; ++n)
+            l->LayerType::forward(input + n * l->in_size, out + n * l->out_size);
+    }
+
+    template <typename T>
+    void forwardVirtual(Layer<T>* layer, const T* input, T* out) noexcept
+    {
+        layer->forward(input, out);
+    }
+
+    template <typename T>
+    void forwardBlockVirtual(Layer<T>* layer, const T* input, T* out, int numSamples) noexcept
+    {
+        layer->forwardBlock(input, out, numSamples);
+    }
+
+    template <typename LayerType, typename T>
+    typename PlanOp<T>::ForwardBlockFn getForwardBlockFn(std::true_type /* overridesForwardBlock */)
+    {
+        return &forwardBlockDirect<LayerType, T>;
+    }
+
+    template <typename LayerType, typename T>
+    typename PlanOp<T>::ForwardBlockFn getForwardBlockFn(std::false_type /* overridesForwardBlock */)
+    {
+        return &forwardBlockPerFrame<LayerType, T>;
+    }
+
+    /** Fills in the function pointers if the layer is exactly a `LayerType`. */
+    template <typename T, typename LayerType>
+    bool resolve(PlanOp<T>& op)
+    {
+        if(typeid(*op.layer) != typeid(LayerType))
+            return false;
+
+        using OverridesForwardBlock = std::integral_constant<bool,
+            !std::is_same<decltype(&LayerType::forwardBlock), decltype(&Layer<T>::forwardBlock)>::value>;
+
+        op.forward = &forwardDirect<LayerType, T>;
+        op.forwardBlock = getForwardBlockFn<LayerType, T>(OverridesForwardBlock {});
+        return true;
+    }
+
+    template <typename T>
+    bool resolveAny(PlanOp<T>&)
+    {
+        return false;
+    }
+
+    template <typename T, typename LayerType, typename... OtherLayerTypes>
+    bool resolveAny(PlanOp<T>& op)
+    {
+        return resolve<T, LayerType>(op) || resolveAny<T, OtherLayerTypes...>(op);
+    }
+} // namespace plan_detail
+#endif // DOXYGEN
+
+/**
+ * Fills in the function pointers of a plan operation for its layer.
+ * The core layer types are called directly, as are the optional layers
+ * (quantized, half-precision, sparse, and low-rank), which resolve
+ * themselves with `Layer::resolvePlanOp()`. Any other layer types fall
+ * back to calling the virtual methods.
+ */
+template <typename T>
+void resolvePlanOp(PlanOp<T>& op)
+{
+    const auto resolved = plan_detail::resolveAny<T,
+        Dense<T>,
+        Conv1D<T>,
+        Conv2D<T>,
+        GRULayer<T>,
+        LSTMLayer<T>,
+        BatchNorm1DLayer<T>,
+        BatchNorm2DLayer<T>,
+        TanhActivation<T>,
+        ReLuActivation<T>,
+        SigmoidActivation<T>,
+        SoftmaxActivation<T>,
+        ELuActivation<T>,
+        LUTActivation<T>,
+        PReLUActivation<T>,
+        GatedActivation<T>>(op)
+        || op.layer->resolvePlanOp(op);
+
+    if(!resolved)
+    {
+        op.forward = &plan_detail::forwardVirtual<T>;
+        op.forwardBlock = &plan_detail::forwardBlockVirtual<T>;
+    }
+}
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // MODEL_PLAN_H_INCLUDED
@@ -0,0 +1,211 @@
+#ifndef MODEL_REGISTRY_H_INCLUDED
+#define MODEL_REGISTRY_H_INCLUDED
+
+#include <memory>
+#include <new>
+
+#include "Model.h"
+#include "ModelT.h"
+#include "memory_arena.h"
+#include "model_loader.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * A minimal block-processing interface, which hides whether a model
+ * is a static `ModelT` or a dynamic `Model`.
+ *
+ * Instances of this class should typically be created with
+ * `ModelRegistry::load()`.
+ */
+template <typename T>
+class BlockModel
+{
+public:
+    virtual ~BlockModel() = default;
+
+    /** Returns the model's input size. */
+    virtual int getInSize() const noexcept = 0;
+
+    /** Returns the model's output size. */
+    virtual int getOutSize() const noexcept = 0;
+
+    /** Returns true if this is one of the registry's static models. */
+    virtual bool isStatic() const noexcept = 0;
+
+    /**
+     * Prepares the model to process blocks of up to `maxBlockSize` frames.
+     * This method may allocate memory, so it should not be called from
+     * the real-time thread.
+     */
+    virtual void prepare(int maxBlockSize) = 0;
+
+    /** Resets the state of the model. */
+    virtual void reset() = 0;
+
+    /**
+     * Performs forward propagation for a block of frames.
+     *
+     * The frames are stored contiguously, so frame `n` of the input starts
+     * at `input + n * getInSize()`, and frame `n` of the output starts at
+     * `output + n * getOutSize()`.
+     */
+    virtual void processBlock(const T* input, T* output, int numFrames) noexcept = 0;
+
+    /** Returns a pointer to the output of the last processed frame. */
+    virtual const T* getOutputs() const noexcept = 0;
+};
+
+/** BlockModel wrapper for a static `ModelT`. */
+template <typename T, typename ModelType>
+class StaticBlockModel final : public BlockModel<T>
+{
+    static_assert(alignof(ModelType) <= MemoryArena::alignment, "Model alignment is larger than the arena alignment!");
+
+public:
+    StaticBlockModel()
+        : memory(sizeof(ModelType))
+    {
+        // the model may need stricter alignment than operator new provides
+        model = new(memory.allocate<unsigned char>(sizeof(ModelType))) ModelType {};
+    }
+
+    ~StaticBlockModel() override { model->~ModelType(); }
+
+    StaticBlockModel(const StaticBlockModel&) = delete;
+    StaticBlockModel& operator=(const StaticBlockModel&) = delete;
+
+    /** Returns the underlying model. */
+    ModelType& getModel() noexcept { return *model; }
+
+    int getInSize() const noexcept override { return ModelType::input_size; }
+    int getOutSize() const noexcept override { return ModelType::output_size; }
+    bool isStatic() const noexcept override { return true; }
+
+    void prepare(int) override { }
+    void reset() override { model->reset(); }
+
+    RTNEURAL_REALTIME void processBlock(const T* input, T* output, int numFrames) noexcept override
+    {
+        model->processBlock(input, output, numFrames);
+    }
+
+    RTNEURAL_REALTIME const T* getOutputs() const noexcept override { return model->getOutputs(); }
+
+private:
+    MemoryArena memory;
+    ModelType* model = nullptr;
+};
+
+/** BlockModel wrapper for a dynamic `Model`. */
+template <typename T>
+class DynamicBlockModel final : public BlockModel<T>
+{
+public:
+    explicit DynamicBlockModel(std::unique_ptr<Model<T>> dynamicModel)
+        : model(std::move(dynamicModel))
+    {
+        model->compile();
+    }
+
+    /** Returns the underlying model. */
+    Model<T>& getModel() noexcept { return *model; }
+
+    int getInSize() const noexcept override { return model->getInSize(); }
+    int getOutSize() const noexcept override { return model->getOutSize(); }
+    bool isStatic() const noexcept override { return false; }
+
+    void prepare(int maxBlockSize) override { model->prepare(maxBlockSize); }
+    void reset() override { model->reset(); }
+
+    RTNEURAL_REALTIME void processBlock(const T* input, T* output, int numFrames) noexcept override
+    {
+        model->forward(input, output, numFrames);
+    }
+
+    RTNEURAL_REALTIME const T* getOutputs() const noexcept override { return model->getOutputs(); }
+
+private:
+    std::unique_ptr<Model<T>> model;
+};
+
+/**
+ *  A build-time list of static model architectures.
+ *
+ *  When a json model is loaded, its layers are matched against each
+ *  of the `ModelTypes` in order, and the first static model that matches
+ *  is used. If none of them match, the json is loaded as a dynamic `Model`.
+ *  ```
+ *  using Registry = ModelRegistry<float,
+ *      ModelT<float, 1, 1, LSTMLayerT<float, 1, 16>, DenseT<float, 16, 1>>,
+ *      ModelT<float, 1, 1, GRULayerT<float, 1, 8>, DenseT<float, 8, 1>>>;
+ *
+ *  auto model = Registry::load(jsonStream);
+ *  ```
+ */
+template <typename T, typename... ModelTypes>
+struct ModelRegistry
+{
+    /** Returns the number of static architectures in the registry. */
+    static constexpr size_t size() noexcept { return sizeof...(ModelTypes); }
+
+    /**
+     * Creates a model from a json object, or returns nullptr if the
+     * json does not describe a valid model.
+     */
+    static std::unique_ptr<BlockModel<T>> load(const nlohmann::json& parent, const bool debug = false)
+    {
+        if(auto model = loadStatic<ModelTypes...>(parent, debug))
+            return model;
+
+        json_parser::debug_print("No matching static model, loading a dynamic model.", debug);
+        auto dynamicModel = json_parser::parseJson<T>(parent, debug);
+        if(dynamicModel == nullptr || dynamicModel->layers.empty())
+            return {};
+
+        return std::make_unique<DynamicBlockModel<T>>(std::move(dynamicModel));
+    }
+
+    /**
+     * Creates a model from a json stream, or returns nullptr if the
+     * json does not describe a valid model.
+     */
+    static std::unique_ptr<BlockModel<T>> load(std::ifstream& jsonStream, const bool debug = false)
+    {
+        nlohmann::json parent;
+        jsonStream >> parent;
+        return load(parent, debug);
+    }
+
+private:
+    template <typename... Ts>
+    static typename std::enable_if<sizeof...(Ts) == 0, std::unique_ptr<BlockModel<T>>>::type
+    loadStatic(const nlohmann::json&, const bool)
+    {
+        return {};
+    }
+
+    template <typename ModelType, typename... OtherModelTypes>
+    static std::unique_ptr<BlockModel<T>> loadStatic(const nlohmann::json& parent, const bool debug)
+    {
+        // a json file which almost matches an architecture should fall
+        // through to the next one, rather than ending the search
+        try
+        {
+            auto model = std::make_unique<StaticBlockModel<T, ModelType>>();
+            if(model->getModel().parseJson(parent, debug))
+                return std::move(model);
+        }
+        catch(const std::exception& e)
+        {
+            json_parser::debug_print(std::string { "Unable to load static model: " } + e.what(), debug);
+        }
+
+        return loadStatic<OtherModelTypes...>(parent, debug);
+    }
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // MODEL_REGISTRY_H_INCLUDED
@@ -0,0 +1,221 @@
+#ifndef ACTIVATION_MULTI_H_INCLUDED
+#define ACTIVATION_MULTI_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include "multi_instance_common.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+#ifndef DOXYGEN
+namespace multi_instance_detail
+{
+    /** Base class for the element-wise multi-instance activations. */
+    template <typename T, int size, int num_instances>
+    class ActivationMultiBase
+    {
+    protected:
+        using v_type = lane_type<T>;
+        static constexpr auto num_groups = num_lane_groups<T>(num_instances);
+
+    public:
+        static constexpr auto in_size = size;
+        static constexpr auto out_size = size;
+
+        ActivationMultiBase() { reset(); }
+
+        /** Returns true since this layer is an activation layer. */
+        constexpr bool isActivation() const noexcept { return true; }
+
+        RTNEURAL_REALTIME void reset()
+        {
+            for(int i = 0; i < size; ++i)
+                for(int g = 0; g < num_groups; ++g)
+                    outs[i][g] = (v_type)(T)0;
+        }
+
+        v_type outs[size][num_groups];
+    };
+} // namespace multi_instance_detail
+#endif // DOXYGEN
+
+/** Static implementation of a tanh activation layer, for `num_instances` instances. */
+template <typename T, int size, int num_instances, typename MathsProvider = DefaultMathsProvider>
+class TanhActivationMultiT : public multi_instance_detail::ActivationMultiBase<T, size, num_instances>
+{
+    using Base = multi_instance_detail::ActivationMultiBase<T, size, num_instances>;
+    using typename Base::v_type;
+    using Base::num_groups;
+
+public:
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "tanh"; }
+
+    /** Performs forward propagation for tanh activation. */
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[size][num_groups]) noexcept
+    {
+        for(int i = 0; i < size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                this->outs[i][g] = ins[i][g];
+        multi_instance_detail::tanh<MathsProvider>(this->outs);
+    }
+};
+
+/** Static implementation of a ReLU activation layer, for `num_instances` instances. */
+template <typename T, int size, int num_instances>
+class ReLuActivationMultiT : public multi_instance_detail::ActivationMultiBase<T, size, num_instances>
+{
+    using Base = multi_instance_detail::ActivationMultiBase<T, size, num_instances>;
+    using typename Base::v_type;
+    using Base::num_groups;
+
+public:
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "relu"; }
+
+    /** Performs forward propagation for ReLU activation. */
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[size][num_groups]) noexcept
+    {
+        for(int i = 0; i < size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                this->outs[i][g] = multi_instance_detail::select_positive(ins[i][g], ins[i][g], (v_type)(T)0);
+    }
+};
+
+/** Static implementation of a sigmoid activation layer, for `num_instances` instances. */
+template <typename T, int size, int num_instances, typename MathsProvider = DefaultMathsProvider>
+class SigmoidActivationMultiT : public multi_instance_detail::ActivationMultiBase<T, size, num_instances>
+{
+    using Base = multi_instance_detail::ActivationMultiBase<T, size, num_instances>;
+    using typename Base::v_type;
+    using Base::num_groups;
+
+public:
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "sigmoid"; }
+
+    /** Performs forward propagation for sigmoid activation. */
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[size][num_groups]) noexcept
+    {
+        for(int i = 0; i < size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                this->outs[i][g] = ins[i][g];
+        multi_instance_detail::sigmoid<MathsProvider>(this->outs);
+    }
+};
+
+/**
+ * Static implementation of a softmax activation layer, for `num_instances` instances.
+ *
+ * The softmax is computed across the channels of each instance.
+ */
+template <typename T, int size, int num_instances, typename MathsProvider = DefaultMathsProvider>
+class SoftmaxActivationMultiT : public multi_instance_detail::ActivationMultiBase<T, size, num_instances>
+{
+    using Base = multi_instance_detail::ActivationMultiBase<T, size, num_instances>;
+    using typename Base::v_type;
+    using Base::num_groups;
+
+public:
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "softmax"; }
+
+    /** Performs forward propagation for softmax activation. */
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[size][num_groups]) noexcept
+    {
+        for(int i = 0; i < size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                this->outs[i][g] = ins[i][g];
+        multi_instance_detail::exp<MathsProvider>(this->outs);
+
+        for(int g = 0; g < num_groups; ++g)
+        {
+            auto exp_sum = (v_type)(T)0;
+            for(int i = 0; i < size; ++i)
+                exp_sum += this->outs[i][g];
+
+            const auto exp_sum_recip = (v_type)(T)1 / exp_sum;
+            for(int i = 0; i < size; ++i)
+                this->outs[i][g] *= exp_sum_recip;
+        }
+    }
+};
+
+/** Static implementation of an elu activation layer, for `num_instances` instances. */
+template <typename T, int size, int num_instances, int AlphaNumerator = 1, int AlphaDenominator = 1, typename MathsProvider = DefaultMathsProvider>
+class ELuActivationMultiT : public multi_instance_detail::ActivationMultiBase<T, size, num_instances>
+{
+    using Base = multi_instance_detail::ActivationMultiBase<T, size, num_instances>;
+    using typename Base::v_type;
+    using Base::num_groups;
+
+public:
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "elu"; }
+
+    /** Performs forward propagation for elu activation. */
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[size][num_groups]) noexcept
+    {
+        for(int i = 0; i < size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                this->outs[i][g] = ins[i][g];
+        multi_instance_detail::exp<MathsProvider>(this->outs);
+
+        const auto alpha = (v_type)((T)AlphaNumerator / (T)AlphaDenominator);
+        for(int i = 0; i < size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                this->outs[i][g] = multi_instance_detail::select_positive(ins[i][g], ins[i][g],
+                    alpha * (this->outs[i][g] - (v_type)(T)1));
+    }
+};
+
+/** Static implementation of a PReLU activation layer, for `num_instances` instances. */
+template <typename T, int size, int num_instances>
+class PReLUActivationMultiT : public multi_instance_detail::ActivationMultiBase<T, size, num_instances>
+{
+    using Base = multi_instance_detail::ActivationMultiBase<T, size, num_instances>;
+    using typename Base::v_type;
+    using Base::num_groups;
+
+public:
+    PReLUActivationMultiT()
+    {
+        for(int i = 0; i < size; ++i)
+            alpha[i] = (T)0;
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "prelu"; }
+
+    /** Returns false since this layer has weights even though it is an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Performs forward propagation for prelu activation. */
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[size][num_groups]) noexcept
+    {
+        for(int i = 0; i < size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                this->outs[i][g] = multi_instance_detail::select_non_negative(ins[i][g], ins[i][g], ins[i][g] * alpha[i]);
+    }
+
+    RTNEURAL_REALTIME void setAlphaVals(const std::vector<T>& alphaVals)
+    {
+        if(alphaVals.size() == 1)
+        {
+            for(int i = 0; i < size; ++i)
+                alpha[i] = alphaVals[0];
+        }
+        else
+        {
+            for(int i = 0; i < size; ++i)
+                alpha[i] = alphaVals[(size_t)i];
+        }
+    }
+
+private:
+    T alpha[size];
+};
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // ACTIVATION_MULTI_H_INCLUDED
@@ -0,0 +1,142 @@
+#ifndef CONV1D_MULTI_H_INCLUDED
+#define CONV1D_MULTI_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include "multi_instance_common.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+/**
+ * Static implementation of a 1-dimensional convolution layer,
+ * which processes `num_instances` independent instances at once.
+ *
+ * The weights are shared between all of the instances, while each
+ * instance has its own state.
+ */
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, int num_instances, int groups = 1>
+class Conv1DMultiT
+{
+    static_assert((in_sizet % groups == 0) && (out_sizet % groups == 0), "in_size and out_size must be divisible by groups!");
+
+    using v_type = multi_instance_detail::lane_type<T>;
+    static constexpr auto num_groups = multi_instance_detail::num_lane_groups<T>(num_instances);
+    static constexpr auto state_size = (kernel_size - 1) * dilation_rate + 1;
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+    static constexpr auto filters_per_group = in_size / groups;
+    static constexpr auto channels_per_group = out_size / groups;
+
+    Conv1DMultiT()
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            for(int k = 0; k < filters_per_group; ++k)
+                for(int j = 0; j < kernel_size; ++j)
+                    weights[i][k][j] = (T)0;
+            bias[i] = (T)0;
+        }
+
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "conv1d"; }
+
+    /** Returns false since convolution is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the layer state for all of the instances. */
+    RTNEURAL_REALTIME void reset()
+    {
+        for(int n = 0; n < state_size; ++n)
+            for(int k = 0; k < in_size; ++k)
+                for(int g = 0; g < num_groups; ++g)
+                    state[n][k][g] = (v_type)(T)0;
+
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                outs[i][g] = (v_type)(T)0;
+
+        state_ptr = 0;
+    }
+
+    /** Performs forward propagation for this layer. */
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[in_size][num_groups]) noexcept
+    {
+        // insert input into a circular buffer
+        for(int k = 0; k < in_size; ++k)
+            for(int g = 0; g < num_groups; ++g)
+                state[state_ptr][k][g] = ins[k][g];
+
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                outs[i][g] = (v_type)bias[i];
+
+        // perform multi-channel convolution, one kernel tap at a time
+        for(int j = 0; j < kernel_size; ++j)
+        {
+            const auto& col = state[(state_ptr + state_size - j * dilation_rate) % state_size];
+            for(int i = 0; i < out_size; ++i)
+            {
+                const auto ii = (i / channels_per_group) * filters_per_group;
+                for(int k = 0; k < filters_per_group; ++k)
+                {
+                    const auto w = (v_type)weights[i][k][j];
+                    for(int g = 0; g < num_groups; ++g)
+                        outs[i][g] += w * col[ii + k][g];
+                }
+            }
+        }
+
+        state_ptr = (state_ptr == state_size - 1 ? 0 : state_ptr + 1); // iterate state pointer forwards
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size weights[out_size][group_count][kernel_size * dilation]
+     */
+    RTNEURAL_REALTIME void setWeights(const std::vector<std::vector<std::vector<T>>>& ws)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < filters_per_group; ++k)
+                for(int j = 0; j < kernel_size; ++j)
+                    weights[i][k][j] = ws[i][k][j];
+    }
+
+    /**
+     * Sets the layer biases.
+     *
+     * The bias vector must have size bias[out_size]
+     */
+    RTNEURAL_REALTIME void setBias(const std::vector<T>& biasVals)
+    {
+        for(int i = 0; i < out_size; ++i)
+            bias[i] = biasVals[i];
+    }
+
+    /** Returns the size of the convolution kernel. */
+    RTNEURAL_REALTIME int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the convolution dilation rate. */
+    RTNEURAL_REALTIME int getDilationRate() const noexcept { return dilation_rate; }
+
+    /** Returns the number of "groups" in the convolution. */
+    int getGroups() const noexcept { return groups; }
+
+    v_type outs[out_size][num_groups];
+
+private:
+    v_type state[state_size][in_size][num_groups];
+    int state_ptr = 0;
+
+    T weights[out_size][filters_per_group][kernel_size];
+    T bias[out_size];
+};
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // CONV1D_MULTI_H_INCLUDED
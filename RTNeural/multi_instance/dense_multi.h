@@ -0,0 +1,107 @@
+#ifndef DENSE_MULTI_H_INCLUDED
+#define DENSE_MULTI_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include "multi_instance_common.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+/**
+ * Static implementation of a fully-connected (dense) layer,
+ * which processes `num_instances` independent instances at once.
+ *
+ * The weights are shared between all of the instances.
+ */
+template <typename T, int in_sizet, int out_sizet, int num_instances>
+class DenseMultiT
+{
+    using v_type = multi_instance_detail::lane_type<T>;
+    static constexpr auto num_groups = multi_instance_detail::num_lane_groups<T>(num_instances);
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    DenseMultiT()
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            for(int k = 0; k < in_size; ++k)
+                weights[i][k] = (T)0;
+            bias[i] = (T)0;
+        }
+
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "dense"; }
+
+    /** Returns false since dense is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Reset is a no-op, since Dense does not have state. */
+    RTNEURAL_REALTIME void reset()
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                outs[i][g] = (v_type)(T)0;
+    }
+
+    /** Performs forward propagation for this layer. */
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[in_size][num_groups]) noexcept
+    {
+        multi_instance_detail::mat_mul(weights, ins, outs);
+
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                outs[i][g] += bias[i];
+    }
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    RTNEURAL_REALTIME void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < in_size; ++k)
+                weights[i][k] = newWeights[i][k];
+    }
+
+    /**
+     * Sets the layer weights from a given array.
+     *
+     * The dimension of the weights array must be
+     * weights[out_size][in_size]
+     */
+    RTNEURAL_REALTIME void setWeights(T** newWeights)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < in_size; ++k)
+                weights[i][k] = newWeights[i][k];
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    RTNEURAL_REALTIME void setBias(const T* b)
+    {
+        for(int i = 0; i < out_size; ++i)
+            bias[i] = b[i];
+    }
+
+    v_type outs[out_size][num_groups];
+
+private:
+    T weights[out_size][in_size];
+    T bias[out_size];
+};
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // DENSE_MULTI_H_INCLUDED
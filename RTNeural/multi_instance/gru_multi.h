@@ -0,0 +1,184 @@
+#ifndef GRU_MULTI_H_INCLUDED
+#define GRU_MULTI_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include "multi_instance_common.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+/**
+ * Static implementation of a gated recurrent unit (GRU) layer,
+ * which processes `num_instances` independent instances at once.
+ *
+ * The weights are shared between all of the instances, while each
+ * instance has its own recurrent state. The weight layout matches
+ * GRULayerT, so the same loaders can be used for both layers.
+ */
+template <typename T, int in_sizet, int out_sizet, int num_instances, typename MathsProvider = DefaultMathsProvider>
+class GRULayerMultiT
+{
+    using v_type = multi_instance_detail::lane_type<T>;
+    static constexpr auto num_groups = multi_instance_detail::num_lane_groups<T>(num_instances);
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    GRULayerMultiT()
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            for(int k = 0; k < in_size; ++k)
+            {
+                Wz[i][k] = (T)0;
+                Wr[i][k] = (T)0;
+                Wh[i][k] = (T)0;
+            }
+
+            for(int k = 0; k < out_size; ++k)
+            {
+                Uz[i][k] = (T)0;
+                Ur[i][k] = (T)0;
+                Uh[i][k] = (T)0;
+            }
+
+            bz[i] = (T)0;
+            br[i] = (T)0;
+            bh0[i] = (T)0;
+            bh1[i] = (T)0;
+        }
+
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "gru"; }
+
+    /** Returns false since GRU is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the GRU for all of the instances. */
+    RTNEURAL_REALTIME void reset()
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                outs[i][g] = (v_type)(T)0;
+    }
+
+    /** Performs forward propagation for this layer. */
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[in_size][num_groups]) noexcept
+    {
+        using namespace multi_instance_detail;
+
+        // compute zt
+        mat_mul(Uz, outs, zt);
+        mat_mul(Wz, ins, kernel_outs);
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                zt[i][g] += bz[i] + kernel_outs[i][g];
+        sigmoid<MathsProvider>(zt);
+
+        // compute rt
+        mat_mul(Ur, outs, rt);
+        mat_mul(Wr, ins, kernel_outs);
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                rt[i][g] += br[i] + kernel_outs[i][g];
+        sigmoid<MathsProvider>(rt);
+
+        // compute h_hat
+        mat_mul(Uh, outs, ct);
+        mat_mul(Wh, ins, kernel_outs);
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                ct[i][g] = rt[i][g] * (ct[i][g] + bh1[i]) + bh0[i] + kernel_outs[i][g];
+        tanh<MathsProvider>(ct);
+
+        // compute output
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                outs[i][g] = ((v_type)(T)1 - zt[i][g]) * ct[i][g] + zt[i][g] * outs[i][g];
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][3 * out_size]
+     */
+    RTNEURAL_REALTIME void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int i = 0; i < in_size; ++i)
+        {
+            for(int j = 0; j < out_size; ++j)
+            {
+                Wz[j][i] = wVals[i][j];
+                Wr[j][i] = wVals[i][j + out_size];
+                Wh[j][i] = wVals[i][j + 2 * out_size];
+            }
+        }
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][3 * out_size]
+     */
+    RTNEURAL_REALTIME void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            for(int j = 0; j < out_size; ++j)
+            {
+                Uz[j][i] = uVals[i][j];
+                Ur[j][i] = uVals[i][j + out_size];
+                Uh[j][i] = uVals[i][j + 2 * out_size];
+            }
+        }
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[2][3 * out_size]
+     */
+    RTNEURAL_REALTIME void setBVals(const std::vector<std::vector<T>>& bVals)
+    {
+        for(int k = 0; k < out_size; ++k)
+        {
+            bz[k] = bVals[0][k] + bVals[1][k];
+            br[k] = bVals[0][k + out_size] + bVals[1][k + out_size];
+            bh0[k] = bVals[0][k + 2 * out_size];
+            bh1[k] = bVals[1][k + 2 * out_size];
+        }
+    }
+
+    v_type outs[out_size][num_groups];
+
+private:
+    // kernel weights
+    T Wz[out_size][in_size];
+    T Wr[out_size][in_size];
+    T Wh[out_size][in_size];
+
+    // recurrent weights
+    T Uz[out_size][out_size];
+    T Ur[out_size][out_size];
+    T Uh[out_size][out_size];
+
+    // biases
+    T bz[out_size];
+    T br[out_size];
+    T bh0[out_size];
+    T bh1[out_size];
+
+    // intermediate values
+    v_type zt[out_size][num_groups];
+    v_type rt[out_size][num_groups];
+    v_type ct[out_size][num_groups];
+    v_type kernel_outs[out_size][num_groups];
+};
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // GRU_MULTI_H_INCLUDED
@@ -0,0 +1,212 @@
+#ifndef LSTM_MULTI_H_INCLUDED
+#define LSTM_MULTI_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include "multi_instance_common.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+/**
+ * Static implementation of a LSTM layer,
+ * which processes `num_instances` independent instances at once.
+ *
+ * The weights are shared between all of the instances, while each
+ * instance has its own recurrent state. The weight layout matches
+ * LSTMLayerT, so the same loaders can be used for both layers.
+ */
+template <typename T, int in_sizet, int out_sizet, int num_instances, typename MathsProvider = DefaultMathsProvider>
+class LSTMLayerMultiT
+{
+    using v_type = multi_instance_detail::lane_type<T>;
+    static constexpr auto num_groups = multi_instance_detail::num_lane_groups<T>(num_instances);
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    LSTMLayerMultiT()
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            for(int k = 0; k < in_size; ++k)
+            {
+                Wi[i][k] = (T)0;
+                Wf[i][k] = (T)0;
+                Wc[i][k] = (T)0;
+                Wo[i][k] = (T)0;
+            }
+
+            for(int k = 0; k < out_size; ++k)
+            {
+                Ui[i][k] = (T)0;
+                Uf[i][k] = (T)0;
+                Uc[i][k] = (T)0;
+                Uo[i][k] = (T)0;
+            }
+
+            bi[i] = (T)0;
+            bf[i] = (T)0;
+            bc[i] = (T)0;
+            bo[i] = (T)0;
+        }
+
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "lstm"; }
+
+    /** Returns false since LSTM is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the LSTM for all of the instances. */
+    RTNEURAL_REALTIME void reset()
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            for(int g = 0; g < num_groups; ++g)
+            {
+                outs[i][g] = (v_type)(T)0;
+                ct[i][g] = (v_type)(T)0;
+            }
+        }
+    }
+
+    /** Performs forward propagation for this layer. */
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[in_size][num_groups]) noexcept
+    {
+        using namespace multi_instance_detail;
+
+        // compute ft
+        mat_mul(Uf, outs, ft);
+        mat_mul(Wf, ins, kernel_outs);
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                ft[i][g] += bf[i] + kernel_outs[i][g];
+        sigmoid<MathsProvider>(ft);
+
+        // compute it
+        mat_mul(Ui, outs, it);
+        mat_mul(Wi, ins, kernel_outs);
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                it[i][g] += bi[i] + kernel_outs[i][g];
+        sigmoid<MathsProvider>(it);
+
+        // compute ot
+        mat_mul(Uo, outs, ot);
+        mat_mul(Wo, ins, kernel_outs);
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                ot[i][g] += bo[i] + kernel_outs[i][g];
+        sigmoid<MathsProvider>(ot);
+
+        // compute ct
+        mat_mul(Uc, outs, ht);
+        mat_mul(Wc, ins, kernel_outs);
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                ht[i][g] += bc[i] + kernel_outs[i][g];
+        tanh<MathsProvider>(ht);
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                ct[i][g] = it[i][g] * ht[i][g] + ft[i][g] * ct[i][g];
+
+        // compute output (ht has been used, so it can hold tanh(ct))
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                ht[i][g] = ct[i][g];
+        tanh<MathsProvider>(ht);
+        for(int i = 0; i < out_size; ++i)
+            for(int g = 0; g < num_groups; ++g)
+                outs[i][g] = ot[i][g] * ht[i][g];
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][4 * out_size]
+     */
+    RTNEURAL_REALTIME void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int i = 0; i < in_size; ++i)
+        {
+            for(int j = 0; j < out_size; ++j)
+            {
+                Wi[j][i] = wVals[i][j];
+                Wf[j][i] = wVals[i][j + out_size];
+                Wc[j][i] = wVals[i][j + 2 * out_size];
+                Wo[j][i] = wVals[i][j + 3 * out_size];
+            }
+        }
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][4 * out_size]
+     */
+    RTNEURAL_REALTIME void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            for(int j = 0; j < out_size; ++j)
+            {
+                Ui[j][i] = uVals[i][j];
+                Uf[j][i] = uVals[i][j + out_size];
+                Uc[j][i] = uVals[i][j + 2 * out_size];
+                Uo[j][i] = uVals[i][j + 3 * out_size];
+            }
+        }
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[4 * out_size]
+     */
+    RTNEURAL_REALTIME void setBVals(const std::vector<T>& bVals)
+    {
+        for(int k = 0; k < out_size; ++k)
+        {
+            bi[k] = bVals[k];
+            bf[k] = bVals[k + out_size];
+            bc[k] = bVals[k + 2 * out_size];
+            bo[k] = bVals[k + 3 * out_size];
+        }
+    }
+
+    v_type outs[out_size][num_groups];
+
+private:
+    // kernel weights
+    T Wi[out_size][in_size];
+    T Wf[out_size][in_size];
+    T Wc[out_size][in_size];
+    T Wo[out_size][in_size];
+
+    // recurrent weights
+    T Ui[out_size][out_size];
+    T Uf[out_size][out_size];
+    T Uc[out_size][out_size];
+    T Uo[out_size][out_size];
+
+    // biases
+    T bi[out_size];
+    T bf[out_size];
+    T bc[out_size];
+    T bo[out_size];
+
+    // intermediate values
+    v_type ft[out_size][num_groups];
+    v_type it[out_size][num_groups];
+    v_type ot[out_size][num_groups];
+    v_type ht[out_size][num_groups];
+    v_type ct[out_size][num_groups];
+    v_type kernel_outs[out_size][num_groups];
+};
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // LSTM_MULTI_H_INCLUDED
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cmath>
+
+#include "../config.h"
+#include "../common.h"
+
+#if RTNEURAL_USE_EIGEN
+#include "../maths/maths_eigen.h"
+#elif RTNEURAL_USE_XSIMD
+#include "../maths/maths_xsimd.h"
+#else
+#include "../maths/maths_stl.h"
+#endif
+
+namespace RTNEURAL_NAMESPACE
+{
+#ifndef DOXYGEN
+/**
+ * Helpers shared by the multi-instance layers.
+ *
+ * The multi-instance layers process `num_instances` independent copies of
+ * the same network at once. Each activation is stored as
+ * `lane_type<T> values[size][num_lane_groups]`, so that one SIMD register
+ * holds the same channel for several instances (one instance per lane).
+ * The weights are stored once, as scalars, and broadcast across the lanes.
+ */
+namespace multi_instance_detail
+{
+#if RTNEURAL_USE_XSIMD
+    template <typename T>
+    using lane_type = xsimd::simd_type<T>;
+
+    template <typename T>
+    constexpr int lane_width() noexcept
+    {
+        return (int)xsimd::simd_type<T>::size;
+    }
+#else
+    template <typename T>
+    using lane_type = T;
+
+    template <typename T>
+    constexpr int lane_width() noexcept
+    {
+        return 1;
+    }
+#endif
+
+    /** Returns the number of lane groups needed to hold `num_instances` instances. */
+    template <typename T>
+    constexpr int num_lane_groups(int num_instances) noexcept
+    {
+        return ceil_div(num_instances, lane_width<T>());
+    }
+
+    /**
+     * Applies `MathsProvider::tanh()` to every lane of `x`, in place.
+     * The lanes are contiguous, so the whole array is processed at once.
+     */
+    template <typename MathsProvider, typename V, int rows, int num_groups>
+    static inline void tanh(V (&x)[rows][num_groups]) noexcept
+    {
+        applyTanh<MathsProvider>(&x[0][0], rows * num_groups);
+    }
+
+    /** Applies `MathsProvider::sigmoid()` to every lane of `x`, in place. */
+    template <typename MathsProvider, typename V, int rows, int num_groups>
+    static inline void sigmoid(V (&x)[rows][num_groups]) noexcept
+    {
+        applySigmoid<MathsProvider>(&x[0][0], rows * num_groups);
+    }
+
+    /** Applies `MathsProvider::exp()` to every lane of `x`, in place. */
+    template <typename MathsProvider, typename V, int rows, int num_groups>
+    static inline void exp(V (&x)[rows][num_groups]) noexcept
+    {
+        applyExp<MathsProvider>(&x[0][0], rows * num_groups);
+    }
+
+    /** Returns `x > 0 ? a : b`, for every lane. */
+    template <typename V>
+    static inline V select_positive(const V& x, const V& a, const V& b) noexcept
+    {
+#if RTNEURAL_USE_XSIMD
+        return xsimd::select(x > (V)0, a, b);
+#else
+        return x > (V)0 ? a : b;
+#endif
+    }
+
+    /** Returns `x >= 0 ? a : b`, for every lane. */
+    template <typename V>
+    static inline V select_non_negative(const V& x, const V& a, const V& b) noexcept
+    {
+#if RTNEURAL_USE_XSIMD
+        return xsimd::select(x >= (V)0, a, b);
+#else
+        return x >= (V)0 ? a : b;
+#endif
+    }
+
+    /** Computes `out[i] = sum_k mat[i][k] * ins[k]` for every lane group. */
+    template <typename T, int rows, int cols, int num_groups>
+    static inline void mat_mul(const T (&mat)[rows][cols],
+        const lane_type<T> (&ins)[cols][num_groups],
+        lane_type<T> (&out)[rows][num_groups]) noexcept
+    {
+        for(int i = 0; i < rows; ++i)
+        {
+            for(int g = 0; g < num_groups; ++g)
+                out[i][g] = (lane_type<T>)(T)0;
+
+            for(int k = 0; k < cols; ++k)
+            {
+                const auto w = (lane_type<T>)mat[i][k];
+                for(int g = 0; g < num_groups; ++g)
+                    out[i][g] += w * ins[k][g];
+            }
+        }
+    }
+} // namespace multi_instance_detail
+#endif // DOXYGEN
+} // namespace RTNEURAL_NAMESPACE
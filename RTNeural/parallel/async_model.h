@@ -0,0 +1,255 @@
+#ifndef ASYNC_MODEL_H_INCLUDED
+#define ASYNC_MODEL_H_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "../config.h"
+#include "spsc_block_ring.h"
+#include "thread_utils.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * Runs a model on a dedicated worker thread, with one block of latency.
+ *
+ * Each call to `process()` pushes an input block to the worker through
+ * a lock-free ring, and returns the output for the block from the previous
+ * call, without waiting for the worker. If the worker has not finished
+ * that block yet, the output is silent and the block is counted as late.
+ * If the worker has fallen so far behind that the input ring is full, the
+ * input block is dropped and counted. The worker always processes the
+ * blocks it receives in order, so the model's state stays consistent,
+ * and any outputs which arrive late are discarded.
+ *
+ * This suits analysis models (e.g. classifiers or parameter estimators),
+ * which can tolerate a block of latency, and the occasional missing block.
+ * `ModelType` may be a dynamic `Model<T>` or a static `ModelT`, and the
+ * model must outlive the `AsyncModel`.
+ */
+template <typename T, typename ModelType>
+class AsyncModel
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    /**
+     * Creates the wrapper and starts its worker thread, for blocks of up to
+     * `maxBlockSize` frames. If `pinThread` is true, the worker is pinned
+     * to CPU core `core`. This constructor allocates memory and starts a
+     * thread, so it should not be called from the real-time thread.
+     */
+    AsyncModel(ModelType& model, int maxBlockSize, bool pinThread = false, int core = 1, int numSlots = 4)
+        : model(model)
+        , inSize(getModelInSize(model))
+        , outSize(getModelOutSize(model))
+        , maxBlockSize(maxBlockSize)
+        , inputs(numSlots, maxBlockSize, inSize)
+        , outputs(numSlots, maxBlockSize, outSize)
+    {
+        worker = std::thread([this]
+            { runWorker(); });
+
+        if(pinThread)
+            pinThreadToCore(worker, core);
+    }
+
+    /** Stops and joins the worker thread. */
+    ~AsyncModel()
+    {
+        quit.store(true, std::memory_order_release);
+        worker.join();
+    }
+
+    AsyncModel(const AsyncModel&) = delete;
+    AsyncModel& operator=(const AsyncModel&) = delete;
+
+    /** Returns the model's input size. */
+    int getInSize() const noexcept { return inSize; }
+
+    /** Returns the model's output size. */
+    int getOutSize() const noexcept { return outSize; }
+
+    /** Returns the largest number of frames in a block. */
+    int getMaxBlockSize() const noexcept { return maxBlockSize; }
+
+    /**
+     * Hands a block of up to `getMaxBlockSize()` frames to the worker, and
+     * writes the output for the block from the previous call.
+     *
+     * The frames are stored contiguously, so frame `n` of the input starts
+     * at `input + n * getInSize()`, and frame `n` of the output starts at
+     * `output + n * getOutSize()`. If the previous block had fewer frames
+     * than this one, the rest of the output is silent.
+     */
+    RTNEURAL_REALTIME void process(const T* input, T* output, int numFrames) noexcept
+    {
+        numFrames = std::min(numFrames, maxBlockSize);
+        pullOutput(output, numFrames);
+        pushInput(input, numFrames);
+    }
+
+    /**
+     * Waits until the worker has processed every block handed to it so far.
+     * This is intended for offline rendering and tests, and should not be
+     * called from the real-time thread.
+     */
+    void waitForPendingBlocks() const
+    {
+        while(!inputs.isEmpty())
+            std::this_thread::yield();
+    }
+
+    /**
+     * Waits for the worker to finish its pending blocks, and then resets
+     * the model. This must not be called while `process()` is running
+     * on another thread.
+     */
+    void reset()
+    {
+        waitForPendingBlocks();
+
+        int numFrames = 0;
+        while(outputs.getReadBlock(numFrames) != nullptr)
+            outputs.popBlock();
+
+        model.reset();
+        lastPushedBlock = -1;
+    }
+
+    /** Returns the number of blocks whose output was not ready in time. */
+    int64_t getNumLateBlocks() const noexcept { return numLateBlocks.load(std::memory_order_relaxed); }
+
+    /** Returns the number of input blocks which were dropped because the worker had fallen behind. */
+    int64_t getNumDroppedBlocks() const noexcept { return numDroppedBlocks.load(std::memory_order_relaxed); }
+
+    /**
+     * Returns the longest time between an input block being handed to
+     * the worker, and its output being ready.
+     */
+    std::chrono::nanoseconds getWorstCaseHandoffLatency() const noexcept
+    {
+        return std::chrono::nanoseconds(worstCaseLatencyNs.load(std::memory_order_relaxed));
+    }
+
+    /** Resets the late and dropped block counters and the worst-case latency. */
+    void resetStats() noexcept
+    {
+        numLateBlocks.store(0, std::memory_order_relaxed);
+        numDroppedBlocks.store(0, std::memory_order_relaxed);
+        worstCaseLatencyNs.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    RTNEURAL_REALTIME void pullOutput(T* output, int numFrames) noexcept
+    {
+        const auto expectedBlock = lastPushedBlock;
+        lastPushedBlock = -1;
+
+        // discard any outputs which arrived too late to be used
+        int outFrames = 0;
+        int64_t outBlock = -1;
+        const T* out = outputs.getReadBlock(outFrames, &outBlock);
+        while(out != nullptr && outBlock < expectedBlock)
+        {
+            outputs.popBlock();
+            out = outputs.getReadBlock(outFrames, &outBlock);
+        }
+
+        if(out == nullptr || outBlock != expectedBlock)
+        {
+            if(expectedBlock >= 0)
+                numLateBlocks.fetch_add(1, std::memory_order_relaxed);
+
+            std::fill(output, output + numFrames * outSize, (T)0);
+            return;
+        }
+
+        const auto numCopied = std::min(outFrames, numFrames);
+        std::copy(out, out + numCopied * outSize, output);
+        std::fill(output + numCopied * outSize, output + numFrames * outSize, (T)0);
+        outputs.popBlock();
+    }
+
+    RTNEURAL_REALTIME void pushInput(const T* input, int numFrames) noexcept
+    {
+        auto* in = inputs.getWriteBlock();
+        if(in == nullptr)
+        {
+            numDroppedBlocks.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        std::copy(input, input + numFrames * inSize, in);
+        inputs.pushBlock(numFrames, clock_type::now().time_since_epoch().count());
+        lastPushedBlock = numPushedBlocks++;
+    }
+
+    void runWorker()
+    {
+        const auto idleSpinTime = std::chrono::microseconds(1000);
+        const auto idleSleepTime = std::chrono::microseconds(50);
+
+        int64_t numProcessedBlocks = 0;
+        auto idleStart = clock_type::now();
+        while(!quit.load(std::memory_order_acquire))
+        {
+            int numFrames = 0;
+            int64_t pushTime = 0;
+            if(const auto* in = inputs.getReadBlock(numFrames, &pushTime))
+            {
+                T* out = nullptr;
+                while((out = outputs.getWriteBlock()) == nullptr)
+                {
+                    if(quit.load(std::memory_order_acquire))
+                        return;
+                    cpuRelax();
+                }
+
+                processModelBlock(model, in, out, numFrames);
+                outputs.pushBlock(numFrames, numProcessedBlocks++);
+                inputs.popBlock();
+
+                const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    clock_type::now() - clock_type::time_point(clock_type::duration(pushTime)))
+                                         .count();
+                if(latency > worstCaseLatencyNs.load(std::memory_order_relaxed))
+                    worstCaseLatencyNs.store(latency, std::memory_order_relaxed);
+
+                idleStart = clock_type::now();
+                continue;
+            }
+
+            if(clock_type::now() - idleStart < idleSpinTime)
+                cpuRelax();
+            else
+                std::this_thread::sleep_for(idleSleepTime);
+        }
+    }
+
+    ModelType& model;
+    const int inSize;
+    const int outSize;
+    const int maxBlockSize;
+
+    SpscBlockRing<T> inputs;
+    SpscBlockRing<T> outputs;
+
+    // only used by the thread calling process()
+    int64_t numPushedBlocks = 0;
+    int64_t lastPushedBlock = -1;
+
+    std::atomic<int64_t> numLateBlocks { 0 };
+    std::atomic<int64_t> numDroppedBlocks { 0 };
+    std::atomic<int64_t> worstCaseLatencyNs { 0 };
+
+    std::thread worker;
+    std::atomic<bool> quit { false };
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // ASYNC_MODEL_H_INCLUDED
@@ -0,0 +1,237 @@
+#ifndef EXECUTOR_H_INCLUDED
+#define EXECUTOR_H_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../config.h"
+#include "thread_utils.h"
+#include "work_stealing_deque.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/** A single job for the executor: a function pointer and its argument. */
+struct ExecutorJob
+{
+    void (*process)(void* context) noexcept = nullptr;
+    void* context = nullptr;
+};
+
+/**
+ * An executor job which processes a block of frames with a model.
+ * The job must stay alive until the executor has processed it.
+ */
+template <typename ModelType, typename T>
+struct ModelBlockJob
+{
+    ModelType* model = nullptr;
+    const T* input = nullptr;
+    T* output = nullptr;
+    int numFrames = 0;
+
+    /** Returns the executor job for this model and buffers. */
+    ExecutorJob getJob() noexcept { return { &process, this }; }
+
+    static void process(void* context) noexcept
+    {
+        auto& job = *static_cast<ModelBlockJob*>(context);
+        processModelBlock(*job.model, job.input, job.output, job.numFrames);
+    }
+};
+
+/**
+ * Runs batches of independent jobs (e.g. one model per track or voice)
+ * on a fixed pool of worker threads.
+ *
+ * The calling thread hands a batch to `process()`, and takes part in
+ * running it. The jobs are pushed onto the caller's work-stealing deque,
+ * and the workers steal them (moving some of them onto their own deques,
+ * for other workers to steal in turn). `process()` returns once every
+ * job has been run, or skipped because the deadline had passed.
+ *
+ * `process()` does not allocate memory, take locks, or make system calls
+ * (other than reading the clock if a deadline is given), so it may be
+ * called from the real-time thread. Idle workers spin briefly after each
+ * batch, and then sleep in short intervals, so a batch may start before
+ * all the workers have woken up.
+ */
+class WorkStealingExecutor
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    /**
+     * Creates an executor with `numWorkers` worker threads (in addition to
+     * the calling thread), for batches of up to `maxJobs` jobs.
+     *
+     * If `pinThreads` is true, worker `i` is pinned to CPU core `firstCore + i`.
+     * This constructor allocates memory and starts threads, so it should
+     * not be called from the real-time thread.
+     */
+    WorkStealingExecutor(int numWorkers, int maxJobs, bool pinThreads = false, int firstCore = 1)
+        : maxJobs(std::max(maxJobs, 1))
+    {
+        numWorkers = std::max(numWorkers, 0);
+        for(int i = 0; i < numWorkers + 1; ++i)
+            participants.emplace_back(new WorkStealingDeque(this->maxJobs));
+
+        workers.reserve((size_t)numWorkers);
+        for(int i = 0; i < numWorkers; ++i)
+        {
+            workers.emplace_back([this, i]
+                { runWorker(i + 1); });
+
+            if(pinThreads)
+                pinThreadToCore(workers.back(), firstCore + i);
+        }
+    }
+
+    /** Stops and joins the worker threads. */
+    ~WorkStealingExecutor()
+    {
+        quit.store(true, std::memory_order_release);
+        for(auto& worker : workers)
+            worker.join();
+    }
+
+    WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+    /** Returns the number of worker threads. */
+    int getNumWorkers() const noexcept { return (int)workers.size(); }
+
+    /** Returns the maximum number of jobs in a batch. */
+    int getMaxJobs() const noexcept { return maxJobs; }
+
+    /**
+     * Runs a batch of jobs, and returns once they have all finished.
+     *
+     * Jobs which have not started by the deadline are skipped, and their
+     * outputs are left unchanged. Returns true if every job was run. At
+     * most `getMaxJobs()` jobs are run, any more are skipped.
+     */
+    RTNEURAL_REALTIME bool process(const ExecutorJob* jobs, int numJobs, clock_type::time_point deadline) noexcept
+    {
+        const auto numToRun = std::min(std::max(numJobs, 0), maxJobs);
+        numSkipped.store(numJobs - numToRun, std::memory_order_relaxed);
+        if(numToRun == 0)
+            return numJobs == 0;
+
+        batchJobs.store(jobs, std::memory_order_relaxed);
+        batchDeadline.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+        pending.store(numToRun, std::memory_order_release);
+
+        auto& callerDeque = *participants[0];
+        for(int i = numToRun - 1; i >= 0; --i)
+            callerDeque.push(i);
+
+        runJobs(0);
+        return numSkipped.load(std::memory_order_relaxed) == 0;
+    }
+
+    /** Runs a batch of jobs without a deadline. */
+    RTNEURAL_REALTIME bool process(const ExecutorJob* jobs, int numJobs) noexcept
+    {
+        return process(jobs, numJobs, clock_type::time_point::max());
+    }
+
+    /** Returns the number of jobs that were skipped in the last batch. */
+    int getNumSkippedJobs() const noexcept { return numSkipped.load(std::memory_order_relaxed); }
+
+private:
+    /** Runs, pops, or steals jobs until the current batch is finished. */
+    RTNEURAL_REALTIME void runJobs(int self) noexcept
+    {
+        int jobIdx = 0;
+        while(pending.load(std::memory_order_acquire) > 0)
+        {
+            if(participants[(size_t)self]->pop(jobIdx) || steal(self, jobIdx))
+                runJob(jobIdx);
+            else
+                cpuRelax();
+        }
+    }
+
+    /**
+     * Steals a job from another participant. Some more jobs are moved
+     * onto this participant's deque, so that they can be stolen from here.
+     */
+    RTNEURAL_REALTIME bool steal(int self, int& jobIdx) noexcept
+    {
+        const auto numParticipants = (int)participants.size();
+        for(int i = 1; i < numParticipants; ++i)
+        {
+            auto& victim = *participants[(size_t)((self + i) % numParticipants)];
+            if(!victim.steal(jobIdx))
+                continue;
+
+            auto& own = *participants[(size_t)self];
+            const auto numExtra = pending.load(std::memory_order_relaxed) / (2 * numParticipants);
+            int extraIdx = 0;
+            for(int n = 0; n < numExtra && victim.steal(extraIdx); ++n)
+                own.push(extraIdx);
+
+            return true;
+        }
+
+        return false;
+    }
+
+    RTNEURAL_REALTIME void runJob(int jobIdx) noexcept
+    {
+        const auto deadline = batchDeadline.load(std::memory_order_relaxed);
+        if(deadline != clock_type::time_point::max().time_since_epoch().count()
+            && clock_type::now().time_since_epoch().count() > deadline)
+        {
+            numSkipped.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            const auto& job = batchJobs.load(std::memory_order_relaxed)[jobIdx];
+            job.process(job.context);
+        }
+
+        pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void runWorker(int self)
+    {
+        const auto idleSpinTime = std::chrono::microseconds(1000);
+        const auto idleSleepTime = std::chrono::microseconds(50);
+
+        auto idleStart = clock_type::now();
+        while(!quit.load(std::memory_order_acquire))
+        {
+            if(pending.load(std::memory_order_acquire) > 0)
+            {
+                runJobs(self);
+                idleStart = clock_type::now();
+                continue;
+            }
+
+            if(clock_type::now() - idleStart < idleSpinTime)
+                cpuRelax();
+            else
+                std::this_thread::sleep_for(idleSleepTime);
+        }
+    }
+
+    const int maxJobs;
+    std::vector<std::unique_ptr<WorkStealingDeque>> participants;
+    std::vector<std::thread> workers;
+
+    std::atomic<const ExecutorJob*> batchJobs { nullptr };
+    std::atomic<clock_type::rep> batchDeadline { 0 };
+    std::atomic<int> pending { 0 };
+    std::atomic<int> numSkipped { 0 };
+    std::atomic<bool> quit { false };
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // EXECUTOR_H_INCLUDED
@@ -0,0 +1,215 @@
+#ifndef MODEL_HOLDER_H_INCLUDED
+#define MODEL_HOLDER_H_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../config.h"
+#include "thread_utils.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * Holds the model used by the audio thread, and lets another thread
+ * replace it while audio is running, without locks.
+ *
+ * A new model is published with `setModel()`, and picked up by the audio
+ * thread at the start of its next call to `process()`. The old model can
+ * keep running for a few samples, while its output is crossfaded into the
+ * new model's output. Once the audio thread is done with the old model,
+ * it is handed back to be destroyed by `collectGarbage()`, so the audio
+ * thread never allocates, frees, or waits for a lock.
+ *
+ * `setModel()` and `collectGarbage()` should be called from the same
+ * (non real-time) thread, and `process()` from the audio thread.
+ * `ModelType` may be a dynamic `Model<T>` or a static `ModelT`.
+ */
+template <typename T, typename ModelType = Model<T>>
+class ModelHolder
+{
+public:
+    /**
+     * Creates an empty holder for blocks of up to `maxBlockSize` frames,
+     * which crossfades between models over `crossfadeSamples` frames.
+     */
+    explicit ModelHolder(int maxBlockSize, int crossfadeSamples = 0)
+        : maxBlockSize(maxBlockSize)
+        , crossfadeSamples(std::max(crossfadeSamples, 0))
+    {
+    }
+
+    /** Destroys all of the models. This must not be called while `process()` is running. */
+    ~ModelHolder()
+    {
+        collectGarbage();
+        delete pending.exchange(nullptr);
+        delete current;
+        delete fadingOut;
+    }
+
+    ModelHolder(const ModelHolder&) = delete;
+    ModelHolder& operator=(const ModelHolder&) = delete;
+
+    /**
+     * Publishes a new model, which the audio thread will switch to at the
+     * start of its next block. The model should already be prepared for
+     * blocks of `maxBlockSize` frames. If a previously published model had
+     * not been picked up yet, it is replaced. Also destroys any models which
+     * the audio thread has finished with. Returns false if `newModel` is null.
+     */
+    bool setModel(std::unique_ptr<ModelType> newModel)
+    {
+        collectGarbage();
+        if(newModel == nullptr)
+            return false;
+
+        auto* entry = new Entry { std::move(newModel), {} };
+        entry->fadeBuffer.resize((size_t)(maxBlockSize * getModelOutSize(*entry->model)), (T)0);
+
+        // a model that was never picked up by the audio thread can be destroyed straight away
+        delete pending.exchange(entry, std::memory_order_acq_rel);
+        return true;
+    }
+
+    /** Destroys any models which the audio thread has finished with. */
+    void collectGarbage()
+    {
+        auto r = retiredRead.load(std::memory_order_relaxed);
+        while(r != retiredWrite.load(std::memory_order_acquire))
+        {
+            delete retired[r % retiredCapacity];
+            retiredRead.store(++r, std::memory_order_release);
+        }
+    }
+
+    /** Sets the length of the crossfade for future model changes. */
+    void setCrossfadeSamples(int numSamples) noexcept
+    {
+        crossfadeSamples.store(std::max(numSamples, 0), std::memory_order_relaxed);
+    }
+
+    /** Returns true if `process()` is crossfading between two models. Call this from the audio thread. */
+    bool isCrossfading() const noexcept { return fadingOut != nullptr; }
+
+    /**
+     * Processes a block of up to `maxBlockSize` frames with the current model.
+     * Returns false (and leaves the output unchanged) if no model has been
+     * published yet.
+     *
+     * The frames are stored contiguously, so frame `n` of the input starts
+     * at `input + n * inSize`, and frame `n` of the output starts at
+     * `output + n * outSize`.
+     */
+    RTNEURAL_REALTIME bool process(const T* input, T* output, int numFrames) noexcept
+    {
+        numFrames = std::min(numFrames, maxBlockSize);
+        swapIfPending();
+
+        if(current == nullptr)
+            return false;
+
+        processModelBlock(*current->model, input, output, numFrames);
+        if(fadingOut == nullptr)
+            return true;
+
+        auto* fadeOutput = fadingOut->fadeBuffer.data();
+        processModelBlock(*fadingOut->model, input, fadeOutput, numFrames);
+
+        const auto outSize = getModelOutSize(*current->model);
+        for(int n = 0; n < numFrames; ++n)
+        {
+            const auto gain = std::min((T)(fadeSample + n + 1) / (T)fadeLength, (T)1);
+            for(int i = 0; i < outSize; ++i)
+            {
+                auto& out = output[n * outSize + i];
+                out = fadeOutput[n * outSize + i] + gain * (out - fadeOutput[n * outSize + i]);
+            }
+        }
+
+        fadeSample += numFrames;
+        if(fadeSample >= fadeLength && retire(fadingOut))
+            fadingOut = nullptr;
+
+        return true;
+    }
+
+private:
+    struct Entry
+    {
+        std::unique_ptr<ModelType> model;
+        std::vector<T> fadeBuffer;
+    };
+
+    /** Picks up a newly published model, if there is room to retire the models it replaces. */
+    RTNEURAL_REALTIME void swapIfPending() noexcept
+    {
+        if(pending.load(std::memory_order_relaxed) == nullptr || getNumFreeRetiredSlots() < 2)
+            return;
+
+        auto* next = pending.exchange(nullptr, std::memory_order_acq_rel);
+        if(next == nullptr)
+            return;
+
+        if(fadingOut != nullptr)
+            retire(fadingOut);
+        fadingOut = nullptr;
+
+        const auto numFadeSamples = crossfadeSamples.load(std::memory_order_relaxed);
+        const auto canCrossfade = current != nullptr
+            && getModelOutSize(*current->model) == getModelOutSize(*next->model);
+
+        if(canCrossfade && numFadeSamples > 0)
+        {
+            fadingOut = current;
+            fadeSample = 0;
+            fadeLength = numFadeSamples;
+        }
+        else if(current != nullptr)
+        {
+            retire(current);
+        }
+
+        current = next;
+    }
+
+    RTNEURAL_REALTIME int getNumFreeRetiredSlots() const noexcept
+    {
+        return retiredCapacity - (int)(retiredWrite.load(std::memory_order_relaxed) - retiredRead.load(std::memory_order_acquire));
+    }
+
+    /** Hands a model back to be destroyed. Returns false if the retired queue is full. */
+    RTNEURAL_REALTIME bool retire(Entry* entry) noexcept
+    {
+        if(getNumFreeRetiredSlots() == 0)
+            return false;
+
+        const auto w = retiredWrite.load(std::memory_order_relaxed);
+        retired[w % retiredCapacity] = entry;
+        retiredWrite.store(w + 1, std::memory_order_release);
+        return true;
+    }
+
+    const int maxBlockSize;
+    std::atomic<int> crossfadeSamples;
+    std::atomic<Entry*> pending { nullptr };
+
+    // only used by the audio thread
+    Entry* current = nullptr;
+    Entry* fadingOut = nullptr;
+    int fadeSample = 0;
+    int fadeLength = 0;
+
+    // models which the audio thread has finished with, waiting to be destroyed
+    static constexpr int retiredCapacity = 8;
+    Entry* retired[retiredCapacity] {};
+    std::atomic<int64_t> retiredWrite { 0 };
+    std::atomic<int64_t> retiredRead { 0 };
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // MODEL_HOLDER_H_INCLUDED
@@ -0,0 +1,533 @@
+#ifndef PIPELINE_MODEL_H_INCLUDED
+#define PIPELINE_MODEL_H_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "../Model.h"
+#include "../ModelT.h"
+#include "../config.h"
+#include "../memory_arena.h"
+#include "../model_plan.h"
+#include "spsc_block_ring.h"
+#include "thread_utils.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * One stage of a pipeline: a function which processes a block of frames
+ * from `inSize` channels to `outSize` channels, and one which resets
+ * the stage's state.
+ */
+template <typename T>
+struct PipelineStage
+{
+    using ProcessFn = void (*)(void* context, const T* input, T* output, int numFrames) noexcept;
+    using ResetFn = void (*)(void* context);
+
+    ProcessFn process = nullptr;
+    ResetFn reset = nullptr;
+    void* context = nullptr;
+    int inSize = 0;
+    int outSize = 0;
+};
+
+/**
+ * Runs a sequence of stages as a pipeline, with each stage on its own thread.
+ *
+ * The first stage runs on the thread which calls `process()`, and each of
+ * the other stages runs on a worker thread. The stages pass their outputs
+ * along through lock-free single-producer single-consumer rings, so while
+ * the caller processes block `k` with the first stage, the second stage
+ * processes block `k - 1`, and so on. `process()` waits for the last stage
+ * to finish its block, and returns the output from `getNumStages() - 1`
+ * blocks ago. The first few outputs are silent.
+ *
+ * `process()` does not allocate memory or take locks, but it does wait
+ * for the slowest stage, so the stages should be roughly balanced.
+ */
+template <typename T>
+class StagePipeline
+{
+public:
+    /**
+     * Creates a pipeline from a list of stages, which process
+     * `blockSize` frames at a time.
+     *
+     * If `pinThreads` is true, the worker running stage `i` is pinned to
+     * CPU core `firstCore + i - 1`. This constructor allocates memory and
+     * starts threads, so it should not be called from the real-time thread.
+     */
+    StagePipeline(const std::vector<PipelineStage<T>>& pipelineStages, int blockSize, bool pinThreads = false, int firstCore = 1)
+        : stages(pipelineStages)
+        , blockSize(blockSize)
+    {
+        const auto numStages = getNumStages();
+        if(numStages < 2)
+            return;
+
+        // each ring can hold every block in flight, so the stages never wait for space
+        for(const auto& stage : stages)
+            rings.emplace_back(new SpscBlockRing<T>(numStages + 1, blockSize, stage.outSize));
+
+        workers.reserve((size_t)numStages - 1);
+        for(int i = 1; i < numStages; ++i)
+        {
+            workers.emplace_back([this, i]
+                { runStage(i); });
+
+            if(pinThreads)
+                pinThreadToCore(workers.back(), firstCore + i - 1);
+        }
+    }
+
+    /** Stops and joins the worker threads. */
+    ~StagePipeline()
+    {
+        quit.store(true, std::memory_order_release);
+        for(auto& worker : workers)
+            worker.join();
+    }
+
+    StagePipeline(const StagePipeline&) = delete;
+    StagePipeline& operator=(const StagePipeline&) = delete;
+
+    /** Returns the number of stages in the pipeline. */
+    int getNumStages() const noexcept { return (int)stages.size(); }
+
+    /** Returns the number of frames processed by each call to `process()`. */
+    int getBlockSize() const noexcept { return blockSize; }
+
+    /** Returns the latency of the pipeline in frames, which is one block for each stage after the first. */
+    int getLatencySamples() const noexcept { return (getNumStages() - 1) * blockSize; }
+
+    /**
+     * Waits for the blocks in flight to finish, and then resets the
+     * state of each stage. This must not be called while `process()`
+     * is running on another thread.
+     */
+    void reset()
+    {
+        if(!rings.empty())
+        {
+            for(size_t i = 0; i + 1 < rings.size(); ++i)
+                while(!rings[i]->isEmpty())
+                    std::this_thread::yield();
+
+            int numFrames = 0;
+            while(rings.back()->getReadBlock(numFrames) != nullptr)
+                rings.back()->popBlock();
+        }
+
+        for(const auto& stage : stages)
+            stage.reset(stage.context);
+
+        numBlocksInFlight = 0;
+    }
+
+    /**
+     * Processes a block of `getBlockSize()` frames, and writes the output
+     * from `getLatencySamples()` frames ago.
+     *
+     * The frames are stored contiguously, so frame `n` of the input starts
+     * at `input + n * inSize`, and frame `n` of the output starts at
+     * `output + n * outSize`.
+     */
+    RTNEURAL_REALTIME void process(const T* input, T* output) noexcept
+    {
+        const auto& firstStage = stages.front();
+        if(rings.empty())
+        {
+            firstStage.process(firstStage.context, input, output, blockSize);
+            return;
+        }
+
+        T* firstOut = nullptr;
+        while((firstOut = rings.front()->getWriteBlock()) == nullptr)
+            cpuRelax();
+
+        firstStage.process(firstStage.context, input, firstOut, blockSize);
+        rings.front()->pushBlock(blockSize);
+
+        const auto outSize = stages.back().outSize;
+        if(numBlocksInFlight < getNumStages() - 1)
+        {
+            ++numBlocksInFlight;
+            std::fill(output, output + blockSize * outSize, (T)0);
+            return;
+        }
+
+        int numFrames = 0;
+        const T* lastOut = nullptr;
+        while((lastOut = rings.back()->getReadBlock(numFrames)) == nullptr)
+            cpuRelax();
+
+        std::copy(lastOut, lastOut + numFrames * outSize, output);
+        rings.back()->popBlock();
+    }
+
+private:
+    void runStage(int stageIdx)
+    {
+        const auto& stage = stages[(size_t)stageIdx];
+        auto& inRing = *rings[(size_t)stageIdx - 1];
+        auto& outRing = *rings[(size_t)stageIdx];
+
+        const auto idleSpinTime = std::chrono::microseconds(1000);
+        const auto idleSleepTime = std::chrono::microseconds(50);
+
+        auto idleStart = std::chrono::steady_clock::now();
+        while(!quit.load(std::memory_order_acquire))
+        {
+            int numFrames = 0;
+            if(const auto* in = inRing.getReadBlock(numFrames))
+            {
+                T* out = nullptr;
+                while((out = outRing.getWriteBlock()) == nullptr)
+                    cpuRelax();
+
+                stage.process(stage.context, in, out, numFrames);
+                outRing.pushBlock(numFrames);
+                inRing.popBlock();
+
+                idleStart = std::chrono::steady_clock::now();
+                continue;
+            }
+
+            if(std::chrono::steady_clock::now() - idleStart < idleSpinTime)
+                cpuRelax();
+            else
+                std::this_thread::sleep_for(idleSleepTime);
+        }
+    }
+
+    const std::vector<PipelineStage<T>> stages;
+    const int blockSize;
+    int numBlocksInFlight = 0;
+
+    std::vector<std::unique_ptr<SpscBlockRing<T>>> rings;
+    std::vector<std::thread> workers;
+    std::atomic<bool> quit { false };
+};
+
+/**
+ * Runs a dynamic `Model` as a pipeline, by splitting its layers
+ * into stages which run on separate threads (see `StagePipeline`).
+ *
+ * The pipeline calls the model's layers directly, so the model must
+ * outlive the pipeline, and should not be used by anything else while
+ * the pipeline exists.
+ */
+template <typename T>
+class PipelineModel
+{
+public:
+    /**
+     * Splits the model's layers into `numStages` stages with roughly
+     * equal amounts of work (see `partitionLayers()`).
+     */
+    PipelineModel(Model<T>& model, int numStages, int blockSize, bool pinThreads = false, int firstCore = 1)
+        : PipelineModel(model, partitionLayers(model, numStages), blockSize, pinThreads, firstCore)
+    {
+    }
+
+    /**
+     * Splits the model's layers into stages, where stage `i` starts
+     * at layer `stageStartLayers[i]`. The first stage must start at layer 0.
+     */
+    PipelineModel(Model<T>& model, const std::vector<int>& stageStartLayers, int blockSize, bool pinThreads = false, int firstCore = 1)
+        : stageStartLayers(stageStartLayers)
+    {
+        const auto numLayers = (int)model.layers.size();
+        std::vector<PipelineStage<T>> stages;
+        for(size_t i = 0; i < stageStartLayers.size(); ++i)
+        {
+            const auto end = i + 1 < stageStartLayers.size() ? stageStartLayers[i + 1] : numLayers;
+            layerStages.emplace_back(new LayerStage(model, stageStartLayers[i], end, blockSize));
+            stages.push_back(layerStages.back()->getStage());
+        }
+
+        pipeline.reset(new StagePipeline<T>(stages, blockSize, pinThreads, firstCore));
+    }
+
+    /**
+     * Returns the first layer of each of `numStages` stages, so that each stage
+     * has roughly the same amount of work. The work done by a layer is
+     * estimated from its number of multiply-adds (see `Layer::getNumMACs()`).
+     */
+    static std::vector<int> partitionLayers(const Model<T>& model, int numStages)
+    {
+        const auto numLayers = (int)model.layers.size();
+        numStages = std::max(1, std::min(numStages, numLayers));
+
+        std::vector<double> costs;
+        double totalCost = 0.0;
+        for(const auto* layer : model.layers)
+        {
+            costs.push_back((double)layer->getNumMACs());
+            totalCost += costs.back();
+        }
+
+        std::vector<int> starts { 0 };
+        double cost = 0.0;
+        for(int i = 0; i < numLayers && (int)starts.size() < numStages; ++i)
+        {
+            const auto numStagesLeft = numStages - (int)starts.size();
+            const auto target = totalCost * (double)starts.size() / (double)numStages;
+            if(i > starts.back() && (cost + 0.5 * costs[(size_t)i] >= target || numLayers - i == numStagesLeft))
+                starts.push_back(i);
+
+            cost += costs[(size_t)i];
+        }
+
+        return starts;
+    }
+
+    /** Returns the first layer of each stage. */
+    const std::vector<int>& getStageStartLayers() const noexcept { return stageStartLayers; }
+
+    /** Returns the number of stages in the pipeline. */
+    int getNumStages() const noexcept { return pipeline->getNumStages(); }
+
+    /** Returns the number of frames processed by each call to `forward()`. */
+    int getBlockSize() const noexcept { return pipeline->getBlockSize(); }
+
+    /** Returns the extra latency of the pipeline in frames. */
+    int getLatencySamples() const noexcept { return pipeline->getLatencySamples(); }
+
+    /** Resets the state of the model (see `StagePipeline::reset()`). */
+    void reset() { pipeline->reset(); }
+
+    /**
+     * Processes a block of `getBlockSize()` frames, and writes the output
+     * from `getLatencySamples()` frames ago.
+     */
+    RTNEURAL_REALTIME void forward(const T* input, T* output) noexcept
+    {
+        pipeline->process(input, output);
+    }
+
+private:
+    /** Runs a range of the model's layers, with the same direct calls as a compiled model. */
+    struct LayerStage
+    {
+        LayerStage(Model<T>& model, int begin, int end, int blockSize)
+            : inSize(model.layers[(size_t)begin]->in_size)
+            , outSize(model.layers[(size_t)end - 1]->out_size)
+        {
+            int maxOutSize = 0;
+            for(int i = begin; i < end; ++i)
+            {
+                PlanOp<T> op;
+                op.layer = model.layers[(size_t)i];
+                resolvePlanOp(op);
+                ops.push_back(op);
+                maxOutSize = std::max(maxOutSize, op.layer->out_size);
+            }
+
+            const auto bufferSize = (size_t)(blockSize * maxOutSize);
+            buffers = MemoryArena(2 * MemoryArena::getBytes<T>(bufferSize));
+            blockBuffers[0] = buffers.allocate<T>(bufferSize);
+            blockBuffers[1] = buffers.allocate<T>(bufferSize);
+        }
+
+        PipelineStage<T> getStage() noexcept { return { &process, &reset, this, inSize, outSize }; }
+
+        static void process(void* context, const T* input, T* output, int numFrames) noexcept
+        {
+            auto& stage = *static_cast<LayerStage*>(context);
+            const auto numOps = (int)stage.ops.size();
+            for(int i = 0; i < numOps; ++i)
+            {
+                const auto* in = i == 0 ? input : stage.blockBuffers[(i - 1) % 2];
+                auto* out = i == numOps - 1 ? output : stage.blockBuffers[i % 2];
+                stage.ops[(size_t)i].forwardBlock(stage.ops[(size_t)i].layer, in, out, numFrames);
+            }
+        }
+
+        static void reset(void* context)
+        {
+            for(auto& op : static_cast<LayerStage*>(context)->ops)
+                op.layer->reset();
+        }
+
+        const int inSize;
+        const int outSize;
+        std::vector<PlanOp<T>> ops;
+        MemoryArena buffers;
+        T* blockBuffers[2] {};
+    };
+
+    std::vector<int> stageStartLayers;
+    std::vector<std::unique_ptr<LayerStage>> layerStages;
+    std::unique_ptr<StagePipeline<T>> pipeline;
+};
+
+/**
+ * Runs a static model as a pipeline, where each stage is a `ModelT`
+ * running on its own thread (see `StagePipeline`).
+ *
+ * The output size of each stage must match the input size of the next:
+ * ```
+ * PipelineModelT<float,
+ *     ModelT<float, 1, 32, GRULayerT<float, 1, 32>, GRULayerT<float, 32, 32>>,
+ *     ModelT<float, 32, 1, DenseT<float, 32, 64>, TanhActivationT<float, 64>, DenseT<float, 64, 1>>>
+ *     model { blockSize };
+ * ```
+ */
+template <typename T, typename... StageModels>
+class PipelineModelT
+{
+    using FirstStage = typename std::tuple_element<0, std::tuple<StageModels...>>::type;
+    using LastStage = typename std::tuple_element<sizeof...(StageModels) - 1, std::tuple<StageModels...>>::type;
+
+public:
+    static constexpr auto input_size = FirstStage::input_size;
+    static constexpr auto output_size = LastStage::output_size;
+
+    /** Creates the pipeline (see the `StagePipeline` constructor). */
+    explicit PipelineModelT(int blockSize, bool pinThreads = false, int firstCore = 1)
+    {
+        static_assert(stagesConnect<StageModels...>(), "The output size of each stage must match the input size of the next stage!");
+
+        std::vector<PipelineStage<T>> stages;
+        modelt_detail::forEachInTuple([&](auto& stageModel, size_t)
+            {
+                using ModelType = typename std::remove_reference<decltype(stageModel)>::type;
+                stages.push_back({ &processStage<ModelType>, &resetStage<ModelType>, &stageModel, (int)ModelType::input_size, (int)ModelType::output_size });
+            },
+            stageModels);
+
+        pipeline.reset(new StagePipeline<T>(stages, blockSize, pinThreads, firstCore));
+    }
+
+    /** Get a reference to the model for the stage at index `Index`. */
+    template <int Index>
+    auto& getStage() noexcept
+    {
+        return std::get<Index>(stageModels);
+    }
+
+    /** Returns the number of stages in the pipeline. */
+    int getNumStages() const noexcept { return pipeline->getNumStages(); }
+
+    /** Returns the number of frames processed by each call to `processBlock()`. */
+    int getBlockSize() const noexcept { return pipeline->getBlockSize(); }
+
+    /** Returns the extra latency of the pipeline in frames. */
+    int getLatencySamples() const noexcept { return pipeline->getLatencySamples(); }
+
+    /** Resets the state of the model (see `StagePipeline::reset()`). */
+    void reset() { pipeline->reset(); }
+
+    /**
+     * Processes a block of `getBlockSize()` frames, and writes the output
+     * from `getLatencySamples()` frames ago.
+     */
+    RTNEURAL_REALTIME void processBlock(const T* input, T* output) noexcept
+    {
+        pipeline->process(input, output);
+    }
+
+    /**
+     * Loads the weights for all of the stages from a json model, whose
+     * layers are split between the stages in order.
+     * Returns true if the json layers exactly match the stages' layers.
+     */
+    bool parseJson(const nlohmann::json& parent, const bool debug = false)
+    {
+        const auto json_layers = parent["layers"];
+        if(!json_layers.is_array())
+            return false;
+
+        bool matched = true;
+        int json_stream_idx = 0;
+        modelt_detail::forEachInTuple([&](auto& stageModel, size_t stageIdx)
+            {
+                using ModelType = typename std::remove_reference<decltype(stageModel)>::type;
+                if(!matched)
+                    return;
+
+                // the first stage sees the model's input shape, and the others see the previous stage's output
+                nlohmann::json stageJson;
+                stageJson["in_shape"] = stageIdx == 0 ? parent["in_shape"] : nlohmann::json::array({ nullptr, nullptr, (int)ModelType::input_size });
+                stageJson["layers"] = nlohmann::json::array();
+
+                // a json layer can hold more than one layer of the stage (e.g. a dense layer and its activation),
+                // so find the shortest run of json layers which matches the stage
+                for(auto idx = json_stream_idx; idx < (int)json_layers.size(); ++idx)
+                {
+                    stageJson["layers"].push_back(json_layers.at(idx));
+                    if(stageModel.parseJson(stageJson, false))
+                    {
+                        json_parser::debug_print("Stage " + std::to_string(stageIdx) + ": json layers "
+                                + std::to_string(json_stream_idx) + " to " + std::to_string(idx),
+                            debug);
+                        json_stream_idx = idx + 1;
+                        return;
+                    }
+                }
+
+                json_parser::debug_print("No json layers match stage " + std::to_string(stageIdx) + "!", debug);
+                matched = false;
+            },
+            stageModels);
+
+        if(matched && json_stream_idx != (int)json_layers.size())
+        {
+            json_parser::debug_print("Too few layers for the json model!", debug);
+            matched = false;
+        }
+
+        return matched;
+    }
+
+    /**
+     * Loads the weights for all of the stages from a json stream.
+     * Returns true if the json layers exactly match the stages' layers.
+     */
+    bool parseJson(std::ifstream& jsonStream, const bool debug = false)
+    {
+        nlohmann::json parent;
+        jsonStream >> parent;
+        return parseJson(parent, debug);
+    }
+
+private:
+    template <typename ModelType>
+    static void processStage(void* context, const T* input, T* output, int numFrames) noexcept
+    {
+        static_cast<ModelType*>(context)->processBlock(input, output, numFrames);
+    }
+
+    template <typename ModelType>
+    static void resetStage(void* context)
+    {
+        static_cast<ModelType*>(context)->reset();
+    }
+
+    template <typename ModelType>
+    static constexpr bool stagesConnect()
+    {
+        return true;
+    }
+
+    template <typename ModelType, typename NextModelType, typename... OtherModelTypes>
+    static constexpr bool stagesConnect()
+    {
+        return ModelType::output_size == NextModelType::input_size && stagesConnect<NextModelType, OtherModelTypes...>();
+    }
+
+    std::tuple<StageModels...> stageModels;
+    std::unique_ptr<StagePipeline<T>> pipeline;
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // PIPELINE_MODEL_H_INCLUDED
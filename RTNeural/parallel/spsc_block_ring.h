@@ -0,0 +1,121 @@
+#ifndef SPSC_BLOCK_RING_H_INCLUDED
+#define SPSC_BLOCK_RING_H_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+
+#include "../config.h"
+#include "../memory_arena.h"
+#include "thread_utils.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * A lock-free, single-producer single-consumer ring of blocks.
+ *
+ * Each slot holds up to `maxBlockSize` frames of `numChannels` values.
+ * The producer fills the slot from `getWriteBlock()` in place and then
+ * calls `pushBlock()`; the consumer reads the slot from `getReadBlock()`
+ * in place and then calls `popBlock()`. The storage is allocated up-front,
+ * so none of these methods allocate memory or take locks.
+ */
+template <typename T>
+class SpscBlockRing
+{
+public:
+    /** Creates a ring with `numSlots` slots of `maxBlockSize` frames with `numChannels` values each. */
+    SpscBlockRing(int numSlots, int maxBlockSize, int numChannels)
+        : numSlots(numSlots)
+        , slotSize(getSlotSize(maxBlockSize, numChannels))
+        , memory(MemoryArena::getBytes<T>((size_t)(numSlots * slotSize)) + MemoryArena::getBytes<BlockInfo>((size_t)numSlots))
+    {
+        blocks = memory.allocate<T>((size_t)(numSlots * slotSize));
+        blockInfos = memory.allocate<BlockInfo>((size_t)numSlots);
+    }
+
+    SpscBlockRing(const SpscBlockRing&) = delete;
+    SpscBlockRing& operator=(const SpscBlockRing&) = delete;
+
+    /** Returns the number of slots in the ring. */
+    int getNumSlots() const noexcept { return numSlots; }
+
+    /** Producer: returns the next slot to fill, or nullptr if the ring is full. */
+    RTNEURAL_REALTIME T* getWriteBlock() noexcept
+    {
+        const auto w = writeIdx.load(std::memory_order_relaxed);
+        if(w - readIdx.load(std::memory_order_acquire) >= (int64_t)numSlots)
+            return nullptr;
+
+        return blocks + (w % numSlots) * slotSize;
+    }
+
+    /**
+     * Producer: publishes the slot returned by `getWriteBlock()`, holding
+     * `numFrames` frames. The `tag` is passed along with the block, e.g.
+     * for a sequence number or a timestamp.
+     */
+    RTNEURAL_REALTIME void pushBlock(int numFrames, int64_t tag = 0) noexcept
+    {
+        const auto w = writeIdx.load(std::memory_order_relaxed);
+        blockInfos[w % numSlots] = { numFrames, tag };
+        writeIdx.store(w + 1, std::memory_order_release);
+    }
+
+    /** Consumer: returns the oldest published slot, or nullptr if the ring is empty. */
+    RTNEURAL_REALTIME const T* getReadBlock(int& numFrames, int64_t* tag = nullptr) const noexcept
+    {
+        const auto r = readIdx.load(std::memory_order_relaxed);
+        if(writeIdx.load(std::memory_order_acquire) == r)
+            return nullptr;
+
+        const auto& info = blockInfos[r % numSlots];
+        numFrames = info.numFrames;
+        if(tag != nullptr)
+            *tag = info.tag;
+
+        return blocks + (r % numSlots) * slotSize;
+    }
+
+    /** Consumer: releases the slot returned by `getReadBlock()`. */
+    RTNEURAL_REALTIME void popBlock() noexcept
+    {
+        readIdx.store(readIdx.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /** Returns true if the ring looked empty (the result may be stale). */
+    bool isEmpty() const noexcept
+    {
+        return writeIdx.load(std::memory_order_acquire) == readIdx.load(std::memory_order_acquire);
+    }
+
+private:
+    struct BlockInfo
+    {
+        int numFrames;
+        int64_t tag;
+    };
+
+    /** Rounds each slot up, so that every slot starts on an aligned address. */
+    static int getSlotSize(int maxBlockSize, int numChannels) noexcept
+    {
+        const auto alignedValues = (int)(MemoryArena::alignment / sizeof(T));
+        const auto values = maxBlockSize * numChannels;
+        return ((values + alignedValues - 1) / alignedValues) * alignedValues;
+    }
+
+    const int numSlots;
+    const int slotSize;
+    MemoryArena memory;
+    T* blocks = nullptr;
+    BlockInfo* blockInfos = nullptr;
+
+    // padded rather than aligned, since over-aligned types can't be allocated safely in C++14
+    std::atomic<int64_t> writeIdx { 0 };
+    char padding[cacheLineSize] {};
+    std::atomic<int64_t> readIdx { 0 };
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // SPSC_BLOCK_RING_H_INCLUDED
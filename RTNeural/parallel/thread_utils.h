@@ -0,0 +1,115 @@
+#ifndef THREAD_UTILS_H_INCLUDED
+#define THREAD_UTILS_H_INCLUDED
+
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#define RTNEURAL_DEFINED_NOMINMAX
+#endif
+#include <windows.h>
+#ifdef RTNEURAL_DEFINED_NOMINMAX
+#undef NOMINMAX
+#undef RTNEURAL_DEFINED_NOMINMAX
+#endif
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#elif defined(_M_ARM64) || defined(_M_ARM)
+#include <intrin.h>
+#endif
+
+#include "../Model.h"
+#include "../config.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * The size of a cache line, used to keep data written by
+ * different threads on separate cache lines.
+ */
+constexpr size_t cacheLineSize = 64;
+
+/** Tells the CPU that the calling thread is busy-waiting. */
+RTNEURAL_REALTIME inline void cpuRelax() noexcept
+{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(_M_ARM64) || defined(_M_ARM)
+    __yield();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * Pins a thread to the given CPU core.
+ * Returns false if pinning failed, or is not supported on this platform.
+ */
+inline bool pinThreadToCore(std::thread& thread, int core) noexcept
+{
+#if defined(__linux__)
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset) == 0;
+#elif defined(_WIN32)
+    return SetThreadAffinityMask(thread.native_handle(), (DWORD_PTR)1 << core) != 0;
+#else
+    (void)thread;
+    (void)core;
+    return false;
+#endif
+}
+
+/** Processes a block of frames with a dynamic model. */
+template <typename T>
+RTNEURAL_REALTIME inline void processModelBlock(Model<T>& model, const T* input, T* output, int numFrames) noexcept
+{
+    model.forward(input, output, numFrames);
+}
+
+/** Processes a block of frames with a static model (or any type with a `processBlock()` method). */
+template <typename ModelType, typename T>
+RTNEURAL_REALTIME inline void processModelBlock(ModelType& model, const T* input, T* output, int numFrames) noexcept
+{
+    model.processBlock(input, output, numFrames);
+}
+
+/** Returns the input size of a dynamic model. */
+template <typename T>
+inline int getModelInSize(const Model<T>& model) noexcept
+{
+    return model.getInSize();
+}
+
+/** Returns the input size of a static model. */
+template <typename ModelType>
+inline int getModelInSize(const ModelType&) noexcept
+{
+    return (int)ModelType::input_size;
+}
+
+/** Returns the output size of a dynamic model. */
+template <typename T>
+inline int getModelOutSize(const Model<T>& model) noexcept
+{
+    return model.getOutSize();
+}
+
+/** Returns the output size of a static model. */
+template <typename ModelType>
+inline int getModelOutSize(const ModelType&) noexcept
+{
+    return (int)ModelType::output_size;
+}
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // THREAD_UTILS_H_INCLUDED
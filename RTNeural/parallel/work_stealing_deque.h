@@ -0,0 +1,112 @@
+#ifndef WORK_STEALING_DEQUE_H_INCLUDED
+#define WORK_STEALING_DEQUE_H_INCLUDED
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+#include "../config.h"
+#include "thread_utils.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * A fixed-capacity, lock-free work-stealing deque of integers
+ * (Chase-Lev, with the memory orderings from Lê et al., 2013).
+ *
+ * Only the owning thread may call `push()` and `pop()`, which work on
+ * the bottom of the deque. Any thread may call `steal()`, which takes
+ * from the top. The storage is allocated up-front, so none of the
+ * methods allocate memory or take locks.
+ */
+class WorkStealingDeque
+{
+public:
+    /** Creates a deque which can hold at least `minCapacity` items. */
+    explicit WorkStealingDeque(int minCapacity)
+    {
+        while(capacity < minCapacity)
+            capacity *= 2;
+
+        mask = (int64_t)capacity - 1;
+        buffer.reset(new std::atomic<int>[(size_t)capacity]);
+    }
+
+    /** Returns the maximum number of items in the deque. */
+    int getCapacity() const noexcept { return capacity; }
+
+    /** Adds an item to the bottom of the deque. Returns false if the deque is full. */
+    RTNEURAL_REALTIME bool push(int item) noexcept
+    {
+        const auto b = bottom.load(std::memory_order_relaxed);
+        const auto t = top.load(std::memory_order_acquire);
+        if(b - t >= (int64_t)capacity)
+            return false;
+
+        buffer[(size_t)(b & mask)].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /** Takes an item from the bottom of the deque. Returns false if the deque is empty. */
+    RTNEURAL_REALTIME bool pop(int& item) noexcept
+    {
+        const auto b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto t = top.load(std::memory_order_relaxed);
+
+        if(t > b)
+        {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = buffer[(size_t)(b & mask)].load(std::memory_order_relaxed);
+        if(t == b)
+        {
+            // last item: race against any thieves
+            const auto won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        return true;
+    }
+
+    /** Takes an item from the top of the deque. Returns false if the deque is empty, or if another thread won the race. */
+    RTNEURAL_REALTIME bool steal(int& item) noexcept
+    {
+        auto t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto b = bottom.load(std::memory_order_acquire);
+        if(t >= b)
+            return false;
+
+        item = buffer[(size_t)(t & mask)].load(std::memory_order_relaxed);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    /** Returns true if the deque looked empty (the result may be stale). */
+    bool isEmpty() const noexcept
+    {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    // padded rather than aligned, since over-aligned types can't be allocated safely in C++14
+    std::atomic<int64_t> top { 0 };
+    char padding[cacheLineSize] {};
+    std::atomic<int64_t> bottom { 0 };
+
+    int capacity = 1;
+    int64_t mask = 0;
+    std::unique_ptr<std::atomic<int>[]> buffer;
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // WORK_STEALING_DEQUE_H_INCLUDED
@@ -0,0 +1,390 @@
+#ifndef CONV1D_HALF_H_INCLUDED
+#define CONV1D_HALF_H_INCLUDED
+
+#include <algorithm>
+#include <vector>
+
+#include "../Layer.h"
+#include "../common.h"
+#include "../config.h"
+#include "../model_plan.h"
+#include "half_kernels.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * Dynamic implementation of a 1-dimensional convolution layer, with 16-bit
+ * weights, and no activation.
+ *
+ * The weights are stored as `WeightType` (`bfloat16` or `float16`), and
+ * converted back to `T` as they are used. The layer inputs are kept at
+ * full precision.
+ *
+ * This implementation was designed for use in "temporal
+ * convolution", so the layer has a "state" made up of past inputs
+ * to the layer. To ensure that the state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, typename WeightType = bfloat16>
+class Conv1DHalf final : public Layer<T>
+{
+public:
+    /**
+     * Constructs a convolution layer for the given dimensions.
+     *
+     * @param in_size: the input size for the layer
+     * @param out_size: the output size for the layer
+     * @param kernel_size: the size of the convolution kernel
+     * @param dilation: the dilation rate to use for dilated convolution
+     * @param groups: controls connections between inputs and outputs
+     */
+    Conv1DHalf(int in_size, int out_size, int kernel_size, int dilation, int groups = 1)
+        : Layer<T>(in_size, out_size)
+        , dilation_rate(dilation)
+        , kernel_size(kernel_size)
+        , state_size((kernel_size - 1) * dilation + 1)
+        , groups(groups)
+        , filters_per_group(in_size / groups)
+        , channels_per_group(out_size / groups)
+        , memory(getMemoryBytes())
+    {
+        bindMemory();
+        reset();
+    }
+
+    Conv1DHalf(std::initializer_list<int> sizes)
+        : Conv1DHalf(*sizes.begin(), *(sizes.begin() + 1), *(sizes.begin() + 2), *(sizes.begin() + 3))
+    {
+    }
+
+    Conv1DHalf(const Conv1DHalf& other)
+        : Conv1DHalf(other.in_size, other.out_size, other.kernel_size, other.dilation_rate, other.groups)
+    {
+    }
+
+    Conv1DHalf& operator=(const Conv1DHalf& other)
+    {
+        return *this = Conv1DHalf(other);
+    }
+
+    virtual ~Conv1DHalf() = default;
+
+    /** Resets the layer state. */
+    RTNEURAL_REALTIME void reset() override
+    {
+        std::fill(history, history + state_size * Layer<T>::in_size, (T)0);
+        state_ptr = 0;
+    }
+
+    /** Returns the number of values in the layer state. */
+    size_t getStateSize() const noexcept override { return (size_t)(state_size * Layer<T>::in_size); }
+
+    /** Copies the past inputs into `state`, from oldest to newest. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept override
+    {
+        for(int k = 0; k < state_size; ++k, state += Layer<T>::in_size)
+        {
+            const auto* frame = history + ((state_ptr + k) % state_size) * Layer<T>::in_size;
+            std::copy(frame, frame + Layer<T>::in_size, state);
+        }
+    }
+
+    /** Restores the past inputs from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept override
+    {
+        std::copy(state, state + state_size * Layer<T>::in_size, history);
+        state_ptr = 0;
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "conv1d"; }
+
+    size_t getNumMACs() const noexcept override { return (size_t)(Layer<T>::out_size * filters_per_group * kernel_size); }
+
+    /** Lets `Model::compile()` call this layer directly. */
+    bool resolvePlanOp(PlanOp<T>& op) override { return plan_detail::resolve<T, Conv1DHalf<T, WeightType>>(op); }
+
+    /** Performs forward propagation for this layer. */
+    RTNEURAL_REALTIME inline void forward(const T* input, T* h) noexcept override
+    {
+        // insert input into a circular buffer
+        std::copy(input, input + Layer<T>::in_size, history + state_ptr * Layer<T>::in_size);
+
+        for(int k = 0; k < kernel_size; ++k)
+            state_ptrs[k] = (state_ptr + state_size - k * dilation_rate) % state_size;
+
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+        {
+            const auto ii = (i / channels_per_group) * filters_per_group;
+            const auto* w = weights + i * kernel_size * filters_per_group;
+
+            T acc = bias[i];
+            for(int k = 0; k < kernel_size; ++k)
+                acc += half_detail::dot(w + k * filters_per_group, history + state_ptrs[k] * Layer<T>::in_size + ii, filters_per_group);
+
+            h[i] = acc;
+        }
+
+        state_ptr = (state_ptr == state_size - 1 ? 0 : state_ptr + 1); // iterate state pointer forwards
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size weights[out_size][group_count][kernel_size * dilation]
+     */
+    void setWeights(const std::vector<std::vector<std::vector<T>>>& ws)
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            for(int k = 0; k < filters_per_group; ++k)
+                for(int j = 0; j < kernel_size; ++j)
+                    weights[(i * kernel_size + j) * filters_per_group + k] = half_detail::fromFloat<WeightType>((float)ws[i][k][j]);
+    }
+
+    /**
+     * Sets the layer biases.
+     *
+     * The bias vector must have size bias[out_size]
+     */
+    void setBias(const std::vector<T>& biasVals)
+    {
+        std::copy(biasVals.begin(), biasVals.begin() + Layer<T>::out_size, bias);
+    }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the convolution dilation rate. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+    /** Returns the number of "groups" in the convolution. */
+    int getGroups() const noexcept { return groups; }
+
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+    }
+
+private:
+    const int dilation_rate;
+    const int kernel_size;
+    const int state_size;
+    const int groups;
+    const int filters_per_group;
+    const int channels_per_group;
+
+    size_t getMemoryBytes() const noexcept
+    {
+        return MemoryArena::getBytes<WeightType>((size_t)(Layer<T>::out_size * kernel_size * filters_per_group))
+            + MemoryArena::getBytes<T>((size_t)Layer<T>::out_size)
+            + MemoryArena::getBytes<T>((size_t)(state_size * Layer<T>::in_size))
+            + MemoryArena::getBytes<int>((size_t)kernel_size);
+    }
+
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept
+    {
+        memory.rewind();
+        weights = memory.allocate<WeightType>((size_t)(Layer<T>::out_size * kernel_size * filters_per_group));
+        bias = memory.allocate<T>((size_t)Layer<T>::out_size);
+        history = memory.allocate<T>((size_t)(state_size * Layer<T>::in_size));
+        state_ptrs = memory.allocate<int>((size_t)kernel_size);
+    }
+
+    MemoryArena memory;
+    WeightType* weights = nullptr;
+    T* bias = nullptr;
+
+    T* history = nullptr;
+    int* state_ptrs = nullptr;
+    int state_ptr = 0;
+};
+
+//====================================================
+/**
+ * Static implementation of a 1-dimensional convolution layer, with 16-bit
+ * weights, and no activation. See `Conv1DHalf` for details.
+ *
+ * @param in_sizet: the input size for the layer
+ * @param out_sizet: the output size for the layer
+ * @param kernel_size: the size of the convolution kernel
+ * @param dilation_rate: the dilation rate to use for dilated convolution
+ * @param groups: controls connections between inputs and outputs
+ * @param WeightType: the storage type for the weights (`bfloat16` or `float16`)
+ */
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, int groups = 1, typename WeightType = bfloat16>
+class Conv1DHalfT
+{
+    static_assert((in_sizet % groups == 0) && (out_sizet % groups == 0), "in_size and out_size must be divisible by groups!");
+
+    static constexpr auto state_size = (kernel_size - 1) * dilation_rate + 1;
+    static constexpr auto filters_per_group = in_sizet / groups;
+    static constexpr auto channels_per_group = out_sizet / groups;
+    static constexpr auto weights_row_size = kernel_size * filters_per_group;
+
+#if RTNEURAL_USE_EIGEN
+    using in_type = Eigen::Matrix<T, in_sizet, 1>;
+    using out_type = Eigen::Matrix<T, out_sizet, 1>;
+#elif RTNEURAL_USE_XSIMD
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_in_size = ceil_div(in_sizet, v_size);
+    static constexpr auto v_out_size = ceil_div(out_sizet, v_size);
+#endif
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    Conv1DHalfT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(weights), std::end(weights), WeightType {});
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+#if RTNEURAL_USE_EIGEN
+        outs = out_type::Zero();
+#elif RTNEURAL_USE_XSIMD
+        std::fill(std::begin(outs), std::end(outs), v_type((T)0));
+#else
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+#endif
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "conv1d"; }
+
+    /** Returns false since convolution is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the layer state. */
+    RTNEURAL_REALTIME void reset()
+    {
+        std::fill(std::begin(history), std::end(history), (T)0);
+        state_ptr = 0;
+    }
+
+    /** Returns the number of values in the layer state. */
+    static constexpr size_t getStateSize() noexcept { return (size_t)(state_size * in_size); }
+
+    /** Copies the past inputs into `state`, from oldest to newest. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept
+    {
+        for(int k = 0; k < state_size; ++k, state += in_size)
+        {
+            const auto* frame = history + ((state_ptr + k) % state_size) * in_size;
+            std::copy(frame, frame + in_size, state);
+        }
+    }
+
+    /** Restores the past inputs from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept
+    {
+        std::copy(state, state + state_size * in_size, std::begin(history));
+        state_ptr = 0;
+    }
+
+    /** Performs forward propagation for this layer. */
+#if RTNEURAL_USE_EIGEN
+    RTNEURAL_REALTIME inline void forward(const in_type& ins) noexcept
+    {
+        forwardInternal(ins.data(), outs.data());
+    }
+#elif RTNEURAL_USE_XSIMD
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        forwardInternal(reinterpret_cast<const T*>(ins), reinterpret_cast<T*>(outs));
+    }
+#else
+    RTNEURAL_REALTIME inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        forwardInternal(ins, outs);
+    }
+#endif
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size weights[out_size][group_count][kernel_size * dilation]
+     */
+    void setWeights(const std::vector<std::vector<std::vector<T>>>& ws)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < filters_per_group; ++k)
+                for(int j = 0; j < kernel_size; ++j)
+                    weights[i * weights_row_size + j * filters_per_group + k] = half_detail::fromFloat<WeightType>((float)ws[i][k][j]);
+    }
+
+    /**
+     * Sets the layer biases.
+     *
+     * The bias vector must have size bias[out_size]
+     */
+    void setBias(const std::vector<T>& biasVals)
+    {
+        std::copy(biasVals.begin(), biasVals.begin() + out_size, std::begin(bias));
+    }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the convolution dilation rate. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+    /** Returns the number of "groups" in the convolution. */
+    int getGroups() const noexcept { return groups; }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<out_type, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD
+    v_type outs[v_out_size];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    RTNEURAL_REALTIME inline void forwardInternal(const T* ins, T* out) noexcept
+    {
+        // insert input into a circular buffer
+        std::copy(ins, ins + in_size, history + state_ptr * in_size);
+
+        int state_ptrs[kernel_size];
+        for(int k = 0; k < kernel_size; ++k)
+            state_ptrs[k] = (state_ptr + state_size - k * dilation_rate) % state_size;
+
+        for(int i = 0; i < out_size; ++i)
+        {
+            const auto ii = (i / channels_per_group) * filters_per_group;
+            const auto* w = weights + i * weights_row_size;
+
+            T acc = bias[i];
+            for(int k = 0; k < kernel_size; ++k)
+                acc += half_detail::dot(w + k * filters_per_group, history + state_ptrs[k] * in_size + ii, filters_per_group);
+
+            out[i] = acc;
+        }
+
+        state_ptr = (state_ptr == state_size - 1 ? 0 : state_ptr + 1); // iterate state pointer forwards
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    WeightType weights[out_size * weights_row_size];
+    T bias[out_size];
+
+    T history[state_size * in_size];
+    int state_ptr = 0;
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // CONV1D_HALF_H_INCLUDED
@@ -0,0 +1,248 @@
+#ifndef DENSE_HALF_H_INCLUDED
+#define DENSE_HALF_H_INCLUDED
+
+#include <algorithm>
+#include <vector>
+
+#include "../Layer.h"
+#include "../common.h"
+#include "../config.h"
+#include "../model_plan.h"
+#include "half_kernels.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * Dynamic implementation of a fully-connected (dense) layer, with 16-bit
+ * weights, and no activation.
+ *
+ * The weights are stored as `WeightType` (`bfloat16` or `float16`), which
+ * halves the memory (and memory bandwidth) needed for the weights of a
+ * float `Dense` layer. The weights are converted back to `T` as they are
+ * used, so the arithmetic is the same as for a `Dense` layer.
+ */
+template <typename T, typename WeightType = bfloat16>
+class DenseHalf final : public Layer<T>
+{
+public:
+    /** Constructs a dense layer for a given input and output size. */
+    DenseHalf(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , memory(getMemoryBytes(in_size, out_size))
+    {
+        bindMemory();
+    }
+
+    DenseHalf(std::initializer_list<int> sizes)
+        : DenseHalf(*sizes.begin(), *(sizes.begin() + 1))
+    {
+    }
+
+    DenseHalf(const DenseHalf& other)
+        : DenseHalf(other.in_size, other.out_size)
+    {
+    }
+
+    DenseHalf& operator=(const DenseHalf& other)
+    {
+        return *this = DenseHalf(other);
+    }
+
+    virtual ~DenseHalf() = default;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "dense"; }
+
+    size_t getNumMACs() const noexcept override { return (size_t)(Layer<T>::in_size * Layer<T>::out_size); }
+
+    /** Lets `Model::compile()` call this layer directly. */
+    bool resolvePlanOp(PlanOp<T>& op) override { return plan_detail::resolve<T, DenseHalf<T, WeightType>>(op); }
+
+    /** Performs forward propagation for this layer. */
+    RTNEURAL_REALTIME inline void forward(const T* input, T* out) noexcept override
+    {
+        half_detail::matVec(weights, input, out, Layer<T>::out_size, Layer<T>::in_size);
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            out[i] += bias[i];
+    }
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            for(int k = 0; k < Layer<T>::in_size; ++k)
+                weights[i * Layer<T>::in_size + k] = half_detail::fromFloat<WeightType>((float)newWeights[i][k]);
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + Layer<T>::out_size, bias);
+    }
+
+    /** Returns the weights value at the given indices. */
+    RTNEURAL_REALTIME T getWeight(int i, int k) const noexcept
+    {
+        return (T)half_detail::toFloat(weights[i * Layer<T>::in_size + k]);
+    }
+
+    /** Returns the bias value at the given index. */
+    RTNEURAL_REALTIME T getBias(int i) const noexcept { return bias[i]; }
+
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+    }
+
+private:
+    static size_t getMemoryBytes(int in_size, int out_size) noexcept
+    {
+        return MemoryArena::getBytes<WeightType>((size_t)(in_size * out_size))
+            + MemoryArena::getBytes<T>((size_t)out_size);
+    }
+
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept
+    {
+        memory.rewind();
+        weights = memory.allocate<WeightType>((size_t)(Layer<T>::in_size * Layer<T>::out_size));
+        bias = memory.allocate<T>((size_t)Layer<T>::out_size);
+    }
+
+    MemoryArena memory;
+    WeightType* weights = nullptr;
+    T* bias = nullptr;
+};
+
+//====================================================
+/**
+ * Static implementation of a fully-connected (dense) layer, with 16-bit
+ * weights, and no activation. See `DenseHalf` for details.
+ */
+template <typename T, int in_sizet, int out_sizet, typename WeightType = bfloat16>
+class DenseHalfT
+{
+#if RTNEURAL_USE_EIGEN
+    using in_type = Eigen::Matrix<T, in_sizet, 1>;
+    using out_type = Eigen::Matrix<T, out_sizet, 1>;
+#elif RTNEURAL_USE_XSIMD
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_in_size = ceil_div(in_sizet, v_size);
+    static constexpr auto v_out_size = ceil_div(out_sizet, v_size);
+#endif
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    DenseHalfT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(weights), std::end(weights), WeightType {});
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+#if RTNEURAL_USE_EIGEN
+        outs = out_type::Zero();
+#elif RTNEURAL_USE_XSIMD
+        std::fill(std::begin(outs), std::end(outs), v_type((T)0));
+#else
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+#endif
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "dense"; }
+
+    /** Returns false since dense is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Reset is a no-op, since Dense does not have state. */
+    RTNEURAL_REALTIME void reset() { }
+
+    /** Performs forward propagation for this layer. */
+#if RTNEURAL_USE_EIGEN
+    RTNEURAL_REALTIME inline void forward(const in_type& ins) noexcept
+    {
+        forwardInternal(ins.data(), outs.data());
+    }
+#elif RTNEURAL_USE_XSIMD
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        forwardInternal(reinterpret_cast<const T*>(ins), reinterpret_cast<T*>(outs));
+    }
+#else
+    RTNEURAL_REALTIME inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        forwardInternal(ins, outs);
+    }
+#endif
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < in_size; ++k)
+                weights[i * in_size + k] = half_detail::fromFloat<WeightType>((float)newWeights[i][k]);
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + out_size, std::begin(bias));
+    }
+
+    /** Returns the weights value at the given indices. */
+    RTNEURAL_REALTIME T getWeight(int i, int k) const noexcept { return (T)half_detail::toFloat(weights[i * in_size + k]); }
+
+    /** Returns the bias value at the given index. */
+    RTNEURAL_REALTIME T getBias(int i) const noexcept { return bias[i]; }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<out_type, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD
+    v_type outs[v_out_size];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    RTNEURAL_REALTIME inline void forwardInternal(const T* ins, T* out) noexcept
+    {
+        half_detail::matVec(weights, ins, out, out_size, in_size);
+        for(int i = 0; i < out_size; ++i)
+            out[i] += bias[i];
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    WeightType weights[in_size * out_size];
+    T bias[out_size];
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // DENSE_HALF_H_INCLUDED
@@ -0,0 +1,282 @@
+#ifndef DENSE_INT8_H_INCLUDED
+#define DENSE_INT8_H_INCLUDED
+
+#include <algorithm>
+#include <vector>
+
+#include "../Layer.h"
+#include "../common.h"
+#include "../config.h"
+#include "../model_plan.h"
+#include "int8_kernels.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * Dynamic implementation of a fully-connected (dense) layer, with int8
+ * weights, and no activation.
+ *
+ * The weights are quantized when they are set, with one scale per output
+ * channel, so they take up a quarter of the memory of a float `Dense`
+ * layer. Each input frame is quantized to int8 as well (with its own scale,
+ * or with a calibrated one, see `setInputRange()`), and the products
+ * are accumulated in int32, before being scaled back to floating point.
+ */
+template <typename T>
+class DenseInt8 final : public Layer<T>
+{
+public:
+    /** Constructs a dense layer for a given input and output size. */
+    DenseInt8(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , memory(getMemoryBytes(in_size, out_size))
+    {
+        bindMemory();
+    }
+
+    DenseInt8(std::initializer_list<int> sizes)
+        : DenseInt8(*sizes.begin(), *(sizes.begin() + 1))
+    {
+    }
+
+    DenseInt8(const DenseInt8& other)
+        : DenseInt8(other.in_size, other.out_size)
+    {
+    }
+
+    DenseInt8& operator=(const DenseInt8& other)
+    {
+        return *this = DenseInt8(other);
+    }
+
+    virtual ~DenseInt8() = default;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "dense"; }
+
+    size_t getNumMACs() const noexcept override { return (size_t)(Layer<T>::in_size * Layer<T>::out_size); }
+
+    /** Lets `Model::compile()` call this layer directly. */
+    bool resolvePlanOp(PlanOp<T>& op) override { return plan_detail::resolve<T, DenseInt8<T>>(op); }
+
+    /** Performs forward propagation for this layer. */
+    RTNEURAL_REALTIME inline void forward(const T* input, T* out) noexcept override
+    {
+        const auto inScale = int8_detail::quantizeInput(input, Layer<T>::in_size, inputScale, inputQ);
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+        {
+            const auto acc = int8_detail::dot(weights + i * Layer<T>::in_size, inputQ, Layer<T>::in_size);
+            out[i] = (T)acc * scales[i] * inScale + bias[i];
+        }
+    }
+
+    /**
+     * Sets the layer weights from a given vector, and quantizes them.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            scales[i] = int8_detail::quantize(newWeights[i].data(), Layer<T>::in_size, weights + i * Layer<T>::in_size);
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + Layer<T>::out_size, bias);
+    }
+
+    /**
+     * Sets a calibrated range for the layer inputs, so that every input frame
+     * is quantized with the same scale, rather than with its own. Inputs outside
+     * of [-maxAbs, maxAbs] saturate. A range of zero (the default) restores the
+     * per-frame scale.
+     */
+    void setInputRange(T maxAbs) noexcept { inputScale = maxAbs / (T)127; }
+
+    /** Returns the calibrated input range, or zero if each input frame is quantized with its own scale. */
+    T getInputRange() const noexcept { return inputScale * (T)127; }
+
+    /** Returns the (de-quantized) weights value at the given indices. */
+    RTNEURAL_REALTIME T getWeight(int i, int k) const noexcept
+    {
+        return scales[i] * (T)weights[i * Layer<T>::in_size + k];
+    }
+
+    /** Returns the bias value at the given index. */
+    RTNEURAL_REALTIME T getBias(int i) const noexcept { return bias[i]; }
+
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+    }
+
+private:
+    static size_t getMemoryBytes(int in_size, int out_size) noexcept
+    {
+        return MemoryArena::getBytes<int8_t>((size_t)(in_size * out_size))
+            + 2 * MemoryArena::getBytes<T>((size_t)out_size)
+            + MemoryArena::getBytes<int8_t>((size_t)in_size);
+    }
+
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept
+    {
+        memory.rewind();
+        weights = memory.allocate<int8_t>((size_t)(Layer<T>::in_size * Layer<T>::out_size));
+        scales = memory.allocate<T>((size_t)Layer<T>::out_size);
+        bias = memory.allocate<T>((size_t)Layer<T>::out_size);
+        inputQ = memory.allocate<int8_t>((size_t)Layer<T>::in_size);
+    }
+
+    MemoryArena memory;
+    int8_t* weights = nullptr;
+    T* scales = nullptr;
+    T* bias = nullptr;
+    int8_t* inputQ = nullptr;
+    T inputScale = (T)0;
+};
+
+//====================================================
+/**
+ * Static implementation of a fully-connected (dense) layer, with int8
+ * weights, and no activation. See `DenseInt8` for details.
+ */
+template <typename T, int in_sizet, int out_sizet>
+class DenseInt8T
+{
+#if RTNEURAL_USE_EIGEN
+    using in_type = Eigen::Matrix<T, in_sizet, 1>;
+    using out_type = Eigen::Matrix<T, out_sizet, 1>;
+#elif RTNEURAL_USE_XSIMD
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_in_size = ceil_div(in_sizet, v_size);
+    static constexpr auto v_out_size = ceil_div(out_sizet, v_size);
+#endif
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    DenseInt8T()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(weights), std::end(weights), (int8_t)0);
+        std::fill(std::begin(scales), std::end(scales), (T)0);
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+#if RTNEURAL_USE_EIGEN
+        outs = out_type::Zero();
+#elif RTNEURAL_USE_XSIMD
+        std::fill(std::begin(outs), std::end(outs), v_type((T)0));
+#else
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+#endif
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "dense"; }
+
+    /** Returns false since dense is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Reset is a no-op, since Dense does not have state. */
+    RTNEURAL_REALTIME void reset() { }
+
+    /** Performs forward propagation for this layer. */
+#if RTNEURAL_USE_EIGEN
+    RTNEURAL_REALTIME inline void forward(const in_type& ins) noexcept
+    {
+        forwardInternal(ins.data(), outs.data());
+    }
+#elif RTNEURAL_USE_XSIMD
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        forwardInternal(reinterpret_cast<const T*>(ins), reinterpret_cast<T*>(outs));
+    }
+#else
+    RTNEURAL_REALTIME inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        forwardInternal(ins, outs);
+    }
+#endif
+
+    /**
+     * Sets the layer weights from a given vector, and quantizes them.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        for(int i = 0; i < out_size; ++i)
+            scales[i] = int8_detail::quantize(newWeights[i].data(), in_size, weights + i * in_size);
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + out_size, std::begin(bias));
+    }
+
+    /**
+     * Sets a calibrated range for the layer inputs, so that every input frame
+     * is quantized with the same scale, rather than with its own. Inputs outside
+     * of [-maxAbs, maxAbs] saturate. A range of zero (the default) restores the
+     * per-frame scale.
+     */
+    void setInputRange(T maxAbs) noexcept { inputScale = maxAbs / (T)127; }
+
+    /** Returns the calibrated input range, or zero if each input frame is quantized with its own scale. */
+    T getInputRange() const noexcept { return inputScale * (T)127; }
+
+    /** Returns the (de-quantized) weights value at the given indices. */
+    RTNEURAL_REALTIME T getWeight(int i, int k) const noexcept { return scales[i] * (T)weights[i * in_size + k]; }
+
+    /** Returns the bias value at the given index. */
+    RTNEURAL_REALTIME T getBias(int i) const noexcept { return bias[i]; }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<out_type, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD
+    v_type outs[v_out_size];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    RTNEURAL_REALTIME inline void forwardInternal(const T* ins, T* out) noexcept
+    {
+        const auto inScale = int8_detail::quantizeInput(ins, in_size, inputScale, inputQ);
+        for(int i = 0; i < out_size; ++i)
+            out[i] = (T)int8_detail::dot(weights + i * in_size, inputQ, in_size) * scales[i] * inScale + bias[i];
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    int8_t weights[in_size * out_size];
+    T scales[out_size];
+    T bias[out_size];
+    int8_t inputQ[in_size];
+    T inputScale = (T)0;
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // DENSE_INT8_H_INCLUDED
@@ -0,0 +1,230 @@
+#ifndef FIXED_POINT_H_INCLUDED
+#define FIXED_POINT_H_INCLUDED
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "../config.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+#ifndef DOXYGEN
+namespace fixed_point_detail
+{
+    /** tanh(x) for x = 0, 1/32, 2/32, ..., 8, in Q31. */
+    inline const int32_t* tanhTable() noexcept
+    {
+        static const int32_t table[257] = {
+            0, 67087027, 134043238, 200738834, 267046038, 332840059, 398000016, 462409793,
+            525958823, 588542781, 650064194, 710432940, 769566653, 827391017, 883839965, 938855767,
+            992389039, 1044398644, 1094851532, 1143722488, 1190993835, 1236655069, 1280702458, 1323138607,
+            1363971989, 1403216471, 1440890820, 1477018219, 1511625774, 1544744046, 1576406585, 1606649491,
+            1635510996, 1663031067, 1689251036, 1714213263, 1737960815, 1760537185, 1781986033, 1802350947,
+            1821675246, 1840001788, 1857372819, 1873829831, 1889413451, 1904163334, 1918118093, 1931315227,
+            1943791074, 1955580771, 1966718233, 1977236130, 1987165888, 1996537682, 2005380453, 2013721914,
+            2021588576, 2029005763, 2035997648, 2042587275, 2048796596, 2054646501, 2060156855, 2065346536,
+            2070233464, 2074834649, 2079166216, 2083243450, 2087080830, 2090692061, 2094090114, 2097287257,
+            2100295089, 2103124571, 2105786059, 2108289334, 2110643629, 2112857658, 2114939645, 2116897344,
+            2118738072, 2120468724, 2122095801, 2123625428, 2125063379, 2126415091, 2127685686, 2128879988,
+            2130002540, 2131057616, 2132049242, 2132981208, 2133857079, 2134680210, 2135453758, 2136180694,
+            2136863812, 2137505741, 2138108952, 2138675772, 2139208386, 2139708851, 2140179101, 2140620954,
+            2141036119, 2141426204, 2141792720, 2142137087, 2142460640, 2142764634, 2143050249, 2143318595,
+            2143570713, 2143807583, 2144030125, 2144239206, 2144435637, 2144620183, 2144793563, 2144956451,
+            2145109482, 2145253251, 2145388318, 2145515209, 2145634419, 2145746413, 2145851627, 2145950471,
+            2146043330, 2146130567, 2146212522, 2146289514, 2146361844, 2146429794, 2146493629, 2146553598,
+            2146609936, 2146662861, 2146712581, 2146759290, 2146803170, 2146844392, 2146883117, 2146919496,
+            2146953672, 2146985778, 2147015939, 2147044273, 2147070891, 2147095897, 2147119387, 2147141455,
+            2147162186, 2147181661, 2147199956, 2147217143, 2147233289, 2147248457, 2147262705, 2147276091,
+            2147288666, 2147300479, 2147311576, 2147322001, 2147331794, 2147340994, 2147349637, 2147357756,
+            2147365383, 2147372548, 2147379279, 2147385602, 2147391543, 2147397123, 2147402365, 2147407290,
+            2147411916, 2147416262, 2147420345, 2147424180, 2147427783, 2147431167, 2147434347, 2147437334,
+            2147440140, 2147442776, 2147445252, 2147447579, 2147449764, 2147451817, 2147453745, 2147455557,
+            2147457259, 2147458858, 2147460360, 2147461771, 2147463096, 2147464341, 2147465511, 2147466610,
+            2147467642, 2147468612, 2147469523, 2147470379, 2147471183, 2147471938, 2147472647, 2147473314,
+            2147473940, 2147474528, 2147475081, 2147475600, 2147476087, 2147476545, 2147476976, 2147477380,
+            2147477760, 2147478117, 2147478452, 2147478766, 2147479062, 2147479340, 2147479601, 2147479846,
+            2147480077, 2147480293, 2147480496, 2147480687, 2147480867, 2147481035, 2147481193, 2147481342,
+            2147481482, 2147481613, 2147481736, 2147481852, 2147481961, 2147482063, 2147482159, 2147482249,
+            2147482334, 2147482414, 2147482489, 2147482559, 2147482625, 2147482687, 2147482745, 2147482800,
+            2147482851, 2147482899, 2147482945, 2147482987, 2147483027, 2147483065, 2147483100, 2147483133,
+            2147483165
+        };
+        return table;
+    }
+
+    /**
+     * Returns tanh(x) in Q31, for a value x with `frac_bits` fractional bits,
+     * by linear interpolation in the table above. Past the end of the table,
+     * the result is within 3e-7 of +/-1. The interpolation error is below 1e-4.
+     */
+    RTNEURAL_REALTIME inline int64_t tanhQ31(int64_t x, int frac_bits) noexcept
+    {
+        const auto* table = tanhTable();
+        const auto indexShift = frac_bits - 5;
+        const auto absX = x < 0 ? -x : x;
+        const auto index = absX >> indexShift;
+
+        int64_t y = table[256];
+        if(index < 256)
+        {
+            const auto frac = absX & (((int64_t)1 << indexShift) - 1);
+            y = (int64_t)table[index] + ((((int64_t)table[index + 1] - (int64_t)table[index]) * frac) >> indexShift);
+        }
+
+        return x < 0 ? -y : y;
+    }
+
+    /** Shifts a value to the right, rounding to nearest. */
+    RTNEURAL_REALTIME inline int64_t roundingShift(int64_t x, int shift) noexcept
+    {
+        return shift > 0 ? ((x + ((int64_t)1 << (shift - 1))) >> shift) : x;
+    }
+} // namespace fixed_point_detail
+#endif
+
+/**
+ * Fixed-point arithmetic, used in place of a `MathsProvider` by the
+ * fixed-point layers (e.g. `GRULayerFixedT`).
+ *
+ * A value `x` is stored as the integer `round(x * 2^FracBits)`. Products
+ * are accumulated in 64-bit integers (see `mulAccum()`), and every result is saturated to
+ * the range of `IntType`, rather than wrapping around. Sigmoid and tanh
+ * are computed from a lookup table with linear interpolation.
+ */
+template <typename IntType, int FracBits>
+struct FixedPointProvider
+{
+    static_assert(std::is_integral<IntType>::value && std::is_signed<IntType>::value && sizeof(IntType) <= 4,
+        "Fixed-point values must be stored in a signed integer type, of at most 32 bits!");
+    static_assert(FracBits >= 5 && FracBits < 8 * (int)sizeof(IntType),
+        "The number of fractional bits must be at least 5, and must leave room for the sign bit!");
+
+    using value_type = IntType;
+    using accum_type = int64_t;
+
+    static constexpr int accum_shift = sizeof(IntType) == 4 ? 16 : 0;
+
+    /** Saturates a wide value to the range of the fixed-point type. */
+    RTNEURAL_REALTIME static IntType saturate(int64_t x) noexcept
+    {
+        if(x > (int64_t)std::numeric_limits<IntType>::max())
+            return std::numeric_limits<IntType>::max();
+        if(x < (int64_t)std::numeric_limits<IntType>::min())
+            return std::numeric_limits<IntType>::min();
+        return (IntType)x;
+    }
+
+    /** Converts a floating-point value to fixed-point. */
+    template <typename T>
+    RTNEURAL_REALTIME static IntType fromFloat(T x) noexcept
+    {
+        return convert<IntType>(x);
+    }
+
+    /**
+     * Converts a floating-point value to a 32-bit value with the same
+     * scaling, e.g. for layer inputs that may be out of range for `IntType`.
+     */
+    template <typename T>
+    RTNEURAL_REALTIME static int32_t fromFloatWide(T x) noexcept
+    {
+        return convert<int32_t>(x);
+    }
+
+    /** Converts a fixed-point value to floating-point. */
+    template <typename T>
+    RTNEURAL_REALTIME static T toFloat(IntType x) noexcept
+    {
+        return (T)x * ((T)1 / (T)((int64_t)1 << FracBits));
+    }
+
+    /** Returns the value 1, or the largest value below 1 for pure fractional formats. */
+    RTNEURAL_REALTIME static IntType one() noexcept { return saturate((int64_t)1 << FracBits); }
+
+    /** Saturating addition. */
+    RTNEURAL_REALTIME static IntType add(IntType a, IntType b) noexcept { return saturate((int64_t)a + (int64_t)b); }
+
+    /** Saturating multiplication. */
+    RTNEURAL_REALTIME static IntType mul(IntType a, IntType b) noexcept
+    {
+        return saturate(fixed_point_detail::roundingShift((int64_t)a * (int64_t)b, FracBits));
+    }
+
+    /**
+     * Returns the product of two values in the accumulator format, which
+     * has `2 * FracBits - accum_shift` fractional bits. For 32-bit types
+     * the products are shifted down, so that sums of products can't overflow.
+     */
+    RTNEURAL_REALTIME static int64_t mulAccum(int32_t a, int32_t b) noexcept
+    {
+        return ((int64_t)a * (int64_t)b) >> accum_shift;
+    }
+
+    /** Returns the dot product of two vectors, in the accumulator format. */
+    template <typename OtherType>
+    RTNEURAL_REALTIME static int64_t dot(const IntType* a, const OtherType* b, int count) noexcept
+    {
+        int64_t acc = 0;
+        for(int k = 0; k < count; ++k)
+            acc += mulAccum(a[k], b[k]);
+        return acc;
+    }
+
+    /** Converts a value to the accumulator format. */
+    RTNEURAL_REALTIME static int64_t toAccum(IntType x) noexcept { return (int64_t)x * ((int64_t)1 << (FracBits - accum_shift)); }
+
+    /** Converts an accumulator back to fixed-point, with rounding and saturation. */
+    RTNEURAL_REALTIME static IntType fromAccum(int64_t acc) noexcept
+    {
+        return saturate(fixed_point_detail::roundingShift(acc, FracBits - accum_shift));
+    }
+
+    /** Fixed-point tanh approximation. */
+    RTNEURAL_REALTIME static IntType tanh(IntType x) noexcept
+    {
+        return fromQ31(fixed_point_detail::tanhQ31((int64_t)x, FracBits));
+    }
+
+    /** Fixed-point sigmoid approximation, using sigmoid(x) = (1 + tanh(x / 2)) / 2. */
+    RTNEURAL_REALTIME static IntType sigmoid(IntType x) noexcept
+    {
+        const auto t = fixed_point_detail::tanhQ31((int64_t)x, FracBits + 1);
+        return fromQ31((t + ((int64_t)1 << 31)) / 2);
+    }
+
+private:
+    template <typename OutType, typename T>
+    static OutType convert(T x) noexcept
+    {
+        const auto scaled = (double)x * (double)((int64_t)1 << FracBits);
+        if(!(scaled < (double)std::numeric_limits<OutType>::max()))
+            return std::numeric_limits<OutType>::max();
+        if(!(scaled > (double)std::numeric_limits<OutType>::min()))
+            return std::numeric_limits<OutType>::min();
+        return (OutType)std::floor(scaled + 0.5);
+    }
+
+    static IntType fromQ31(int64_t x) noexcept
+    {
+        return saturate(fixed_point_detail::roundingShift(x, 31 - FracBits));
+    }
+};
+
+/** 16-bit fixed-point, with 3 integer bits (Q3.12), so that weights and pre-activations up to +/-8 can be represented. */
+using FixedPoint16 = FixedPointProvider<int16_t, 12>;
+
+/** 32-bit fixed-point, with 7 integer bits (Q7.24). */
+using FixedPoint32 = FixedPointProvider<int32_t, 24>;
+
+/** 16-bit fixed-point in [-1, 1) (Q15). Larger weights or states will saturate. */
+using FixedPointQ15 = FixedPointProvider<int16_t, 15>;
+
+/** 32-bit fixed-point in [-1, 1) (Q31). Larger weights or states will saturate. */
+using FixedPointQ31 = FixedPointProvider<int32_t, 31>;
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // FIXED_POINT_H_INCLUDED
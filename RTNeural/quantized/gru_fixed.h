@@ -0,0 +1,262 @@
+#ifndef GRU_FIXED_H_INCLUDED
+#define GRU_FIXED_H_INCLUDED
+
+#include <algorithm>
+#include <vector>
+
+#include "../Layer.h"
+#include "../common.h"
+#include "../config.h"
+#include "fixed_point.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * Static implementation of a gated recurrent unit (GRU) layer,
+ * with tanh activation and sigmoid recurrent activation, computed
+ * in fixed-point arithmetic.
+ *
+ * The weights are converted from floating-point when they are set,
+ * and the input is converted as it enters the layer, so the layer can
+ * be used in place of a `GRULayerT`. The fixed-point format is chosen
+ * with the `FixedPoint` template argument (see `FixedPointProvider`).
+ * The input is kept at 32 bits, so that inputs outside the range of a
+ * 16-bit format don't saturate.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, int in_sizet, int out_sizet, typename FixedPoint = FixedPoint16>
+class GRULayerFixedT
+{
+    using fixed_type = typename FixedPoint::value_type;
+
+#if RTNEURAL_USE_EIGEN
+    using in_type = Eigen::Matrix<T, in_sizet, 1>;
+    using out_type = Eigen::Matrix<T, out_sizet, 1>;
+#elif RTNEURAL_USE_XSIMD
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_in_size = ceil_div(in_sizet, v_size);
+    static constexpr auto v_out_size = ceil_div(out_sizet, v_size);
+#endif
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    GRULayerFixedT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            std::fill(std::begin(Wz[i]), std::end(Wz[i]), (fixed_type)0);
+            std::fill(std::begin(Wr[i]), std::end(Wr[i]), (fixed_type)0);
+            std::fill(std::begin(Wh[i]), std::end(Wh[i]), (fixed_type)0);
+            std::fill(std::begin(Uz[i]), std::end(Uz[i]), (fixed_type)0);
+            std::fill(std::begin(Ur[i]), std::end(Ur[i]), (fixed_type)0);
+            std::fill(std::begin(Uh[i]), std::end(Uh[i]), (fixed_type)0);
+        }
+
+        std::fill(std::begin(bz), std::end(bz), (fixed_type)0);
+        std::fill(std::begin(br), std::end(br), (fixed_type)0);
+        std::fill(std::begin(bh0), std::end(bh0), (fixed_type)0);
+        std::fill(std::begin(bh1), std::end(bh1), (fixed_type)0);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "gru"; }
+
+    /** Returns false since GRU is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the GRU. */
+    RTNEURAL_REALTIME void reset()
+    {
+        std::fill(std::begin(ht1), std::end(ht1), (fixed_type)0);
+#if RTNEURAL_USE_EIGEN
+        outs = out_type::Zero();
+#elif RTNEURAL_USE_XSIMD
+        std::fill(std::begin(outs), std::end(outs), v_type((T)0));
+#else
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+#endif
+    }
+
+    /** Returns the number of values in the GRU state. */
+    static constexpr size_t getStateSize() noexcept { return (size_t)out_size; }
+
+    /** Copies the GRU state into `state`, which must hold `getStateSize()` values. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+            state[i] = FixedPoint::template toFloat<T>(ht1[i]);
+    }
+
+    /** Restores the GRU state from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+            ht1[i] = FixedPoint::fromFloat(state[i]);
+        writeOutputs(outsData());
+    }
+
+    /** Performs forward propagation for this layer. */
+#if RTNEURAL_USE_EIGEN
+    RTNEURAL_REALTIME inline void forward(const in_type& ins) noexcept
+    {
+        forwardInternal(ins.data(), outs.data());
+    }
+#elif RTNEURAL_USE_XSIMD
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        forwardInternal(reinterpret_cast<const T*>(ins), reinterpret_cast<T*>(outs));
+    }
+#else
+    RTNEURAL_REALTIME inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        forwardInternal(ins, outs);
+    }
+#endif
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int i = 0; i < in_size; ++i)
+        {
+            for(int j = 0; j < out_size; ++j)
+            {
+                Wz[j][i] = FixedPoint::fromFloat(wVals[i][j]);
+                Wr[j][i] = FixedPoint::fromFloat(wVals[i][j + out_size]);
+                Wh[j][i] = FixedPoint::fromFloat(wVals[i][j + 2 * out_size]);
+            }
+        }
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            for(int j = 0; j < out_size; ++j)
+            {
+                Uz[j][i] = FixedPoint::fromFloat(uVals[i][j]);
+                Ur[j][i] = FixedPoint::fromFloat(uVals[i][j + out_size]);
+                Uh[j][i] = FixedPoint::fromFloat(uVals[i][j + 2 * out_size]);
+            }
+        }
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[2][3 * out_size]
+     */
+    void setBVals(const std::vector<std::vector<T>>& bVals)
+    {
+        for(int k = 0; k < out_size; ++k)
+        {
+            bz[k] = FixedPoint::fromFloat(bVals[0][k] + bVals[1][k]);
+            br[k] = FixedPoint::fromFloat(bVals[0][k + out_size] + bVals[1][k + out_size]);
+            bh0[k] = FixedPoint::fromFloat(bVals[0][k + 2 * out_size]);
+            bh1[k] = FixedPoint::fromFloat(bVals[1][k + 2 * out_size]);
+        }
+    }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<out_type, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD
+    v_type outs[v_out_size];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    RTNEURAL_REALTIME inline void forwardInternal(const T* ins, T* out) noexcept
+    {
+        for(int i = 0; i < in_size; ++i)
+            xt[i] = FixedPoint::fromFloatWide(ins[i]);
+
+        for(int i = 0; i < out_size; ++i)
+        {
+            // compute zt and rt
+            zt[i] = FixedPoint::sigmoid(FixedPoint::fromAccum(FixedPoint::dot(Wz[i], xt, in_size)
+                + FixedPoint::dot(Uz[i], ht1, out_size) + FixedPoint::toAccum(bz[i])));
+            rt[i] = FixedPoint::sigmoid(FixedPoint::fromAccum(FixedPoint::dot(Wr[i], xt, in_size)
+                + FixedPoint::dot(Ur[i], ht1, out_size) + FixedPoint::toAccum(br[i])));
+
+            // compute h_hat
+            const auto ct = FixedPoint::fromAccum(FixedPoint::dot(Uh[i], ht1, out_size) + FixedPoint::toAccum(bh1[i]));
+            ht[i] = FixedPoint::tanh(FixedPoint::fromAccum(FixedPoint::mulAccum(rt[i], ct)
+                + FixedPoint::dot(Wh[i], xt, in_size) + FixedPoint::toAccum(bh0[i])));
+        }
+
+        // h = (1 - z) * h_hat + z * h
+        const auto one = FixedPoint::one();
+        for(int i = 0; i < out_size; ++i)
+            ht1[i] = FixedPoint::fromAccum(FixedPoint::mulAccum((fixed_type)(one - zt[i]), ht[i]) + FixedPoint::mulAccum(zt[i], ht1[i]));
+
+        writeOutputs(out);
+    }
+
+    RTNEURAL_REALTIME inline void writeOutputs(T* out) noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+            out[i] = FixedPoint::template toFloat<T>(ht1[i]);
+    }
+
+    T* outsData() noexcept
+    {
+#if RTNEURAL_USE_EIGEN
+        return outs.data();
+#elif RTNEURAL_USE_XSIMD
+        return reinterpret_cast<T*>(outs);
+#else
+        return outs;
+#endif
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    // kernel weights
+    fixed_type Wz[out_size][in_size];
+    fixed_type Wr[out_size][in_size];
+    fixed_type Wh[out_size][in_size];
+
+    // recurrent weights
+    fixed_type Uz[out_size][out_size];
+    fixed_type Ur[out_size][out_size];
+    fixed_type Uh[out_size][out_size];
+
+    // biases
+    fixed_type bz[out_size];
+    fixed_type br[out_size];
+    fixed_type bh0[out_size];
+    fixed_type bh1[out_size];
+
+    // intermediate vars
+    int32_t xt[in_size];
+    fixed_type zt[out_size];
+    fixed_type rt[out_size];
+    fixed_type ht[out_size];
+    fixed_type ht1[out_size];
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // GRU_FIXED_H_INCLUDED
@@ -0,0 +1,229 @@
+#ifndef HALF_KERNELS_H_INCLUDED
+#define HALF_KERNELS_H_INCLUDED
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "../config.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/** Storage type for bfloat16 weights (the upper 16 bits of an IEEE single-precision float). */
+struct bfloat16
+{
+    uint16_t bits;
+};
+
+/** Storage type for IEEE 754 half-precision weights. */
+struct float16
+{
+    uint16_t bits;
+};
+
+/**
+ * Kernels for the layers with 16-bit weights.
+ *
+ * The weights are only stored as 16-bit values: they are converted to
+ * float (or double) as they are loaded, and all of the arithmetic is
+ * done in the layer's data type.
+ */
+namespace half_detail
+{
+    inline uint32_t floatToBits(float x) noexcept
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(float));
+        return bits;
+    }
+
+    inline float bitsToFloat(uint32_t bits) noexcept
+    {
+        float x;
+        std::memcpy(&x, &bits, sizeof(float));
+        return x;
+    }
+
+    /** Converts a value to 16-bit storage, rounding to nearest-even. */
+    template <typename WeightType>
+    WeightType fromFloat(float x) noexcept;
+
+    template <>
+    inline bfloat16 fromFloat<bfloat16>(float x) noexcept
+    {
+        const auto bits = floatToBits(x);
+        if((bits & 0x7fffffffu) > 0x7f800000u) // keep NaNs quiet
+            return { (uint16_t)((bits >> 16) | 0x40u) };
+
+        return { (uint16_t)((bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16) };
+    }
+
+    template <>
+    inline float16 fromFloat<float16>(float x) noexcept
+    {
+        const auto bits = floatToBits(x);
+        const auto sign = (uint16_t)((bits >> 16) & 0x8000u);
+        const auto absBits = bits & 0x7fffffffu;
+
+        if(absBits >= 0x7f800000u) // infinity or NaN
+            return { (uint16_t)(sign | 0x7c00u | (absBits > 0x7f800000u ? 0x200u : 0u)) };
+
+        if(absBits >= 0x477ff000u) // rounds past the largest half value
+            return { (uint16_t)(sign | 0x7c00u) };
+
+        if(absBits >= 0x38800000u) // normal half value: re-bias the exponent, and round the mantissa
+        {
+            auto rebiased = absBits - (112u << 23);
+            rebiased += 0xfffu + ((rebiased >> 13) & 1u);
+            return { (uint16_t)(sign | (rebiased >> 13)) };
+        }
+
+        if(absBits <= 0x33000000u) // rounds to zero
+            return { sign };
+
+        // sub-normal half value
+        const auto shift = 126u - (absBits >> 23);
+        const auto mantissa = (absBits & 0x7fffffu) | 0x800000u;
+        auto result = mantissa >> shift;
+        const auto remainder = mantissa & ((1u << shift) - 1u);
+        const auto halfway = 1u << (shift - 1u);
+        if(remainder > halfway || (remainder == halfway && (result & 1u)))
+            ++result;
+
+        return { (uint16_t)(sign | result) };
+    }
+
+    /** Converts a 16-bit weight to float. */
+    inline float toFloat(bfloat16 x) noexcept
+    {
+        return bitsToFloat((uint32_t)x.bits << 16);
+    }
+
+    /** Converts a 16-bit weight to float. */
+    inline float toFloat(float16 x) noexcept
+    {
+        const auto sign = (uint32_t)(x.bits & 0x8000u) << 16;
+        auto exponent = (uint32_t)(x.bits >> 10) & 0x1fu;
+        auto mantissa = (uint32_t)x.bits & 0x3ffu;
+
+        if(exponent == 0x1fu) // infinity or NaN
+            return bitsToFloat(sign | 0x7f800000u | (mantissa << 13));
+
+        if(exponent != 0)
+            return bitsToFloat(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+
+        if(mantissa == 0)
+            return bitsToFloat(sign);
+
+        // sub-normal half value
+        exponent = 113u;
+        while((mantissa & 0x400u) == 0)
+        {
+            mantissa <<= 1;
+            --exponent;
+        }
+
+        return bitsToFloat(sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13));
+    }
+
+#if defined(__AVX2__) && defined(__FMA__)
+    inline float horizontalSum(__m256 x) noexcept
+    {
+        auto sum = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+        return _mm_cvtss_f32(sum);
+    }
+
+    inline __m256 load8(const bfloat16* w) noexcept
+    {
+        const auto bits = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w)));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(bits, 16));
+    }
+
+#if defined(__F16C__)
+    inline __m256 load8(const float16* w) noexcept
+    {
+        return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w)));
+    }
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    inline float32x4_t load4(const bfloat16* w) noexcept
+    {
+        return vreinterpretq_f32_u32(vshll_n_u16(vld1_u16(reinterpret_cast<const uint16_t*>(w)), 16));
+    }
+
+    inline float32x4_t load4(const float16* w) noexcept
+    {
+        return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(reinterpret_cast<const uint16_t*>(w))));
+    }
+#endif
+
+    /** Returns the dot product of a vector of 16-bit weights with a vector of values. */
+    template <typename T, typename WeightType>
+    RTNEURAL_REALTIME inline T dot(const WeightType* w, const T* x, int count) noexcept
+    {
+        T sum = (T)0;
+        for(int k = 0; k < count; ++k)
+            sum += (T)toFloat(w[k]) * x[k];
+        return sum;
+    }
+
+    /**
+     * Returns the dot product of a vector of 16-bit weights with a vector of floats.
+     *
+     * With AVX2 (and F16C for IEEE half), or with NEON on ARM64, the weights are
+     * converted eight (or four) at a time in registers. Otherwise the weights are
+     * converted one at a time.
+     */
+    template <typename WeightType>
+    RTNEURAL_REALTIME inline float dot(const WeightType* w, const float* x, int count) noexcept
+    {
+        float sum = 0.0f;
+        int k = 0;
+
+#if defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+        auto acc = _mm256_setzero_ps();
+        for(; k + 8 <= count; k += 8)
+            acc = _mm256_fmadd_ps(load8(w + k), _mm256_loadu_ps(x + k), acc);
+        sum = horizontalSum(acc);
+#elif defined(__AVX2__) && defined(__FMA__)
+        if(std::is_same<WeightType, bfloat16>::value)
+        {
+            auto acc = _mm256_setzero_ps();
+            for(; k + 8 <= count; k += 8)
+                acc = _mm256_fmadd_ps(load8(reinterpret_cast<const bfloat16*>(w + k)), _mm256_loadu_ps(x + k), acc);
+            sum = horizontalSum(acc);
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        auto acc = vdupq_n_f32(0.0f);
+        for(; k + 4 <= count; k += 4)
+            acc = vfmaq_f32(acc, load4(w + k), vld1q_f32(x + k));
+        sum = vaddvq_f32(acc);
+#endif
+
+        for(; k < count; ++k)
+            sum += toFloat(w[k]) * x[k];
+
+        return sum;
+    }
+
+    /** Computes out = mat * x, for a row-major matrix of 16-bit weights. */
+    template <typename T, typename WeightType>
+    RTNEURAL_REALTIME inline void matVec(const WeightType* mat, const T* x, T* out, int rows, int cols) noexcept
+    {
+        for(int i = 0; i < rows; ++i)
+            out[i] = dot(mat + i * cols, x, cols);
+    }
+} // namespace half_detail
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // HALF_KERNELS_H_INCLUDED
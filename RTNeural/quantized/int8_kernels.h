@@ -0,0 +1,143 @@
+#ifndef INT8_KERNELS_H_INCLUDED
+#define INT8_KERNELS_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "../config.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * Kernels for the int8 quantized layers.
+ *
+ * Values are quantized symmetrically to the range [-127, 127], with a single
+ * scale per row (or frame), so that `value ~= scale * quantized`. The range
+ * is kept symmetric so that the dot products below can use the sign trick
+ * for unsigned-by-signed multiply-add instructions without saturating.
+ */
+namespace int8_detail
+{
+    /**
+     * Quantizes `count` values into `quantized`, and returns the scale
+     * for the quantized values. The scale is zero if all of the values are.
+     */
+    template <typename T>
+    RTNEURAL_REALTIME T quantize(const T* values, int count, int8_t* quantized) noexcept
+    {
+        T maxAbs = (T)0;
+        for(int i = 0; i < count; ++i)
+            maxAbs = std::max(maxAbs, std::abs(values[i]));
+
+        if(maxAbs == (T)0)
+        {
+            std::fill(quantized, quantized + count, (int8_t)0);
+            return (T)0;
+        }
+
+        const auto invScale = (T)127 / maxAbs;
+        for(int i = 0; i < count; ++i)
+        {
+            const auto q = values[i] * invScale;
+            quantized[i] = (int8_t)std::min(std::max((int)(q + (q < (T)0 ? (T)-0.5 : (T)0.5)), -127), 127);
+        }
+
+        return maxAbs / (T)127;
+    }
+
+    /**
+     * Quantizes `count` values into `quantized`, using a fixed scale (e.g. from
+     * calibration) if it is non-zero, or the scale of the values otherwise.
+     * Values outside of the fixed range saturate. Returns the scale.
+     */
+    template <typename T>
+    RTNEURAL_REALTIME T quantizeInput(const T* values, int count, T fixedScale, int8_t* quantized) noexcept
+    {
+        if(fixedScale == (T)0)
+            return quantize(values, count, quantized);
+
+        const auto invScale = (T)1 / fixedScale;
+        for(int i = 0; i < count; ++i)
+        {
+            const auto q = values[i] * invScale;
+            quantized[i] = (int8_t)std::min(std::max((int)(q + (q < (T)0 ? (T)-0.5 : (T)0.5)), -127), 127);
+        }
+
+        return fixedScale;
+    }
+
+    /**
+     * Returns the dot product of two int8 vectors, accumulated in int32.
+     * All of the values must be in the range [-127, 127].
+     *
+     * On x86 this uses AVX-512 VNNI or AVX-VNNI (dpbusd), or AVX2 (maddubs),
+     * depending on the instruction sets enabled at compile-time. On ARM it
+     * uses the NEON dot product instructions where available. Otherwise
+     * it falls back to a plain loop, which most compilers will vectorize.
+     */
+    RTNEURAL_REALTIME inline int32_t dot(const int8_t* a, const int8_t* b, int count) noexcept
+    {
+        int32_t sum = 0;
+        int k = 0;
+
+#if defined(__AVX2__)
+        auto acc = _mm256_setzero_si256();
+#if !((defined(__AVX512VNNI__) && defined(__AVX512VL__)) || defined(__AVXVNNI__))
+        const auto ones = _mm256_set1_epi16(1);
+#endif
+        for(; k + 32 <= count; k += 32)
+        {
+            const auto va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k));
+            const auto vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k));
+
+            // |a| * (b * sign(a)) == a * b, with the first operand unsigned
+            const auto absA = _mm256_sign_epi8(va, va);
+            const auto signedB = _mm256_sign_epi8(vb, va);
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+            acc = _mm256_dpbusd_epi32(acc, absA, signedB);
+#elif defined(__AVXVNNI__)
+            acc = _mm256_dpbusd_avx_epi32(acc, absA, signedB);
+#else
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_maddubs_epi16(absA, signedB), ones));
+#endif
+        }
+
+        auto acc128 = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        acc128 = _mm_add_epi32(acc128, _mm_shuffle_epi32(acc128, _MM_SHUFFLE(1, 0, 3, 2)));
+        acc128 = _mm_add_epi32(acc128, _mm_shuffle_epi32(acc128, _MM_SHUFFLE(2, 3, 0, 1)));
+        sum = _mm_cvtsi128_si32(acc128);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        auto acc = vdupq_n_s32(0);
+        for(; k + 16 <= count; k += 16)
+        {
+            const auto va = vld1q_s8(a + k);
+            const auto vb = vld1q_s8(b + k);
+#if defined(__ARM_FEATURE_DOTPROD)
+            acc = vdotq_s32(acc, va, vb);
+#else
+            auto prod = vmull_s8(vget_low_s8(va), vget_low_s8(vb));
+            prod = vmlal_s8(prod, vget_high_s8(va), vget_high_s8(vb));
+            acc = vpadalq_s16(acc, prod);
+#endif
+        }
+        sum = vaddvq_s32(acc);
+#endif
+
+        for(; k < count; ++k)
+            sum += (int32_t)a[k] * (int32_t)b[k];
+
+        return sum;
+    }
+} // namespace int8_detail
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // INT8_KERNELS_H_INCLUDED
@@ -0,0 +1,279 @@
+#ifndef LSTM_FIXED_H_INCLUDED
+#define LSTM_FIXED_H_INCLUDED
+
+#include <algorithm>
+#include <vector>
+
+#include "../Layer.h"
+#include "../common.h"
+#include "../config.h"
+#include "fixed_point.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * Static implementation of a LSTM layer with tanh activation
+ * and sigmoid recurrent activation, computed in fixed-point arithmetic.
+ *
+ * The weights are converted from floating-point when they are set,
+ * and the input is converted as it enters the layer, so the layer can
+ * be used in place of a `LSTMLayerT`. The fixed-point format is chosen
+ * with the `FixedPoint` template argument (see `FixedPointProvider`).
+ * The input is kept at 32 bits, so that inputs outside the range of a
+ * 16-bit format don't saturate.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, int in_sizet, int out_sizet, typename FixedPoint = FixedPoint16>
+class LSTMLayerFixedT
+{
+    using fixed_type = typename FixedPoint::value_type;
+
+#if RTNEURAL_USE_EIGEN
+    using in_type = Eigen::Matrix<T, in_sizet, 1>;
+    using out_type = Eigen::Matrix<T, out_sizet, 1>;
+#elif RTNEURAL_USE_XSIMD
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_in_size = ceil_div(in_sizet, v_size);
+    static constexpr auto v_out_size = ceil_div(out_sizet, v_size);
+#endif
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    LSTMLayerFixedT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            std::fill(std::begin(Wf[i]), std::end(Wf[i]), (fixed_type)0);
+            std::fill(std::begin(Wi[i]), std::end(Wi[i]), (fixed_type)0);
+            std::fill(std::begin(Wo[i]), std::end(Wo[i]), (fixed_type)0);
+            std::fill(std::begin(Wc[i]), std::end(Wc[i]), (fixed_type)0);
+            std::fill(std::begin(Uf[i]), std::end(Uf[i]), (fixed_type)0);
+            std::fill(std::begin(Ui[i]), std::end(Ui[i]), (fixed_type)0);
+            std::fill(std::begin(Uo[i]), std::end(Uo[i]), (fixed_type)0);
+            std::fill(std::begin(Uc[i]), std::end(Uc[i]), (fixed_type)0);
+        }
+
+        std::fill(std::begin(bf), std::end(bf), (fixed_type)0);
+        std::fill(std::begin(bi), std::end(bi), (fixed_type)0);
+        std::fill(std::begin(bo), std::end(bo), (fixed_type)0);
+        std::fill(std::begin(bc), std::end(bc), (fixed_type)0);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "lstm"; }
+
+    /** Returns false since LSTM is not an activation. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the LSTM. */
+    RTNEURAL_REALTIME void reset()
+    {
+        std::fill(std::begin(ht1), std::end(ht1), (fixed_type)0);
+        std::fill(std::begin(ct1), std::end(ct1), (fixed_type)0);
+#if RTNEURAL_USE_EIGEN
+        outs = out_type::Zero();
+#elif RTNEURAL_USE_XSIMD
+        std::fill(std::begin(outs), std::end(outs), v_type((T)0));
+#else
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+#endif
+    }
+
+    /** Returns the number of values in the LSTM state. */
+    static constexpr size_t getStateSize() noexcept { return (size_t)(2 * out_size); }
+
+    /** Copies the LSTM state into `state`, which must hold `getStateSize()` values. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            state[i] = FixedPoint::template toFloat<T>(ht1[i]);
+            state[i + out_size] = FixedPoint::template toFloat<T>(ct1[i]);
+        }
+    }
+
+    /** Restores the LSTM state from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            ht1[i] = FixedPoint::fromFloat(state[i]);
+            ct1[i] = FixedPoint::fromFloat(state[i + out_size]);
+        }
+        writeOutputs(outsData());
+    }
+
+    /** Performs forward propagation for this layer. */
+#if RTNEURAL_USE_EIGEN
+    RTNEURAL_REALTIME inline void forward(const in_type& ins) noexcept
+    {
+        forwardInternal(ins.data(), outs.data());
+    }
+#elif RTNEURAL_USE_XSIMD
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        forwardInternal(reinterpret_cast<const T*>(ins), reinterpret_cast<T*>(outs));
+    }
+#else
+    RTNEURAL_REALTIME inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        forwardInternal(ins, outs);
+    }
+#endif
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int i = 0; i < in_size; ++i)
+        {
+            for(int j = 0; j < out_size; ++j)
+            {
+                Wi[j][i] = FixedPoint::fromFloat(wVals[i][j]);
+                Wf[j][i] = FixedPoint::fromFloat(wVals[i][j + out_size]);
+                Wc[j][i] = FixedPoint::fromFloat(wVals[i][j + 2 * out_size]);
+                Wo[j][i] = FixedPoint::fromFloat(wVals[i][j + 3 * out_size]);
+            }
+        }
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            for(int j = 0; j < out_size; ++j)
+            {
+                Ui[j][i] = FixedPoint::fromFloat(uVals[i][j]);
+                Uf[j][i] = FixedPoint::fromFloat(uVals[i][j + out_size]);
+                Uc[j][i] = FixedPoint::fromFloat(uVals[i][j + 2 * out_size]);
+                Uo[j][i] = FixedPoint::fromFloat(uVals[i][j + 3 * out_size]);
+            }
+        }
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[4 * out_size]
+     */
+    void setBVals(const std::vector<T>& bVals)
+    {
+        for(int k = 0; k < out_size; ++k)
+        {
+            bi[k] = FixedPoint::fromFloat(bVals[k]);
+            bf[k] = FixedPoint::fromFloat(bVals[k + out_size]);
+            bc[k] = FixedPoint::fromFloat(bVals[k + 2 * out_size]);
+            bo[k] = FixedPoint::fromFloat(bVals[k + 3 * out_size]);
+        }
+    }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<out_type, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD
+    v_type outs[v_out_size];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    RTNEURAL_REALTIME inline void forwardInternal(const T* ins, T* out) noexcept
+    {
+        for(int i = 0; i < in_size; ++i)
+            xt[i] = FixedPoint::fromFloatWide(ins[i]);
+
+        for(int i = 0; i < out_size; ++i)
+        {
+            // compute ft, it, and ot
+            ft[i] = FixedPoint::sigmoid(FixedPoint::fromAccum(FixedPoint::dot(Wf[i], xt, in_size)
+                + FixedPoint::dot(Uf[i], ht1, out_size) + FixedPoint::toAccum(bf[i])));
+            it[i] = FixedPoint::sigmoid(FixedPoint::fromAccum(FixedPoint::dot(Wi[i], xt, in_size)
+                + FixedPoint::dot(Ui[i], ht1, out_size) + FixedPoint::toAccum(bi[i])));
+            ot[i] = FixedPoint::sigmoid(FixedPoint::fromAccum(FixedPoint::dot(Wo[i], xt, in_size)
+                + FixedPoint::dot(Uo[i], ht1, out_size) + FixedPoint::toAccum(bo[i])));
+
+            // compute the candidate cell state
+            ctHat[i] = FixedPoint::tanh(FixedPoint::fromAccum(FixedPoint::dot(Wc[i], xt, in_size)
+                + FixedPoint::dot(Uc[i], ht1, out_size) + FixedPoint::toAccum(bc[i])));
+        }
+
+        // c = f * c + i * c_hat, h = o * tanh(c)
+        for(int i = 0; i < out_size; ++i)
+        {
+            ct1[i] = FixedPoint::fromAccum(FixedPoint::mulAccum(ft[i], ct1[i]) + FixedPoint::mulAccum(it[i], ctHat[i]));
+            ht1[i] = FixedPoint::mul(ot[i], FixedPoint::tanh(ct1[i]));
+        }
+
+        writeOutputs(out);
+    }
+
+    RTNEURAL_REALTIME inline void writeOutputs(T* out) noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+            out[i] = FixedPoint::template toFloat<T>(ht1[i]);
+    }
+
+    T* outsData() noexcept
+    {
+#if RTNEURAL_USE_EIGEN
+        return outs.data();
+#elif RTNEURAL_USE_XSIMD
+        return reinterpret_cast<T*>(outs);
+#else
+        return outs;
+#endif
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    // kernel weights
+    fixed_type Wf[out_size][in_size];
+    fixed_type Wi[out_size][in_size];
+    fixed_type Wo[out_size][in_size];
+    fixed_type Wc[out_size][in_size];
+
+    // recurrent weights
+    fixed_type Uf[out_size][out_size];
+    fixed_type Ui[out_size][out_size];
+    fixed_type Uo[out_size][out_size];
+    fixed_type Uc[out_size][out_size];
+
+    // biases
+    fixed_type bf[out_size];
+    fixed_type bi[out_size];
+    fixed_type bo[out_size];
+    fixed_type bc[out_size];
+
+    // intermediate vars
+    int32_t xt[in_size];
+    fixed_type ft[out_size];
+    fixed_type it[out_size];
+    fixed_type ot[out_size];
+    fixed_type ctHat[out_size];
+    fixed_type ct1[out_size];
+    fixed_type ht1[out_size];
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // LSTM_FIXED_H_INCLUDED
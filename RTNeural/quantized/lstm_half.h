@@ -0,0 +1,381 @@
+#ifndef LSTM_HALF_H_INCLUDED
+#define LSTM_HALF_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "../Layer.h"
+#include "../common.h"
+#include "../config.h"
+#include "../model_plan.h"
+#include "half_kernels.h"
+
+#if RTNEURAL_USE_EIGEN
+#include "../maths/maths_eigen.h"
+#elif RTNEURAL_USE_XSIMD
+#include "../maths/maths_xsimd.h"
+#else
+#include "../maths/maths_stl.h"
+#endif
+
+namespace RTNEURAL_NAMESPACE
+{
+
+#ifndef DOXYGEN
+namespace half_detail
+{
+    /**
+     * Computes one step of a LSTM layer with 16-bit weights.
+     *
+     * The kernel and recurrent weights are stored with one row per output,
+     * for the i, f, c, and o gates in turn, and the biases are stored in
+     * the same order. `scratch` must hold 8 * out_size values.
+     */
+    template <typename MathsProvider, typename T, typename WeightType>
+    RTNEURAL_REALTIME inline void lstmStep(const WeightType* W, const WeightType* U, const T* bias,
+        const T* x, T* h, T* c, T* scratch, int in_size, int out_size) noexcept
+    {
+        auto* kernelOuts = scratch;
+        auto* recurrentOuts = scratch + 4 * out_size;
+        matVec(W, x, kernelOuts, 4 * out_size, in_size);
+        matVec(U, h, recurrentOuts, 4 * out_size, out_size);
+
+        for(int j = 0; j < 4 * out_size; ++j)
+            kernelOuts[j] += recurrentOuts[j] + bias[j];
+
+        auto* it = kernelOuts;
+        auto* ft = kernelOuts + out_size;
+        auto* ctHat = kernelOuts + 2 * out_size;
+        auto* ot = kernelOuts + 3 * out_size;
+        applySigmoid<MathsProvider>(it, 2 * out_size);
+        applyTanh<MathsProvider>(ctHat, out_size);
+        applySigmoid<MathsProvider>(ot, out_size);
+
+        // the recurrent outputs have been used, so they can hold tanh(c)
+        auto* cTanh = recurrentOuts;
+        for(int i = 0; i < out_size; ++i)
+        {
+            c[i] = ft[i] * c[i] + it[i] * ctHat[i];
+            cTanh[i] = c[i];
+        }
+        applyTanh<MathsProvider>(cTanh, out_size);
+
+        for(int i = 0; i < out_size; ++i)
+            h[i] = ot[i] * cTanh[i];
+    }
+
+    /** Converts LSTM weights with size weights[rows][4 * out_size] to one row per output. */
+    template <typename T, typename WeightType>
+    void setLSTMWeights(WeightType* dest, const std::vector<std::vector<T>>& vals, int rows, int out_size)
+    {
+        for(int i = 0; i < rows; ++i)
+            for(int j = 0; j < 4 * out_size; ++j)
+                dest[j * rows + i] = fromFloat<WeightType>((float)vals[i][j]);
+    }
+} // namespace half_detail
+#endif
+
+/**
+ * Dynamic implementation of a LSTM layer with tanh
+ * activation and sigmoid recurrent activation, and 16-bit weights.
+ *
+ * The weights are stored as `WeightType` (`bfloat16` or `float16`),
+ * and converted back to `T` as they are used. The recurrent and cell
+ * states are kept at full precision.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, typename WeightType = bfloat16, typename MathsProvider = DefaultMathsProvider>
+class LSTMLayerHalf final : public Layer<T>
+{
+public:
+    /** Constructs a LSTM layer for a given input and output size. */
+    LSTMLayerHalf(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , memory(getMemoryBytes(in_size, out_size))
+    {
+        bindMemory();
+        reset();
+    }
+
+    LSTMLayerHalf(std::initializer_list<int> sizes)
+        : LSTMLayerHalf(*sizes.begin(), *(sizes.begin() + 1))
+    {
+    }
+
+    LSTMLayerHalf(const LSTMLayerHalf& other)
+        : LSTMLayerHalf(other.in_size, other.out_size)
+    {
+    }
+
+    LSTMLayerHalf& operator=(const LSTMLayerHalf& other)
+    {
+        return *this = LSTMLayerHalf(other);
+    }
+
+    virtual ~LSTMLayerHalf() = default;
+
+    /** Resets the state of the LSTM. */
+    RTNEURAL_REALTIME void reset() override
+    {
+        std::fill(ht1, ht1 + Layer<T>::out_size, (T)0);
+        std::fill(ct1, ct1 + Layer<T>::out_size, (T)0);
+    }
+
+    /** Returns the number of values in the LSTM state. */
+    size_t getStateSize() const noexcept override { return (size_t)(2 * Layer<T>::out_size); }
+
+    /** Copies the LSTM state into `state`. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept override
+    {
+        std::copy(ht1, ht1 + Layer<T>::out_size, state);
+        std::copy(ct1, ct1 + Layer<T>::out_size, state + Layer<T>::out_size);
+    }
+
+    /** Restores the LSTM state from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept override
+    {
+        std::copy(state, state + Layer<T>::out_size, ht1);
+        std::copy(state + Layer<T>::out_size, state + 2 * Layer<T>::out_size, ct1);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "lstm"; }
+
+    size_t getNumMACs() const noexcept override { return (size_t)(4 * Layer<T>::out_size * (Layer<T>::in_size + Layer<T>::out_size)); }
+
+    /** Lets `Model::compile()` call this layer directly. */
+    bool resolvePlanOp(PlanOp<T>& op) override { return plan_detail::resolve<T, LSTMLayerHalf<T, WeightType, MathsProvider>>(op); }
+
+    /** Performs forward propagation for this layer. */
+    RTNEURAL_REALTIME inline void forward(const T* input, T* h) noexcept override
+    {
+        half_detail::lstmStep<MathsProvider>(kernelWeights, recurrentWeights, bias, input, ht1, ct1, scratch, Layer<T>::in_size, Layer<T>::out_size);
+        std::copy(ht1, ht1 + Layer<T>::out_size, h);
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        half_detail::setLSTMWeights(kernelWeights, wVals, Layer<T>::in_size, Layer<T>::out_size);
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        half_detail::setLSTMWeights(recurrentWeights, uVals, Layer<T>::out_size, Layer<T>::out_size);
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[4 * out_size]
+     */
+    void setBVals(const std::vector<T>& bVals)
+    {
+        std::copy(bVals.begin(), bVals.begin() + 4 * Layer<T>::out_size, bias);
+    }
+
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+    }
+
+private:
+    static size_t getMemoryBytes(int in_size, int out_size) noexcept
+    {
+        return MemoryArena::getBytes<WeightType>((size_t)(4 * out_size * in_size))
+            + MemoryArena::getBytes<WeightType>((size_t)(4 * out_size * out_size))
+            + MemoryArena::getBytes<T>((size_t)(4 * out_size))
+            + 2 * MemoryArena::getBytes<T>((size_t)out_size)
+            + MemoryArena::getBytes<T>((size_t)(8 * out_size));
+    }
+
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept
+    {
+        memory.rewind();
+        kernelWeights = memory.allocate<WeightType>((size_t)(4 * Layer<T>::out_size * Layer<T>::in_size));
+        recurrentWeights = memory.allocate<WeightType>((size_t)(4 * Layer<T>::out_size * Layer<T>::out_size));
+        bias = memory.allocate<T>((size_t)(4 * Layer<T>::out_size));
+        ht1 = memory.allocate<T>((size_t)Layer<T>::out_size);
+        ct1 = memory.allocate<T>((size_t)Layer<T>::out_size);
+        scratch = memory.allocate<T>((size_t)(8 * Layer<T>::out_size));
+    }
+
+    MemoryArena memory;
+    WeightType* kernelWeights = nullptr;
+    WeightType* recurrentWeights = nullptr;
+    T* bias = nullptr;
+    T* ht1 = nullptr;
+    T* ct1 = nullptr;
+    T* scratch = nullptr;
+};
+
+//====================================================
+/**
+ * Static implementation of a LSTM layer with tanh
+ * activation and sigmoid recurrent activation, and 16-bit weights. See `LSTMLayerHalf` for details.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, int in_sizet, int out_sizet, typename WeightType = bfloat16, typename MathsProvider = DefaultMathsProvider>
+class LSTMLayerHalfT
+{
+#if RTNEURAL_USE_EIGEN
+    using in_type = Eigen::Matrix<T, in_sizet, 1>;
+    using out_type = Eigen::Matrix<T, out_sizet, 1>;
+#elif RTNEURAL_USE_XSIMD
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_in_size = ceil_div(in_sizet, v_size);
+    static constexpr auto v_out_size = ceil_div(out_sizet, v_size);
+#endif
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    LSTMLayerHalfT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(kernelWeights), std::end(kernelWeights), WeightType {});
+        std::fill(std::begin(recurrentWeights), std::end(recurrentWeights), WeightType {});
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "lstm"; }
+
+    /** Returns false since LSTM is not an activation. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the LSTM. */
+    RTNEURAL_REALTIME void reset()
+    {
+        std::fill(std::begin(ht1), std::end(ht1), (T)0);
+        std::fill(std::begin(ct1), std::end(ct1), (T)0);
+#if RTNEURAL_USE_EIGEN
+        outs = out_type::Zero();
+#elif RTNEURAL_USE_XSIMD
+        std::fill(std::begin(outs), std::end(outs), v_type((T)0));
+#else
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+#endif
+    }
+
+    /** Returns the number of values in the LSTM state. */
+    static constexpr size_t getStateSize() noexcept { return (size_t)(2 * out_size); }
+
+    /** Copies the LSTM state into `state`, which must hold `getStateSize()` values. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept
+    {
+        std::copy(std::begin(ht1), std::end(ht1), state);
+        std::copy(std::begin(ct1), std::end(ct1), state + out_size);
+    }
+
+    /** Restores the LSTM state from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept
+    {
+        std::copy(state, state + out_size, std::begin(ht1));
+        std::copy(state + out_size, state + 2 * out_size, std::begin(ct1));
+    }
+
+    /** Performs forward propagation for this layer. */
+#if RTNEURAL_USE_EIGEN
+    RTNEURAL_REALTIME inline void forward(const in_type& ins) noexcept
+    {
+        forwardInternal(ins.data(), outs.data());
+    }
+#elif RTNEURAL_USE_XSIMD
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        forwardInternal(reinterpret_cast<const T*>(ins), reinterpret_cast<T*>(outs));
+    }
+#else
+    RTNEURAL_REALTIME inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        forwardInternal(ins, outs);
+    }
+#endif
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        half_detail::setLSTMWeights(kernelWeights, wVals, in_size, out_size);
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        half_detail::setLSTMWeights(recurrentWeights, uVals, out_size, out_size);
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[4 * out_size]
+     */
+    void setBVals(const std::vector<T>& bVals)
+    {
+        std::copy(bVals.begin(), bVals.begin() + 4 * out_size, std::begin(bias));
+    }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<out_type, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD
+    v_type outs[v_out_size];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    RTNEURAL_REALTIME inline void forwardInternal(const T* ins, T* out) noexcept
+    {
+        half_detail::lstmStep<MathsProvider>(kernelWeights, recurrentWeights, bias, ins, ht1, ct1, scratch, in_size, out_size);
+        std::copy(std::begin(ht1), std::end(ht1), out);
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    WeightType kernelWeights[4 * out_size * in_size];
+    WeightType recurrentWeights[4 * out_size * out_size];
+    T bias[4 * out_size];
+
+    T ht1[out_size];
+    T ct1[out_size];
+    T scratch[8 * out_size];
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // LSTM_HALF_H_INCLUDED
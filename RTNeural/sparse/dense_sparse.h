@@ -0,0 +1,247 @@
+#ifndef DENSE_SPARSE_H_INCLUDED
+#define DENSE_SPARSE_H_INCLUDED
+
+#include <algorithm>
+#include <vector>
+
+#include "../Layer.h"
+#include "../common.h"
+#include "../config.h"
+#include "../model_plan.h"
+#include "sparse_kernels.h"
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * Dynamic implementation of a fully-connected (dense) layer, with
+ * block-sparse weights, and no activation.
+ *
+ * Only the blocks of weights (`sparse_detail::blockRows` outputs by one
+ * input) with a non-zero weight are stored and computed, so pruned layers
+ * take less time (and memory) than a `Dense` layer. `json_parser::parseJson()` uses this layer
+ * for dense layers whose weights are sparse enough.
+ */
+template <typename T>
+class DenseSparse final : public Layer<T>
+{
+public:
+    /** Constructs a dense layer for a given input and output size. */
+    DenseSparse(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , weights(out_size, in_size)
+        , memory(MemoryArena::getBytes<T>((size_t)out_size))
+    {
+        bindMemory();
+        std::fill(bias, bias + out_size, (T)0);
+    }
+
+    DenseSparse(std::initializer_list<int> sizes)
+        : DenseSparse(*sizes.begin(), *(sizes.begin() + 1))
+    {
+    }
+
+    DenseSparse(const DenseSparse& other)
+        : DenseSparse(other.in_size, other.out_size)
+    {
+    }
+
+    DenseSparse& operator=(const DenseSparse& other)
+    {
+        return *this = DenseSparse(other);
+    }
+
+    virtual ~DenseSparse() = default;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "dense"; }
+
+    size_t getNumMACs() const noexcept override { return weights.getNumMACs(); }
+
+    /** Lets `Model::compile()` call this layer directly. */
+    bool resolvePlanOp(PlanOp<T>& op) override { return plan_detail::resolve<T, DenseSparse<T>>(op); }
+
+    /** Performs forward propagation for this layer. */
+    RTNEURAL_REALTIME inline void forward(const T* input, T* out) noexcept override
+    {
+        weights.matVec(input, out);
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            out[i] += bias[i];
+    }
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        weights.setWeights([&newWeights](int i, int k)
+            { return newWeights[(size_t)i][(size_t)k]; });
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + Layer<T>::out_size, bias);
+    }
+
+    /** Returns the weights value at the given indices. */
+    T getWeight(int i, int k) const noexcept { return weights.getWeight(i, k); }
+
+    /** Returns the bias value at the given index. */
+    RTNEURAL_REALTIME T getBias(int i) const noexcept { return bias[i]; }
+
+    /** Returns the fraction of the weight blocks which are all zeros. */
+    float getSparsity() const noexcept { return weights.getSparsity(); }
+
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity() + weights.getArenaBytes(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+        weights.moveToArena(arena);
+    }
+
+private:
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept
+    {
+        memory.rewind();
+        bias = memory.allocate<T>((size_t)Layer<T>::out_size);
+    }
+
+    BlockSparseMatrix<T> weights;
+    MemoryArena memory;
+    T* bias = nullptr;
+};
+
+//====================================================
+/**
+ * Static implementation of a fully-connected (dense) layer, with
+ * block-sparse weights, and no activation. See `DenseSparse` for details.
+ *
+ * The layer has room for all of the weights, but only the non-zero
+ * blocks of weights are computed.
+ */
+template <typename T, int in_sizet, int out_sizet>
+class DenseSparseT
+{
+#if RTNEURAL_USE_EIGEN
+    using in_type = Eigen::Matrix<T, in_sizet, 1>;
+    using out_type = Eigen::Matrix<T, out_sizet, 1>;
+#elif RTNEURAL_USE_XSIMD
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_in_size = ceil_div(in_sizet, v_size);
+    static constexpr auto v_out_size = ceil_div(out_sizet, v_size);
+#endif
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    DenseSparseT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+#if RTNEURAL_USE_EIGEN
+        outs = out_type::Zero();
+#elif RTNEURAL_USE_XSIMD
+        std::fill(std::begin(outs), std::end(outs), v_type((T)0));
+#else
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+#endif
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "dense"; }
+
+    /** Returns false since dense is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Reset is a no-op, since Dense does not have state. */
+    RTNEURAL_REALTIME void reset() { }
+
+    /** Performs forward propagation for this layer. */
+#if RTNEURAL_USE_EIGEN
+    RTNEURAL_REALTIME inline void forward(const in_type& ins) noexcept
+    {
+        forwardInternal(ins.data(), outs.data());
+    }
+#elif RTNEURAL_USE_XSIMD
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        forwardInternal(reinterpret_cast<const T*>(ins), reinterpret_cast<T*>(outs));
+    }
+#else
+    RTNEURAL_REALTIME inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        forwardInternal(ins, outs);
+    }
+#endif
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        weights.setWeights([&newWeights](int i, int k)
+            { return newWeights[(size_t)i][(size_t)k]; });
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + out_size, std::begin(bias));
+    }
+
+    /** Returns the weights value at the given indices. */
+    T getWeight(int i, int k) const noexcept { return weights.getWeight(i, k); }
+
+    /** Returns the bias value at the given index. */
+    RTNEURAL_REALTIME T getBias(int i) const noexcept { return bias[i]; }
+
+    /** Returns the fraction of the weight blocks which are all zeros. */
+    float getSparsity() const noexcept { return weights.getSparsity(); }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<out_type, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD
+    v_type outs[v_out_size];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    RTNEURAL_REALTIME inline void forwardInternal(const T* ins, T* out) noexcept
+    {
+        weights.matVec(ins, out);
+        for(int i = 0; i < out_size; ++i)
+            out[i] += bias[i];
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    BlockSparseMatrixT<T, out_size, in_size> weights;
+    T bias[out_size];
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // DENSE_SPARSE_H_INCLUDED
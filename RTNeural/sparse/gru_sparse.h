@@ -0,0 +1,367 @@
+#ifndef GRU_SPARSE_H_INCLUDED
+#define GRU_SPARSE_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "../Layer.h"
+#include "../common.h"
+#include "../config.h"
+#include "../model_plan.h"
+#include "sparse_kernels.h"
+
+#if RTNEURAL_USE_EIGEN
+#include "../maths/maths_eigen.h"
+#elif RTNEURAL_USE_XSIMD
+#include "../maths/maths_xsimd.h"
+#else
+#include "../maths/maths_stl.h"
+#endif
+
+namespace RTNEURAL_NAMESPACE
+{
+
+#ifndef DOXYGEN
+namespace sparse_detail
+{
+    /**
+     * Computes the GRU gates and updates the state `h`, from the kernel
+     * and recurrent outputs for the z, r, and h gates in turn. The biases
+     * are stored as bz, br, bh0, bh1. The kernel outputs are overwritten.
+     */
+    template <typename MathsProvider, typename T>
+    RTNEURAL_REALTIME inline void gruGates(T* kernelOuts, const T* recurrentOuts, const T* bias, T* h, int out_size) noexcept
+    {
+        // bz and br are stored next to each other, so both gates can be computed at once
+        auto* zt = kernelOuts;
+        auto* rt = kernelOuts + out_size;
+        for(int i = 0; i < 2 * out_size; ++i)
+            kernelOuts[i] += recurrentOuts[i] + bias[i];
+        applySigmoid<MathsProvider>(kernelOuts, 2 * out_size);
+
+        auto* ht = kernelOuts + 2 * out_size;
+        const auto* bh0 = bias + 2 * out_size;
+        const auto* bh1 = bias + 3 * out_size;
+        for(int i = 0; i < out_size; ++i)
+            ht[i] += rt[i] * (recurrentOuts[2 * out_size + i] + bh1[i]) + bh0[i];
+        applyTanh<MathsProvider>(ht, out_size);
+
+        for(int i = 0; i < out_size; ++i)
+            h[i] = ((T)1 - zt[i]) * ht[i] + zt[i] * h[i];
+    }
+
+    /** Converts GRU biases with size bias[2][3 * out_size] to bz, br, bh0, bh1. */
+    template <typename T>
+    void setGRUBias(T* dest, const std::vector<std::vector<T>>& vals, int out_size)
+    {
+        for(int k = 0; k < out_size; ++k)
+        {
+            dest[k] = vals[0][k] + vals[1][k];
+            dest[out_size + k] = vals[0][out_size + k] + vals[1][out_size + k];
+            dest[2 * out_size + k] = vals[0][2 * out_size + k];
+            dest[3 * out_size + k] = vals[1][2 * out_size + k];
+        }
+    }
+} // namespace sparse_detail
+#endif
+
+/**
+ * Dynamic implementation of a gated recurrent unit (GRU) layer
+ * with tanh activation and sigmoid recurrent activation, and
+ * block-sparse recurrent weights.
+ *
+ * Only the blocks of weights (`sparse_detail::blockRows` outputs by one
+ * input) with a non-zero weight are stored and computed. The kernel
+ * weights use the same layout, so they may be pruned as well, but
+ * `json_parser::parseJson()` chooses this layer for GRU layers whose
+ * recurrent weights are sparse enough.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, typename MathsProvider = DefaultMathsProvider>
+class GRULayerSparse final : public Layer<T>
+{
+public:
+    /** Constructs a GRU layer for a given input and output size. */
+    GRULayerSparse(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , kernelWeights(3 * out_size, in_size)
+        , recurrentWeights(3 * out_size, out_size)
+        , memory(getMemoryBytes(out_size))
+    {
+        bindMemory();
+        reset();
+    }
+
+    GRULayerSparse(std::initializer_list<int> sizes)
+        : GRULayerSparse(*sizes.begin(), *(sizes.begin() + 1))
+    {
+    }
+
+    GRULayerSparse(const GRULayerSparse& other)
+        : GRULayerSparse(other.in_size, other.out_size)
+    {
+    }
+
+    GRULayerSparse& operator=(const GRULayerSparse& other)
+    {
+        return *this = GRULayerSparse(other);
+    }
+
+    virtual ~GRULayerSparse() = default;
+
+    /** Resets the state of the GRU. */
+    RTNEURAL_REALTIME void reset() override { std::fill(ht1, ht1 + Layer<T>::out_size, (T)0); }
+
+    /** Returns the number of values in the GRU state. */
+    size_t getStateSize() const noexcept override { return (size_t)Layer<T>::out_size; }
+
+    /** Copies the GRU state into `state`. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept override { std::copy(ht1, ht1 + Layer<T>::out_size, state); }
+
+    /** Restores the GRU state from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept override { std::copy(state, state + Layer<T>::out_size, ht1); }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "gru"; }
+
+    size_t getNumMACs() const noexcept override { return kernelWeights.getNumMACs() + recurrentWeights.getNumMACs(); }
+
+    /** Lets `Model::compile()` call this layer directly. */
+    bool resolvePlanOp(PlanOp<T>& op) override { return plan_detail::resolve<T, GRULayerSparse<T, MathsProvider>>(op); }
+
+    /** Performs forward propagation for this layer. */
+    RTNEURAL_REALTIME inline void forward(const T* input, T* h) noexcept override
+    {
+        auto* kernelOuts = scratch;
+        auto* recurrentOuts = scratch + 3 * Layer<T>::out_size;
+        kernelWeights.matVec(input, kernelOuts);
+        recurrentWeights.matVec(ht1, recurrentOuts);
+        sparse_detail::gruGates<MathsProvider>(kernelOuts, recurrentOuts, bias, ht1, Layer<T>::out_size);
+        std::copy(ht1, ht1 + Layer<T>::out_size, h);
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        kernelWeights.setWeights([&wVals](int j, int i)
+            { return wVals[(size_t)i][(size_t)j]; });
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        recurrentWeights.setWeights([&uVals](int j, int i)
+            { return uVals[(size_t)i][(size_t)j]; });
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[2][3 * out_size]
+     */
+    void setBVals(const std::vector<std::vector<T>>& bVals)
+    {
+        sparse_detail::setGRUBias(bias, bVals, Layer<T>::out_size);
+    }
+
+    /** Returns the fraction of the recurrent weight blocks which are all zeros. */
+    float getSparsity() const noexcept { return recurrentWeights.getSparsity(); }
+
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity() + kernelWeights.getArenaBytes() + recurrentWeights.getArenaBytes(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+        kernelWeights.moveToArena(arena);
+        recurrentWeights.moveToArena(arena);
+    }
+
+private:
+    static size_t getMemoryBytes(int out_size) noexcept
+    {
+        return MemoryArena::getBytes<T>((size_t)(4 * out_size))
+            + MemoryArena::getBytes<T>((size_t)out_size)
+            + MemoryArena::getBytes<T>((size_t)(6 * out_size));
+    }
+
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept
+    {
+        memory.rewind();
+        bias = memory.allocate<T>((size_t)(4 * Layer<T>::out_size));
+        ht1 = memory.allocate<T>((size_t)Layer<T>::out_size);
+        scratch = memory.allocate<T>((size_t)(6 * Layer<T>::out_size));
+    }
+
+    BlockSparseMatrix<T> kernelWeights;
+    BlockSparseMatrix<T> recurrentWeights;
+    MemoryArena memory;
+    T* bias = nullptr;
+    T* ht1 = nullptr;
+    T* scratch = nullptr;
+};
+
+//====================================================
+/**
+ * Static implementation of a gated recurrent unit (GRU) layer
+ * with tanh activation and sigmoid recurrent activation, and
+ * block-sparse recurrent weights. See `GRULayerSparse` for details.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, int in_sizet, int out_sizet, typename MathsProvider = DefaultMathsProvider>
+class GRULayerSparseT
+{
+#if RTNEURAL_USE_EIGEN
+    using in_type = Eigen::Matrix<T, in_sizet, 1>;
+    using out_type = Eigen::Matrix<T, out_sizet, 1>;
+#elif RTNEURAL_USE_XSIMD
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_in_size = ceil_div(in_sizet, v_size);
+    static constexpr auto v_out_size = ceil_div(out_sizet, v_size);
+#endif
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    GRULayerSparseT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "gru"; }
+
+    /** Returns false since GRU is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the GRU. */
+    RTNEURAL_REALTIME void reset()
+    {
+        std::fill(std::begin(ht1), std::end(ht1), (T)0);
+#if RTNEURAL_USE_EIGEN
+        outs = out_type::Zero();
+#elif RTNEURAL_USE_XSIMD
+        std::fill(std::begin(outs), std::end(outs), v_type((T)0));
+#else
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+#endif
+    }
+
+    /** Returns the number of values in the GRU state. */
+    static constexpr size_t getStateSize() noexcept { return (size_t)out_size; }
+
+    /** Copies the GRU state into `state`, which must hold `getStateSize()` values. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept { std::copy(std::begin(ht1), std::end(ht1), state); }
+
+    /** Restores the GRU state from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept { std::copy(state, state + out_size, std::begin(ht1)); }
+
+    /** Performs forward propagation for this layer. */
+#if RTNEURAL_USE_EIGEN
+    RTNEURAL_REALTIME inline void forward(const in_type& ins) noexcept
+    {
+        forwardInternal(ins.data(), outs.data());
+    }
+#elif RTNEURAL_USE_XSIMD
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        forwardInternal(reinterpret_cast<const T*>(ins), reinterpret_cast<T*>(outs));
+    }
+#else
+    RTNEURAL_REALTIME inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        forwardInternal(ins, outs);
+    }
+#endif
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        kernelWeights.setWeights([&wVals](int j, int i)
+            { return wVals[(size_t)i][(size_t)j]; });
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        recurrentWeights.setWeights([&uVals](int j, int i)
+            { return uVals[(size_t)i][(size_t)j]; });
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[2][3 * out_size]
+     */
+    void setBVals(const std::vector<std::vector<T>>& bVals)
+    {
+        sparse_detail::setGRUBias(bias, bVals, out_size);
+    }
+
+    /** Returns the fraction of the recurrent weight blocks which are all zeros. */
+    float getSparsity() const noexcept { return recurrentWeights.getSparsity(); }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<out_type, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD
+    v_type outs[v_out_size];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    RTNEURAL_REALTIME inline void forwardInternal(const T* ins, T* out) noexcept
+    {
+        auto* kernelOuts = scratch;
+        auto* recurrentOuts = scratch + 3 * out_size;
+        kernelWeights.matVec(ins, kernelOuts);
+        recurrentWeights.matVec(ht1, recurrentOuts);
+        sparse_detail::gruGates<MathsProvider>(kernelOuts, recurrentOuts, bias, ht1, out_size);
+        std::copy(std::begin(ht1), std::end(ht1), out);
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    BlockSparseMatrixT<T, 3 * out_size, in_size> kernelWeights;
+    BlockSparseMatrixT<T, 3 * out_size, out_size> recurrentWeights;
+    T bias[4 * out_size];
+
+    T ht1[out_size];
+    T scratch[6 * out_size];
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // GRU_SPARSE_H_INCLUDED
@@ -0,0 +1,387 @@
+#ifndef LSTM_SPARSE_H_INCLUDED
+#define LSTM_SPARSE_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "../Layer.h"
+#include "../common.h"
+#include "../config.h"
+#include "../model_plan.h"
+#include "sparse_kernels.h"
+
+#if RTNEURAL_USE_EIGEN
+#include "../maths/maths_eigen.h"
+#elif RTNEURAL_USE_XSIMD
+#include "../maths/maths_xsimd.h"
+#else
+#include "../maths/maths_stl.h"
+#endif
+
+namespace RTNEURAL_NAMESPACE
+{
+
+#ifndef DOXYGEN
+namespace sparse_detail
+{
+    /**
+     * Computes the LSTM gates and updates the states `h` and `c`, from the
+     * sum of the kernel outputs, recurrent outputs, and biases, for the
+     * i, f, c, and o gates in turn. The gate outputs are overwritten.
+     */
+    template <typename MathsProvider, typename T>
+    RTNEURAL_REALTIME inline void lstmGates(T* gateOuts, T* h, T* c, int out_size) noexcept
+    {
+        auto* it = gateOuts;
+        auto* ft = gateOuts + out_size;
+        auto* ctHat = gateOuts + 2 * out_size;
+        auto* ot = gateOuts + 3 * out_size;
+        applySigmoid<MathsProvider>(it, 2 * out_size);
+        applyTanh<MathsProvider>(ctHat, out_size);
+        applySigmoid<MathsProvider>(ot, out_size);
+
+        // ctHat has been used, so it can hold tanh(c)
+        auto* cTanh = ctHat;
+        for(int i = 0; i < out_size; ++i)
+        {
+            c[i] = ft[i] * c[i] + it[i] * ctHat[i];
+            cTanh[i] = c[i];
+        }
+        applyTanh<MathsProvider>(cTanh, out_size);
+
+        for(int i = 0; i < out_size; ++i)
+            h[i] = ot[i] * cTanh[i];
+    }
+} // namespace sparse_detail
+#endif
+
+/**
+ * Dynamic implementation of a LSTM layer with tanh
+ * activation and sigmoid recurrent activation, and
+ * block-sparse recurrent weights.
+ *
+ * Only the blocks of weights (`sparse_detail::blockRows` outputs by one
+ * input) with a non-zero weight are stored and computed. The kernel
+ * weights use the same layout, so they may be pruned as well, but
+ * `json_parser::parseJson()` chooses this layer for LSTM layers whose
+ * recurrent weights are sparse enough.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, typename MathsProvider = DefaultMathsProvider>
+class LSTMLayerSparse final : public Layer<T>
+{
+public:
+    /** Constructs a LSTM layer for a given input and output size. */
+    LSTMLayerSparse(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , kernelWeights(4 * out_size, in_size)
+        , recurrentWeights(4 * out_size, out_size)
+        , memory(getMemoryBytes(out_size))
+    {
+        bindMemory();
+        reset();
+    }
+
+    LSTMLayerSparse(std::initializer_list<int> sizes)
+        : LSTMLayerSparse(*sizes.begin(), *(sizes.begin() + 1))
+    {
+    }
+
+    LSTMLayerSparse(const LSTMLayerSparse& other)
+        : LSTMLayerSparse(other.in_size, other.out_size)
+    {
+    }
+
+    LSTMLayerSparse& operator=(const LSTMLayerSparse& other)
+    {
+        return *this = LSTMLayerSparse(other);
+    }
+
+    virtual ~LSTMLayerSparse() = default;
+
+    /** Resets the state of the LSTM. */
+    RTNEURAL_REALTIME void reset() override
+    {
+        std::fill(ht1, ht1 + Layer<T>::out_size, (T)0);
+        std::fill(ct1, ct1 + Layer<T>::out_size, (T)0);
+    }
+
+    /** Returns the number of values in the LSTM state. */
+    size_t getStateSize() const noexcept override { return (size_t)(2 * Layer<T>::out_size); }
+
+    /** Copies the LSTM state into `state`. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept override
+    {
+        std::copy(ht1, ht1 + Layer<T>::out_size, state);
+        std::copy(ct1, ct1 + Layer<T>::out_size, state + Layer<T>::out_size);
+    }
+
+    /** Restores the LSTM state from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept override
+    {
+        std::copy(state, state + Layer<T>::out_size, ht1);
+        std::copy(state + Layer<T>::out_size, state + 2 * Layer<T>::out_size, ct1);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "lstm"; }
+
+    size_t getNumMACs() const noexcept override { return kernelWeights.getNumMACs() + recurrentWeights.getNumMACs(); }
+
+    /** Lets `Model::compile()` call this layer directly. */
+    bool resolvePlanOp(PlanOp<T>& op) override { return plan_detail::resolve<T, LSTMLayerSparse<T, MathsProvider>>(op); }
+
+    /** Performs forward propagation for this layer. */
+    RTNEURAL_REALTIME inline void forward(const T* input, T* h) noexcept override
+    {
+        auto* kernelOuts = scratch;
+        auto* recurrentOuts = scratch + 4 * Layer<T>::out_size;
+        kernelWeights.matVec(input, kernelOuts);
+        recurrentWeights.matVec(ht1, recurrentOuts);
+
+        for(int j = 0; j < 4 * Layer<T>::out_size; ++j)
+            kernelOuts[j] += recurrentOuts[j] + bias[j];
+        sparse_detail::lstmGates<MathsProvider>(kernelOuts, ht1, ct1, Layer<T>::out_size);
+        std::copy(ht1, ht1 + Layer<T>::out_size, h);
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        kernelWeights.setWeights([&wVals](int j, int i)
+            { return wVals[(size_t)i][(size_t)j]; });
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        recurrentWeights.setWeights([&uVals](int j, int i)
+            { return uVals[(size_t)i][(size_t)j]; });
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[4 * out_size]
+     */
+    void setBVals(const std::vector<T>& bVals)
+    {
+        std::copy(bVals.begin(), bVals.begin() + 4 * Layer<T>::out_size, bias);
+    }
+
+    /** Returns the fraction of the recurrent weight blocks which are all zeros. */
+    float getSparsity() const noexcept { return recurrentWeights.getSparsity(); }
+
+    size_t getArenaBytes() const noexcept override { return memory.getCapacity() + kernelWeights.getArenaBytes() + recurrentWeights.getArenaBytes(); }
+
+    void moveToArena(MemoryArena& arena) override
+    {
+        memory.moveInto(arena);
+        bindMemory();
+        kernelWeights.moveToArena(arena);
+        recurrentWeights.moveToArena(arena);
+    }
+
+private:
+    static size_t getMemoryBytes(int out_size) noexcept
+    {
+        return MemoryArena::getBytes<T>((size_t)(4 * out_size))
+            + 2 * MemoryArena::getBytes<T>((size_t)out_size)
+            + MemoryArena::getBytes<T>((size_t)(8 * out_size));
+    }
+
+    /** Points the layer buffers at the layer memory. */
+    void bindMemory() noexcept
+    {
+        memory.rewind();
+        bias = memory.allocate<T>((size_t)(4 * Layer<T>::out_size));
+        ht1 = memory.allocate<T>((size_t)Layer<T>::out_size);
+        ct1 = memory.allocate<T>((size_t)Layer<T>::out_size);
+        scratch = memory.allocate<T>((size_t)(8 * Layer<T>::out_size));
+    }
+
+    BlockSparseMatrix<T> kernelWeights;
+    BlockSparseMatrix<T> recurrentWeights;
+    MemoryArena memory;
+    T* bias = nullptr;
+    T* ht1 = nullptr;
+    T* ct1 = nullptr;
+    T* scratch = nullptr;
+};
+
+//====================================================
+/**
+ * Static implementation of a LSTM layer with tanh
+ * activation and sigmoid recurrent activation, and
+ * block-sparse recurrent weights. See `LSTMLayerSparse` for details.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, int in_sizet, int out_sizet, typename MathsProvider = DefaultMathsProvider>
+class LSTMLayerSparseT
+{
+#if RTNEURAL_USE_EIGEN
+    using in_type = Eigen::Matrix<T, in_sizet, 1>;
+    using out_type = Eigen::Matrix<T, out_sizet, 1>;
+#elif RTNEURAL_USE_XSIMD
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_in_size = ceil_div(in_sizet, v_size);
+    static constexpr auto v_out_size = ceil_div(out_sizet, v_size);
+#endif
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    LSTMLayerSparseT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "lstm"; }
+
+    /** Returns false since LSTM is not an activation. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the LSTM. */
+    RTNEURAL_REALTIME void reset()
+    {
+        std::fill(std::begin(ht1), std::end(ht1), (T)0);
+        std::fill(std::begin(ct1), std::end(ct1), (T)0);
+#if RTNEURAL_USE_EIGEN
+        outs = out_type::Zero();
+#elif RTNEURAL_USE_XSIMD
+        std::fill(std::begin(outs), std::end(outs), v_type((T)0));
+#else
+        std::fill(std::begin(outs), std::end(outs), (T)0);
+#endif
+    }
+
+    /** Returns the number of values in the LSTM state. */
+    static constexpr size_t getStateSize() noexcept { return (size_t)(2 * out_size); }
+
+    /** Copies the LSTM state into `state`, which must hold `getStateSize()` values. */
+    RTNEURAL_REALTIME void saveState(T* state) const noexcept
+    {
+        std::copy(std::begin(ht1), std::end(ht1), state);
+        std::copy(std::begin(ct1), std::end(ct1), state + out_size);
+    }
+
+    /** Restores the LSTM state from values written by `saveState()`. */
+    RTNEURAL_REALTIME void loadState(const T* state) noexcept
+    {
+        std::copy(state, state + out_size, std::begin(ht1));
+        std::copy(state + out_size, state + 2 * out_size, std::begin(ct1));
+    }
+
+    /** Performs forward propagation for this layer. */
+#if RTNEURAL_USE_EIGEN
+    RTNEURAL_REALTIME inline void forward(const in_type& ins) noexcept
+    {
+        forwardInternal(ins.data(), outs.data());
+    }
+#elif RTNEURAL_USE_XSIMD
+    RTNEURAL_REALTIME inline void forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        forwardInternal(reinterpret_cast<const T*>(ins), reinterpret_cast<T*>(outs));
+    }
+#else
+    RTNEURAL_REALTIME inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        forwardInternal(ins, outs);
+    }
+#endif
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        kernelWeights.setWeights([&wVals](int j, int i)
+            { return wVals[(size_t)i][(size_t)j]; });
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        recurrentWeights.setWeights([&uVals](int j, int i)
+            { return uVals[(size_t)i][(size_t)j]; });
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[4 * out_size]
+     */
+    void setBVals(const std::vector<T>& bVals)
+    {
+        std::copy(bVals.begin(), bVals.begin() + 4 * out_size, std::begin(bias));
+    }
+
+    /** Returns the fraction of the recurrent weight blocks which are all zeros. */
+    float getSparsity() const noexcept { return recurrentWeights.getSparsity(); }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<out_type, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD
+    v_type outs[v_out_size];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    RTNEURAL_REALTIME inline void forwardInternal(const T* ins, T* out) noexcept
+    {
+        auto* kernelOuts = scratch;
+        auto* recurrentOuts = scratch + 4 * out_size;
+        kernelWeights.matVec(ins, kernelOuts);
+        recurrentWeights.matVec(ht1, recurrentOuts);
+
+        for(int j = 0; j < 4 * out_size; ++j)
+            kernelOuts[j] += recurrentOuts[j] + bias[j];
+        sparse_detail::lstmGates<MathsProvider>(kernelOuts, ht1, ct1, out_size);
+        std::copy(std::begin(ht1), std::end(ht1), out);
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    BlockSparseMatrixT<T, 4 * out_size, in_size> kernelWeights;
+    BlockSparseMatrixT<T, 4 * out_size, out_size> recurrentWeights;
+    T bias[4 * out_size];
+
+    T ht1[out_size];
+    T ct1[out_size];
+    T scratch[8 * out_size];
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // LSTM_SPARSE_H_INCLUDED
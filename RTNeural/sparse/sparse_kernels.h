@@ -0,0 +1,341 @@
+#ifndef SPARSE_KERNELS_H_INCLUDED
+#define SPARSE_KERNELS_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "../common.h"
+#include "../config.h"
+#include "../memory_arena.h"
+
+#if defined(__AVX__) && defined(__FMA__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace RTNEURAL_NAMESPACE
+{
+
+/**
+ * Kernels for the layers with block-sparse weights.
+ *
+ * The weight matrices are split into blocks of rows (outputs) by one
+ * column (input), and only the blocks with a non-zero weight are stored,
+ * in a CSR-like layout: for each group of rows, `rowStart` gives the range
+ * of blocks in `values` (`blockRows` weights per block), and `colIndex`
+ * gives the input for each block. Each block is computed as a single SIMD
+ * multiply-add of the weights with one input value.
+ */
+namespace sparse_detail
+{
+    /** The number of rows in each block (the number of floats in a SIMD register). */
+#if defined(__AVX__) && defined(__FMA__)
+    constexpr int blockRows = 8;
+#else
+    constexpr int blockRows = 4;
+#endif
+
+    /** Returns true if a block of the weight matrix has any non-zero weights. */
+    template <typename GetWeight>
+    bool isBlockNonZero(GetWeight&& getWeight, int rows, int rowBlock, int col)
+    {
+        for(int i = rowBlock * blockRows; i < std::min(rows, (rowBlock + 1) * blockRows); ++i)
+        {
+            if(getWeight(i, col) != 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    /** Returns the number of blocks with non-zero weights, for a matrix with `getWeight(row, col)`. */
+    template <typename GetWeight>
+    int countBlocks(GetWeight&& getWeight, int rows, int cols)
+    {
+        int numBlocks = 0;
+        for(int rb = 0; rb < ceil_div(rows, blockRows); ++rb)
+            for(int k = 0; k < cols; ++k)
+                numBlocks += isBlockNonZero(getWeight, rows, rb, k) ? 1 : 0;
+
+        return numBlocks;
+    }
+
+    /** Returns the fraction of the blocks in a matrix which are all zeros. */
+    template <typename GetWeight>
+    float getBlockSparsity(GetWeight&& getWeight, int rows, int cols)
+    {
+        const auto totalBlocks = ceil_div(rows, blockRows) * cols;
+        if(totalBlocks == 0)
+            return 0.0f;
+
+        return 1.0f - (float)countBlocks(getWeight, rows, cols) / (float)totalBlocks;
+    }
+
+    /**
+     * Stores the non-zero blocks of a matrix. `values` must hold
+     * `blockRows * countBlocks()` weights, `colIndex` must hold `countBlocks()`
+     * indices, and `rowStart` must hold `ceil_div(rows, blockRows) + 1` indices.
+     */
+    template <typename T, typename GetWeight>
+    void setBlocks(GetWeight&& getWeight, int rows, int cols, T* values, int32_t* colIndex, int32_t* rowStart)
+    {
+        int32_t numBlocks = 0;
+        for(int rb = 0; rb < ceil_div(rows, blockRows); ++rb)
+        {
+            rowStart[rb] = numBlocks;
+            for(int k = 0; k < cols; ++k)
+            {
+                if(!isBlockNonZero(getWeight, rows, rb, k))
+                    continue;
+
+                for(int r = 0; r < blockRows; ++r)
+                {
+                    const auto i = rb * blockRows + r;
+                    values[numBlocks * blockRows + r] = i < rows ? (T)getWeight(i, k) : (T)0;
+                }
+                colIndex[numBlocks++] = (int32_t)k;
+            }
+        }
+        rowStart[ceil_div(rows, blockRows)] = numBlocks;
+    }
+
+    /** Returns a weight from a block-sparse matrix. */
+    template <typename T>
+    T getWeight(const T* values, const int32_t* colIndex, const int32_t* rowStart, int row, int col) noexcept
+    {
+        const auto rb = row / blockRows;
+        for(auto b = rowStart[rb]; b < rowStart[rb + 1]; ++b)
+        {
+            if(colIndex[b] == col)
+                return values[b * blockRows + row % blockRows];
+        }
+
+        return (T)0;
+    }
+
+    /** Computes out = mat * x, for a block-sparse matrix. */
+    template <typename T>
+    RTNEURAL_REALTIME inline void matVec(const T* values, const int32_t* colIndex, const int32_t* rowStart,
+        const T* x, T* out, int rows) noexcept
+    {
+        for(int rb = 0; rb < ceil_div(rows, blockRows); ++rb)
+        {
+            T acc[blockRows] {};
+            for(auto b = rowStart[rb]; b < rowStart[rb + 1]; ++b)
+            {
+                const auto xk = x[colIndex[b]];
+                for(int r = 0; r < blockRows; ++r)
+                    acc[r] += values[b * blockRows + r] * xk;
+            }
+
+            const auto numRows = std::min(blockRows, rows - rb * blockRows);
+            std::copy(acc, acc + numRows, out + rb * blockRows);
+        }
+    }
+
+#if (defined(__AVX__) && defined(__FMA__)) || defined(__SSE2__) || defined(_M_X64) || (defined(__ARM_NEON) && defined(__aarch64__))
+#if defined(__AVX__) && defined(__FMA__)
+    using float_reg = __m256;
+    inline float_reg loadBlock(const float* w) noexcept { return _mm256_loadu_ps(w); }
+    inline float_reg zeroBlock() noexcept { return _mm256_setzero_ps(); }
+    inline float_reg addBlocks(float_reg a, float_reg b) noexcept { return _mm256_add_ps(a, b); }
+    inline float_reg madd(float_reg acc, float_reg w, float x) noexcept { return _mm256_fmadd_ps(w, _mm256_set1_ps(x), acc); }
+    inline void storeBlock(float* out, float_reg x) noexcept { _mm256_storeu_ps(out, x); }
+#elif defined(__SSE2__) || defined(_M_X64)
+    using float_reg = __m128;
+    inline float_reg loadBlock(const float* w) noexcept { return _mm_loadu_ps(w); }
+    inline float_reg zeroBlock() noexcept { return _mm_setzero_ps(); }
+    inline float_reg addBlocks(float_reg a, float_reg b) noexcept { return _mm_add_ps(a, b); }
+#if defined(__FMA__)
+    inline float_reg madd(float_reg acc, float_reg w, float x) noexcept { return _mm_fmadd_ps(w, _mm_set1_ps(x), acc); }
+#else
+    inline float_reg madd(float_reg acc, float_reg w, float x) noexcept { return _mm_add_ps(_mm_mul_ps(w, _mm_set1_ps(x)), acc); }
+#endif
+    inline void storeBlock(float* out, float_reg x) noexcept { _mm_storeu_ps(out, x); }
+#else
+    using float_reg = float32x4_t;
+    inline float_reg loadBlock(const float* w) noexcept { return vld1q_f32(w); }
+    inline float_reg zeroBlock() noexcept { return vdupq_n_f32(0.0f); }
+    inline float_reg addBlocks(float_reg a, float_reg b) noexcept { return vaddq_f32(a, b); }
+    inline float_reg madd(float_reg acc, float_reg w, float x) noexcept { return vfmaq_n_f32(acc, w, x); }
+    inline void storeBlock(float* out, float_reg x) noexcept { vst1q_f32(out, x); }
+#endif
+
+    /**
+     * Computes out = mat * x, for a block-sparse matrix of floats.
+     *
+     * Each block is a single AVX (eight-wide), SSE, or NEON (four-wide)
+     * multiply-add, using two accumulators so that consecutive blocks don't
+     * wait on each other.
+     */
+    RTNEURAL_REALTIME inline void matVec(const float* values, const int32_t* colIndex, const int32_t* rowStart,
+        const float* x, float* out, int rows) noexcept
+    {
+        for(int rb = 0; rb < ceil_div(rows, blockRows); ++rb)
+        {
+            auto b = rowStart[rb];
+            const auto end = rowStart[rb + 1];
+
+            auto acc0 = zeroBlock();
+            auto acc1 = zeroBlock();
+            for(; b + 2 <= end; b += 2)
+            {
+                acc0 = madd(acc0, loadBlock(values + b * blockRows), x[colIndex[b]]);
+                acc1 = madd(acc1, loadBlock(values + (b + 1) * blockRows), x[colIndex[b + 1]]);
+            }
+            if(b < end)
+                acc0 = madd(acc0, loadBlock(values + b * blockRows), x[colIndex[b]]);
+
+            if((rb + 1) * blockRows <= rows)
+            {
+                storeBlock(out + rb * blockRows, addBlocks(acc0, acc1));
+            }
+            else
+            {
+                alignas(RTNEURAL_DEFAULT_ALIGNMENT) float acc[blockRows];
+                storeBlock(acc, addBlocks(acc0, acc1));
+                std::copy(acc, acc + rows - rb * blockRows, out + rb * blockRows);
+            }
+        }
+    }
+#endif
+} // namespace sparse_detail
+
+/**
+ * A block-sparse weight matrix, for the dynamic layers.
+ *
+ * The memory for the non-zero blocks is allocated when the weights are set,
+ * so the matrix only takes up as much memory as the blocks that it stores.
+ */
+template <typename T>
+class BlockSparseMatrix
+{
+public:
+    /** Creates an empty (all zeros) matrix. */
+    BlockSparseMatrix(int rows, int cols)
+        : rows(rows)
+        , cols(cols)
+    {
+        allocate(0);
+    }
+
+    /** Sets the matrix weights, from a function `getWeight(row, col)`. */
+    template <typename GetWeight>
+    void setWeights(GetWeight&& getWeight)
+    {
+        allocate(sparse_detail::countBlocks(getWeight, rows, cols));
+        sparse_detail::setBlocks(getWeight, rows, cols, values, colIndex, rowStart);
+    }
+
+    /** Computes out = mat * x. */
+    RTNEURAL_REALTIME inline void matVec(const T* x, T* out) const noexcept
+    {
+        sparse_detail::matVec(values, colIndex, rowStart, x, out, rows);
+    }
+
+    /** Returns the weight at the given indices. */
+    T getWeight(int row, int col) const noexcept { return sparse_detail::getWeight(values, colIndex, rowStart, row, col); }
+
+    /** Returns the number of stored (non-zero) blocks. */
+    int getNumBlocks() const noexcept { return numBlocks; }
+
+    /** Returns the number of multiply-adds in `matVec()`. */
+    size_t getNumMACs() const noexcept { return (size_t)(numBlocks * sparse_detail::blockRows); }
+
+    /** Returns the fraction of the blocks in the matrix which are all zeros. */
+    float getSparsity() const noexcept
+    {
+        const auto totalBlocks = ceil_div(rows, sparse_detail::blockRows) * cols;
+        return totalBlocks == 0 ? 0.0f : 1.0f - (float)numBlocks / (float)totalBlocks;
+    }
+
+    size_t getArenaBytes() const noexcept { return memory.getCapacity(); }
+
+    void moveToArena(MemoryArena& arena)
+    {
+        memory.moveInto(arena);
+        bindMemory();
+    }
+
+private:
+    void allocate(int newNumBlocks)
+    {
+        numBlocks = newNumBlocks;
+        memory = MemoryArena(MemoryArena::getBytes<T>((size_t)(numBlocks * sparse_detail::blockRows))
+            + MemoryArena::getBytes<int32_t>((size_t)numBlocks)
+            + MemoryArena::getBytes<int32_t>((size_t)(ceil_div(rows, sparse_detail::blockRows) + 1)));
+        bindMemory();
+    }
+
+    /** Points the matrix buffers at the matrix memory. */
+    void bindMemory() noexcept
+    {
+        memory.rewind();
+        values = memory.allocate<T>((size_t)(numBlocks * sparse_detail::blockRows));
+        colIndex = memory.allocate<int32_t>((size_t)numBlocks);
+        rowStart = memory.allocate<int32_t>((size_t)(ceil_div(rows, sparse_detail::blockRows) + 1));
+    }
+
+    int rows;
+    int cols;
+    int numBlocks = 0;
+
+    MemoryArena memory;
+    T* values = nullptr;
+    int32_t* colIndex = nullptr;
+    int32_t* rowStart = nullptr;
+};
+
+/**
+ * A block-sparse weight matrix, for the static layers.
+ *
+ * Since the sizes are known at compile-time, the matrix has room for
+ * all of the blocks, but the time taken to multiply by the matrix only
+ * depends on the number of non-zero blocks.
+ */
+template <typename T, int rows, int cols>
+class BlockSparseMatrixT
+{
+    static constexpr auto numRowBlocks = ceil_div(rows, sparse_detail::blockRows);
+
+public:
+    BlockSparseMatrixT()
+    {
+        std::fill(std::begin(rowStart), std::end(rowStart), 0);
+    }
+
+    /** Sets the matrix weights, from a function `getWeight(row, col)`. */
+    template <typename GetWeight>
+    void setWeights(GetWeight&& getWeight)
+    {
+        sparse_detail::setBlocks(getWeight, rows, cols, values, colIndex, rowStart);
+    }
+
+    /** Computes out = mat * x. */
+    RTNEURAL_REALTIME inline void matVec(const T* x, T* out) const noexcept
+    {
+        sparse_detail::matVec(values, colIndex, rowStart, x, out, rows);
+    }
+
+    /** Returns the weight at the given indices. */
+    T getWeight(int row, int col) const noexcept { return sparse_detail::getWeight(values, colIndex, rowStart, row, col); }
+
+    /** Returns the number of stored (non-zero) blocks. */
+    int getNumBlocks() const noexcept { return rowStart[numRowBlocks]; }
+
+    /** Returns the fraction of the blocks in the matrix which are all zeros. */
+    float getSparsity() const noexcept { return 1.0f - (float)getNumBlocks() / (float)(numRowBlocks * cols); }
+
+private:
+    T values alignas(RTNEURAL_DEFAULT_ALIGNMENT)[numRowBlocks * sparse_detail::blockRows * cols];
+    int32_t colIndex[numRowBlocks * cols];
+    int32_t rowStart[numRowBlocks + 1];
+};
+
+} // namespace RTNEURAL_NAMESPACE
+
+#endif // SPARSE_KERNELS_H_INCLUDED
@@ -0,0 +1,81 @@
+#include "bench_utils.hpp"
+#include <RTNeural.h>
+#include <parallel/executor.h>
+#include <chrono>
+
+namespace
+{
+constexpr int numModels = 64;
+constexpr int blockSize = 64;
+using ModelJob = RTNeural::ModelBlockJob<RTNeural::Model<double>, double>;
+
+std::vector<std::unique_ptr<RTNeural::Model<double>>> loadModels(const std::string& model_file)
+{
+    std::vector<std::unique_ptr<RTNeural::Model<double>>> models;
+    for(int i = 0; i < numModels; ++i)
+    {
+        std::ifstream jsonStream(model_file, std::ifstream::binary);
+        models.push_back(RTNeural::json_parser::parseJson<double>(jsonStream));
+        models.back()->prepare(blockSize);
+        models.back()->compile();
+    }
+
+    return models;
+}
+
+double runBench(int numWorkers, std::vector<std::unique_ptr<RTNeural::Model<double>>>& models, double length_seconds)
+{
+    // generate audio
+    constexpr double sample_rate = 48000.0;
+    const auto n_blocks = static_cast<size_t>(sample_rate * length_seconds) / blockSize;
+    const auto signal = generate_signal(blockSize, 1);
+    std::vector<double> input(blockSize);
+    for(int n = 0; n < blockSize; ++n)
+        input[n] = signal[n][0];
+
+    std::vector<std::vector<double>> outputs(numModels, std::vector<double>(blockSize));
+    std::vector<ModelJob> modelJobs(numModels);
+    std::vector<RTNeural::ExecutorJob> jobs(numModels);
+    for(int i = 0; i < numModels; ++i)
+    {
+        modelJobs[i] = { models[i].get(), input.data(), outputs[i].data(), blockSize };
+        jobs[i] = modelJobs[i].getJob();
+    }
+
+    RTNeural::WorkStealingExecutor executor(numWorkers, numModels);
+
+    // run benchmark
+    using clock_t = std::chrono::high_resolution_clock;
+    using second_t = std::chrono::duration<double>;
+
+    auto start = clock_t::now();
+    for(size_t i = 0; i < n_blocks; ++i)
+        executor.process(jobs.data(), numModels);
+    auto duration = std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+
+    std::cout << numWorkers << " worker(s): processed " << length_seconds << " seconds of signal with "
+              << numModels << " models in " << duration << " seconds ("
+              << length_seconds / duration << "x real-time)" << std::endl;
+
+    return duration;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::string model_file = "models/full_model.json";
+    constexpr double bench_time = 10.0;
+
+    auto models = loadModels(model_file);
+    const auto maxWorkers = std::max((int)std::thread::hardware_concurrency() - 1, 0);
+
+    double serialDur = 0.0;
+    for(int numWorkers = 0; numWorkers <= maxWorkers; ++numWorkers)
+    {
+        const auto duration = runBench(numWorkers, models, bench_time);
+        if(numWorkers == 0)
+            serialDur = duration;
+        else
+            std::cout << "Speedup with " << numWorkers + 1 << " threads: " << serialDur / duration << "x" << std::endl;
+    }
+}
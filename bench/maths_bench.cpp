@@ -0,0 +1,128 @@
+#include "bench_utils.hpp"
+#include <RTNeural.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+constexpr int layerSize = 16;
+constexpr double sampleRate = 48000.0;
+constexpr double benchTime = 10.0;
+
+std::vector<std::vector<float>> makeWeights(size_t rows, size_t cols, std::default_random_engine& generator)
+{
+    std::uniform_real_distribution<float> distribution(-0.5f, 0.5f);
+    std::vector<std::vector<float>> weights(rows, std::vector<float>(cols));
+    for(auto& row : weights)
+        for(auto& w : row)
+            w = distribution(generator);
+    return weights;
+}
+
+template <typename MathsProvider>
+std::unique_ptr<RTNeural::Layer<float>> createLayer(const std::string& type)
+{
+    std::default_random_engine generator;
+    if(type == "tanh")
+        return std::make_unique<RTNeural::TanhActivation<float, MathsProvider>>(layerSize);
+    if(type == "sigmoid")
+        return std::make_unique<RTNeural::SigmoidActivation<float, MathsProvider>>(layerSize);
+    if(type == "elu")
+        return std::make_unique<RTNeural::ELuActivation<float, MathsProvider>>(layerSize);
+
+    if(type == "gru")
+    {
+        auto gru = std::make_unique<RTNeural::GRULayer<float, MathsProvider>>(layerSize, layerSize);
+        gru->setWVals(makeWeights(layerSize, 3 * layerSize, generator));
+        gru->setUVals(makeWeights(layerSize, 3 * layerSize, generator));
+        gru->setBVals(makeWeights(2, 3 * layerSize, generator));
+        return std::move(gru);
+    }
+
+    auto lstm = std::make_unique<RTNeural::LSTMLayer<float, MathsProvider>>(layerSize, layerSize);
+    lstm->setWVals(makeWeights(layerSize, 4 * layerSize, generator));
+    lstm->setUVals(makeWeights(layerSize, 4 * layerSize, generator));
+    lstm->setBVals(makeWeights(1, 4 * layerSize, generator)[0]);
+    return std::move(lstm);
+}
+
+/** Runs a layer over the test signal, and returns the duration (in seconds) and the output. */
+std::pair<double, std::vector<float>> runLayer(RTNeural::Layer<float>& layer, const std::vector<float>& input)
+{
+    using clock_t = std::chrono::high_resolution_clock;
+    using second_t = std::chrono::duration<double>;
+
+    const auto numFrames = input.size() / layerSize;
+    std::vector<float> output(input.size());
+
+    layer.reset();
+    auto start = clock_t::now();
+    for(size_t n = 0; n < numFrames; ++n)
+        layer.forward(input.data() + n * layerSize, output.data() + n * layerSize);
+    auto duration = std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+
+    return { duration, std::move(output) };
+}
+
+void compareLayers(const std::string& type, const std::string& name, RTNeural::Layer<float>& defaultLayer, RTNeural::Layer<float>& layer, const std::vector<float>& input)
+{
+    const auto expected = runLayer(defaultLayer, input);
+    const auto result = runLayer(layer, input);
+
+    float maxError = 0.0f;
+    for(size_t i = 0; i < input.size(); ++i)
+        maxError = std::max(maxError, std::abs(result.second[i] - expected.second[i]));
+
+    std::cout << std::left << std::setw(8) << type << std::setw(28) << name
+              << "default: " << std::setw(12) << expected.first
+              << "approx: " << std::setw(12) << result.first
+              << "speedup: " << std::setw(10) << expected.first / result.first
+              << "max error: " << maxError << std::endl;
+}
+
+template <typename MathsProvider>
+void runBench(const std::string& type, const std::string& providerName, const std::vector<float>& input)
+{
+    auto defaultLayer = createLayer<RTNeural::DefaultMathsProvider>(type);
+    auto layer = createLayer<MathsProvider>(type);
+    compareLayers(type, providerName, *defaultLayer, *layer, input);
+}
+
+void runTableBench(const std::string& type, RTNeural::LUTFunction func, int tableSize, const std::vector<float>& input)
+{
+    auto defaultLayer = createLayer<RTNeural::DefaultMathsProvider>(type);
+    RTNeural::LUTActivation<float> layer(layerSize, func, tableSize);
+    compareLayers(type, "LUTActivation (" + std::to_string(tableSize) + ")", *defaultLayer, layer, input);
+}
+} // namespace
+
+int main()
+{
+    const auto numFrames = static_cast<size_t>(sampleRate * benchTime);
+    const auto signal = generate_signal(numFrames * layerSize, 1);
+
+    // spread the inputs over the range where the approximations differ the most
+    std::vector<float> input(numFrames * layerSize);
+    for(size_t i = 0; i < input.size(); ++i)
+        input[i] = 8.0f * (float)signal[i][0];
+
+    std::cout << "Processing " << benchTime << " seconds of signal, with layers of size " << layerSize << std::endl;
+    for(const std::string type : { "tanh", "sigmoid", "gru", "lstm" })
+    {
+        runBench<RTNeural::PadeTanhMathsProvider>(type, "PadeTanhMathsProvider", input);
+        runBench<RTNeural::Exp2SigmoidMathsProvider>(type, "Exp2SigmoidMathsProvider", input);
+        runBench<RTNeural::FastMathsProvider>(type, "FastMathsProvider", input);
+    }
+    runBench<RTNeural::PolynomialEluMathsProvider>("elu", "PolynomialEluMathsProvider", input);
+    runBench<RTNeural::FastMathsProvider>("elu", "FastMathsProvider", input);
+
+    for(int tableSize : { 256, 2048 })
+    {
+        runTableBench("tanh", RTNeural::LUTFunction::Tanh, tableSize, input);
+        runTableBench("sigmoid", RTNeural::LUTFunction::Sigmoid, tableSize, input);
+        runTableBench("elu", RTNeural::LUTFunction::ELu, tableSize, input);
+    }
+
+    return 0;
+}
@@ -5,6 +5,8 @@
 namespace fs = std::filesystem;
 
 // include the implementation of the custom layer here
+// (RTNeural also has a built-in, vectorized version of this layer, RTNeural::GatedActivationT,
+// which is re-implemented here to show how a custom layer can be written)
 #if RTNEURAL_USE_XSIMD
 #include "GatedActivation_xsimd.h"
 #elif RTNEURAL_USE_EIGEN
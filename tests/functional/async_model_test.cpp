@@ -0,0 +1,96 @@
+#include <gmock/gmock.h>
+
+#include <RTNeural/RTNeural.h>
+#include <RTNeural/parallel/async_model.h>
+#include <random>
+
+namespace
+{
+using TestType = double;
+constexpr int blockSize = 32;
+constexpr int numBlocks = 20;
+
+/** A "model" which takes a long time to process each block. */
+struct SlowModel
+{
+    static constexpr int input_size = 1;
+    static constexpr int output_size = 1;
+
+    void reset() { }
+
+    void processBlock(const TestType* input, TestType* output, int numFrames) noexcept
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::copy(input, input + numFrames, output);
+    }
+};
+} // namespace
+
+TEST(TestAsyncModel, outputIsDelayedByOneBlock)
+{
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + "models/full_model.json", std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution(-1.0, 1.0);
+    std::vector<TestType> input(blockSize * numBlocks);
+    for(auto& x : input)
+        x = distribution(generator);
+
+    auto serialModel = RTNeural::json_parser::parseJson<TestType>(modelJson);
+    serialModel->prepare(blockSize);
+    std::vector<TestType> expected(input.size());
+    serialModel->forward(input.data(), expected.data(), (int)input.size());
+
+    auto model = RTNeural::json_parser::parseJson<TestType>(modelJson);
+    model->prepare(blockSize);
+    RTNeural::AsyncModel<TestType, RTNeural::Model<TestType>> asyncModel(*model, blockSize);
+    EXPECT_EQ(asyncModel.getInSize(), 1);
+    EXPECT_EQ(asyncModel.getOutSize(), 1);
+
+    std::vector<TestType> output(input.size());
+    for(int b = 0; b < numBlocks; ++b)
+    {
+        asyncModel.process(input.data() + b * blockSize, output.data() + b * blockSize, blockSize);
+        asyncModel.waitForPendingBlocks();
+    }
+
+    for(int n = 0; n < blockSize; ++n)
+        EXPECT_EQ(output[n], (TestType)0);
+    for(int n = blockSize; n < (int)output.size(); ++n)
+        EXPECT_DOUBLE_EQ(output[n], expected[n - blockSize]) << "Sample " << n;
+
+    EXPECT_EQ(asyncModel.getNumLateBlocks(), 0);
+    EXPECT_EQ(asyncModel.getNumDroppedBlocks(), 0);
+    EXPECT_GT(asyncModel.getWorstCaseHandoffLatency().count(), 0);
+}
+
+TEST(TestAsyncModel, countsLateAndDroppedBlocks)
+{
+    SlowModel model;
+    RTNeural::AsyncModel<TestType, SlowModel> asyncModel(model, blockSize, false, 1, 2);
+
+    const std::vector<TestType> input(blockSize, (TestType)1);
+    std::vector<TestType> output(blockSize);
+
+    // the worker can't keep up, so the outputs are late, and the input ring fills up
+    for(int b = 0; b < 6; ++b)
+    {
+        asyncModel.process(input.data(), output.data(), blockSize);
+        EXPECT_THAT(output, testing::Each((TestType)0));
+    }
+
+    EXPECT_GT(asyncModel.getNumLateBlocks(), 0);
+    EXPECT_GT(asyncModel.getNumDroppedBlocks(), 0);
+
+    // once the worker has caught up, the next block is on time
+    asyncModel.reset();
+    asyncModel.resetStats();
+    asyncModel.process(input.data(), output.data(), blockSize);
+    asyncModel.waitForPendingBlocks();
+    asyncModel.process(input.data(), output.data(), blockSize);
+    EXPECT_THAT(output, testing::Each((TestType)1));
+    EXPECT_EQ(asyncModel.getNumLateBlocks(), 0);
+    EXPECT_GE(asyncModel.getWorstCaseHandoffLatency(), std::chrono::milliseconds(20));
+}
@@ -0,0 +1,112 @@
+#include <gmock/gmock.h>
+
+#include "load_csv.hpp"
+#include <RTNeural/RTNeural.h>
+#include <RTNeural/parallel/executor.h>
+
+namespace
+{
+using TestType = double;
+constexpr int numModels = 12;
+constexpr int blockSize = 64;
+using ModelJob = RTNeural::ModelBlockJob<RTNeural::Model<TestType>, TestType>;
+
+std::vector<std::unique_ptr<RTNeural::Model<TestType>>> loadModels()
+{
+    std::vector<std::unique_ptr<RTNeural::Model<TestType>>> models;
+    for(int i = 0; i < numModels; ++i)
+    {
+        std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + "models/gru.json", std::ifstream::binary);
+        models.push_back(RTNeural::json_parser::parseJson<TestType>(jsonStream));
+        models.back()->prepare(blockSize);
+    }
+
+    return models;
+}
+
+std::vector<TestType> loadInputData()
+{
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + "test_data/gru_x_python.csv");
+    return load_csv::loadFile<TestType>(pythonX);
+}
+
+/** Each model gets a different gain on its input, so that the outputs differ. */
+std::vector<TestType> makeInput(const std::vector<TestType>& xData, int modelIdx)
+{
+    std::vector<TestType> input(xData.size());
+    for(size_t n = 0; n < xData.size(); ++n)
+        input[n] = xData[n] * (TestType)(modelIdx + 1) / (TestType)numModels;
+    return input;
+}
+} // namespace
+
+TEST(TestExecutor, outputMatchesSerialProcessing)
+{
+    const auto xData = loadInputData();
+    const auto numBlocks = (int)xData.size() / blockSize;
+    const auto numSamples = numBlocks * blockSize;
+
+    std::vector<std::vector<TestType>> inputs;
+    for(int i = 0; i < numModels; ++i)
+        inputs.push_back(makeInput(xData, i));
+
+    auto serialModels = loadModels();
+    std::vector<std::vector<TestType>> expected(numModels, std::vector<TestType>((size_t)numSamples));
+    for(int i = 0; i < numModels; ++i)
+        for(int b = 0; b < numBlocks; ++b)
+            serialModels[i]->forward(inputs[i].data() + b * blockSize, expected[i].data() + b * blockSize, blockSize);
+
+    for(int numWorkers : { 0, 1, 3 })
+    {
+        auto models = loadModels();
+        std::vector<std::vector<TestType>> outputs(numModels, std::vector<TestType>((size_t)numSamples));
+        std::vector<ModelJob> modelJobs(numModels);
+        std::vector<RTNeural::ExecutorJob> jobs(numModels);
+
+        RTNeural::WorkStealingExecutor executor(numWorkers, numModels);
+        EXPECT_EQ(executor.getNumWorkers(), numWorkers);
+
+        for(int b = 0; b < numBlocks; ++b)
+        {
+            for(int i = 0; i < numModels; ++i)
+            {
+                modelJobs[i] = { models[i].get(), inputs[i].data() + b * blockSize, outputs[i].data() + b * blockSize, blockSize };
+                jobs[i] = modelJobs[i].getJob();
+            }
+
+            EXPECT_TRUE(executor.process(jobs.data(), numModels));
+        }
+
+        for(int i = 0; i < numModels; ++i)
+            EXPECT_THAT(outputs[i], testing::Pointwise(testing::DoubleEq(), expected[i])) << "Model " << i << ", " << numWorkers << " worker(s)";
+    }
+}
+
+TEST(TestExecutor, skipsJobsAfterDeadline)
+{
+    auto models = loadModels();
+    const std::vector<TestType> input((size_t)blockSize, (TestType)0.5);
+    std::vector<std::vector<TestType>> outputs(numModels, std::vector<TestType>((size_t)blockSize, (TestType)-1));
+
+    std::vector<ModelJob> modelJobs(numModels);
+    std::vector<RTNeural::ExecutorJob> jobs(numModels);
+    for(int i = 0; i < numModels; ++i)
+    {
+        modelJobs[i] = { models[i].get(), input.data(), outputs[i].data(), blockSize };
+        jobs[i] = modelJobs[i].getJob();
+    }
+
+    RTNeural::WorkStealingExecutor executor(2, numModels);
+    const auto deadline = RTNeural::WorkStealingExecutor::clock_type::now() - std::chrono::seconds(1);
+    EXPECT_FALSE(executor.process(jobs.data(), numModels, deadline));
+    EXPECT_EQ(executor.getNumSkippedJobs(), numModels);
+
+    // skipped jobs leave their outputs untouched
+    for(const auto& output : outputs)
+        EXPECT_THAT(output, testing::Each((TestType)-1));
+
+    // jobs beyond the executor's capacity are skipped too
+    RTNeural::WorkStealingExecutor smallExecutor(1, numModels / 2);
+    EXPECT_FALSE(smallExecutor.process(jobs.data(), numModels));
+    EXPECT_EQ(smallExecutor.getNumSkippedJobs(), numModels - numModels / 2);
+}
@@ -0,0 +1,133 @@
+#include <gmock/gmock.h>
+
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include <RTNeural/RTNeural.h>
+#include <iostream>
+
+namespace
+{
+using TestType = float;
+using namespace RTNeural;
+
+template <typename FixedPoint>
+using GRUModel = ModelT<TestType, 1, 1,
+    DenseT<TestType, 1, 8>,
+    TanhActivationT<TestType, 8>,
+    GRULayerFixedT<TestType, 8, 8, FixedPoint>,
+    DenseT<TestType, 8, 8>,
+    SigmoidActivationT<TestType, 8>,
+    DenseT<TestType, 8, 1>>;
+
+template <typename FixedPoint>
+using GRU1DModel = ModelT<TestType, 1, 1,
+    GRULayerFixedT<TestType, 1, 8, FixedPoint>,
+    DenseT<TestType, 8, 8>,
+    SigmoidActivationT<TestType, 8>,
+    DenseT<TestType, 8, 1>>;
+
+template <typename FixedPoint>
+using LSTMModel = ModelT<TestType, 1, 1,
+    DenseT<TestType, 1, 8>,
+    TanhActivationT<TestType, 8>,
+    LSTMLayerFixedT<TestType, 8, 8, FixedPoint>,
+    DenseT<TestType, 8, 1>>;
+
+template <typename FixedPoint>
+using LSTM1DModel = ModelT<TestType, 1, 1,
+    LSTMLayerFixedT<TestType, 1, 8, FixedPoint>,
+    DenseT<TestType, 8, 1>>;
+
+/** Runs the model over the test data, and returns the largest error against the reference output. */
+template <typename ModelType>
+double getMaxError(const TestConfig& test, const std::string& format)
+{
+    ModelType model;
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + test.model_file, std::ifstream::binary);
+    EXPECT_TRUE(model.parseJson(jsonStream));
+    model.reset();
+
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+
+    std::ifstream pythonY(std::string { RTNEURAL_ROOT_DIR } + test.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    double maxError = 0.0;
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        TestType input[] = { xData[n] };
+        maxError = std::max(maxError, std::abs((double)model.forward(input) - (double)yRefData[n]));
+    }
+
+    std::cout << test.name << " (" << format << ") max error: " << maxError << std::endl;
+    return maxError;
+}
+} // namespace
+
+TEST(TestFixedPoint, activationsAreAccurate)
+{
+    for(double x = -12.0; x <= 12.0; x += 1.0 / 1024.0)
+    {
+        const auto x16 = FixedPoint16::fromFloat(x);
+        EXPECT_NEAR(FixedPoint16::toFloat<double>(FixedPoint16::tanh(x16)), std::tanh(FixedPoint16::toFloat<double>(x16)), 3.0e-4);
+        EXPECT_NEAR(FixedPoint16::toFloat<double>(FixedPoint16::sigmoid(x16)), 1.0 / (1.0 + std::exp(-FixedPoint16::toFloat<double>(x16))), 3.0e-4);
+
+        const auto x32 = FixedPoint32::fromFloat(x);
+        EXPECT_NEAR(FixedPoint32::toFloat<double>(FixedPoint32::tanh(x32)), std::tanh(x), 1.0e-4);
+        EXPECT_NEAR(FixedPoint32::toFloat<double>(FixedPoint32::sigmoid(x32)), 1.0 / (1.0 + std::exp(-x)), 1.0e-4);
+    }
+}
+
+TEST(TestFixedPoint, arithmeticSaturates)
+{
+    const auto maxVal = std::numeric_limits<int16_t>::max();
+    const auto minVal = std::numeric_limits<int16_t>::min();
+
+    EXPECT_EQ(FixedPoint16::fromFloat(100.0f), maxVal);
+    EXPECT_EQ(FixedPoint16::fromFloat(-100.0f), minVal);
+    EXPECT_EQ(FixedPoint16::add(maxVal, FixedPoint16::one()), maxVal);
+    EXPECT_EQ(FixedPoint16::add(minVal, (int16_t)-FixedPoint16::one()), minVal);
+    EXPECT_EQ(FixedPoint16::mul(FixedPoint16::fromFloat(4.0f), FixedPoint16::fromFloat(-4.0f)), minVal);
+    EXPECT_EQ(FixedPoint16::mul(FixedPoint16::fromFloat(0.5f), FixedPoint16::fromFloat(-1.5f)), FixedPoint16::fromFloat(-0.75f));
+
+    // pure fractional formats can't represent 1
+    EXPECT_EQ(FixedPointQ15::one(), maxVal);
+    EXPECT_NEAR(FixedPointQ15::toFloat<double>(FixedPointQ15::sigmoid(maxVal)), 1.0 / (1.0 + std::exp(-1.0)), 1.0e-4);
+}
+
+TEST(TestFixedPoint, modelOutputIsCloseToPythonImplementation)
+{
+    EXPECT_LT(getMaxError<GRUModel<FixedPoint16>>(tests.at("gru"), "FixedPoint16"), 2.0e-3);
+    EXPECT_LT(getMaxError<GRU1DModel<FixedPoint16>>(tests.at("gru_1d"), "FixedPoint16"), 2.0e-3);
+    EXPECT_LT(getMaxError<LSTMModel<FixedPoint16>>(tests.at("lstm"), "FixedPoint16"), 2.0e-3);
+    EXPECT_LT(getMaxError<LSTM1DModel<FixedPoint16>>(tests.at("lstm_1d"), "FixedPoint16"), 2.0e-3);
+
+    EXPECT_LT(getMaxError<GRUModel<FixedPoint32>>(tests.at("gru"), "FixedPoint32"), 2.0e-4);
+    EXPECT_LT(getMaxError<GRU1DModel<FixedPoint32>>(tests.at("gru_1d"), "FixedPoint32"), 2.0e-4);
+    EXPECT_LT(getMaxError<LSTMModel<FixedPoint32>>(tests.at("lstm"), "FixedPoint32"), 2.0e-4);
+    EXPECT_LT(getMaxError<LSTM1DModel<FixedPoint32>>(tests.at("lstm_1d"), "FixedPoint32"), 2.0e-4);
+}
+
+TEST(TestFixedPoint, stateRoundTrips)
+{
+    GRUModel<FixedPoint16> model, otherModel;
+    for(auto* m : { &model, &otherModel })
+    {
+        std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + "models/gru.json", std::ifstream::binary);
+        m->parseJson(jsonStream);
+        m->reset();
+    }
+
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + "test_data/gru_x_python.csv");
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    for(size_t n = 0; n < xData.size() / 2; ++n)
+        model.forward(&xData[n]);
+
+    std::vector<TestType> state(model.getStateSize());
+    model.saveState(state.data());
+    otherModel.loadState(state.data());
+
+    for(size_t n = xData.size() / 2; n < xData.size(); ++n)
+        EXPECT_EQ(otherModel.forward(&xData[n]), model.forward(&xData[n])) << "Index: " << n;
+}
@@ -0,0 +1,124 @@
+#include <gmock/gmock.h>
+
+#include <RTNeural/RTNeural.h>
+#include <random>
+
+namespace
+{
+using TestType = float;
+using namespace RTNeural;
+
+nlohmann::json makeDense(std::mt19937& rng, int in_size, int out_size)
+{
+    std::uniform_real_distribution<TestType> dist(-1.0f, 1.0f);
+    std::vector<std::vector<TestType>> kernel((size_t)in_size, std::vector<TestType>((size_t)out_size));
+    for(auto& row : kernel)
+        for(auto& w : row)
+            w = dist(rng);
+
+    return nlohmann::json { { "type", "dense" }, { "activation", "" }, { "shape", { nullptr, nullptr, out_size } },
+        { "weights", { kernel, std::vector<TestType>((size_t)out_size, 0.1f) } } };
+}
+
+nlohmann::json makeGated(int out_size)
+{
+    return nlohmann::json { { "type", "gated_activation" }, { "activation", "" }, { "shape", { nullptr, nullptr, out_size } } };
+}
+
+/** Checks a templated model against the dynamic model loaded from the same json, one frame at a time and in blocks. */
+template <typename ModelType>
+void checkModel(ModelType& modelT, const nlohmann::json& modelJson)
+{
+    constexpr int numFrames = 100;
+
+    EXPECT_TRUE(modelT.parseJson(modelJson));
+    auto model = json_parser::parseJson<TestType>(modelJson);
+    ASSERT_NE(model, nullptr);
+
+    std::mt19937 rng(0x5eed);
+    std::uniform_real_distribution<TestType> dist(-1.0f, 1.0f);
+    std::vector<TestType> input(numFrames);
+    for(auto& x : input)
+        x = 2.0f * dist(rng);
+
+    std::vector<TestType> expected(numFrames);
+    for(int n = 0; n < numFrames; ++n)
+    {
+        expected[(size_t)n] = model->forward(&input[(size_t)n]);
+        EXPECT_NEAR(modelT.forward(&input[(size_t)n]), expected[(size_t)n], 1.0e-6) << "Index: " << n;
+    }
+
+    std::vector<TestType> output(numFrames);
+    modelT.reset();
+    modelT.processBlock(input.data(), output.data(), numFrames);
+    EXPECT_THAT(output, testing::Pointwise(testing::FloatNear(1.0e-6f), expected));
+}
+} // namespace
+
+TEST(TestGatedActivation, loadsFromJson)
+{
+    std::mt19937 rng(0x5eed);
+    nlohmann::json modelJson;
+    modelJson["in_shape"] = { nullptr, nullptr, 1 };
+    modelJson["layers"] = { makeDense(rng, 1, 16), makeGated(8), makeDense(rng, 8, 1) };
+
+    auto model = json_parser::parseJson<TestType>(modelJson);
+    ASSERT_EQ(model->layers.size(), 3u);
+    EXPECT_NE(dynamic_cast<GatedActivation<TestType>*>(model->layers[1]), nullptr);
+    EXPECT_EQ(model->layers[1]->in_size, 16);
+    EXPECT_EQ(model->layers[1]->out_size, 8);
+
+    ModelT<TestType, 1, 1, DenseT<TestType, 1, 16>, GatedActivationT<TestType, 16>, DenseT<TestType, 8, 1>> modelT;
+    checkModel(modelT, modelJson);
+
+    // the output size must be half of the input size
+    ModelT<TestType, 1, 1, DenseT<TestType, 1, 16>, GatedActivationT<TestType, 8>, DenseT<TestType, 8, 1>> badModelT;
+    EXPECT_FALSE(badModelT.parseJson(modelJson));
+}
+
+TEST(TestGatedActivation, rejectsBadShapes)
+{
+    std::mt19937 rng(0x5eed);
+
+    // the layer shape must be half of the input size
+    nlohmann::json wrongShapeJson;
+    wrongShapeJson["in_shape"] = { nullptr, nullptr, 1 };
+    wrongShapeJson["layers"] = { makeDense(rng, 1, 16), makeGated(6), makeDense(rng, 6, 1) };
+    EXPECT_EQ(json_parser::parseJson<TestType>(wrongShapeJson), nullptr);
+
+    // the input size must be even
+    nlohmann::json oddSizeJson;
+    oddSizeJson["in_shape"] = { nullptr, nullptr, 1 };
+    oddSizeJson["layers"] = { makeDense(rng, 1, 7), makeGated(3), makeDense(rng, 3, 1) };
+    EXPECT_EQ(json_parser::parseJson<TestType>(oddSizeJson), nullptr);
+}
+
+TEST(TestGatedActivation, oddHalvesMatchDynamicModel)
+{
+    // halves which don't line up with the SIMD registers
+    std::mt19937 rng(0x5eed);
+    nlohmann::json modelJson;
+    modelJson["in_shape"] = { nullptr, nullptr, 1 };
+    modelJson["layers"] = { makeDense(rng, 1, 6), makeGated(3), makeDense(rng, 3, 10), makeGated(5), makeDense(rng, 5, 1) };
+
+    ModelT<TestType, 1, 1,
+        DenseT<TestType, 1, 6>, GatedActivationT<TestType, 6>,
+        DenseT<TestType, 3, 10>, GatedActivationT<TestType, 10>,
+        DenseT<TestType, 5, 1>>
+        modelT;
+    checkModel(modelT, modelJson);
+}
+
+TEST(TestGatedActivation, customLayerExampleLoads)
+{
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + "examples/custom_layer_model/test_net.json", std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+
+    ModelT<TestType, 1, 1,
+        DenseT<TestType, 1, 8>, TanhActivationT<TestType, 8>,
+        DenseT<TestType, 8, 8>, GatedActivationT<TestType, 8>,
+        DenseT<TestType, 4, 1>>
+        modelT;
+    checkModel(modelT, modelJson);
+}
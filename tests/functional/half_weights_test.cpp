@@ -0,0 +1,227 @@
+#include <gmock/gmock.h>
+
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include <RTNeural/RTNeural.h>
+#include <iostream>
+#include <random>
+
+namespace
+{
+using TestType = float;
+using namespace RTNeural;
+using json_parser::WeightFormat;
+
+std::unique_ptr<Model<TestType>> loadDynamicModel(const std::string& model_file, WeightFormat weightFormat)
+{
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + model_file, std::ifstream::binary);
+    json_parser::LoadOptions options;
+    options.weightFormat = weightFormat;
+    return json_parser::parseJson<TestType>(jsonStream, options);
+}
+
+/** Runs the model over the test data, and returns the largest error against the reference output. */
+template <typename ModelType>
+double getMaxError(ModelType& model, const TestConfig& test)
+{
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+
+    std::ifstream pythonY(std::string { RTNEURAL_ROOT_DIR } + test.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    model.reset();
+    double maxError = 0.0;
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        alignas(RTNEURAL_DEFAULT_ALIGNMENT) TestType input[] = { xData[n] };
+        maxError = std::max(maxError, std::abs((double)model.forward(input) - (double)yRefData[n]));
+    }
+
+    return maxError;
+}
+} // namespace
+
+TEST(TestHalfWeights, conversionRoundsToNearest)
+{
+    using namespace half_detail;
+
+    // exactly representable values
+    for(auto x : { 0.0f, 1.0f, -2.5f, 0.15625f, -1024.0f })
+    {
+        EXPECT_EQ(toFloat(fromFloat<bfloat16>(x)), x);
+        EXPECT_EQ(toFloat(fromFloat<float16>(x)), x);
+    }
+    EXPECT_EQ(toFloat(fromFloat<float16>(65504.0f)), 65504.0f);
+    EXPECT_EQ(toFloat(fromFloat<float16>(std::ldexp(1.0f, -24))), std::ldexp(1.0f, -24)); // smallest sub-normal
+
+    // ties round to even
+    EXPECT_EQ(toFloat(fromFloat<float16>(1.0f + std::ldexp(1.0f, -11))), 1.0f);
+    EXPECT_EQ(toFloat(fromFloat<float16>(1.0f + 3.0f * std::ldexp(1.0f, -11))), 1.0f + std::ldexp(1.0f, -9));
+    EXPECT_EQ(toFloat(fromFloat<bfloat16>(1.0f + std::ldexp(1.0f, -8))), 1.0f);
+
+    // out of range values
+    EXPECT_TRUE(std::isinf(toFloat(fromFloat<float16>(1.0e5f))));
+    EXPECT_TRUE(std::isnan(toFloat(fromFloat<float16>(std::numeric_limits<float>::quiet_NaN()))));
+    EXPECT_TRUE(std::isnan(toFloat(fromFloat<bfloat16>(std::numeric_limits<float>::quiet_NaN()))));
+    EXPECT_EQ(toFloat(fromFloat<float16>(1.0e-9f)), 0.0f);
+
+    // relative error is within half a unit in the last place
+    std::mt19937 rng(0x5eed);
+    std::uniform_real_distribution<float> dist(-4.0f, 4.0f);
+    for(int n = 0; n < 1000; ++n)
+    {
+        const auto x = dist(rng);
+        EXPECT_NEAR(toFloat(fromFloat<bfloat16>(x)), x, std::abs(x) * std::ldexp(1.0f, -8));
+        EXPECT_NEAR(toFloat(fromFloat<float16>(x)), x, std::abs(x) * std::ldexp(1.0f, -11));
+    }
+}
+
+TEST(TestHalfWeights, dotProductMatchesReference)
+{
+    std::mt19937 rng(0x5eed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    std::vector<float> x(41);
+    std::vector<bfloat16> wb(x.size());
+    std::vector<float16> wh(x.size());
+    for(size_t i = 0; i < x.size(); ++i)
+    {
+        x[i] = dist(rng);
+        wb[i] = half_detail::fromFloat<bfloat16>(dist(rng));
+        wh[i] = half_detail::fromFloat<float16>(dist(rng));
+    }
+
+    for(int count = 0; count <= (int)x.size(); ++count)
+    {
+        double expectedB = 0.0, expectedH = 0.0;
+        for(int i = 0; i < count; ++i)
+        {
+            expectedB += (double)half_detail::toFloat(wb[(size_t)i]) * (double)x[(size_t)i];
+            expectedH += (double)half_detail::toFloat(wh[(size_t)i]) * (double)x[(size_t)i];
+        }
+
+        EXPECT_NEAR(half_detail::dot(wb.data(), x.data(), count), expectedB, 1.0e-5) << "Count: " << count;
+        EXPECT_NEAR(half_detail::dot(wh.data(), x.data(), count), expectedH, 1.0e-5) << "Count: " << count;
+    }
+}
+
+TEST(TestHalfWeights, halfWeightsUseLessMemory)
+{
+    EXPECT_LT(DenseHalf<TestType>(64, 64).getArenaBytes() * 3, Dense<TestType>(64, 64).getArenaBytes() * 2);
+    EXPECT_LT(GRULayerHalf<TestType>(16, 16).getArenaBytes(), GRULayer<TestType>(16, 16).getArenaBytes());
+}
+
+TEST(TestHalfWeights, modelOutputIsCloseToPythonImplementation)
+{
+    for(const auto* name : { "dense", "conv1d", "gru", "gru_1d", "lstm", "lstm_1d" })
+    {
+        const auto& test = tests.at(name);
+        auto floatModel = loadDynamicModel(test.model_file, WeightFormat::Float);
+        auto bf16Model = loadDynamicModel(test.model_file, WeightFormat::BFloat16);
+        auto fp16Model = loadDynamicModel(test.model_file, WeightFormat::Float16);
+
+        const auto floatError = getMaxError(*floatModel, test);
+        const auto bf16Error = getMaxError(*bf16Model, test);
+        const auto fp16Error = getMaxError(*fp16Model, test);
+        std::cout << test.name << " max error: fp32 " << floatError << ", bf16 " << bf16Error << ", fp16 " << fp16Error << std::endl;
+
+        EXPECT_LT(bf16Error, 5.0e-3) << test.name;
+        EXPECT_LT(fp16Error, 5.0e-4) << test.name;
+    }
+}
+
+TEST(TestHalfWeights, templatedModelMatchesDynamicModel)
+{
+    using ModelType = ModelT<TestType, 1, 1,
+        DenseHalfT<TestType, 1, 8, float16>,
+        TanhActivationT<TestType, 8>,
+        Conv1DHalfT<TestType, 8, 4, 3, 2, 1, float16>,
+        TanhActivationT<TestType, 4>,
+        GRULayerHalfT<TestType, 4, 8, float16>,
+        DenseHalfT<TestType, 8, 1, float16>>;
+
+    ModelType modelT;
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + "models/full_model.json", std::ifstream::binary);
+    EXPECT_TRUE(modelT.parseJson(jsonStream));
+
+    auto dynamicModel = loadDynamicModel("models/full_model.json", WeightFormat::Float16);
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + "test_data/dense_x_python.csv");
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+
+    modelT.reset();
+    dynamicModel->reset();
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        alignas(RTNEURAL_DEFAULT_ALIGNMENT) TestType input[] = { xData[n] };
+        EXPECT_NEAR(modelT.forward(input), dynamicModel->forward(input), 1.0e-5) << "Index: " << n;
+    }
+}
+
+TEST(TestHalfWeights, lstmStateRoundTrips)
+{
+    using ModelType = ModelT<TestType, 1, 1,
+        DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        LSTMLayerHalfT<TestType, 8, 8>,
+        DenseT<TestType, 8, 1>>;
+
+    ModelType model, otherModel;
+    for(auto* m : { &model, &otherModel })
+    {
+        std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + "models/lstm.json", std::ifstream::binary);
+        EXPECT_TRUE(m->parseJson(jsonStream));
+        m->reset();
+    }
+
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + "test_data/lstm_x_python.csv");
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    for(size_t n = 0; n < xData.size() / 2; ++n)
+        model.forward(&xData[n]);
+
+    std::vector<TestType> state(model.getStateSize());
+    model.saveState(state.data());
+    otherModel.loadState(state.data());
+
+    for(size_t n = xData.size() / 2; n < xData.size(); ++n)
+        EXPECT_EQ(otherModel.forward(&xData[n]), model.forward(&xData[n])) << "Index: " << n;
+}
+
+TEST(TestHalfWeights, recurrentLayersUseMathsProvider)
+{
+    using DefaultModelType = ModelT<TestType, 1, 1,
+        DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        LSTMLayerHalfT<TestType, 8, 8>,
+        DenseT<TestType, 8, 1>>;
+    using ApproxModelType = ModelT<TestType, 1, 1,
+        DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        LSTMLayerHalfT<TestType, 8, 8, bfloat16, Exp2SigmoidMathsProvider>,
+        DenseT<TestType, 8, 1>>;
+
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + "models/lstm.json", std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+
+    DefaultModelType defaultModel;
+    ApproxModelType approxModel;
+    EXPECT_TRUE(defaultModel.parseJson(modelJson));
+    EXPECT_TRUE(approxModel.parseJson(modelJson));
+    defaultModel.reset();
+    approxModel.reset();
+
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + "test_data/lstm_x_python.csv");
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+
+    // the approximations are close to the standard functions, but not exact
+    bool anyDifferent = false;
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        const auto expected = defaultModel.forward(&xData[n]);
+        const auto actual = approxModel.forward(&xData[n]);
+        EXPECT_NEAR(actual, expected, 1.0e-3) << "Index: " << n;
+        anyDifferent |= actual != expected;
+    }
+    EXPECT_TRUE(anyDifferent);
+}
@@ -0,0 +1,210 @@
+#include <gmock/gmock.h>
+
+#include <RTNeural/RTNeural.h>
+#include <random>
+
+namespace
+{
+using TestType = float;
+using namespace RTNeural;
+
+/** Returns a random out_size x in_size matrix with the given rank. */
+std::vector<std::vector<TestType>> makeLowRankWeights(int in_size, int out_size, int rank, std::mt19937& rng)
+{
+    std::uniform_real_distribution<TestType> dist(-1.0f, 1.0f);
+    std::vector<std::vector<TestType>> left((size_t)out_size, std::vector<TestType>((size_t)rank));
+    std::vector<std::vector<TestType>> right((size_t)rank, std::vector<TestType>((size_t)in_size));
+    for(auto& row : left)
+        for(auto& w : row)
+            w = dist(rng);
+    for(auto& row : right)
+        for(auto& w : row)
+            w = dist(rng);
+
+    std::vector<std::vector<TestType>> weights((size_t)out_size, std::vector<TestType>((size_t)in_size, 0.0f));
+    for(int i = 0; i < out_size; ++i)
+        for(int k = 0; k < in_size; ++k)
+            for(int r = 0; r < rank; ++r)
+                weights[(size_t)i][(size_t)k] += left[(size_t)i][(size_t)r] * right[(size_t)r][(size_t)k];
+
+    return weights;
+}
+
+/** Returns a json model with a dense layer (with the given weights[out_size][in_size]), followed by a 1-output dense layer. */
+nlohmann::json makeModelJson(const std::vector<std::vector<TestType>>& weights, std::mt19937& rng)
+{
+    std::uniform_real_distribution<TestType> dist(-1.0f, 1.0f);
+    const auto out_size = weights.size();
+    const auto in_size = weights[0].size();
+
+    nlohmann::json kernel = nlohmann::json::array();
+    for(size_t k = 0; k < in_size; ++k)
+    {
+        std::vector<TestType> row(out_size);
+        for(size_t i = 0; i < out_size; ++i)
+            row[i] = weights[i][k];
+        kernel.push_back(row);
+    }
+
+    std::vector<TestType> bias(out_size), outKernel(out_size);
+    for(size_t i = 0; i < out_size; ++i)
+    {
+        bias[i] = dist(rng);
+        outKernel[i] = dist(rng);
+    }
+
+    nlohmann::json outWeights = nlohmann::json::array();
+    for(auto w : outKernel)
+        outWeights.push_back(std::vector<TestType> { w });
+
+    nlohmann::json modelJson;
+    modelJson["in_shape"] = { nullptr, nullptr, in_size };
+    modelJson["layers"] = nlohmann::json::array();
+    modelJson["layers"].push_back({ { "type", "dense" }, { "activation", "tanh" }, { "shape", { nullptr, nullptr, out_size } },
+        { "weights", { kernel, bias } } });
+    modelJson["layers"].push_back({ { "type", "dense" }, { "activation", "" }, { "shape", { nullptr, nullptr, 1 } },
+        { "weights", { outWeights, std::vector<TestType> { 0.1f } } } });
+    return modelJson;
+}
+
+std::vector<TestType> makeInput(int size, std::mt19937& rng)
+{
+    std::uniform_real_distribution<TestType> dist(-1.0f, 1.0f);
+    std::vector<TestType> input((size_t)size);
+    for(auto& x : input)
+        x = dist(rng);
+    return input;
+}
+
+/** Loading options which never use the sparse layers, so that the dense layers are either full or low-rank. */
+json_parser::LoadOptions withLowRankTolerance(float lowRankTolerance)
+{
+    json_parser::LoadOptions options;
+    options.sparsityThreshold = 2.0f;
+    options.lowRankTolerance = lowRankTolerance;
+    return options;
+}
+} // namespace
+
+TEST(TestLowRankDense, factorizationFindsTheRank)
+{
+    std::mt19937 rng(0x5eed);
+    for(const auto& dims : std::vector<std::pair<int, int>> { { 64, 48 }, { 24, 64 }, { 17, 17 } })
+    {
+        const auto weights = makeLowRankWeights(dims.first, dims.second, 3, rng);
+        DenseLowRank<TestType> dense(dims.first, dims.second);
+        dense.setTolerance(1.0e-5f);
+        dense.setWeights(weights);
+
+        EXPECT_EQ(dense.getRank(), 3) << dims.first << "x" << dims.second;
+        for(int i = 0; i < dims.second; ++i)
+            for(int k = 0; k < dims.first; ++k)
+                EXPECT_NEAR(dense.getWeight(i, k), weights[(size_t)i][(size_t)k], 1.0e-4f);
+    }
+}
+
+TEST(TestLowRankDense, errorIsWithinTolerance)
+{
+    std::mt19937 rng(0x5eed);
+    const auto weights = makeLowRankWeights(32, 32, 32, rng);
+
+    for(float tolerance : { 0.05f, 0.2f, 0.5f })
+    {
+        DenseLowRank<TestType> dense(32, 32);
+        dense.setTolerance(tolerance);
+        dense.setWeights(weights);
+        EXPECT_LT(dense.getRank(), 32);
+
+        double norm = 0.0, error = 0.0;
+        for(int i = 0; i < 32; ++i)
+        {
+            for(int k = 0; k < 32; ++k)
+            {
+                const auto w = (double)weights[(size_t)i][(size_t)k];
+                const auto diff = (double)dense.getWeight(i, k) - w;
+                norm += w * w;
+                error += diff * diff;
+            }
+        }
+        EXPECT_LE(std::sqrt(error), tolerance * std::sqrt(norm) * 1.001) << "Tolerance: " << tolerance;
+    }
+}
+
+TEST(TestLowRankDense, toleranceChoosesLayers)
+{
+    std::mt19937 rng(0x5eed);
+    const auto modelJson = makeModelJson(makeLowRankWeights(64, 64, 4, rng), rng);
+
+    auto lowRankModel = json_parser::parseJson<TestType>(modelJson, withLowRankTolerance(1.0e-4f));
+    ASSERT_NE(dynamic_cast<DenseLowRank<TestType>*>(lowRankModel->layers[0]), nullptr);
+    EXPECT_EQ(dynamic_cast<DenseLowRank<TestType>*>(lowRankModel->layers[0])->getRank(), 4);
+    EXPECT_NE(dynamic_cast<Dense<TestType>*>(lowRankModel->layers[2]), nullptr); // 64x1 is already cheaper than any factorization
+
+    auto denseModel = json_parser::parseJson<TestType>(modelJson, withLowRankTolerance(0.0f));
+    EXPECT_NE(dynamic_cast<Dense<TestType>*>(denseModel->layers[0]), nullptr);
+
+    // full-rank weights stay dense
+    const auto fullRankJson = makeModelJson(makeLowRankWeights(64, 64, 64, rng), rng);
+    auto fullRankModel = json_parser::parseJson<TestType>(fullRankJson, withLowRankTolerance(1.0e-4f));
+    EXPECT_NE(dynamic_cast<Dense<TestType>*>(fullRankModel->layers[0]), nullptr);
+
+    lowRankModel->allocateArena();
+    for(int n = 0; n < 50; ++n)
+    {
+        auto input = makeInput(64, rng);
+        EXPECT_NEAR(lowRankModel->forward(input.data()), denseModel->forward(input.data()), 1.0e-4) << "Index: " << n;
+    }
+}
+
+TEST(TestLowRankDense, preFactoredWeights)
+{
+    std::mt19937 rng(0x5eed);
+    std::uniform_real_distribution<TestType> dist(-1.0f, 1.0f);
+    auto modelJson = makeModelJson(makeLowRankWeights(16, 8, 8, rng), rng);
+
+    // kernel = a * b, with sizes [in_size][rank] and [rank][out_size]
+    std::vector<std::vector<TestType>> a(16, std::vector<TestType>(2)), b(2, std::vector<TestType>(8));
+    for(auto& row : a)
+        for(auto& w : row)
+            w = dist(rng);
+    for(auto& row : b)
+        for(auto& w : row)
+            w = dist(rng);
+    const auto bias = modelJson["layers"][0]["weights"][1];
+    modelJson["layers"][0]["weights"] = { a, b, bias };
+
+    auto model = json_parser::parseJson<TestType>(modelJson);
+    auto* dense = dynamic_cast<DenseLowRank<TestType>*>(model->layers[0]);
+    ASSERT_NE(dense, nullptr);
+    EXPECT_EQ(dense->getRank(), 2);
+
+    ModelT<TestType, 16, 1, DenseLowRankT<TestType, 16, 8>, TanhActivationT<TestType, 8>, DenseT<TestType, 8, 1>> lowRankModelT;
+    ModelT<TestType, 16, 1, DenseT<TestType, 16, 8>, TanhActivationT<TestType, 8>, DenseT<TestType, 8, 1>> denseModelT;
+    EXPECT_TRUE(lowRankModelT.parseJson(modelJson));
+    EXPECT_TRUE(denseModelT.parseJson(modelJson));
+    EXPECT_EQ(lowRankModelT.get<0>().getRank(), 2);
+
+    for(int n = 0; n < 50; ++n)
+    {
+        auto input = makeInput(16, rng);
+        const auto expected = denseModelT.forward(input.data());
+        EXPECT_NEAR(model->forward(input.data()), expected, 1.0e-5) << "Index: " << n;
+        EXPECT_NEAR(lowRankModelT.forward(input.data()), expected, 1.0e-5) << "Index: " << n;
+    }
+}
+
+TEST(TestLowRankDense, templatedLayerIsTruncatedToMaxRank)
+{
+    std::mt19937 rng(0x5eed);
+    const auto weights = makeLowRankWeights(32, 32, 32, rng);
+
+    DenseLowRankT<TestType, 32, 32, 6> dense;
+    dense.setTolerance(1.0e-5f);
+    dense.setWeights(weights);
+    EXPECT_EQ(dense.getRank(), 6);
+
+    DenseLowRank<TestType> dynamicDense(32, 32);
+    dynamicDense.setTolerance(0.0f);
+    dynamicDense.setWeights(weights);
+    EXPECT_EQ(dynamicDense.getRank(), 32);
+}
@@ -0,0 +1,171 @@
+#include <gmock/gmock.h>
+
+#include <RTNeural/RTNeural.h>
+#include <random>
+
+namespace
+{
+using TestType = float;
+using namespace RTNeural;
+
+/** Returns evenly spaced values over [-20, 20]. */
+std::vector<TestType> makeInputs()
+{
+    std::vector<TestType> input(40001);
+    for(size_t i = 0; i < input.size(); ++i)
+        input[i] = -20.0f + 40.0f * (TestType)i / (TestType)(input.size() - 1);
+    return input;
+}
+
+double evaluate(LUTFunction func, double x)
+{
+    if(func == LUTFunction::Tanh)
+        return std::tanh(x);
+    if(func == LUTFunction::Sigmoid)
+        return 1.0 / (1.0 + std::exp(-x));
+    return x > 0.0 ? x : std::exp(x) - 1.0;
+}
+
+double getMaxError(LUTFunction func, const std::vector<TestType>& input, const std::vector<TestType>& output)
+{
+    double maxError = 0.0;
+    for(size_t i = 0; i < input.size(); ++i)
+        maxError = std::max(maxError, std::abs((double)output[i] - evaluate(func, (double)input[i])));
+    return maxError;
+}
+
+template <LUTFunction func, int tableSize>
+void checkStaticLayer()
+{
+    constexpr int size = 8;
+    LUTActivationT<TestType, size, func, tableSize> layer;
+    const auto input = makeInputs();
+    std::vector<TestType> output(input.size());
+
+    for(size_t n = 0; n + size <= input.size(); n += size)
+    {
+#if RTNEURAL_USE_EIGEN
+        layer.forward(Eigen::Map<const Eigen::Matrix<TestType, size, 1>>(input.data() + n));
+        std::copy(layer.outs.data(), layer.outs.data() + size, output.begin() + (long)n);
+#elif RTNEURAL_USE_XSIMD
+        alignas(RTNEURAL_DEFAULT_ALIGNMENT) TestType ins[size];
+        std::copy(input.begin() + (long)n, input.begin() + (long)n + size, ins);
+        xsimd::simd_type<TestType> vIns[ceil_div(size, (int)xsimd::simd_type<TestType>::size)];
+        for(int i = 0; i < ceil_div(size, (int)xsimd::simd_type<TestType>::size); ++i)
+            vIns[i] = xsimd::load_aligned(ins + i * (int)xsimd::simd_type<TestType>::size);
+        layer.forward(vIns);
+        std::copy(reinterpret_cast<TestType*>(layer.outs), reinterpret_cast<TestType*>(layer.outs) + size, output.begin() + (long)n);
+#else
+        TestType ins[size];
+        std::copy(input.begin() + (long)n, input.begin() + (long)n + size, ins);
+        layer.forward(ins);
+        std::copy(std::begin(layer.outs), std::end(layer.outs), output.begin() + (long)n);
+#endif
+    }
+
+    output.back() = (TestType)evaluate(func, (double)input.back()); // the last value doesn't fill a frame
+    EXPECT_LE(getMaxError(func, input, output), layer.getMaxError()) << lut_detail::getName(func) << ", table size: " << tableSize;
+}
+} // namespace
+
+TEST(TestLUTActivation, errorIsWithinBound)
+{
+    const auto input = makeInputs();
+    std::vector<TestType> output(input.size());
+
+    for(auto func : { LUTFunction::Tanh, LUTFunction::Sigmoid, LUTFunction::ELu })
+    {
+        for(int tableSize : { 64, 512, 2048 })
+        {
+            LUTActivation<TestType> layer((int)input.size(), func, tableSize);
+            layer.forward(input.data(), output.data());
+
+            const auto maxError = getMaxError(func, input, output);
+            EXPECT_LE(maxError, layer.getMaxError()) << layer.getName() << ", table size: " << tableSize;
+        }
+    }
+
+    EXPECT_LT(lut_detail::getMaxError<TestType>(LUTFunction::Tanh, 2048), 1.0e-5);
+    EXPECT_LT(lut_detail::getMaxError<TestType>(LUTFunction::Sigmoid, 2048), 1.0e-5);
+    EXPECT_LT(lut_detail::getMaxError<TestType>(LUTFunction::ELu, 2048), 1.0e-5);
+}
+
+TEST(TestLUTActivation, staticErrorIsWithinBound)
+{
+    checkStaticLayer<LUTFunction::Tanh, 2048>();
+    checkStaticLayer<LUTFunction::Sigmoid, 2048>();
+    checkStaticLayer<LUTFunction::ELu, 2048>();
+    checkStaticLayer<LUTFunction::Tanh, 100>();
+}
+
+TEST(TestLUTActivation, extremeInputsAreClamped)
+{
+    const auto input = std::vector<TestType> {
+        -std::numeric_limits<TestType>::infinity(),
+        -1.0e30f,
+        1.0e30f,
+        std::numeric_limits<TestType>::infinity(),
+        std::numeric_limits<TestType>::quiet_NaN(),
+    };
+    std::vector<TestType> output(input.size());
+
+    LUTActivation<TestType>((int)input.size(), LUTFunction::Tanh).forward(input.data(), output.data());
+    EXPECT_THAT(output, testing::Pointwise(testing::FloatNear(1.0e-6f), std::vector<TestType> { -1.0f, -1.0f, 1.0f, 1.0f, -1.0f }));
+
+    LUTActivation<TestType>((int)input.size(), LUTFunction::Sigmoid).forward(input.data(), output.data());
+    EXPECT_THAT(output, testing::Pointwise(testing::FloatNear(1.0e-6f), std::vector<TestType> { 0.0f, 0.0f, 1.0f, 1.0f, 0.0f }));
+}
+
+TEST(TestLUTActivation, tableSizeChoosesLayers)
+{
+    std::mt19937 rng(0x5eed);
+    std::uniform_real_distribution<TestType> dist(-1.0f, 1.0f);
+
+    auto makeDense = [&](int in_size, int out_size, const std::string& activation)
+    {
+        std::vector<std::vector<TestType>> kernel((size_t)in_size, std::vector<TestType>((size_t)out_size));
+        for(auto& row : kernel)
+            for(auto& w : row)
+                w = 2.0f * dist(rng);
+
+        return nlohmann::json { { "type", "dense" }, { "activation", activation }, { "shape", { nullptr, nullptr, out_size } },
+            { "weights", { kernel, std::vector<TestType>((size_t)out_size, 0.0f) } } };
+    };
+
+    nlohmann::json modelJson;
+    modelJson["in_shape"] = { nullptr, nullptr, 4 };
+    modelJson["layers"] = { makeDense(4, 8, "tanh"), makeDense(8, 8, "elu"), makeDense(8, 1, "sigmoid") };
+    modelJson["layers"][1]["activation_table_size"] = 0; // uses the exact ELU
+
+    json_parser::LoadOptions options;
+    options.activationTableSize = 2048;
+    auto model = json_parser::parseJson<TestType>(modelJson, options);
+    auto exactModel = json_parser::parseJson<TestType>(modelJson);
+
+    auto* tanh = dynamic_cast<LUTActivation<TestType>*>(model->layers[1]);
+    ASSERT_NE(tanh, nullptr);
+    EXPECT_EQ(tanh->getFunction(), LUTFunction::Tanh);
+    EXPECT_EQ(tanh->getTableSize(), 2048);
+    EXPECT_EQ(dynamic_cast<LUTActivation<TestType>*>(model->layers[3]), nullptr);
+    EXPECT_NE(dynamic_cast<LUTActivation<TestType>*>(model->layers[5]), nullptr);
+    EXPECT_EQ(dynamic_cast<LUTActivation<TestType>*>(exactModel->layers[1]), nullptr);
+
+    ModelT<TestType, 4, 1,
+        DenseT<TestType, 4, 8>, LUTActivationT<TestType, 8, LUTFunction::Tanh>,
+        DenseT<TestType, 8, 8>, ELuActivationT<TestType, 8>,
+        DenseT<TestType, 8, 1>, LUTActivationT<TestType, 1, LUTFunction::Sigmoid>>
+        modelT;
+    EXPECT_TRUE(modelT.parseJson(modelJson));
+
+    model->allocateArena();
+    for(int n = 0; n < 50; ++n)
+    {
+        alignas(RTNEURAL_DEFAULT_ALIGNMENT) TestType input[4];
+        for(auto& x : input)
+            x = dist(rng);
+
+        const auto expected = exactModel->forward(input);
+        EXPECT_NEAR(model->forward(input), expected, 1.0e-4) << "Index: " << n;
+        EXPECT_NEAR(modelT.forward(input), expected, 1.0e-4) << "Index: " << n;
+    }
+}
@@ -0,0 +1,190 @@
+#include <gmock/gmock.h>
+
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include <RTNeural/RTNeural.h>
+
+namespace
+{
+using namespace RTNeural;
+
+template <typename ModelType>
+void loadStaticModel(ModelType& model, const std::string& file)
+{
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + file, std::ifstream::binary);
+    EXPECT_TRUE(model.parseJson(jsonStream));
+}
+
+template <typename ModelType>
+std::vector<float> runModel(ModelType& model, const std::vector<float>& xData)
+{
+    std::vector<float> yData(xData.size(), 0.0f);
+    model.reset();
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        alignas(RTNEURAL_DEFAULT_ALIGNMENT) float input[] = { xData[n] };
+        yData[n] = model.forward(input);
+    }
+    return yData;
+}
+
+/** Checks a model with float and double layers against the same model with only double layers. */
+template <typename MixedModelType, typename DoubleModelType>
+void runMixedPrecisionTest(const TestConfig& test, double threshold)
+{
+    MixedModelType mixedModel;
+    loadStaticModel(mixedModel, test.model_file);
+
+    DoubleModelType doubleModel;
+    loadStaticModel(doubleModel, test.model_file);
+
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + test.x_data_file);
+    const auto xData = load_csv::loadFile<float>(pythonX);
+
+    std::ifstream pythonY(std::string { RTNEURAL_ROOT_DIR } + test.y_data_file);
+    const auto yRefData = load_csv::loadFile<float>(pythonY);
+
+    const auto yData = runModel(mixedModel, xData);
+    doubleModel.reset();
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        alignas(RTNEURAL_DEFAULT_ALIGNMENT) double input[] = { (double)xData[n] };
+        EXPECT_NEAR(yData[n], doubleModel.forward(input), threshold) << "Index: " << n;
+        EXPECT_NEAR(yData[n], yRefData[n], test.threshold * 10) << "Index: " << n;
+    }
+}
+} // namespace
+
+TEST(TestMixedPrecision, doubleRecurrentLayerInFloatModel)
+{
+    using MixedModelType = ModelT<float, 1, 1,
+        DenseT<float, 1, 8>,
+        TanhActivationT<float, 8>,
+        LSTMLayerT<double, 8, 8>,
+        DenseT<float, 8, 1>>;
+
+    using DoubleModelType = ModelT<double, 1, 1,
+        DenseT<double, 1, 8>,
+        TanhActivationT<double, 8>,
+        LSTMLayerT<double, 8, 8>,
+        DenseT<double, 8, 1>>;
+
+    runMixedPrecisionTest<MixedModelType, DoubleModelType>(tests.at("lstm"), 1.0e-5);
+}
+
+TEST(TestMixedPrecision, doubleInputAndOutputLayers)
+{
+    using MixedModelType = ModelT<float, 1, 1,
+        DenseT<double, 1, 8>,
+        TanhActivationT<double, 8>,
+        GRULayerT<float, 8, 8>,
+        DenseT<float, 8, 8>,
+        SigmoidActivationT<float, 8>,
+        DenseT<double, 8, 1>>;
+
+    using DoubleModelType = ModelT<double, 1, 1,
+        DenseT<double, 1, 8>,
+        TanhActivationT<double, 8>,
+        GRULayerT<double, 8, 8>,
+        DenseT<double, 8, 8>,
+        SigmoidActivationT<double, 8>,
+        DenseT<double, 8, 1>>;
+
+    runMixedPrecisionTest<MixedModelType, DoubleModelType>(tests.at("gru"), 1.0e-5);
+}
+
+TEST(TestMixedPrecision, processBlockMatchesForward)
+{
+    using ModelType = ModelT<float, 1, 1,
+        DenseT<float, 1, 8>,
+        TanhActivationT<float, 8>,
+        Conv1DT<float, 8, 4, 3, 2>,
+        TanhActivationT<float, 4>,
+        GRULayerT<double, 4, 8>,
+        DenseT<float, 8, 1>>;
+
+    ModelType model;
+    loadStaticModel(model, "models/full_model.json");
+
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + "test_data/dense_x_python.csv");
+    const auto xData = load_csv::loadFile<float>(pythonX);
+    const auto expected = runModel(model, xData);
+
+    std::vector<float> actual(xData.size());
+    model.reset();
+    model.processBlock(xData.data(), actual.data(), (int)xData.size());
+    EXPECT_EQ(actual, expected);
+    EXPECT_EQ(*model.getOutputs(), expected.back());
+}
+
+TEST(TestMixedPrecision, stateIsConvertedToModelType)
+{
+    using ModelType = ModelT<float, 1, 1,
+        DenseT<float, 1, 8>,
+        TanhActivationT<float, 8>,
+        LSTMLayerT<double, 8, 8>,
+        DenseT<float, 8, 1>>;
+
+    ModelType model, otherModel;
+    loadStaticModel(model, "models/lstm.json");
+    loadStaticModel(otherModel, "models/lstm.json");
+    const auto lstmStateSize = LSTMLayerT<double, 8, 8> {}.getStateSize();
+    EXPECT_EQ(model.getStateSize(), lstmStateSize);
+
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + "test_data/lstm_x_python.csv");
+    const auto xData = load_csv::loadFile<float>(pythonX);
+
+    model.reset();
+    otherModel.reset();
+    for(size_t n = 0; n < xData.size() / 2; ++n)
+        model.forward(&xData[n]);
+
+    std::vector<float> state(model.getStateSize());
+    EXPECT_TRUE(model.saveState(state.data()));
+    EXPECT_TRUE(otherModel.loadState(state.data()));
+
+    // the state is rounded to float, so the outputs are close, but not exact
+    for(size_t n = xData.size() / 2; n < xData.size(); ++n)
+        EXPECT_NEAR(otherModel.forward(&xData[n]), model.forward(&xData[n]), 1.0e-6) << "Index: " << n;
+}
+
+TEST(TestMixedPrecision, stateConversionFollowsStateSize)
+{
+    using ModelType = ModelT<float, 1, 1,
+        DenseT<float, 1, 8>,
+        TanhActivationT<float, 8>,
+        LSTMLayerT<double, 8, 8, SampleRateCorrectionMode::NoInterp>,
+        DenseT<float, 8, 1>>;
+
+    ModelType model, otherModel;
+    loadStaticModel(model, "models/lstm.json");
+    loadStaticModel(otherModel, "models/lstm.json");
+
+    // a longer delay line makes the layer state bigger than when the model was constructed
+    const auto initialStateSize = model.getStateSize();
+    model.get<2>().prepare(4);
+    otherModel.get<2>().prepare(4);
+    ASSERT_GT(model.getStateSize(), initialStateSize);
+
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + "test_data/lstm_x_python.csv");
+    const auto xData = load_csv::loadFile<float>(pythonX);
+
+    model.reset();
+    otherModel.reset();
+    for(size_t n = 0; n < xData.size() / 2; ++n)
+        model.forward(&xData[n]);
+
+    // until the conversion memory is re-allocated, the state can't be saved or loaded
+    std::vector<float> state(model.getStateSize(), 1.0f);
+    EXPECT_FALSE(model.saveState(state.data()));
+    EXPECT_THAT(state, testing::Each(1.0f));
+    EXPECT_FALSE(otherModel.loadState(state.data()));
+
+    model.prepareStateConversion();
+    otherModel.prepareStateConversion();
+    EXPECT_TRUE(model.saveState(state.data()));
+    EXPECT_TRUE(otherModel.loadState(state.data()));
+
+    for(size_t n = xData.size() / 2; n < xData.size(); ++n)
+        EXPECT_NEAR(otherModel.forward(&xData[n]), model.forward(&xData[n]), 1.0e-6) << "Index: " << n;
+}
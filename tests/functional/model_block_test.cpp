@@ -0,0 +1,199 @@
+#include <gmock/gmock.h>
+
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include <RTNeural/RTNeural.h>
+
+namespace
+{
+using TestType = double;
+constexpr int maxInSize = 16;
+
+auto loadDynamicModel(const std::string& model_file)
+{
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + model_file, std::ifstream::binary);
+    return RTNeural::json_parser::parseJson<TestType>(jsonStream);
+}
+
+auto loadInputData(const std::string& data_file)
+{
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + data_file);
+    return load_csv::loadFile<TestType>(pythonX);
+}
+
+std::vector<TestType> processFrameByFrame(RTNeural::Model<TestType>& model, const std::vector<TestType>& xData)
+{
+    const auto inSize = model.getInSize();
+    const auto outSize = model.getOutSize();
+    const auto numFrames = (int)xData.size() / inSize;
+
+    TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[maxInSize];
+    std::vector<TestType> yData((size_t)(numFrames * outSize), (TestType)0);
+
+    model.reset();
+    for(int n = 0; n < numFrames; ++n)
+    {
+        std::copy(xData.begin() + n * inSize, xData.begin() + (n + 1) * inSize, input);
+        model.forward(input);
+        std::copy(model.getOutputs(), model.getOutputs() + outSize, yData.begin() + n * outSize);
+    }
+
+    return yData;
+}
+
+std::vector<TestType> processInBlocks(RTNeural::Model<TestType>& model, const std::vector<TestType>& xData, const std::vector<int>& blockSizes)
+{
+    const auto inSize = model.getInSize();
+    const auto outSize = model.getOutSize();
+    const auto numFrames = (int)xData.size() / inSize;
+
+    std::vector<TestType> yData((size_t)(numFrames * outSize), (TestType)0);
+
+    model.reset();
+    for(int n = 0, blockIdx = 0; n < numFrames; ++blockIdx)
+    {
+        const auto blockSize = std::min(blockSizes[(size_t)blockIdx % blockSizes.size()], numFrames - n);
+        model.forward(xData.data() + n * inSize, yData.data() + n * outSize, blockSize);
+        n += blockSize;
+    }
+
+    return yData;
+}
+
+void runBlockTest(const std::string& model_file, const std::string& data_file, int maxBlockSize)
+{
+    constexpr double threshold = 1.0e-12;
+
+    auto xData = loadInputData(data_file);
+    auto model = loadDynamicModel(model_file);
+    model->prepare(maxBlockSize);
+    ASSERT_LE(model->getInSize(), maxInSize);
+
+    const auto yRefData = processFrameByFrame(*model, xData);
+
+    // odd-sized blocks, including blocks larger than the maximum block size
+    const auto yData = processInBlocks(*model, xData, { 1, 7, 32, 100, 3 });
+
+    using namespace testing;
+    EXPECT_THAT(yData, Pointwise(DoubleNear(threshold), yRefData));
+    EXPECT_THAT(std::vector<TestType>(model->getOutputs(), model->getOutputs() + model->getOutSize()),
+        Pointwise(DoubleNear(threshold), std::vector<TestType>(yRefData.end() - model->getOutSize(), yRefData.end())));
+}
+
+template <typename ModelType>
+void runTemplatedBlockTest(const std::string& model_file, const std::string& data_file)
+{
+    constexpr double threshold = 1.0e-12;
+    constexpr auto inSize = ModelType::input_size;
+    constexpr auto outSize = ModelType::output_size;
+
+    const auto xData = loadInputData(data_file);
+    const auto numFrames = (int)xData.size() / inSize;
+
+    ModelType model;
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + model_file, std::ifstream::binary);
+    model.parseJson(jsonStream);
+
+    std::vector<TestType> yRefData((size_t)(numFrames * outSize), (TestType)0);
+    model.reset();
+    for(int n = 0; n < numFrames; ++n)
+    {
+        TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[maxInSize] {};
+        std::copy(xData.begin() + n * inSize, xData.begin() + (n + 1) * inSize, input);
+        model.forward(input);
+        std::copy(model.getOutputs(), model.getOutputs() + outSize, yRefData.begin() + n * outSize);
+    }
+
+    // odd-sized blocks, including blocks larger than RTNEURAL_MODELT_BLOCK_SIZE
+    const std::vector<int> blockSizes { 1, 7, 32, 100, 3 };
+    std::vector<TestType> yData((size_t)(numFrames * outSize), (TestType)0);
+    model.reset();
+    for(int n = 0, blockIdx = 0; n < numFrames; ++blockIdx)
+    {
+        const auto blockSize = std::min(blockSizes[(size_t)blockIdx % blockSizes.size()], numFrames - n);
+        model.processBlock(xData.data() + n * inSize, yData.data() + n * outSize, blockSize);
+        n += blockSize;
+    }
+
+    using namespace testing;
+    EXPECT_THAT(yData, Pointwise(DoubleNear(threshold), yRefData));
+    EXPECT_THAT(std::vector<TestType>(model.getOutputs(), model.getOutputs() + outSize),
+        Pointwise(DoubleNear(threshold), std::vector<TestType>(yRefData.end() - outSize, yRefData.end())));
+}
+}
+
+TEST(TestModelBlock, blockOutputMatchesFrameOutput)
+{
+    for(const auto& testConfig : tests)
+    {
+        SCOPED_TRACE(testConfig.second.name);
+        runBlockTest(testConfig.second.model_file, testConfig.second.x_data_file, 64);
+    }
+}
+
+TEST(TestModelBlock, blockOutputMatchesFrameOutputFullModel)
+{
+    runBlockTest("models/full_model.json", "test_data/dense_x_python.csv", 64);
+}
+
+TEST(TestModelBlock, blocksLargerThanMaxBlockSize)
+{
+    runBlockTest("models/full_model.json", "test_data/dense_x_python.csv", 16);
+}
+
+TEST(TestModelBlock, templatedBlockOutputMatchesFrameOutputDense)
+{
+    using namespace RTNeural;
+    using ModelType = ModelT<TestType, 1, 1,
+        DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        DenseT<TestType, 8, 8>,
+        ReLuActivationT<TestType, 8>,
+        DenseT<TestType, 8, 8>,
+        ELuActivationT<TestType, 8>,
+        DenseT<TestType, 8, 8>,
+        SoftmaxActivationT<TestType, 8>,
+        DenseT<TestType, 8, 1>>;
+
+    runTemplatedBlockTest<ModelType>(tests.at("dense").model_file, tests.at("dense").x_data_file);
+}
+
+TEST(TestModelBlock, templatedBlockOutputMatchesFrameOutputFullModel)
+{
+    using namespace RTNeural;
+    using ModelType = ModelT<TestType, 1, 1,
+        DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        Conv1DT<TestType, 8, 4, 3, 2>,
+        TanhActivationT<TestType, 4>,
+        GRULayerT<TestType, 4, 8>,
+        DenseT<TestType, 8, 1>>;
+
+    runTemplatedBlockTest<ModelType>("models/full_model.json", "test_data/dense_x_python.csv");
+}
+
+TEST(TestModelBlock, templatedBlockOutputMatchesFrameOutputGRU)
+{
+    using namespace RTNeural;
+    using ModelType = ModelT<TestType, 1, 1,
+        DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        GRULayerT<TestType, 8, 8>,
+        DenseT<TestType, 8, 8>,
+        SigmoidActivationT<TestType, 8>,
+        DenseT<TestType, 8, 1>>;
+
+    runTemplatedBlockTest<ModelType>(tests.at("gru").model_file, tests.at("gru").x_data_file);
+}
+
+TEST(TestModelBlock, templatedBlockOutputMatchesFrameOutputLSTM)
+{
+    using namespace RTNeural;
+    using ModelType = ModelT<TestType, 1, 1,
+        DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        LSTMLayerT<TestType, 8, 8>,
+        DenseT<TestType, 8, 1>>;
+
+    runTemplatedBlockTest<ModelType>(tests.at("lstm").model_file, tests.at("lstm").x_data_file);
+}
@@ -0,0 +1,105 @@
+#include <gmock/gmock.h>
+
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include <RTNeural/RTNeural.h>
+
+namespace
+{
+using TestType = double;
+constexpr int maxInSize = 16;
+constexpr int maxBlockSize = 64;
+
+auto loadDynamicModel(const std::string& model_file)
+{
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + model_file, std::ifstream::binary);
+    auto model = RTNeural::json_parser::parseJson<TestType>(jsonStream);
+    model->prepare(maxBlockSize);
+    return model;
+}
+
+auto loadInputData(const std::string& data_file)
+{
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + data_file);
+    return load_csv::loadFile<TestType>(pythonX);
+}
+
+/** Runs the first half of the data frame-by-frame, and the second half in blocks. */
+std::vector<TestType> processModel(RTNeural::Model<TestType>& model, const std::vector<TestType>& xData)
+{
+    const auto inSize = model.getInSize();
+    const auto outSize = model.getOutSize();
+    const auto numFrames = (int)xData.size() / inSize;
+
+    TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[maxInSize];
+    std::vector<TestType> yData((size_t)(numFrames * outSize), (TestType)0);
+
+    model.reset();
+    int n = 0;
+    for(; n < numFrames / 2; ++n)
+    {
+        std::copy(xData.begin() + n * inSize, xData.begin() + (n + 1) * inSize, input);
+        model.forward(input);
+        std::copy(model.getOutputs(), model.getOutputs() + outSize, yData.begin() + n * outSize);
+    }
+
+    while(n < numFrames)
+    {
+        const auto blockSize = std::min(37, numFrames - n);
+        model.forward(xData.data() + n * inSize, yData.data() + n * outSize, blockSize);
+        n += blockSize;
+    }
+
+    return yData;
+}
+
+void runBufferReuseTest(const std::string& model_file, const std::string& data_file)
+{
+    const auto xData = loadInputData(data_file);
+    auto refModel = loadDynamicModel(model_file);
+    ASSERT_LE(refModel->getInSize(), maxInSize);
+    const auto yRefData = processModel(*refModel, xData);
+
+    using namespace testing;
+    {
+        auto model = loadDynamicModel(model_file);
+        model->setBufferReuse(true);
+        ASSERT_TRUE(model->getBufferReuse());
+        EXPECT_THAT(processModel(*model, xData), ContainerEq(yRefData));
+    }
+
+    {
+        auto model = loadDynamicModel(model_file);
+        model->setBufferReuse(true);
+        model->compile();
+        model->allocateArena();
+        EXPECT_THAT(processModel(*model, xData), ContainerEq(yRefData));
+    }
+}
+}
+
+TEST(TestModelBufferReuse, reusedBufferOutputMatchesDefaultOutput)
+{
+    for(const auto& testConfig : tests)
+    {
+        SCOPED_TRACE(testConfig.second.name);
+        runBufferReuseTest(testConfig.second.model_file, testConfig.second.x_data_file);
+    }
+}
+
+TEST(TestModelBufferReuse, reusedBufferOutputMatchesDefaultOutputFullModel)
+{
+    runBufferReuseTest("models/full_model.json", "test_data/dense_x_python.csv");
+}
+
+TEST(TestModelBufferReuse, reusedBuffersUseLessMemory)
+{
+    auto model = loadDynamicModel("models/full_model.json");
+    const auto defaultBytes = model->getArenaBytes();
+
+    model->setBufferReuse(true);
+    EXPECT_LT(model->getArenaBytes(), defaultBytes);
+
+    model->setBufferReuse(false);
+    EXPECT_EQ(model->getArenaBytes(), defaultBytes);
+}
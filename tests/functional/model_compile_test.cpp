@@ -0,0 +1,151 @@
+#include <gmock/gmock.h>
+
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include <RTNeural/RTNeural.h>
+
+namespace
+{
+using TestType = double;
+constexpr int maxInSize = 16;
+constexpr int maxBlockSize = 64;
+
+auto loadDynamicModel(const std::string& model_file)
+{
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + model_file, std::ifstream::binary);
+    auto model = RTNeural::json_parser::parseJson<TestType>(jsonStream);
+    model->prepare(maxBlockSize);
+    return model;
+}
+
+auto loadInputData(const std::string& data_file)
+{
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + data_file);
+    return load_csv::loadFile<TestType>(pythonX);
+}
+
+/** Runs the first half of the data frame-by-frame, and the second half in blocks. */
+std::vector<TestType> processModel(RTNeural::Model<TestType>& model, const std::vector<TestType>& xData)
+{
+    const auto inSize = model.getInSize();
+    const auto outSize = model.getOutSize();
+    const auto numFrames = (int)xData.size() / inSize;
+
+    TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[maxInSize];
+    std::vector<TestType> yData((size_t)(numFrames * outSize), (TestType)0);
+
+    model.reset();
+    int n = 0;
+    for(; n < numFrames / 2; ++n)
+    {
+        std::copy(xData.begin() + n * inSize, xData.begin() + (n + 1) * inSize, input);
+        model.forward(input);
+        std::copy(model.getOutputs(), model.getOutputs() + outSize, yData.begin() + n * outSize);
+    }
+
+    while(n < numFrames)
+    {
+        const auto blockSize = std::min(37, numFrames - n);
+        model.forward(xData.data() + n * inSize, yData.data() + n * outSize, blockSize);
+        n += blockSize;
+    }
+
+    return yData;
+}
+
+/** A layer type that the execution plan doesn't know about. */
+struct ScaleLayer : RTNeural::Layer<TestType>
+{
+    explicit ScaleLayer(int size)
+        : RTNeural::Layer<TestType>(size, size)
+    {
+    }
+
+    void forward(const TestType* input, TestType* out) noexcept override
+    {
+        for(int i = 0; i < out_size; ++i)
+            out[i] = (TestType)0.5 * input[i];
+    }
+};
+
+void runCompileTest(const std::string& model_file, const std::string& data_file)
+{
+    const auto xData = loadInputData(data_file);
+    auto refModel = loadDynamicModel(model_file);
+    ASSERT_LE(refModel->getInSize(), maxInSize);
+    const auto yRefData = processModel(*refModel, xData);
+
+    using namespace testing;
+    {
+        auto model = loadDynamicModel(model_file);
+        model->compile();
+        ASSERT_TRUE(model->isCompiled());
+        EXPECT_THAT(processModel(*model, xData), ContainerEq(yRefData));
+    }
+
+    {
+        // the plan should follow the buffers when they are re-allocated
+        auto model = loadDynamicModel(model_file);
+        model->compile();
+        model->prepare(maxBlockSize);
+        model->allocateArena();
+        EXPECT_THAT(processModel(*model, xData), ContainerEq(yRefData));
+    }
+}
+}
+
+TEST(TestModelCompile, compiledOutputMatchesDefaultOutput)
+{
+    for(const auto& testConfig : tests)
+    {
+        SCOPED_TRACE(testConfig.second.name);
+        runCompileTest(testConfig.second.model_file, testConfig.second.x_data_file);
+    }
+}
+
+TEST(TestModelCompile, compiledOutputMatchesDefaultOutputFullModel)
+{
+    runCompileTest("models/full_model.json", "test_data/dense_x_python.csv");
+}
+
+TEST(TestModelCompile, unknownLayersFallBackToVirtualCalls)
+{
+    const auto xData = loadInputData("test_data/dense_x_python.csv");
+
+    auto refModel = loadDynamicModel("models/dense.json");
+    refModel->addLayer(new ScaleLayer(refModel->getNextInSize()));
+    const auto yRefData = processModel(*refModel, xData);
+
+    auto model = loadDynamicModel("models/dense.json");
+    model->addLayer(new ScaleLayer(model->getNextInSize()));
+    model->compile();
+    EXPECT_THAT(processModel(*model, xData), testing::ContainerEq(yRefData));
+}
+
+TEST(TestModelCompile, optionalLayersResolveThemselves)
+{
+    const auto xData = loadInputData("test_data/gru_x_python.csv");
+
+    RTNeural::json_parser::LoadOptions options;
+    options.weightFormat = RTNeural::json_parser::WeightFormat::BFloat16;
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + "models/gru.json", std::ifstream::binary);
+    auto refModel = RTNeural::json_parser::parseJson<TestType>(jsonStream, options);
+    refModel->prepare(maxBlockSize);
+    const auto yRefData = processModel(*refModel, xData);
+
+    // the half-precision layers aren't in the plan's list of layer types, so they resolve themselves
+    RTNeural::PlanOp<TestType> op;
+    op.layer = refModel->layers[2];
+    ASSERT_NE(dynamic_cast<RTNeural::GRULayerHalf<TestType>*>(op.layer), nullptr);
+    EXPECT_TRUE(op.layer->resolvePlanOp(op));
+    EXPECT_NE(op.forward, nullptr);
+    EXPECT_NE(op.forwardBlock, nullptr);
+
+    ScaleLayer scale { 4 };
+    op = {};
+    op.layer = &scale;
+    EXPECT_FALSE(scale.resolvePlanOp(op));
+
+    refModel->compile();
+    EXPECT_THAT(processModel(*refModel, xData), testing::ContainerEq(yRefData));
+}
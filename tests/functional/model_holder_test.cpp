@@ -0,0 +1,116 @@
+#include <gmock/gmock.h>
+
+#include <RTNeural/RTNeural.h>
+#include <RTNeural/parallel/model_holder.h>
+
+namespace
+{
+using TestType = double;
+constexpr int blockSize = 16;
+
+/** A "model" which outputs a constant, and counts how many instances have been destroyed. */
+struct ConstantModel
+{
+    static constexpr int input_size = 1;
+    static constexpr int output_size = 1;
+    static int numDestroyed;
+
+    explicit ConstantModel(TestType value)
+        : value(value)
+    {
+    }
+
+    ~ConstantModel() { ++numDestroyed; }
+
+    void reset() { }
+
+    void processBlock(const TestType*, TestType* output, int numFrames) noexcept
+    {
+        std::fill(output, output + numFrames, value);
+    }
+
+    TestType value;
+};
+
+int ConstantModel::numDestroyed = 0;
+} // namespace
+
+TEST(TestModelHolder, swapsDynamicModels)
+{
+    const auto loadModel = [](const std::string& file)
+    {
+        std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + file, std::ifstream::binary);
+        auto model = RTNeural::json_parser::parseJson<TestType>(jsonStream);
+        model->prepare(blockSize);
+        return model;
+    };
+
+    std::vector<TestType> input(blockSize);
+    for(int n = 0; n < blockSize; ++n)
+        input[n] = std::sin((TestType)n * 0.1);
+
+    std::vector<TestType> expected(blockSize);
+    loadModel("models/gru.json")->forward(input.data(), expected.data(), blockSize);
+
+    RTNeural::ModelHolder<TestType> holder(blockSize);
+    std::vector<TestType> output(blockSize);
+    EXPECT_FALSE(holder.process(input.data(), output.data(), blockSize));
+
+    EXPECT_TRUE(holder.setModel(loadModel("models/dense.json")));
+    EXPECT_TRUE(holder.process(input.data(), output.data(), blockSize));
+
+    EXPECT_TRUE(holder.setModel(loadModel("models/gru.json")));
+    EXPECT_TRUE(holder.process(input.data(), output.data(), blockSize));
+    EXPECT_THAT(output, testing::Pointwise(testing::DoubleEq(), expected));
+    EXPECT_FALSE(holder.setModel(nullptr));
+}
+
+TEST(TestModelHolder, crossfadesBetweenModels)
+{
+    constexpr int crossfadeSamples = 40;
+    RTNeural::ModelHolder<TestType, ConstantModel> holder(blockSize, crossfadeSamples);
+
+    std::vector<TestType> input(blockSize), output(blockSize);
+    holder.setModel(std::make_unique<ConstantModel>(0.0));
+    holder.process(input.data(), output.data(), blockSize);
+    EXPECT_THAT(output, testing::Each(0.0));
+
+    holder.setModel(std::make_unique<ConstantModel>(1.0));
+    std::vector<TestType> faded;
+    for(int b = 0; b < 4; ++b)
+    {
+        holder.process(input.data(), output.data(), blockSize);
+        faded.insert(faded.end(), output.begin(), output.end());
+    }
+
+    for(int n = 0; n < (int)faded.size(); ++n)
+        EXPECT_DOUBLE_EQ(faded[n], std::min((TestType)(n + 1) / (TestType)crossfadeSamples, (TestType)1)) << "Sample " << n;
+    EXPECT_FALSE(holder.isCrossfading());
+}
+
+TEST(TestModelHolder, oldModelsAreDestroyedOffTheAudioThread)
+{
+    ConstantModel::numDestroyed = 0;
+    {
+        RTNeural::ModelHolder<TestType, ConstantModel> holder(blockSize);
+        std::vector<TestType> input(blockSize), output(blockSize);
+
+        holder.setModel(std::make_unique<ConstantModel>(1.0));
+        holder.process(input.data(), output.data(), blockSize);
+
+        // a model which was never picked up is destroyed when it is replaced
+        holder.setModel(std::make_unique<ConstantModel>(2.0));
+        holder.setModel(std::make_unique<ConstantModel>(3.0));
+        EXPECT_EQ(ConstantModel::numDestroyed, 1);
+
+        // the audio thread hands the old model back, but does not destroy it
+        holder.process(input.data(), output.data(), blockSize);
+        EXPECT_THAT(output, testing::Each(3.0));
+        EXPECT_EQ(ConstantModel::numDestroyed, 1);
+
+        holder.collectGarbage();
+        EXPECT_EQ(ConstantModel::numDestroyed, 2);
+    }
+
+    EXPECT_EQ(ConstantModel::numDestroyed, 3);
+}
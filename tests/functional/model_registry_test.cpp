@@ -0,0 +1,193 @@
+#include <gmock/gmock.h>
+
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include <RTNeural/RTNeural.h>
+
+namespace
+{
+using TestType = double;
+
+using GRUModelType = RTNeural::ModelT<TestType, 1, 1,
+    RTNeural::DenseT<TestType, 1, 8>,
+    RTNeural::TanhActivationT<TestType, 8>,
+    RTNeural::GRULayerT<TestType, 8, 8>,
+    RTNeural::DenseT<TestType, 8, 8>,
+    RTNeural::SigmoidActivationT<TestType, 8>,
+    RTNeural::DenseT<TestType, 8, 1>>;
+
+using LSTMModelType = RTNeural::ModelT<TestType, 1, 1,
+    RTNeural::DenseT<TestType, 1, 8>,
+    RTNeural::TanhActivationT<TestType, 8>,
+    RTNeural::LSTMLayerT<TestType, 8, 8>,
+    RTNeural::DenseT<TestType, 8, 1>>;
+
+using Registry = RTNeural::ModelRegistry<TestType, GRUModelType, LSTMModelType>;
+
+nlohmann::json loadJson(const std::string& model_file)
+{
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + model_file, std::ifstream::binary);
+    nlohmann::json parent;
+    jsonStream >> parent;
+    return parent;
+}
+
+nlohmann::json makeDense(int in_size, int out_size, const std::string& activation = "")
+{
+    std::vector<std::vector<TestType>> kernel((size_t)in_size, std::vector<TestType>((size_t)out_size));
+    for(size_t k = 0; k < kernel.size(); ++k)
+        for(size_t i = 0; i < kernel[k].size(); ++i)
+            kernel[k][i] = 0.1 * std::sin((double)(k * kernel[k].size() + i));
+
+    return nlohmann::json { { "type", "dense" }, { "activation", activation }, { "shape", { nullptr, nullptr, out_size } },
+        { "weights", { kernel, std::vector<TestType>((size_t)out_size, 0.1) } } };
+}
+
+auto loadInputData(const std::string& data_file)
+{
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + data_file);
+    return load_csv::loadFile<TestType>(pythonX);
+}
+
+std::vector<TestType> processInBlocks(RTNeural::BlockModel<TestType>& model, const std::vector<TestType>& xData)
+{
+    const auto inSize = model.getInSize();
+    const auto outSize = model.getOutSize();
+    const auto numFrames = (int)xData.size() / inSize;
+
+    std::vector<TestType> yData((size_t)(numFrames * outSize), (TestType)0);
+    model.prepare(64);
+    model.reset();
+    for(int n = 0; n < numFrames; n += 50)
+    {
+        const auto blockSize = std::min(50, numFrames - n);
+        model.processBlock(xData.data() + n * inSize, yData.data() + n * outSize, blockSize);
+    }
+
+    return yData;
+}
+
+template <typename ModelType>
+std::vector<TestType> processStatic(const nlohmann::json& modelJson, const std::vector<TestType>& xData)
+{
+    ModelType model;
+    model.parseJson(modelJson);
+    model.reset();
+
+    std::vector<TestType> yData(xData.size(), (TestType)0);
+    for(size_t n = 0; n < xData.size(); ++n)
+        yData[n] = model.forward(&xData[n]);
+
+    return yData;
+}
+
+std::vector<TestType> processDynamic(const nlohmann::json& modelJson, const std::vector<TestType>& xData)
+{
+    auto model = RTNeural::json_parser::parseJson<TestType>(modelJson);
+    model->reset();
+
+    std::vector<TestType> yData(xData.size(), (TestType)0);
+    for(size_t n = 0; n < xData.size(); ++n)
+        yData[n] = model->forward(&xData[n]);
+
+    return yData;
+}
+}
+
+TEST(TestModelRegistry, parseJsonReportsMatch)
+{
+    const auto gruJson = loadJson(tests.at("gru").model_file);
+    const auto lstmJson = loadJson(tests.at("lstm").model_file);
+
+    GRUModelType gruModel;
+    EXPECT_TRUE(gruModel.parseJson(gruJson));
+    EXPECT_FALSE(gruModel.parseJson(lstmJson));
+
+    LSTMModelType lstmModel;
+    EXPECT_TRUE(lstmModel.parseJson(lstmJson));
+    EXPECT_FALSE(lstmModel.parseJson(gruJson));
+    EXPECT_FALSE(lstmModel.parseJson(loadJson(tests.at("dense").model_file)));
+
+    // convolutional layers must not read conv-only fields from other layer types
+    RTNeural::ModelT<TestType, 1, 1,
+        RTNeural::DenseT<TestType, 1, 8>,
+        RTNeural::TanhActivationT<TestType, 8>,
+        RTNeural::Conv1DT<TestType, 8, 8, 3, 1>,
+        RTNeural::DenseT<TestType, 8, 8>,
+        RTNeural::SigmoidActivationT<TestType, 8>,
+        RTNeural::DenseT<TestType, 8, 1>>
+        convModel;
+    EXPECT_FALSE(convModel.parseJson(gruJson));
+}
+
+TEST(TestModelRegistry, matchingModelsAreStatic)
+{
+    constexpr double threshold = 1.0e-12;
+    using namespace testing;
+
+    {
+        const auto modelJson = loadJson(tests.at("gru").model_file);
+        const auto xData = loadInputData(tests.at("gru").x_data_file);
+
+        auto model = Registry::load(modelJson);
+        ASSERT_NE(model, nullptr);
+        EXPECT_TRUE(model->isStatic());
+        EXPECT_THAT(processInBlocks(*model, xData), Pointwise(DoubleNear(threshold), processStatic<GRUModelType>(modelJson, xData)));
+    }
+
+    {
+        const auto modelJson = loadJson(tests.at("lstm").model_file);
+        const auto xData = loadInputData(tests.at("lstm").x_data_file);
+
+        auto model = Registry::load(modelJson);
+        ASSERT_NE(model, nullptr);
+        EXPECT_TRUE(model->isStatic());
+        EXPECT_THAT(processInBlocks(*model, xData), Pointwise(DoubleNear(threshold), processStatic<LSTMModelType>(modelJson, xData)));
+    }
+}
+
+TEST(TestModelRegistry, otherModelsFallBackToDynamic)
+{
+    constexpr double threshold = 1.0e-12;
+    using namespace testing;
+
+    const auto modelJson = loadJson(tests.at("dense").model_file);
+    const auto xData = loadInputData(tests.at("dense").x_data_file);
+
+    auto model = Registry::load(modelJson);
+    ASSERT_NE(model, nullptr);
+    EXPECT_FALSE(model->isStatic());
+    EXPECT_THAT(processInBlocks(*model, xData), Pointwise(DoubleNear(threshold), processDynamic(modelJson, xData)));
+}
+
+TEST(TestModelRegistry, nearlyMatchingModelsAreSkipped)
+{
+    // the last layer has the right output size, but the wrong input size for the first model type
+    nlohmann::json modelJson;
+    modelJson["in_shape"] = { nullptr, nullptr, 1 };
+    modelJson["layers"] = { makeDense(1, 16, "tanh"), makeDense(16, 1) };
+
+    using NearModelType = RTNeural::ModelT<TestType, 1, 1,
+        RTNeural::DenseT<TestType, 1, 8>,
+        RTNeural::TanhActivationT<TestType, 8>,
+        RTNeural::DenseT<TestType, 8, 1>>;
+    using MatchingModelType = RTNeural::ModelT<TestType, 1, 1,
+        RTNeural::DenseT<TestType, 1, 16>,
+        RTNeural::TanhActivationT<TestType, 16>,
+        RTNeural::DenseT<TestType, 16, 1>>;
+
+    NearModelType nearModel;
+    EXPECT_FALSE(nearModel.parseJson(modelJson));
+
+    const auto xData = loadInputData(tests.at("dense").x_data_file);
+
+    auto model = RTNeural::ModelRegistry<TestType, NearModelType>::load(modelJson);
+    ASSERT_NE(model, nullptr);
+    EXPECT_FALSE(model->isStatic());
+    EXPECT_THAT(processInBlocks(*model, xData), testing::Pointwise(testing::DoubleNear(1.0e-12), processDynamic(modelJson, xData)));
+
+    model = RTNeural::ModelRegistry<TestType, NearModelType, MatchingModelType>::load(modelJson);
+    ASSERT_NE(model, nullptr);
+    EXPECT_TRUE(model->isStatic());
+    EXPECT_THAT(processInBlocks(*model, xData), testing::Pointwise(testing::DoubleNear(1.0e-12), processStatic<MatchingModelType>(modelJson, xData)));
+}
@@ -0,0 +1,173 @@
+#include <gmock/gmock.h>
+
+#include <RTNeural/RTNeural.h>
+
+namespace
+{
+using TestType = double;
+constexpr int numWarmUpFrames = 200;
+constexpr int numTestFrames = 100;
+
+std::vector<TestType> getInputSignal(int numFrames, int inSize, TestType freq)
+{
+    std::vector<TestType> x((size_t)(numFrames * inSize));
+    for(size_t n = 0; n < x.size(); ++n)
+        x[n] = std::sin(freq * (TestType)n);
+    return x;
+}
+
+template <typename ModelType>
+std::vector<TestType> runFrames(ModelType& model, const std::vector<TestType>& input, int inSize, int outSize)
+{
+    const auto numFrames = (int)input.size() / inSize;
+    std::vector<TestType> output((size_t)(numFrames * outSize));
+    std::vector<TestType> frame((size_t)inSize); // some layers need an aligned input
+    for(int n = 0; n < numFrames; ++n)
+    {
+        std::copy(input.begin() + n * inSize, input.begin() + (n + 1) * inSize, frame.begin());
+        model.forward(frame.data());
+        std::copy(model.getOutputs(), model.getOutputs() + outSize, output.begin() + n * outSize);
+    }
+    return output;
+}
+
+/**
+ * Warms up `model`, saves its state and records its output from there,
+ * then checks that `otherModel` produces the same output once the state
+ * is loaded into it, regardless of what it was processing before.
+ */
+template <typename ModelType>
+void runStateTest(ModelType& model, ModelType& otherModel, int inSize, int outSize)
+{
+    const auto stateSize = model.getStateSize();
+    EXPECT_GT(stateSize, (size_t)0);
+    EXPECT_EQ(otherModel.getStateSize(), stateSize);
+
+    model.reset();
+    runFrames(model, getInputSignal(numWarmUpFrames, inSize, (TestType)0.05), inSize, outSize);
+
+    std::vector<TestType> state(stateSize);
+    model.saveState(state.data());
+
+    const auto testInput = getInputSignal(numTestFrames, inSize, (TestType)0.13);
+    const auto expected = runFrames(model, testInput, inSize, outSize);
+
+    otherModel.reset();
+    runFrames(otherModel, getInputSignal(numWarmUpFrames / 2, inSize, (TestType)0.31), inSize, outSize);
+    otherModel.loadState(state.data());
+    const auto actual = runFrames(otherModel, testInput, inSize, outSize);
+
+    for(size_t n = 0; n < expected.size(); ++n)
+        EXPECT_NEAR(actual[n], expected[n], 1.0e-12) << "Index: " << n;
+
+    // a model started from zero state should sound different
+    otherModel.reset();
+    const auto fromReset = runFrames(otherModel, testInput, inSize, outSize);
+    EXPECT_NE(fromReset, expected);
+}
+
+std::unique_ptr<RTNeural::Model<TestType>> loadDynamicModel(const std::string& file, bool debug = false)
+{
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + file, std::ifstream::binary);
+    return RTNeural::json_parser::parseJson<TestType>(jsonStream, debug);
+}
+
+template <typename ModelType>
+void loadStaticModel(ModelType& model, const std::string& file, bool debug = false)
+{
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + file, std::ifstream::binary);
+    model.parseJson(jsonStream, debug);
+}
+} // namespace
+
+TEST(TestModelState, dynamicModelRestoresConvAndGRUState)
+{
+    auto model = loadDynamicModel("models/full_model.json");
+    auto otherModel = loadDynamicModel("models/full_model.json");
+    runStateTest(*model, *otherModel, 1, 1);
+}
+
+TEST(TestModelState, dynamicModelRestoresLSTMState)
+{
+    auto model = loadDynamicModel("models/lstm.json");
+    auto otherModel = loadDynamicModel("models/lstm.json");
+    runStateTest(*model, *otherModel, 1, 1);
+}
+
+TEST(TestModelState, dynamicModelRestoresConv2DState)
+{
+    auto model = loadDynamicModel("models/conv2d.json");
+    auto otherModel = loadDynamicModel("models/conv2d.json");
+    runStateTest(*model, *otherModel, model->getInSize(), model->getOutSize());
+}
+
+TEST(TestModelState, staticModelRestoresConvAndGRUState)
+{
+    using namespace RTNeural;
+    using ModelType = ModelT<TestType, 1, 1,
+        DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        Conv1DT<TestType, 8, 4, 3, 2>,
+        TanhActivationT<TestType, 4>,
+        GRULayerT<TestType, 4, 8>,
+        DenseT<TestType, 8, 1>>;
+
+    ModelType model, otherModel;
+    loadStaticModel(model, "models/full_model.json");
+    loadStaticModel(otherModel, "models/full_model.json");
+    runStateTest(model, otherModel, 1, 1);
+}
+
+TEST(TestModelState, staticModelRestoresGRUDelayLine)
+{
+    using namespace RTNeural;
+    using ModelType = ModelT<TestType, 1, 1,
+        DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        GRULayerT<TestType, 8, 8, SampleRateCorrectionMode::NoInterp>,
+        DenseT<TestType, 8, 8>,
+        SigmoidActivationT<TestType, 8>,
+        DenseT<TestType, 8, 1>>;
+
+    ModelType model, otherModel;
+    loadStaticModel(model, "models/gru.json");
+    loadStaticModel(otherModel, "models/gru.json");
+    model.get<2>().prepare(3);
+    otherModel.get<2>().prepare(3);
+    EXPECT_GT(model.getStateSize(), ModelType {}.getStateSize());
+    runStateTest(model, otherModel, 1, 1);
+}
+
+TEST(TestModelState, staticModelRestoresLSTMDelayLines)
+{
+    using namespace RTNeural;
+    using ModelType = ModelT<TestType, 1, 1,
+        DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        LSTMLayerT<TestType, 8, 8, SampleRateCorrectionMode::LinInterp>,
+        DenseT<TestType, 8, 1>>;
+
+    ModelType model, otherModel;
+    loadStaticModel(model, "models/lstm.json");
+    loadStaticModel(otherModel, "models/lstm.json");
+    model.get<2>().prepare((TestType)1.5);
+    otherModel.get<2>().prepare((TestType)1.5);
+    runStateTest(model, otherModel, 1, 1);
+}
+
+TEST(TestModelState, staticModelRestoresConv2DState)
+{
+    constexpr int numFeaturesIn = 23;
+    using ModelType = RTNeural::ModelT2D<TestType, 1, numFeaturesIn, 1, 8,
+        RTNeural::Conv2DT<TestType, 1, 2, numFeaturesIn, 5, 5, 2, 1, true>,
+        RTNeural::BatchNorm2DT<TestType, 2, 19, false>,
+        RTNeural::ReLuActivationT<TestType, 2 * 19>,
+        RTNeural::Conv2DT<TestType, 2, 3, 19, 4, 3, 1, 2, false>,
+        RTNeural::BatchNorm2DT<TestType, 3, 10, true>,
+        RTNeural::Conv2DT<TestType, 3, 1, 10, 2, 3, 3, 1, true>>;
+
+    ModelType model, otherModel;
+    loadStaticModel(model, "models/conv2d.json");
+    loadStaticModel(otherModel, "models/conv2d.json");
+    runStateTest(model, otherModel, numFeaturesIn, 8);
+}
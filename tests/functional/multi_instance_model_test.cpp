@@ -0,0 +1,137 @@
+#include <gmock/gmock.h>
+
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include <RTNeural/RTNeural.h>
+
+namespace
+{
+using TestType = double;
+
+// not a multiple of the SIMD width, so that the last lane group is only partially used
+constexpr int numInstances = 5;
+
+/**
+ * Runs a multi-instance model with a different input stream for each instance,
+ * and checks that every instance matches a separate ModelT running the same stream.
+ */
+template <typename... Layers>
+void runMultiInstanceTest(const std::string& model_file, const std::string& data_file)
+{
+    constexpr double threshold = 1.0e-12;
+
+    using ModelType = RTNeural::ModelT<TestType, 1, 1, Layers...>;
+    using MultiModelType = RTNeural::MultiInstanceModelT<TestType, numInstances, 1, 1, Layers...>;
+
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    const auto numFrames = (int)xData.size();
+
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + model_file, std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+
+    std::vector<ModelType> refModels(numInstances);
+    for(auto& model : refModels)
+    {
+        ASSERT_TRUE(model.parseJson(modelJson));
+        model.reset();
+    }
+
+    MultiModelType multiModel;
+    ASSERT_TRUE(multiModel.parseJson(modelJson));
+    multiModel.reset();
+
+    const auto getInput = [&](int instance, int n)
+    { return xData[(size_t)((n + 37 * instance) % numFrames)] * (1.0 - 0.1 * instance); };
+
+    std::vector<TestType> yRefData;
+    std::vector<TestType> yData;
+    for(int n = 0; n < numFrames; ++n)
+    {
+        TestType input[numInstances];
+        for(int i = 0; i < numInstances; ++i)
+        {
+            input[i] = getInput(i, n);
+            yRefData.push_back(refModels[(size_t)i].forward(&input[i]));
+        }
+
+        multiModel.forward(input);
+        yData.insert(yData.end(), multiModel.getOutputs(), multiModel.getOutputs() + numInstances);
+    }
+
+    using namespace testing;
+    EXPECT_THAT(yData, Pointwise(DoubleNear(threshold), yRefData));
+}
+}
+
+TEST(TestMultiInstanceModel, instancesMatchSeparateModelsDense)
+{
+    using namespace RTNeural;
+    runMultiInstanceTest<DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        DenseT<TestType, 8, 8>,
+        ReLuActivationT<TestType, 8>,
+        DenseT<TestType, 8, 8>,
+        ELuActivationT<TestType, 8>,
+        DenseT<TestType, 8, 8>,
+        SoftmaxActivationT<TestType, 8>,
+        DenseT<TestType, 8, 1>>(tests.at("dense").model_file, tests.at("dense").x_data_file);
+}
+
+TEST(TestMultiInstanceModel, instancesMatchSeparateModelsFullModel)
+{
+    using namespace RTNeural;
+    runMultiInstanceTest<DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        Conv1DT<TestType, 8, 4, 3, 2>,
+        TanhActivationT<TestType, 4>,
+        GRULayerT<TestType, 4, 8>,
+        DenseT<TestType, 8, 1>>("models/full_model.json", "test_data/dense_x_python.csv");
+}
+
+TEST(TestMultiInstanceModel, instancesMatchSeparateModelsGRU)
+{
+    using namespace RTNeural;
+    runMultiInstanceTest<DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        GRULayerT<TestType, 8, 8>,
+        DenseT<TestType, 8, 8>,
+        SigmoidActivationT<TestType, 8>,
+        DenseT<TestType, 8, 1>>(tests.at("gru").model_file, tests.at("gru").x_data_file);
+}
+
+TEST(TestMultiInstanceModel, instancesMatchSeparateModelsLSTM)
+{
+    using namespace RTNeural;
+    runMultiInstanceTest<DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        LSTMLayerT<TestType, 8, 8>,
+        DenseT<TestType, 8, 1>>(tests.at("lstm").model_file, tests.at("lstm").x_data_file);
+}
+
+TEST(TestMultiInstanceModel, instancesUseMathsProvider)
+{
+    using namespace RTNeural;
+    runMultiInstanceTest<DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8, FastMathsProvider>,
+        GRULayerT<TestType, 8, 8, SampleRateCorrectionMode::None, FastMathsProvider>,
+        DenseT<TestType, 8, 8>,
+        SigmoidActivationT<TestType, 8, FastMathsProvider>,
+        DenseT<TestType, 8, 1>>(tests.at("gru").model_file, tests.at("gru").x_data_file);
+
+    runMultiInstanceTest<DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8, FastMathsProvider>,
+        LSTMLayerT<TestType, 8, 8, SampleRateCorrectionMode::None, FastMathsProvider>,
+        DenseT<TestType, 8, 1>>(tests.at("lstm").model_file, tests.at("lstm").x_data_file);
+
+    runMultiInstanceTest<DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        DenseT<TestType, 8, 8>,
+        ReLuActivationT<TestType, 8>,
+        DenseT<TestType, 8, 8>,
+        ELuActivationT<TestType, 8, 1, 1, PolynomialEluMathsProvider>,
+        DenseT<TestType, 8, 8>,
+        SoftmaxActivationT<TestType, 8, PolynomialEluMathsProvider>,
+        DenseT<TestType, 8, 1>>(tests.at("dense").model_file, tests.at("dense").x_data_file);
+}
@@ -0,0 +1,170 @@
+#include <gmock/gmock.h>
+
+#include <RTNeural/RTNeural.h>
+#include <RTNeural/parallel/pipeline_model.h>
+#include <random>
+
+namespace
+{
+using TestType = double;
+constexpr int blockSize = 32;
+constexpr int numBlocks = 40;
+const std::string modelFile = "models/full_model.json";
+
+std::unique_ptr<RTNeural::Model<TestType>> loadDynamicModel()
+{
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + modelFile, std::ifstream::binary);
+    auto model = RTNeural::json_parser::parseJson<TestType>(jsonStream);
+    model->prepare(blockSize);
+    return model;
+}
+
+std::vector<TestType> makeInput()
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution(-1.0, 1.0);
+
+    std::vector<TestType> input(blockSize * numBlocks);
+    for(auto& x : input)
+        x = distribution(generator);
+    return input;
+}
+
+/** Checks that the pipeline output is the expected output, delayed by the pipeline latency. */
+void checkDelayedOutput(const std::vector<TestType>& output, const std::vector<TestType>& expected, int latency)
+{
+    for(int n = 0; n < latency; ++n)
+        EXPECT_EQ(output[n], (TestType)0) << "Sample " << n;
+
+    for(int n = latency; n < (int)output.size(); ++n)
+        EXPECT_DOUBLE_EQ(output[n], expected[n - latency]) << "Sample " << n;
+}
+
+template <typename PipelineType, typename ProcessFn>
+std::vector<TestType> runPipeline(PipelineType& pipeline, const std::vector<TestType>& input, ProcessFn&& process)
+{
+    std::vector<TestType> output(input.size());
+    for(int b = 0; b < numBlocks; ++b)
+        process(pipeline, input.data() + b * blockSize, output.data() + b * blockSize);
+    return output;
+}
+
+using Stage0Type = RTNeural::ModelT<TestType, 1, 4,
+    RTNeural::DenseT<TestType, 1, 8>,
+    RTNeural::TanhActivationT<TestType, 8>,
+    RTNeural::Conv1DT<TestType, 8, 4, 3, 2>,
+    RTNeural::TanhActivationT<TestType, 4>>;
+
+using Stage1Type = RTNeural::ModelT<TestType, 4, 1,
+    RTNeural::GRULayerT<TestType, 4, 8>,
+    RTNeural::DenseT<TestType, 8, 1>>;
+} // namespace
+
+TEST(TestPipelineModel, partitionCoversAllLayers)
+{
+    auto model = loadDynamicModel();
+    const auto numLayers = (int)model->layers.size();
+
+    for(int numStages = 1; numStages <= numLayers + 1; ++numStages)
+    {
+        const auto starts = RTNeural::PipelineModel<TestType>::partitionLayers(*model, numStages);
+        EXPECT_EQ((int)starts.size(), std::min(numStages, numLayers));
+        EXPECT_EQ(starts.front(), 0);
+        for(size_t i = 1; i < starts.size(); ++i)
+            EXPECT_GT(starts[i], starts[i - 1]);
+        EXPECT_LT(starts.back(), numLayers);
+    }
+}
+
+TEST(TestPipelineModel, partitionBalancesMultiplyAdds)
+{
+    RTNeural::Dense<TestType> dense { 32, 16 };
+    RTNeural::Conv1D<TestType> conv(16, 8, 3, 1, 2);
+    RTNeural::GRULayer<TestType> gru { 8, 4 };
+    RTNeural::LSTMLayer<TestType> lstm { 8, 4 };
+    RTNeural::TanhActivation<TestType> tanh { 8 };
+    EXPECT_EQ(dense.getNumMACs(), 32u * 16u);
+    EXPECT_EQ(conv.getNumMACs(), 8u * 8u * 3u);
+    EXPECT_EQ(gru.getNumMACs(), 3u * 4u * (8u + 4u));
+    EXPECT_EQ(lstm.getNumMACs(), 4u * 4u * (8u + 4u));
+    EXPECT_EQ(tanh.getNumMACs(), 8u);
+
+    // each output channel of a grouped convolution only sees the input channels in its group
+    RTNeural::Conv1D<TestType> groupedConv(6, 12, 3, 1, 3);
+    EXPECT_EQ(groupedConv.getNumMACs(), 12u * 2u * 3u);
+
+    // the convolution does most of the work, so it should get a stage to itself
+    RTNeural::Model<TestType> model { 1 };
+    model.addLayer(new RTNeural::Dense<TestType> { 1, 32 });
+    model.addLayer(new RTNeural::TanhActivation<TestType> { 32 });
+    model.addLayer(new RTNeural::Dense<TestType> { 32, 32 });
+    model.addLayer(new RTNeural::TanhActivation<TestType> { 32 });
+    model.addLayer(new RTNeural::Conv1D<TestType> { 32, 32, 4, 1 });
+    model.addLayer(new RTNeural::Dense<TestType> { 32, 1 });
+
+    const auto starts = RTNeural::PipelineModel<TestType>::partitionLayers(model, 2);
+    EXPECT_EQ(starts, (std::vector<int> { 0, 4 }));
+}
+
+TEST(TestPipelineModel, dynamicOutputMatchesDelayedModelOutput)
+{
+    const auto input = makeInput();
+
+    auto serialModel = loadDynamicModel();
+    std::vector<TestType> expected(input.size());
+    for(int b = 0; b < numBlocks; ++b)
+        serialModel->forward(input.data() + b * blockSize, expected.data() + b * blockSize, blockSize);
+
+    for(int numStages = 1; numStages <= 4; ++numStages)
+    {
+        auto model = loadDynamicModel();
+        RTNeural::PipelineModel<TestType> pipeline(*model, numStages, blockSize);
+        EXPECT_EQ(pipeline.getLatencySamples(), (pipeline.getNumStages() - 1) * blockSize);
+
+        const auto process = [](auto& p, const TestType* in, TestType* out)
+        { p.forward(in, out); };
+
+        checkDelayedOutput(runPipeline(pipeline, input, process), expected, pipeline.getLatencySamples());
+
+        // after a reset, the pipeline should start from scratch
+        pipeline.reset();
+        checkDelayedOutput(runPipeline(pipeline, input, process), expected, pipeline.getLatencySamples());
+    }
+}
+
+TEST(TestPipelineModel, staticOutputMatchesDelayedModelOutput)
+{
+    const auto input = makeInput();
+
+    RTNeural::ModelT<TestType, 1, 1,
+        RTNeural::DenseT<TestType, 1, 8>,
+        RTNeural::TanhActivationT<TestType, 8>,
+        RTNeural::Conv1DT<TestType, 8, 4, 3, 2>,
+        RTNeural::TanhActivationT<TestType, 4>,
+        RTNeural::GRULayerT<TestType, 4, 8>,
+        RTNeural::DenseT<TestType, 8, 1>>
+        serialModel;
+
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + modelFile, std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+    ASSERT_TRUE(serialModel.parseJson(modelJson));
+
+    std::vector<TestType> expected(input.size());
+    serialModel.processBlock(input.data(), expected.data(), (int)input.size());
+
+    RTNeural::PipelineModelT<TestType, Stage0Type, Stage1Type> pipeline { blockSize };
+    ASSERT_TRUE(pipeline.parseJson(modelJson));
+    EXPECT_EQ(pipeline.getLatencySamples(), blockSize);
+
+    const auto output = runPipeline(pipeline, input, [](auto& p, const TestType* in, TestType* out)
+        { p.processBlock(in, out); });
+    checkDelayedOutput(output, expected, pipeline.getLatencySamples());
+}
+
+TEST(TestPipelineModel, staticParseFailsForMismatchedJson)
+{
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + "models/gru.json", std::ifstream::binary);
+    RTNeural::PipelineModelT<TestType, Stage0Type, Stage1Type> pipeline { blockSize };
+    EXPECT_FALSE(pipeline.parseJson(jsonStream));
+}
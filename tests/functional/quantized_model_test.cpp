@@ -0,0 +1,213 @@
+#include <gmock/gmock.h>
+
+#include "load_csv.hpp"
+#include <RTNeural/RTNeural.h>
+#include <random>
+
+namespace
+{
+using TestType = double;
+
+auto loadDynamicModel(const std::string& model_file, bool quantizeWeights)
+{
+    using RTNeural::json_parser::WeightFormat;
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + model_file, std::ifstream::binary);
+    RTNeural::json_parser::LoadOptions options;
+    options.weightFormat = quantizeWeights ? WeightFormat::Int8 : WeightFormat::Float;
+    return RTNeural::json_parser::parseJson<TestType>(jsonStream, options);
+}
+
+auto loadInputData()
+{
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + "test_data/dense_x_python.csv");
+    return load_csv::loadFile<TestType>(pythonX);
+}
+
+template <typename ModelType>
+std::vector<TestType> processFrames(ModelType& model, const std::vector<TestType>& xData)
+{
+    std::vector<TestType> yData(xData.size(), (TestType)0);
+
+    model.reset();
+    for(size_t n = 0; n < xData.size(); ++n)
+        yData[n] = model.forward(&xData[n]);
+
+    return yData;
+}
+
+/** Checks that the int8 model stays close to the float model, relative to the size of the output. */
+void expectCloseToFloat(const std::vector<TestType>& quantized, const std::vector<TestType>& reference, TestType relTolerance)
+{
+    TestType maxAbs = (TestType)0;
+    for(auto y : reference)
+        maxAbs = std::max(maxAbs, std::abs(y));
+
+    for(size_t n = 0; n < reference.size(); ++n)
+        EXPECT_NEAR(quantized[n], reference[n], relTolerance * maxAbs) << "Index: " << n;
+}
+} // namespace
+
+TEST(TestQuantized, dotProductMatchesReference)
+{
+    std::mt19937 rng(0x5eed);
+    std::uniform_int_distribution<int> dist(-127, 127);
+
+    std::vector<int8_t> a(130), b(130);
+    for(size_t i = 0; i < a.size(); ++i)
+    {
+        a[i] = (int8_t)dist(rng);
+        b[i] = (int8_t)dist(rng);
+    }
+
+    // cover the SIMD loops and the remainders, and the largest possible products
+    std::fill(a.begin(), a.begin() + 32, (int8_t)127);
+    std::fill(b.begin(), b.begin() + 32, (int8_t)-127);
+    for(int count = 0; count <= (int)a.size(); ++count)
+    {
+        int32_t expected = 0;
+        for(int i = 0; i < count; ++i)
+            expected += (int32_t)a[(size_t)i] * (int32_t)b[(size_t)i];
+
+        EXPECT_EQ(RTNeural::int8_detail::dot(a.data(), b.data(), count), expected) << "Count: " << count;
+    }
+}
+
+TEST(TestQuantized, quantizeErrorIsWithinHalfAStep)
+{
+    const std::vector<TestType> values { 0.5, -1.25, 0.001, 2.0, -2.0, 0.7 };
+    std::vector<int8_t> quantized(values.size());
+    const auto scale = RTNeural::int8_detail::quantize(values.data(), (int)values.size(), quantized.data());
+
+    EXPECT_DOUBLE_EQ(scale, 2.0 / 127.0);
+    for(size_t i = 0; i < values.size(); ++i)
+        EXPECT_NEAR(scale * quantized[i], values[i], 0.5 * scale + 1.0e-12);
+
+    const std::vector<TestType> zeros(4, 0.0);
+    EXPECT_EQ(RTNeural::int8_detail::quantize(zeros.data(), (int)zeros.size(), quantized.data()), 0.0);
+}
+
+TEST(TestQuantized, quantizedDenseUsesLessMemory)
+{
+    RTNeural::Dense<TestType> dense(64, 64);
+    RTNeural::DenseInt8<TestType> denseInt8(64, 64);
+    EXPECT_LT(denseInt8.getArenaBytes() * 4, dense.getArenaBytes());
+}
+
+TEST(TestQuantized, dynamicModelIsCloseToFloatModel)
+{
+    const auto xData = loadInputData();
+
+    for(const auto* file : { "models/dense.json", "models/full_model.json" })
+    {
+        auto floatModel = loadDynamicModel(file, false);
+        auto quantizedModel = loadDynamicModel(file, true);
+        ASSERT_NE(quantizedModel, nullptr);
+
+        int numQuantizedLayers = 0;
+        for(auto* layer : quantizedModel->layers)
+        {
+            if(dynamic_cast<RTNeural::DenseInt8<TestType>*>(layer) != nullptr
+                || dynamic_cast<RTNeural::Conv1DInt8<TestType>*>(layer) != nullptr)
+                ++numQuantizedLayers;
+        }
+        EXPECT_GT(numQuantizedLayers, 0);
+
+        expectCloseToFloat(processFrames(*quantizedModel, xData), processFrames(*floatModel, xData), 0.05);
+    }
+}
+
+TEST(TestQuantized, templatedModelMatchesDynamicModel)
+{
+    using namespace RTNeural;
+    using ModelType = ModelT<TestType, 1, 1,
+        DenseInt8T<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        Conv1DInt8T<TestType, 8, 4, 3, 2>,
+        TanhActivationT<TestType, 4>,
+        GRULayerT<TestType, 4, 8>,
+        DenseInt8T<TestType, 8, 1>>;
+
+    ModelType modelT;
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + "models/full_model.json", std::ifstream::binary);
+    EXPECT_TRUE(modelT.parseJson(jsonStream));
+
+    const auto xData = loadInputData();
+    auto dynamicModel = loadDynamicModel("models/full_model.json", true);
+    const auto expected = processFrames(*dynamicModel, xData);
+    const auto actual = processFrames(modelT, xData);
+
+    for(size_t n = 0; n < expected.size(); ++n)
+        EXPECT_NEAR(actual[n], expected[n], 1.0e-6) << "Index: " << n;
+}
+
+TEST(TestQuantized, convStateRoundTrips)
+{
+    auto model = loadDynamicModel("models/full_model.json", true);
+    auto otherModel = loadDynamicModel("models/full_model.json", true);
+    const auto xData = loadInputData();
+
+    model->reset();
+    for(size_t n = 0; n < xData.size() / 2; ++n)
+        model->forward(&xData[n]);
+
+    std::vector<TestType> state(model->getStateSize());
+    model->saveState(state.data());
+    otherModel->reset();
+    otherModel->loadState(state.data());
+
+    for(size_t n = xData.size() / 2; n < xData.size(); ++n)
+        EXPECT_NEAR(otherModel->forward(&xData[n]), model->forward(&xData[n]), 1.0e-9) << "Index: " << n;
+}
+
+TEST(TestQuantized, calibratedInputRangeSaturates)
+{
+    const std::vector<TestType> values { 0.5, -1.0, 4.0, -4.0 };
+    std::vector<int8_t> quantized(values.size());
+    const auto scale = RTNeural::int8_detail::quantizeInput(values.data(), (int)values.size(), 1.0 / 127.0, quantized.data());
+
+    EXPECT_DOUBLE_EQ(scale, 1.0 / 127.0);
+    EXPECT_EQ(quantized[0], 64);
+    EXPECT_EQ(quantized[1], -127);
+    EXPECT_EQ(quantized[2], 127);
+    EXPECT_EQ(quantized[3], -127);
+
+    RTNeural::DenseInt8<TestType> dense(4, 2);
+    EXPECT_EQ(dense.getInputRange(), (TestType)0);
+    dense.setInputRange((TestType)2);
+    EXPECT_NEAR(dense.getInputRange(), (TestType)2, 1.0e-12);
+}
+
+TEST(TestQuantized, perLayerWeightFormatIsLoaded)
+{
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + "models/full_model.json", std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+
+    auto& denseJson = modelJson["layers"][0];
+    denseJson["weight_format"] = "int8";
+    denseJson["input_range"] = 1.0;
+
+    auto dynamicModel = RTNeural::json_parser::parseJson<TestType>(modelJson);
+    auto* dense = dynamic_cast<RTNeural::DenseInt8<TestType>*>(dynamicModel->layers[0]);
+    ASSERT_NE(dense, nullptr);
+    EXPECT_NEAR(dense->getInputRange(), (TestType)1, 1.0e-12);
+    EXPECT_EQ(dynamic_cast<RTNeural::DenseInt8<TestType>*>(dynamicModel->layers.back()), nullptr);
+
+    using namespace RTNeural;
+    ModelT<TestType, 1, 1,
+        DenseInt8T<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        Conv1DT<TestType, 8, 4, 3, 2>,
+        TanhActivationT<TestType, 4>,
+        GRULayerT<TestType, 4, 8>,
+        DenseT<TestType, 8, 1>>
+        modelT;
+    modelT.parseJson(modelJson);
+    EXPECT_NEAR(modelT.get<0>().getInputRange(), (TestType)1, 1.0e-12);
+
+    const auto xData = loadInputData();
+    const auto expected = processFrames(*dynamicModel, xData);
+    const auto actual = processFrames(modelT, xData);
+    for(size_t n = 0; n < expected.size(); ++n)
+        EXPECT_NEAR(actual[n], expected[n], 1.0e-6) << "Index: " << n;
+}
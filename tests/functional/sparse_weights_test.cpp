@@ -0,0 +1,273 @@
+#include <gmock/gmock.h>
+
+#include "load_csv.hpp"
+#include <RTNeural/RTNeural.h>
+#include <random>
+
+namespace
+{
+using TestType = float;
+using namespace RTNeural;
+
+/**
+ * Sets a random fraction of the weight blocks (`sparse_detail::blockRows` outputs by one input) to zero,
+ * for a json weight matrix with size weights[in_size][out_size].
+ */
+void pruneBlocks(nlohmann::json& weights, double fraction, std::mt19937& rng)
+{
+    std::bernoulli_distribution prune(fraction);
+    for(auto& row : weights)
+    {
+        for(size_t j = 0; j < row.size(); j += sparse_detail::blockRows)
+        {
+            if(!prune(rng))
+                continue;
+
+            for(size_t r = j; r < std::min(j + (size_t)sparse_detail::blockRows, row.size()); ++r)
+                row[r] = 0.0;
+        }
+    }
+}
+
+/** Loads a json model, and prunes the dense weights and recurrent weights. */
+nlohmann::json loadPrunedModel(const std::string& model_file, double fraction)
+{
+    std::ifstream jsonStream(std::string { RTNEURAL_ROOT_DIR } + model_file, std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+
+    std::mt19937 rng(0x5eed);
+    for(auto& l : modelJson.at("layers"))
+    {
+        const auto type = l.at("type").get<std::string>();
+        if(type == "dense" || type == "time-distributed-dense")
+            pruneBlocks(l.at("weights").at(0), fraction, rng);
+        else if(type == "gru" || type == "lstm")
+            pruneBlocks(l.at("weights").at(1), fraction, rng);
+    }
+
+    return modelJson;
+}
+
+std::vector<TestType> loadInputData(const std::string& x_data_file)
+{
+    std::ifstream pythonX(std::string { RTNEURAL_ROOT_DIR } + x_data_file);
+    return load_csv::loadFile<TestType>(pythonX);
+}
+
+template <typename MatrixType>
+void checkMatrix(MatrixType& matrix, int rows, int cols, double fraction, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::bernoulli_distribution prune(fraction);
+
+    std::vector<std::vector<float>> weights((size_t)rows, std::vector<float>((size_t)cols, 0.0f));
+    int numBlocks = 0;
+    for(int k = 0; k < cols; ++k)
+    {
+        for(int i = 0; i < rows; i += sparse_detail::blockRows)
+        {
+            if(prune(rng))
+                continue;
+
+            numBlocks++;
+            for(int r = i; r < std::min(i + sparse_detail::blockRows, rows); ++r)
+                weights[(size_t)r][(size_t)k] = dist(rng);
+        }
+    }
+
+    matrix.setWeights([&weights](int i, int k)
+        { return weights[(size_t)i][(size_t)k]; });
+    EXPECT_EQ(matrix.getNumBlocks(), numBlocks);
+    EXPECT_NEAR(matrix.getSparsity(), 1.0f - (float)numBlocks / (float)(ceil_div(rows, sparse_detail::blockRows) * cols), 1.0e-6f);
+
+    std::vector<float> x((size_t)cols), out((size_t)rows + 1, 123.0f);
+    for(auto& v : x)
+        v = dist(rng);
+    matrix.matVec(x.data(), out.data());
+
+    for(int i = 0; i < rows; ++i)
+    {
+        double expected = 0.0;
+        for(int k = 0; k < cols; ++k)
+        {
+            expected += (double)weights[(size_t)i][(size_t)k] * (double)x[(size_t)k];
+            EXPECT_EQ(matrix.getWeight(i, k), weights[(size_t)i][(size_t)k]);
+        }
+
+        EXPECT_NEAR(out[(size_t)i], expected, 1.0e-5) << "Rows: " << rows << ", cols: " << cols << ", row: " << i;
+    }
+    EXPECT_EQ(out[(size_t)rows], 123.0f); // no writes past the end of the output
+}
+
+json_parser::LoadOptions withSparsityThreshold(float sparsityThreshold)
+{
+    json_parser::LoadOptions options;
+    options.sparsityThreshold = sparsityThreshold;
+    return options;
+}
+} // namespace
+
+TEST(TestSparseWeights, matVecMatchesDenseMatrix)
+{
+    std::mt19937 rng(0x5eed);
+    for(int rows : { 1, 3, 4, 7, 13, 24 })
+    {
+        for(int cols : { 1, 5, 16 })
+        {
+            for(double fraction : { 0.0, 0.5, 0.9, 1.0 })
+            {
+                BlockSparseMatrix<float> matrix(rows, cols);
+                checkMatrix(matrix, rows, cols, fraction, rng);
+            }
+        }
+    }
+
+    BlockSparseMatrixT<float, 13, 5> staticMatrix;
+    checkMatrix(staticMatrix, 13, 5, 0.5, rng);
+}
+
+TEST(TestSparseWeights, sparseLayersUseLessMemory)
+{
+    std::mt19937 rng(0x5eed);
+    std::uniform_real_distribution<TestType> dist(-1.0f, 1.0f);
+    std::vector<std::vector<TestType>> weights(64, std::vector<TestType>(64, 0.0f));
+    for(size_t k = 0; k < 64; k += 4) // one non-zero block in every fourth column
+        weights[k][k] = dist(rng);
+
+    DenseSparse<TestType> dense(64, 64);
+    dense.setWeights(weights);
+    EXPECT_NEAR(dense.getSparsity(), 1.0f - 1.0f / 64.0f, 1.0e-6f);
+    EXPECT_LT(dense.getArenaBytes() * 10, Dense<TestType>(64, 64).getArenaBytes());
+}
+
+TEST(TestSparseWeights, sparsityThresholdChoosesLayers)
+{
+    const auto modelJson = loadPrunedModel("models/gru.json", 0.9);
+
+    auto sparseModel = json_parser::parseJson<TestType>(modelJson);
+    EXPECT_NE(dynamic_cast<GRULayerSparse<TestType>*>(sparseModel->layers[2]), nullptr);
+    EXPECT_NE(dynamic_cast<DenseSparse<TestType>*>(sparseModel->layers[3]), nullptr);
+
+    auto denseModel = json_parser::parseJson<TestType>(modelJson, withSparsityThreshold(2.0f));
+    EXPECT_NE(dynamic_cast<GRULayer<TestType>*>(denseModel->layers[2]), nullptr);
+    EXPECT_NE(dynamic_cast<Dense<TestType>*>(denseModel->layers[3]), nullptr);
+
+    // un-pruned weights stay dense
+    auto unprunedModel = json_parser::parseJson<TestType>(loadPrunedModel("models/gru.json", 0.0));
+    EXPECT_NE(dynamic_cast<GRULayer<TestType>*>(unprunedModel->layers[2]), nullptr);
+}
+
+TEST(TestSparseWeights, prunedModelMatchesDenseModel)
+{
+    for(const auto& files : std::vector<std::pair<std::string, std::string>> {
+            { "models/dense.json", "test_data/dense_x_python.csv" },
+            { "models/gru.json", "test_data/gru_x_python.csv" },
+            { "models/lstm.json", "test_data/lstm_x_python.csv" } })
+    {
+        const auto modelJson = loadPrunedModel(files.first, 0.75);
+        auto sparseModel = json_parser::parseJson<TestType>(modelJson, withSparsityThreshold(0.0f));
+        auto denseModel = json_parser::parseJson<TestType>(modelJson, withSparsityThreshold(2.0f));
+        sparseModel->allocateArena();
+
+        const auto xData = loadInputData(files.second);
+        sparseModel->reset();
+        denseModel->reset();
+        for(size_t n = 0; n < xData.size(); ++n)
+        {
+            alignas(RTNEURAL_DEFAULT_ALIGNMENT) TestType input[] = { xData[n] };
+            EXPECT_NEAR(sparseModel->forward(input), denseModel->forward(input), 1.0e-5) << files.first << ", index: " << n;
+        }
+    }
+}
+
+TEST(TestSparseWeights, templatedModelMatchesDynamicModel)
+{
+    const auto modelJson = loadPrunedModel("models/lstm.json", 0.75);
+
+    ModelT<TestType, 1, 1,
+        DenseSparseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        LSTMLayerSparseT<TestType, 8, 8>,
+        DenseSparseT<TestType, 8, 1>>
+        modelT;
+    EXPECT_TRUE(modelT.parseJson(modelJson));
+    EXPECT_GT(modelT.get<2>().getSparsity(), 0.5f);
+
+    auto dynamicModel = json_parser::parseJson<TestType>(modelJson, withSparsityThreshold(2.0f));
+    const auto xData = loadInputData("test_data/lstm_x_python.csv");
+
+    modelT.reset();
+    dynamicModel->reset();
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        alignas(RTNEURAL_DEFAULT_ALIGNMENT) TestType input[] = { xData[n] };
+        EXPECT_NEAR(modelT.forward(input), dynamicModel->forward(input), 1.0e-5) << "Index: " << n;
+    }
+}
+
+TEST(TestSparseWeights, gruStateRoundTrips)
+{
+    const auto modelJson = loadPrunedModel("models/gru.json", 0.75);
+    ModelT<TestType, 1, 1,
+        DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        GRULayerSparseT<TestType, 8, 8>,
+        DenseT<TestType, 8, 8>,
+        SigmoidActivationT<TestType, 8>,
+        DenseT<TestType, 8, 1>>
+        model, otherModel;
+    EXPECT_TRUE(model.parseJson(modelJson));
+    EXPECT_TRUE(otherModel.parseJson(modelJson));
+
+    const auto xData = loadInputData("test_data/gru_x_python.csv");
+    model.reset();
+    for(size_t n = 0; n < xData.size() / 2; ++n)
+        model.forward(&xData[n]);
+
+    std::vector<TestType> state(model.getStateSize());
+    model.saveState(state.data());
+    otherModel.reset();
+    otherModel.loadState(state.data());
+
+    for(size_t n = xData.size() / 2; n < xData.size(); ++n)
+        EXPECT_EQ(otherModel.forward(&xData[n]), model.forward(&xData[n])) << "Index: " << n;
+}
+
+TEST(TestSparseWeights, recurrentLayersUseMathsProvider)
+{
+    const auto modelJson = loadPrunedModel("models/gru.json", 0.75);
+    ModelT<TestType, 1, 1,
+        DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        GRULayerSparseT<TestType, 8, 8>,
+        DenseT<TestType, 8, 8>,
+        SigmoidActivationT<TestType, 8>,
+        DenseT<TestType, 8, 1>>
+        defaultModel;
+    ModelT<TestType, 1, 1,
+        DenseT<TestType, 1, 8>,
+        TanhActivationT<TestType, 8>,
+        GRULayerSparseT<TestType, 8, 8, Exp2SigmoidMathsProvider>,
+        DenseT<TestType, 8, 8>,
+        SigmoidActivationT<TestType, 8>,
+        DenseT<TestType, 8, 1>>
+        approxModel;
+    EXPECT_TRUE(defaultModel.parseJson(modelJson));
+    EXPECT_TRUE(approxModel.parseJson(modelJson));
+
+    const auto xData = loadInputData("test_data/gru_x_python.csv");
+    defaultModel.reset();
+    approxModel.reset();
+
+    // the approximations are close to the standard functions, but not exact
+    bool anyDifferent = false;
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        const auto expected = defaultModel.forward(&xData[n]);
+        const auto actual = approxModel.forward(&xData[n]);
+        EXPECT_NEAR(actual, expected, 1.0e-3) << "Index: " << n;
+        anyDifferent |= actual != expected;
+    }
+    EXPECT_TRUE(anyDifferent);
+}
@@ -1,6 +1,7 @@
 #include <gmock/gmock.h>
 
 #include <RTNeural/activation/activation.h>
+#include <RTNeural/activation/gated_activation.h>
 
 using namespace testing;
 
@@ -60,3 +61,26 @@ TEST(ActivationTest, reluActivationPassClipsNegativeVaulesToZero)
 
     EXPECT_THAT(output, Pointwise(FloatNear(1e-6f), expected));
 }
+
+TEST(ActivationTest, gatedActivationNameIsReportedCorrectly)
+{
+    EXPECT_THAT(RTNeural::GatedActivation<float>(2).getName(), Eq("gated_activation"));
+}
+
+TEST(ActivationTest, gatedActivationPassMultipliesTanhBySigmoid)
+{
+    auto const input = std::vector<float> { -2.0f, -1.0f, 0.0f, 1.0f, 2.0f, 3.0f, -3.0f, 0.5f, 1.0f, -1.0f };
+    auto gated = RTNeural::GatedActivation<float>(input.size());
+    auto output = std::vector<float>(input.size() / 2);
+    gated.forward(input.data(), output.data());
+
+    const auto sigmoid = [](float x)
+    { return 1.0f / (1.0f + std::exp(-x)); };
+
+    auto expected = std::vector<float>(input.size() / 2);
+    for(size_t i = 0; i < expected.size(); ++i)
+        expected[i] = std::tanh(input[i]) * sigmoid(input[i + expected.size()]);
+
+    EXPECT_EQ(gated.out_size, 5);
+    EXPECT_THAT(output, Pointwise(FloatNear(1e-6f), expected));
+}
@@ -0,0 +1,141 @@
+#include <gmock/gmock.h>
+
+#include <RTNeural/RTNeural.h>
+
+using namespace testing;
+
+namespace
+{
+constexpr int numFrames = 11;
+constexpr int maxFrameSize = 16;
+
+std::vector<double> makeInput(int size)
+{
+    std::vector<double> input((size_t)(size * numFrames));
+    for(size_t i = 0; i < input.size(); ++i)
+        input[i] = std::sin(0.37 * (double)i) * 2.0;
+    return input;
+}
+
+/** Runs a layer over the input one frame at a time, using aligned frame buffers. */
+std::vector<double> forwardFrameByFrame(RTNeural::Layer<double>& layer, const std::vector<double>& input)
+{
+    double frameIn alignas(RTNEURAL_DEFAULT_ALIGNMENT)[maxFrameSize];
+    double frameOut alignas(RTNEURAL_DEFAULT_ALIGNMENT)[maxFrameSize];
+
+    std::vector<double> output((size_t)(layer.out_size * numFrames));
+    layer.reset();
+    for(int n = 0; n < numFrames; ++n)
+    {
+        std::copy(input.begin() + n * layer.in_size, input.begin() + (n + 1) * layer.in_size, frameIn);
+        layer.forward(frameIn, frameOut);
+        std::copy(frameOut, frameOut + layer.out_size, output.begin() + n * layer.out_size);
+    }
+
+    return output;
+}
+
+void checkBlockMatchesFrames(RTNeural::Layer<double>& layer)
+{
+    ASSERT_LE(layer.in_size, maxFrameSize);
+    ASSERT_LE(layer.out_size, maxFrameSize);
+
+    const auto input = makeInput(layer.in_size);
+    const auto expected = forwardFrameByFrame(layer, input);
+
+    // offset the block by one sample, so that the frames are not aligned
+    std::vector<double> inputBlock(input.size() + 1);
+    std::copy(input.begin(), input.end(), inputBlock.begin() + 1);
+    std::vector<double> outputBlock((size_t)(layer.out_size * numFrames + 1));
+
+    layer.reset();
+    layer.forwardBlock(inputBlock.data() + 1, outputBlock.data() + 1, numFrames);
+
+    EXPECT_THAT(std::vector<double>(outputBlock.begin() + 1, outputBlock.end()), Pointwise(DoubleNear(1.0e-12), expected));
+}
+}
+
+TEST(LayerBlockTest, activationBlocksMatchFrames)
+{
+    RTNeural::TanhActivation<double> tanh(5);
+    checkBlockMatchesFrames(tanh);
+
+    RTNeural::ReLuActivation<double> relu(5);
+    checkBlockMatchesFrames(relu);
+
+    RTNeural::SigmoidActivation<double> sigmoid(5);
+    checkBlockMatchesFrames(sigmoid);
+
+    RTNeural::SoftmaxActivation<double> softmax(5);
+    checkBlockMatchesFrames(softmax);
+
+    RTNeural::ELuActivation<double> elu(5);
+    elu.set_alpha(0.5);
+    checkBlockMatchesFrames(elu);
+
+    RTNeural::PReLUActivation<double> prelu(5);
+    prelu.setAlphaVals({ 0.1, 0.2, 0.3, 0.4, 0.5 });
+    checkBlockMatchesFrames(prelu);
+}
+
+TEST(LayerBlockTest, denseBlockMatchesFrames)
+{
+    // input sizes which are smaller than, and not a multiple of, the SIMD width
+    for(const auto in_size : { 3, 13 })
+    {
+        RTNeural::Dense<double> dense(in_size, 5);
+        std::vector<std::vector<double>> weights(5, std::vector<double>((size_t)in_size));
+        for(int i = 0; i < 5; ++i)
+            for(int k = 0; k < in_size; ++k)
+                weights[i][k] = 0.1 * (i + 1) - 0.07 * k;
+        dense.setWeights(weights);
+
+        const double bias[] = { 0.1, -0.1, 0.2, -0.2, 0.3 };
+        dense.setBias(bias);
+
+        checkBlockMatchesFrames(dense);
+    }
+}
+
+TEST(LayerBlockTest, batchNormBlockMatchesFrames)
+{
+    RTNeural::BatchNorm1DLayer<double> batchnorm(3);
+    batchnorm.setGamma({ 0.5, 1.0, 1.5 });
+    batchnorm.setBeta({ 0.1, 0.2, -0.3 });
+    batchnorm.setRunningMean({ 0.2, -0.1, 0.0 });
+    batchnorm.setRunningVariance({ 1.5, 0.5, 2.0 });
+    checkBlockMatchesFrames(batchnorm);
+
+    RTNeural::BatchNorm2DLayer<double> batchnorm2d(3, 2);
+    batchnorm2d.setGamma({ 0.5, 1.0, 1.5 });
+    batchnorm2d.setBeta({ 0.1, 0.2, -0.3 });
+    batchnorm2d.setRunningMean({ 0.2, -0.1, 0.0 });
+    batchnorm2d.setRunningVariance({ 1.5, 0.5, 2.0 });
+    checkBlockMatchesFrames(batchnorm2d);
+}
+
+TEST(LayerBlockTest, conv1dBlockMatchesFrames)
+{
+    const auto makeConv = [](int kernel_size, int dilation)
+    {
+        auto conv = std::make_unique<RTNeural::Conv1D<double>>(3, 4, kernel_size, dilation);
+
+        std::vector<std::vector<std::vector<double>>> weights(4, std::vector<std::vector<double>>(3, std::vector<double>((size_t)kernel_size)));
+        for(int i = 0; i < 4; ++i)
+            for(int k = 0; k < 3; ++k)
+                for(int j = 0; j < kernel_size; ++j)
+                    weights[i][k][j] = 0.1 * (i + 1) - 0.05 * k + 0.03 * j;
+        conv->setWeights(weights);
+        conv->setBias({ 0.1, -0.1, 0.2, -0.2 });
+
+        return conv;
+    };
+
+    // state shorter than the block
+    auto conv = makeConv(3, 2);
+    checkBlockMatchesFrames(*conv);
+
+    // state longer than the block
+    auto convDilated = makeConv(3, 6);
+    checkBlockMatchesFrames(*convDilated);
+}
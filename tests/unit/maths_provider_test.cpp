@@ -0,0 +1,75 @@
+#include <gmock/gmock.h>
+
+#include <RTNeural/activation/activation.h>
+
+namespace
+{
+/** Returns evenly spaced values over [-20, 20]. */
+std::vector<float> makeInputs()
+{
+    std::vector<float> input(40001);
+    for(size_t i = 0; i < input.size(); ++i)
+        input[i] = -20.0f + 40.0f * (float)i / (float)(input.size() - 1);
+    return input;
+}
+
+/** Returns the largest absolute error of a layer's output, against a function computed in double. */
+template <typename LayerType, typename Function>
+double getMaxError(LayerType&& layer, Function&& expected)
+{
+    const auto input = makeInputs();
+    std::vector<float> output(input.size());
+    layer.forward(input.data(), output.data());
+
+    double maxError = 0.0;
+    for(size_t i = 0; i < input.size(); ++i)
+        maxError = std::max(maxError, std::abs((double)output[i] - expected((double)input[i])));
+    return maxError;
+}
+
+double sigmoid(double x) { return 1.0 / (1.0 + std::exp(-x)); }
+double elu(double x) { return x > 0.0 ? x : std::exp(x) - 1.0; }
+} // namespace
+
+TEST(MathsProviderTest, padeTanhIsWithinDocumentedError)
+{
+    const auto size = (int)makeInputs().size();
+    EXPECT_LT(getMaxError(RTNeural::TanhActivation<float, RTNeural::PadeTanhMathsProvider>(size), [](double x)
+                  { return std::tanh(x); }),
+        9.7e-5);
+    EXPECT_LT(getMaxError(RTNeural::SigmoidActivation<float, RTNeural::PadeTanhMathsProvider>(size), sigmoid), 4.9e-5);
+}
+
+TEST(MathsProviderTest, exp2SigmoidIsWithinDocumentedError)
+{
+    const auto size = (int)makeInputs().size();
+    EXPECT_LT(getMaxError(RTNeural::SigmoidActivation<float, RTNeural::Exp2SigmoidMathsProvider>(size), sigmoid), 2.2e-5);
+}
+
+TEST(MathsProviderTest, polynomialEluIsWithinDocumentedError)
+{
+    const auto size = (int)makeInputs().size();
+    EXPECT_LT(getMaxError(RTNeural::ELuActivation<float, RTNeural::PolynomialEluMathsProvider>(size), elu), 2.0e-7);
+}
+
+TEST(MathsProviderTest, fastProviderMatchesOtherProviders)
+{
+    const auto size = (int)makeInputs().size();
+    EXPECT_LT(getMaxError(RTNeural::TanhActivation<float, RTNeural::FastMathsProvider>(size), [](double x)
+                  { return std::tanh(x); }),
+        9.7e-5);
+    EXPECT_LT(getMaxError(RTNeural::SigmoidActivation<float, RTNeural::FastMathsProvider>(size), sigmoid), 4.9e-5);
+    EXPECT_LT(getMaxError(RTNeural::ELuActivation<float, RTNeural::FastMathsProvider>(size), elu), 2.0e-7);
+}
+
+TEST(MathsProviderTest, approximationsSaturate)
+{
+    const auto input = std::vector<float> { -1.0e6f, -100.0f, 100.0f, 1.0e6f };
+    std::vector<float> output(input.size());
+
+    RTNeural::TanhActivation<float, RTNeural::FastMathsProvider>((int)input.size()).forward(input.data(), output.data());
+    EXPECT_THAT(output, testing::Pointwise(testing::FloatNear(1.0e-6f), std::vector<float> { -1.0f, -1.0f, 1.0f, 1.0f }));
+
+    RTNeural::SigmoidActivation<float, RTNeural::FastMathsProvider>((int)input.size()).forward(input.data(), output.data());
+    EXPECT_THAT(output, testing::Pointwise(testing::FloatNear(1.0e-6f), std::vector<float> { 0.0f, 0.0f, 1.0f, 1.0f }));
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Reads the calibration input for a model, as a vector of frames stored
+ * contiguously, with `in_size` values per frame.
+ *
+ * CSV files should have one frame per line, with the frame values separated
+ * by commas. WAV files (16/24/32-bit PCM, or 32-bit float) should have either
+ * one channel per model input, or a single channel for models with one input.
+ */
+namespace input_file
+{
+inline bool hasExtension(const std::string& path, const std::string& extension)
+{
+    if(path.size() < extension.size())
+        return false;
+
+    auto end = path.substr(path.size() - extension.size());
+    for(auto& c : end)
+        c = (char)std::tolower(c);
+    return end == extension;
+}
+
+inline std::vector<float> readCSV(const std::string& path, int in_size)
+{
+    std::ifstream stream(path);
+    if(!stream.is_open())
+        throw std::runtime_error("Unable to open input file: " + path);
+
+    std::vector<float> frames;
+    std::string line;
+    while(std::getline(stream, line))
+    {
+        if(line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        std::stringstream lineStream(line);
+        std::string value;
+        int count = 0;
+        while(std::getline(lineStream, value, ','))
+        {
+            frames.push_back(std::stof(value));
+            count++;
+        }
+
+        if(count != in_size)
+            throw std::runtime_error("Each line of the CSV file should have " + std::to_string(in_size) + " values!");
+    }
+
+    return frames;
+}
+
+template <typename IntType>
+IntType readInt(const unsigned char* bytes)
+{
+    IntType value = 0;
+    for(size_t i = 0; i < sizeof(IntType); ++i)
+        value |= (IntType)((IntType)bytes[i] << (8 * i));
+    return value;
+}
+
+inline float readSample(const unsigned char* bytes, int format, int bitsPerSample)
+{
+    if(format == 3) // IEEE float
+    {
+        float sample;
+        std::memcpy(&sample, bytes, sizeof(float));
+        return sample;
+    }
+
+    switch(bitsPerSample)
+    {
+    case 16:
+        return (float)(int16_t)readInt<uint16_t>(bytes) / 32768.0f;
+    case 24:
+        return (float)((int32_t)(readInt<uint32_t>(bytes) << 8) >> 8) / 8388608.0f;
+    default:
+        return (float)(int32_t)readInt<uint32_t>(bytes) / 2147483648.0f;
+    }
+}
+
+inline std::vector<float> readWAV(const std::string& path, int in_size)
+{
+    std::ifstream stream(path, std::ifstream::binary);
+    if(!stream.is_open())
+        throw std::runtime_error("Unable to open input file: " + path);
+
+    const std::vector<unsigned char> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    if(data.size() < 12 || std::memcmp(data.data(), "RIFF", 4) != 0 || std::memcmp(data.data() + 8, "WAVE", 4) != 0)
+        throw std::runtime_error("Not a WAV file: " + path);
+
+    int format = 0, numChannels = 0, bitsPerSample = 0;
+    for(size_t pos = 12; pos + 8 <= data.size();)
+    {
+        const auto chunkSize = (size_t)readInt<uint32_t>(data.data() + pos + 4);
+        const auto* chunk = data.data() + pos + 8;
+        if(pos + 8 + chunkSize > data.size())
+            break;
+
+        if(std::memcmp(data.data() + pos, "fmt ", 4) == 0)
+        {
+            format = readInt<uint16_t>(chunk);
+            numChannels = readInt<uint16_t>(chunk + 2);
+            bitsPerSample = readInt<uint16_t>(chunk + 14);
+            if(format == 0xfffe && chunkSize >= 26) // WAVE_FORMAT_EXTENSIBLE
+                format = readInt<uint16_t>(chunk + 24);
+        }
+        else if(std::memcmp(data.data() + pos, "data", 4) == 0)
+        {
+            const auto supported = (format == 1 && (bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32))
+                || (format == 3 && bitsPerSample == 32);
+            if(!supported)
+                throw std::runtime_error("Unsupported WAV format (expected 16/24/32-bit PCM, or 32-bit float)");
+
+            if(numChannels != in_size && numChannels != 1)
+                throw std::runtime_error("The WAV file should have one channel, or one channel per model input");
+
+            const auto bytesPerSample = (size_t)bitsPerSample / 8;
+            const auto numFrames = chunkSize / (bytesPerSample * (size_t)numChannels);
+
+            // single-channel files are repeated across the model inputs
+            std::vector<float> frames(numFrames * (size_t)in_size);
+            for(size_t n = 0; n < numFrames; ++n)
+            {
+                for(int i = 0; i < in_size; ++i)
+                {
+                    const auto channel = numChannels == 1 ? 0 : (size_t)i;
+                    frames[n * (size_t)in_size + (size_t)i] = readSample(chunk + (n * (size_t)numChannels + channel) * bytesPerSample, format, bitsPerSample);
+                }
+            }
+
+            return frames;
+        }
+
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    throw std::runtime_error("No audio data found in WAV file: " + path);
+}
+
+/** Reads the frames from a CSV or WAV file. */
+inline std::vector<float> read(const std::string& path, int in_size)
+{
+    if(hasExtension(path, ".wav"))
+        return readWAV(path, in_size);
+
+    return readCSV(path, in_size);
+}
+} // namespace input_file
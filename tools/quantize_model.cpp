@@ -0,0 +1,475 @@
+#include "input_file.hpp"
+#include <RTNeural.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+
+/**
+ * Post-training quantization tool.
+ *
+ * Runs some representative input through a float model, to record the
+ * range of the activations going into each layer. Then each layer that
+ * supports the requested weight format is quantized on its own, to measure
+ * its error and speedup. Layers which aren't fast enough when quantized are
+ * skipped, and the rest are added to the quantized model (most accurate first),
+ * for as long as the error of the whole model stays within the error budget.
+ *
+ * The quantized model is written as a json file with the same weights, where
+ * the quantized layers have a "weight_format" field, and int8 layers also have
+ * the calibrated "input_range". `json_parser::parseJson()` (and `ModelT` for the
+ * int8 layer types) load these fields.
+ */
+namespace
+{
+using namespace RTNeural;
+using json_parser::WeightFormat;
+using clock_type = std::chrono::high_resolution_clock;
+using second_type = std::chrono::duration<double>;
+
+constexpr double minTimingSeconds = 0.25;
+
+/** A float buffer with the alignment needed by the SIMD backends, since some layers need an aligned input. */
+class AlignedBuffer
+{
+public:
+    AlignedBuffer() = default;
+    AlignedBuffer(const float* values, size_t count)
+        : AlignedBuffer(count)
+    {
+        std::copy(values, values + count, data());
+    }
+
+    explicit AlignedBuffer(size_t count)
+        : storage(count + RTNEURAL_DEFAULT_ALIGNMENT / sizeof(float), 0.0f)
+        , size(count)
+    {
+    }
+
+    float* data() noexcept
+    {
+        void* ptr = storage.data();
+        auto space = storage.size() * sizeof(float);
+        return static_cast<float*>(std::align(RTNEURAL_DEFAULT_ALIGNMENT, size * sizeof(float), ptr, space));
+    }
+
+    const float* data() const noexcept { return const_cast<AlignedBuffer*>(this)->data(); }
+
+private:
+    std::vector<float> storage;
+    size_t size = 0;
+};
+
+struct Options
+{
+    std::string modelFile;
+    std::string inputFile;
+    std::string outputFile;
+    WeightFormat format = WeightFormat::Int8;
+    float maxError = 1.0e-2f;
+    double minSpeedup = 1.0;
+};
+
+void printUsage()
+{
+    std::cout << "Usage: rtneural_quantize <model.json> <input.csv|input.wav> <output.json> [options]\n"
+              << "Options:\n"
+              << "  --format <int8|bfloat16|float16>  weight format for the quantized layers (default: int8)\n"
+              << "  --max-error <value>               largest output error allowed, compared to the float model (default: 0.01)\n"
+              << "  --min-speedup <value>             smallest per-layer speedup needed to quantize a layer (default: 1)\n";
+}
+
+/** Parses the command line arguments. Numeric arguments which can't be parsed throw an exception. */
+bool parseArgs(int argc, char* argv[], Options& options)
+{
+    if(argc < 4)
+        return false;
+
+    options.modelFile = argv[1];
+    options.inputFile = argv[2];
+    options.outputFile = argv[3];
+
+    for(int i = 4; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if(arg == "--format")
+        {
+            nlohmann::json layer { { "weight_format", value } };
+            options.format = json_parser::getLayerWeightFormat(layer, WeightFormat::Float);
+            if(options.format == WeightFormat::Float)
+                return false;
+        }
+        else if(arg == "--max-error")
+        {
+            options.maxError = std::stof(value);
+        }
+        else if(arg == "--min-speedup")
+        {
+            options.minSpeedup = std::stod(value);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return (argc - 4) % 2 == 0;
+}
+
+/** Information about one layer of the json model. */
+struct LayerInfo
+{
+    std::string type;
+    int firstModelLayer = 0; // a json layer may create an extra activation layer
+    int numModelLayers = 0;
+
+    float inputRange = 0.0f;
+    float outputMin = 0.0f;
+    float outputMax = 0.0f;
+    std::vector<AlignedBuffer> inputs; // the layer inputs from the float model, used for timing
+
+    bool quantizable = false;
+    float maxError = 0.0f;
+    float rmsError = 0.0f;
+    double floatSeconds = 0.0;
+    double quantizedSeconds = 0.0;
+    bool selected = false;
+
+    double getSpeedup() const noexcept { return floatSeconds / quantizedSeconds; }
+};
+
+struct ErrorStats
+{
+    float maxError = 0.0f;
+    float rmsError = 0.0f;
+};
+
+/** Loads a model from its json representation, and throws if the model can't be loaded. */
+std::unique_ptr<Model<float>> loadModel(const nlohmann::json& modelJson)
+{
+    auto model = json_parser::parseJson<float>(modelJson);
+    if(model == nullptr)
+        throw std::runtime_error("Unable to load model!");
+    return model;
+}
+
+bool isQuantizable(const std::string& type, WeightFormat format)
+{
+    if(type == "dense" || type == "time-distributed-dense" || type == "conv1d")
+        return true;
+
+    return format != WeightFormat::Int8 && (type == "gru" || type == "lstm");
+}
+
+/** Runs the model over all of the frames, and returns the output frames. */
+std::vector<float> runModel(Model<float>& model, const std::vector<float>& frames)
+{
+    const auto inSize = (size_t)model.getInSize();
+    const auto outSize = (size_t)model.getOutSize();
+    const auto numFrames = frames.size() / inSize;
+
+    std::vector<float> outputs(numFrames * outSize);
+    AlignedBuffer frame(inSize);
+    model.reset();
+    for(size_t n = 0; n < numFrames; ++n)
+    {
+        std::copy(frames.begin() + (std::ptrdiff_t)(n * inSize), frames.begin() + (std::ptrdiff_t)((n + 1) * inSize), frame.data());
+        model.forward(frame.data());
+        std::copy(model.getOutputs(), model.getOutputs() + outSize, outputs.begin() + (std::ptrdiff_t)(n * outSize));
+    }
+
+    return outputs;
+}
+
+ErrorStats getError(const std::vector<float>& outputs, const std::vector<float>& reference)
+{
+    ErrorStats stats;
+    double sumSquares = 0.0;
+    for(size_t n = 0; n < outputs.size(); ++n)
+    {
+        const auto error = std::abs(outputs[n] - reference[n]);
+        stats.maxError = std::max(stats.maxError, error);
+        sumSquares += (double)error * (double)error;
+    }
+
+    stats.rmsError = outputs.empty() ? 0.0f : (float)std::sqrt(sumSquares / (double)outputs.size());
+    return stats;
+}
+
+/** Returns the time taken by a function that processes `numFrames` frames, in seconds per frame. */
+template <typename Fn>
+double timePerFrame(Fn&& process, size_t numFrames)
+{
+    size_t framesProcessed = 0;
+    const auto start = clock_type::now();
+    double duration = 0.0;
+    while(duration < minTimingSeconds || framesProcessed == 0)
+    {
+        process();
+        framesProcessed += numFrames;
+        duration = std::chrono::duration_cast<second_type>(clock_type::now() - start).count();
+    }
+
+    return duration / (double)framesProcessed;
+}
+
+double timeModel(Model<float>& model, const std::vector<float>& frames)
+{
+    return timePerFrame([&]
+        { runModel(model, frames); },
+        frames.size() / (size_t)model.getInSize());
+}
+
+/** Times some model layers, running over the given layer inputs. */
+double timeLayers(Model<float>& model, const LayerInfo& info)
+{
+    const auto first = (size_t)info.firstModelLayer;
+
+    std::vector<AlignedBuffer> outs;
+    for(int i = 0; i < info.numModelLayers; ++i)
+        outs.emplace_back((size_t)model.layers[first + (size_t)i]->out_size);
+
+    return timePerFrame([&]
+        {
+            for(int i = 0; i < info.numModelLayers; ++i)
+                model.layers[first + (size_t)i]->reset();
+
+            for(const auto& input : info.inputs)
+            {
+                model.layers[first]->forward(input.data(), outs[0].data());
+                for(size_t i = 1; i < outs.size(); ++i)
+                    model.layers[first + i]->forward(outs[i - 1].data(), outs[i].data());
+            }
+        },
+        info.inputs.size());
+}
+
+size_t getLayerBytes(const Model<float>& model)
+{
+    size_t numBytes = 0;
+    for(const auto* l : model.layers)
+        numBytes += l->getArenaBytes();
+    return numBytes;
+}
+
+/** Works out which model layers were created for each json layer. */
+std::vector<LayerInfo> getLayerInfo(const nlohmann::json& modelJson, const Options& options)
+{
+    std::vector<LayerInfo> layers;
+    auto prefixJson = modelJson;
+    prefixJson["layers"] = nlohmann::json::array();
+
+    int numModelLayers = 0;
+    for(const auto& l : modelJson.at("layers"))
+    {
+        prefixJson["layers"].push_back(l);
+        const auto prefixModel = loadModel(prefixJson);
+
+        LayerInfo info;
+        info.type = l.at("type").get<std::string>();
+        info.firstModelLayer = numModelLayers;
+        info.numModelLayers = (int)prefixModel->layers.size() - numModelLayers;
+        info.quantizable = isQuantizable(info.type, options.format);
+        numModelLayers = (int)prefixModel->layers.size();
+        layers.push_back(std::move(info));
+    }
+
+    return layers;
+}
+
+/** Runs the float model layer-by-layer, and records the activation ranges for each json layer. */
+void calibrate(Model<float>& model, const std::vector<float>& frames, std::vector<LayerInfo>& layers)
+{
+    const auto inSize = (size_t)model.getInSize();
+    const auto numFrames = frames.size() / inSize;
+
+    std::vector<AlignedBuffer> outs;
+    for(const auto* l : model.layers)
+        outs.emplace_back((size_t)l->out_size);
+
+    for(auto& info : layers)
+    {
+        info.outputMin = std::numeric_limits<float>::max();
+        info.outputMax = std::numeric_limits<float>::lowest();
+    }
+
+    model.reset();
+    for(size_t n = 0; n < numFrames; ++n)
+    {
+        const AlignedBuffer frame(frames.data() + n * inSize, inSize);
+        const float* input = frame.data();
+        for(auto& info : layers)
+        {
+            const auto first = (size_t)info.firstModelLayer;
+            if(info.numModelLayers == 0)
+                continue;
+
+            const auto layerInSize = (size_t)model.layers[first]->in_size;
+            for(size_t i = 0; i < layerInSize; ++i)
+                info.inputRange = std::max(info.inputRange, std::abs(input[i]));
+            if(info.quantizable)
+                info.inputs.emplace_back(input, layerInSize);
+
+            for(size_t i = first; i < first + (size_t)info.numModelLayers; ++i)
+            {
+                model.layers[i]->forward(input, outs[i].data());
+                input = outs[i].data();
+            }
+
+            const auto outSize = (size_t)model.layers[first + (size_t)info.numModelLayers - 1]->out_size;
+            const auto range = std::minmax_element(input, input + outSize);
+            info.outputMin = std::min(info.outputMin, *range.first);
+            info.outputMax = std::max(info.outputMax, *range.second);
+        }
+    }
+}
+
+/** Marks a json layer as quantized, with the calibrated input range for int8 layers. */
+void quantizeLayer(nlohmann::json& layerJson, const LayerInfo& info, WeightFormat format)
+{
+    layerJson["weight_format"] = json_parser::getWeightFormatName(format);
+    if(format == WeightFormat::Int8 && info.inputRange > 0.0f)
+        layerJson["input_range"] = info.inputRange;
+}
+
+/** Describes whether a layer was quantized, and if not, why. */
+std::string getQuantizedStatus(const LayerInfo& info, const Options& options)
+{
+    if(info.selected)
+        return "yes";
+    if(info.getSpeedup() < options.minSpeedup)
+        return "no (too slow)";
+    return "no (error)";
+}
+
+void printReport(const std::vector<LayerInfo>& layers, const Options& options)
+{
+    std::cout << std::left << std::setw(4) << "#" << std::setw(24) << "Layer" << std::setw(12) << "In range"
+              << std::setw(24) << "Out range" << std::setw(12) << "Max error" << std::setw(12) << "RMS error"
+              << std::setw(10) << "Speedup" << "Quantized" << std::endl;
+
+    for(size_t i = 0; i < layers.size(); ++i)
+    {
+        const auto& info = layers[i];
+        std::stringstream outRange;
+        outRange << "[" << std::setprecision(3) << info.outputMin << ", " << info.outputMax << "]";
+
+        std::cout << std::left << std::setw(4) << i << std::setw(24) << info.type << std::setw(12) << std::setprecision(4) << info.inputRange
+                  << std::setw(24) << outRange.str();
+
+        if(!info.quantizable)
+        {
+            std::cout << "-" << std::endl;
+            continue;
+        }
+
+        std::cout << std::setw(12) << info.maxError << std::setw(12) << info.rmsError
+                  << std::setw(10) << std::setprecision(3) << info.getSpeedup()
+                  << getQuantizedStatus(info, options) << std::endl;
+    }
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    try
+    {
+        if(!parseArgs(argc, argv, options))
+        {
+            printUsage();
+            return 1;
+        }
+
+        std::ifstream jsonStream(options.modelFile, std::ifstream::binary);
+        if(!jsonStream.is_open())
+            throw std::runtime_error("Unable to open model file: " + options.modelFile);
+
+        nlohmann::json modelJson;
+        jsonStream >> modelJson;
+
+        auto floatModel = loadModel(modelJson);
+        const auto frames = input_file::read(options.inputFile, floatModel->getInSize());
+        if(frames.empty())
+            throw std::runtime_error("No input frames found in: " + options.inputFile);
+
+        std::cout << "Calibrating with " << frames.size() / (size_t)floatModel->getInSize() << " frames..." << std::endl;
+        const auto reference = runModel(*floatModel, frames);
+
+        auto layers = getLayerInfo(modelJson, options);
+        calibrate(*floatModel, frames, layers);
+
+        // measure the error and speedup for each layer on its own
+        for(size_t i = 0; i < layers.size(); ++i)
+        {
+            auto& info = layers[i];
+            if(!info.quantizable)
+                continue;
+
+            auto layerJson = modelJson;
+            quantizeLayer(layerJson["layers"][i], info, options.format);
+            auto layerModel = loadModel(layerJson);
+
+            const auto error = getError(runModel(*layerModel, frames), reference);
+            info.maxError = error.maxError;
+            info.rmsError = error.rmsError;
+            info.floatSeconds = timeLayers(*floatModel, info);
+            info.quantizedSeconds = timeLayers(*layerModel, info);
+        }
+
+        // add the layers which are fast enough to the quantized model, most accurate first, while the error stays in budget
+        std::vector<size_t> order;
+        for(size_t i = 0; i < layers.size(); ++i)
+        {
+            if(layers[i].quantizable && layers[i].getSpeedup() >= options.minSpeedup && layers[i].maxError <= options.maxError)
+                order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+            { return layers[a].maxError < layers[b].maxError; });
+
+        auto quantizedJson = modelJson;
+        for(auto i : order)
+        {
+            auto candidateJson = quantizedJson;
+            quantizeLayer(candidateJson["layers"][i], layers[i], options.format);
+            auto candidateModel = loadModel(candidateJson);
+            if(getError(runModel(*candidateModel, frames), reference).maxError <= options.maxError)
+            {
+                quantizedJson = std::move(candidateJson);
+                layers[i].selected = true;
+            }
+        }
+
+        auto quantizedModel = loadModel(quantizedJson);
+        const auto error = getError(runModel(*quantizedModel, frames), reference);
+        const auto floatSeconds = timeModel(*floatModel, frames);
+        const auto quantizedSeconds = timeModel(*quantizedModel, frames);
+
+        std::cout << std::endl;
+        printReport(layers, options);
+        std::cout << std::endl
+                  << "Quantized model (" << json_parser::getWeightFormatName(options.format) << "):" << std::endl
+                  << "  max error: " << error.maxError << ", RMS error: " << error.rmsError << std::endl
+                  << "  arena memory: " << getLayerBytes(*floatModel) << " -> " << getLayerBytes(*quantizedModel) << " bytes" << std::endl
+                  << "  time per frame: " << floatSeconds * 1.0e9 << " -> " << quantizedSeconds * 1.0e9 << " ns ("
+                  << floatSeconds / quantizedSeconds << "x)" << std::endl;
+
+        std::ofstream outStream(options.outputFile);
+        if(!outStream.is_open())
+            throw std::runtime_error("Unable to write output file: " + options.outputFile);
+        outStream << quantizedJson.dump();
+        std::cout << "Quantized model written to: " << options.outputFile << std::endl;
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}